@@ -0,0 +1,74 @@
+/**
+ * Tests that change streams with {fullDocument: "updateLookup"} share the documents looked up for
+ * the same update events through the post-image lookup cache, unless they use a non-simple
+ * collation, and that the cache is reported in serverStatus.
+ *
+ * @tags: [
+ *   requires_majority_read_concern,
+ *   requires_replication,
+ *   uses_change_streams,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+// Keep the cached lookups for the whole test.
+rst.startSet({setParameter: {internalChangeStreamPostImageLookupCacheTTLMillis: 10 * 60 * 1000}});
+rst.initiate();
+
+const db = rst.getPrimary().getDB(jsTestName());
+const coll = db.coll;
+
+const kNumDocs = 10;
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.commandWorked(coll.insert({_id: i, updated: false}));
+}
+
+const cacheMetrics = () => db.serverStatus().metrics.changeStreams.postImageLookupCache;
+const openChangeStream = (options) =>
+    coll.aggregate([{$changeStream: {fullDocument: "updateLookup"}}], options);
+
+// Open the change streams before the updates. They only use lookups made after they were opened.
+const changeStreams = [openChangeStream({}), openChangeStream({}), openChangeStream({})];
+const collationChangeStream = openChangeStream({collation: {locale: "en_US", strength: 2}});
+
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.commandWorked(
+        coll.update({_id: i}, {$set: {updated: true}}, {writeConcern: {w: "majority"}}));
+}
+
+function readEvents(changeStream) {
+    const events = [];
+    assert.soon(() => {
+        while (events.length < kNumDocs && changeStream.hasNext()) {
+            events.push(changeStream.next());
+        }
+        return events.length === kNumDocs;
+    });
+    changeStream.close();
+
+    assert.eq(events.map((event) => event.fullDocument),
+              [...Array(kNumDocs).keys()].map((i) => ({_id: i, updated: true})),
+              tojson(events));
+    return events;
+}
+
+// The first change stream looks up each document, and the others use its lookups.
+let before = cacheMetrics();
+const events = changeStreams.map(readEvents);
+let after = cacheMetrics();
+assert.eq(kNumDocs, after.misses - before.misses, tojson({before: before, after: after}));
+assert.eq((changeStreams.length - 1) * kNumDocs,
+          after.hits - before.hits,
+          tojson({before: before, after: after}));
+events.forEach((streamEvents) => assert.eq(events[0], streamEvents));
+
+// A change stream with a non-simple collation makes its own lookups without the cache.
+before = cacheMetrics();
+assert.eq(events[0], readEvents(collationChangeStream));
+after = cacheMetrics();
+assert.eq(before, after);
+
+rst.stopSet();
+})();
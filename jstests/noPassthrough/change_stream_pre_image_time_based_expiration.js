@@ -176,16 +176,26 @@ function testTimeBasedPreImageRetentionPolicy(conn, primary) {
     currentTimeFailPoint.off();
 }
 
-// Tests pre-image time based expiration on a replica-set.
+// Tests pre-image time based expiration on a replica-set, with the expired pre-images removed
+// either by replicated deletes or by truncates.
 // TODO SERVER-61802: Add test cases for shared cluster.
-(function testChangeStreamPreImagesforTimeBasedExpirationOnReplicaSet() {
+for (const truncateExpiredPreImages of [false, true]) {
     const replSetTest = new ReplSetTest({name: "replSet", nodes: 1});
-    replSetTest.startSet();
+    replSetTest.startSet(
+        {setParameter: {truncateExpiredChangeStreamPreImages: truncateExpiredPreImages}});
     replSetTest.initiate();
 
     const conn = replSetTest.getPrimary();
     const primary = replSetTest.getPrimary();
     testTimeBasedPreImageRetentionPolicy(conn, primary);
+
+    // Truncates are not replicated.
+    if (truncateExpiredPreImages) {
+        assert.eq(0,
+                  primary.getDB("local")
+                      .oplog.rs.find({op: "d", ns: "config.system.preimages"})
+                      .itcount());
+    }
     replSetTest.stopSet();
-})();
+}
 }());
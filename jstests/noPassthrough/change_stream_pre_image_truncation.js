@@ -0,0 +1,109 @@
+/**
+ * Tests that with 'truncateExpiredChangeStreamPreImages' enabled every node of a replica set
+ * removes its expired pre-images by truncating them, including the expired pre-images at the front
+ * of a truncate marker which has not expired as a whole, and that truncates are not replicated.
+ *
+ * @tags: [
+ *   requires_fcv_60,
+ *   featureFlagChangeStreamPreAndPostImages,
+ *   assumes_against_mongod_not_mongos,
+ *   requires_replication,
+ *   requires_majority_read_concern,
+ * ]
+ */
+(function() {
+"use strict";
+
+load("jstests/replsets/rslib.js");  // For getLatestOp, getFirstOplogEntry.
+
+const rst = new ReplSetTest({nodes: 2, oplogSize: 1});
+rst.startSet({
+    setParameter: {
+        expiredChangeStreamPreImageRemovalJobSleepSecs: 1,
+        truncateExpiredChangeStreamPreImages: true,
+        // Each marker covers a few pre-images, so that both whole markers and the expired front
+        // of a marker are truncated.
+        changeStreamPreImageTruncateMarkerBytes: 1024,
+    }
+});
+rst.initiate();
+
+const primary = rst.getPrimary();
+const secondary = rst.getSecondary();
+const testDB = primary.getDB(jsTestName());
+const largeStr = "abcdefghi".repeat(4 * 1024);
+const padding = "x".repeat(200);
+const kNumExpiredUpdates = 10;
+
+const getPreImages = (node) => node.getDB("config").system.preimages.find().toArray();
+const purgingJobMetrics = (node) =>
+    node.getDB("admin").serverStatus().metrics.changeStreamPreImages.purgingJob;
+
+// Checks if the oplog of every node has been rolled over past the entry with timestamp 'ts'.
+function oplogIsRolledOver(ts) {
+    return [primary, secondary].every(
+        (node) => timestampCmp(ts, getFirstOplogEntry(node, {readConcern: "majority"}).ts) <= 0);
+}
+
+const colls = ["collA", "collB"].map((collName) => {
+    assert.commandWorked(
+        testDB.createCollection(collName, {changeStreamPreAndPostImages: {enabled: true}}));
+    return testDB[collName];
+});
+
+// Record pre-images which expire once the oplog rolls over.
+for (const coll of colls) {
+    assert.commandWorked(coll.insert({_id: 0, version: 0, padding: padding}));
+    for (let i = 0; i < kNumExpiredUpdates; ++i) {
+        assert.commandWorked(coll.update({_id: 0}, {$inc: {version: 1}}));
+    }
+}
+rst.awaitReplication();
+for (const node of [primary, secondary]) {
+    assert.eq(colls.length * kNumExpiredUpdates, getPreImages(node).length);
+}
+const metricsBefore = [primary, secondary].map(purgingJobMetrics);
+
+const lastOplogEntryToBeRemoved = getLatestOp(primary);
+while (!oplogIsRolledOver(lastOplogEntryToBeRemoved.ts)) {
+    assert.commandWorked(testDB.tmp.insert({longStr: largeStr}, {writeConcern: {w: "majority"}}));
+}
+
+// Record pre-images which are not expired, and which may share a marker with expired ones.
+for (const coll of colls) {
+    for (let i = 0; i < 2; ++i) {
+        assert.commandWorked(coll.update({_id: 0}, {$inc: {version: 1}}));
+    }
+}
+rst.awaitReplication();
+
+// Every node truncates its own expired pre-images.
+[primary, secondary].forEach((node, i) => {
+    assert.soon(() => {
+        const preImages = getPreImages(node);
+        return preImages.length == 2 * colls.length &&
+            preImages.every((preImage) =>
+                                timestampCmp(preImage._id.ts, lastOplogEntryToBeRemoved.ts) > 0);
+    }, () => tojson(getPreImages(node)));
+
+    const metricsAfter = purgingJobMetrics(node);
+    assert.gte(metricsAfter.docsDeleted - metricsBefore[i].docsDeleted,
+               colls.length * kNumExpiredUpdates,
+               tojson({before: metricsBefore[i], after: metricsAfter}));
+    assert.gt(metricsAfter.bytesDeleted,
+              metricsBefore[i].bytesDeleted,
+              tojson({before: metricsBefore[i], after: metricsAfter}));
+});
+
+// Truncates are not replicated.
+assert.eq(0, primary.getDB("local").oplog.rs.find({ns: "config.system.preimages"}).itcount());
+assert.eq(0, bsonWoCompare(getPreImages(primary), getPreImages(secondary)));
+
+// Increase the oplog size on each node to prevent oplog entries from being deleted, which removes
+// the risk of a replica set consistency check failure during the tear down of the replica set.
+rst.nodes.forEach((node) => {
+    assert.commandWorked(node.adminCommand({replSetResizeOplog: 1, size: 1000}));
+});
+
+rst.stopSet();
+})();
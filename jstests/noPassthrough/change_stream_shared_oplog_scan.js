@@ -0,0 +1,87 @@
+/**
+ * Tests that change streams tailing the oplog together read most oplog entries from the buffer of
+ * entries shared between them, and that they see the same events as change streams which do not
+ * share oplog entries.
+ *
+ * @tags: [
+ *   requires_majority_read_concern,
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const db = primary.getDB(jsTestName());
+const coll = db.coll;
+
+const kNumStreams = 5;
+const kNumDocs = 20;
+
+const startAtOperationTime =
+    assert.commandWorked(db.runCommand({create: coll.getName()})).operationTime;
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.commandWorked(coll.insert({_id: i}, {writeConcern: {w: "majority"}}));
+}
+
+const sharedOplogScanMetrics = () => db.serverStatus().metrics.changeStreams.sharedOplogScan;
+
+// Opens 'kNumStreams' change streams on 'coll', and returns the events each of them sees.
+function readEvents() {
+    const streams = [];
+    for (let i = 0; i < kNumStreams; ++i) {
+        streams.push(coll.watch([], {startAtOperationTime: startAtOperationTime}));
+    }
+
+    return streams.map((stream) => {
+        const events = [];
+        assert.soon(() => {
+            while (events.length < kNumDocs && stream.hasNext()) {
+                events.push(stream.next());
+            }
+            return events.length === kNumDocs;
+        });
+        stream.close();
+
+        assert.eq(events.map((event) => event.operationType),
+                  Array(kNumDocs).fill("insert"),
+                  tojson(events));
+        assert.eq(events.map((event) => event.documentKey._id),
+                  [...Array(kNumDocs).keys()],
+                  tojson(events));
+        return events;
+    });
+}
+
+// The first change stream reads the entries from storage. The others only read the first entry
+// they scan from storage, as they do not know which entry precedes it, and the rest from the
+// buffer.
+let before = sharedOplogScanMetrics();
+const sharedEvents = readEvents();
+let after = sharedOplogScanMetrics();
+assert.gte(after.entriesReadFromStorage - before.entriesReadFromStorage,
+           kNumDocs,
+           tojson({before: before, after: after}));
+assert.gte(after.entriesReadFromBuffer - before.entriesReadFromBuffer,
+           (kNumStreams - 1) * kNumDocs,
+           tojson({before: before, after: after}));
+sharedEvents.forEach((events) => assert.eq(sharedEvents[0], events));
+
+// Change streams opened once sharing is turned off read every entry from storage, and see the
+// same events.
+assert.commandWorked(
+    primary.adminCommand({setParameter: 1, internalChangeStreamSharedOplogScanBufferBytes: 0}));
+before = sharedOplogScanMetrics();
+const unsharedEvents = readEvents();
+after = sharedOplogScanMetrics();
+assert.eq(before.entriesReadFromBuffer,
+          after.entriesReadFromBuffer,
+          tojson({before: before, after: after}));
+unsharedEvents.forEach((events) => assert.eq(sharedEvents[0], events));
+
+rst.stopSet();
+})();
@@ -32,9 +32,15 @@ const preImagesCollectionName = "system.preimages";
 const oplogSizeMB = 1;
 
 // Set up the replica set with two nodes and two collections with 'changeStreamPreAndPostImages'
-// enabled and run expired pre-image removal job every second.
+// enabled and run expired pre-image removal job every second. The job removes the expired
+// pre-images with replicated deletes, see change_stream_pre_image_truncation.js for truncates.
 const rst = new ReplSetTest({nodes: 2, oplogSize: oplogSizeMB});
-rst.startSet({setParameter: {expiredChangeStreamPreImageRemovalJobSleepSecs: 1}});
+rst.startSet({
+    setParameter: {
+        expiredChangeStreamPreImageRemovalJobSleepSecs: 1,
+        truncateExpiredChangeStreamPreImages: false,
+    }
+});
 rst.initiate();
 const largeStr = 'abcdefghi'.repeat(4 * 1024);
 const primaryNode = rst.getPrimary();
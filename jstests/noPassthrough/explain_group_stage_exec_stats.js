@@ -86,6 +86,7 @@ function checkGroupStages(stage, expectedAccumMemUsages, isExecExplain, expected
             assert.eq(stage.usedDisk, expectedSpills > 0, stage);
             assert.gte(stage.spills, expectedSpills, stage);
             assert.lte(stage.spills, 2 * expectedSpills, stage);
+            assert.eq(stage.spilledDataStorageSize > 0, expectedSpills > 0, stage);
         }
     } else {
         assert(!stage.hasOwnProperty("usedDisk"), stage);
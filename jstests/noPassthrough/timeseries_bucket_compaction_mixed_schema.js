@@ -0,0 +1,67 @@
+/**
+ * Tests that the background bucket compactor only merges adjacent buckets whose fields agree in
+ * type, and that queries return the same results before and after compaction.
+ *
+ * @tags: [
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet({setParameter: {timeseriesBucketCompactionIntervalSecs: 1}});
+rst.initiate();
+
+const primary = rst.getPrimary();
+const db = primary.getDB(jsTestName());
+const coll = db.ts;
+const bucketsColl = db.getCollection("system.buckets." + coll.getName());
+
+assert.commandWorked(
+    db.createCollection(coll.getName(), {timeseries: {timeField: "time", metaField: "meta"}}));
+
+const start = ISODate("2022-06-01T00:00:00Z");
+const at = (offsetSecs) => new Date(start.getTime() + offsetSecs * 1000);
+
+// Each change of type of 'a' rolls the bucket over, leaving closed buckets with conflicting
+// schemas next to each other. The last bucket stays open.
+[1, "x", 2, "y"].forEach((value, i) => {
+    assert.commandWorked(coll.insert({time: at(i), meta: "mixed", a: value}));
+});
+
+// Going back in time by more than the bucket rounding rolls the bucket over too, leaving closed
+// buckets which agree in type.
+[3, 2, 1].forEach((minutes) => {
+    assert.commandWorked(coll.insert({time: at(minutes * 60), meta: "same", a: minutes}));
+});
+
+const bucketCount = (meta) => bucketsColl.find({meta: meta}).itcount();
+assert.eq(4, bucketCount("mixed"));
+assert.eq(3, bucketCount("same"));
+
+const queries = [{}, {a: {$gt: 1}}, {a: {$type: "string"}}, {a: {$lte: "x"}}, {a: null}];
+const runQueries = () =>
+    queries.map((query) => coll.find(query, {_id: 0}).sort({meta: 1, time: 1}).toArray());
+const expected = runQueries();
+
+const compactionMetrics = () => db.serverStatus().metrics.timeseries.compaction;
+const passesBefore = compactionMetrics().passes;
+assert.commandWorked(
+    primary.adminCommand({setParameter: 1, timeseriesBucketCompactionEnabled: true}));
+
+// Wait for a pass which started after compaction was enabled to finish.
+assert.soon(() => compactionMetrics().passes >= passesBefore + 2, tojson(compactionMetrics()));
+assert.commandWorked(
+    primary.adminCommand({setParameter: 1, timeseriesBucketCompactionEnabled: false}));
+
+// Only the two closed buckets of the 'same' series were merged.
+assert.eq(4, bucketCount("mixed"), tojson(bucketsColl.find().toArray()));
+assert.eq(2, bucketCount("same"), tojson(bucketsColl.find().toArray()));
+assert.eq(1, compactionMetrics().merges, tojson(compactionMetrics()));
+assert.eq(2, compactionMetrics().bucketsMerged, tojson(compactionMetrics()));
+
+assert.eq(expected, runQueries());
+
+rst.stopSet();
+})();
@@ -69,8 +69,8 @@ checkLog.contains(secondaryDB.getMongo(), "Starting initial sync");
 // we'll nearly always fail when we should fail.
 //
 // Once the hangAfterCollectionInserts failpoint is turned off, the write of {_id: "b"} will
-// complete and both the data and the oplog entry for the write will be written out. The oplog
-// visibility thread will then close the oplog hole.
+// complete and both the data and the oplog entry for the write will be written out. Committing
+// the write will then close the oplog hole.
 jsTestLog("Allow the uncommitted write to finish in 5 seconds.");
 const joinDisableFailPoint = startParallelShell(() => {
     sleep(5000);
@@ -6,12 +6,14 @@
 (function() {
 "use strict";
 
-// Force oplog sampling to occur on start up for small numbers of oplog inserts.
+// Force oplog sampling to occur on start up for small numbers of oplog inserts. The truncation
+// points are not persisted, so that they are not loaded instead.
 const replSet = new ReplSetTest({
     nodes: 1,
     nodeOptions: {
         setParameter: {
             "maxOplogTruncationPointsDuringStartup": 10,
+            "persistOplogTruncationPoints": false,
             logComponentVerbosity: tojson({storage: {verbosity: 2}}),
         }
     }
@@ -0,0 +1,43 @@
+/**
+ * Ensure the oplog truncation points are persisted on shutdown and loaded on the following start
+ * up, rather than being determined by scanning or sampling the oplog.
+ * @tags: [ requires_wiredtiger, requires_persistence ]
+ */
+(function() {
+"use strict";
+
+// The default 40MB oplog is split into truncation points of 4MB each.
+const replSet = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter: {
+            logComponentVerbosity: tojson({storage: {verbosity: 2}}),
+        }
+    }
+});
+replSet.startSet();
+replSet.initiate();
+
+let coll = replSet.getPrimary().getDB("test").getCollection("testcoll");
+
+let res = replSet.getPrimary().getDB("test").serverStatus();
+assert.commandWorked(res);
+assert.eq(res.oplogTruncation.processingMethod, "scanning", tojson(res.oplogTruncation));
+
+// Insert enough data to create a couple of truncation points, without truncating the oplog.
+const bigStr = "a".repeat(100 * 1024);
+for (let i = 0; i < 100; i++) {
+    assert.commandWorked(coll.insert({m: i, bigStr: bigStr}));
+}
+
+// Restart the replica set. The truncation points are persisted by the shutdown checkpoint.
+replSet.stopSet(null /* signal */, true /* forRestart */);
+replSet.startSet({restart: true});
+
+res = replSet.getPrimary().getDB("test").serverStatus();
+assert.commandWorked(res);
+assert.eq(res.oplogTruncation.processingMethod, "loading", tojson(res.oplogTruncation));
+assert.gt(res.oplogTruncation.numTruncationPointsLoaded, 0, tojson(res.oplogTruncation));
+
+replSet.stopSet();
+})();
@@ -64,6 +64,7 @@ namespace mongo {
 
 class CappedCallback;
 class CollectionPtr;
+class FieldRefSetWithStorage;
 class IndexCatalog;
 class IndexCatalogEntry;
 class MatchExpression;
@@ -100,6 +101,10 @@ struct CollectionUpdateArgs {
 
     // Set if OpTimes were reserved for the update ahead of time.
     std::vector<OplogSlot> oplogSlots;
+
+    // If set, the complete set of paths modified by the update. Index keys are only regenerated
+    // for indexes which may index one of these paths. Must outlive the call to updateDocument().
+    const FieldRefSetWithStorage* modifiedPaths = nullptr;
 };
 
 /**
@@ -1404,6 +1404,7 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                                     *args->preImageDoc,
                                                     newDoc,
                                                     oldLocation,
+                                                    args->modifiedPaths,
                                                     &keysInserted,
                                                     &keysDeleted));
 
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Brings up a WiredTiger-backed mongod catalog outside of the unit test runner, so that inserts can
+ * be timed through the same Collection and index catalog code paths that the insert command uses.
+ */
+class InsertBenchmarkFixture : public CatalogTestFixture {
+public:
+    InsertBenchmarkFixture() : CatalogTestFixture("wiredTiger") {
+        setUp();
+    }
+
+    ~InsertBenchmarkFixture() {
+        tearDown();
+    }
+
+private:
+    void _doTest() override {}
+};
+
+/**
+ * Inserts batches of 'state.range(1)' documents into a collection with two secondary indexes, the
+ * way the insert command's batched path does. When 'state.range(0)' is set, every document
+ * receives its own oplog slot, as on a replica set primary; otherwise the collection is
+ * unreplicated and the whole batch shares the null timestamp. 'state.range(2)' toggles batched
+ * index key insertion.
+ */
+void BM_CollectionInsertBatch(benchmark::State& state) {
+    const bool timestamped = state.range(0);
+    const auto batchSize = static_cast<size_t>(state.range(1));
+    const bool batchedKeyInsertion = state.range(2);
+
+    const bool batchedKeyInsertionWas = gIndexBatchedKeyInsertion.load();
+    gIndexBatchedKeyInsertion.store(batchedKeyInsertion);
+
+    InsertBenchmarkFixture fixture;
+    auto opCtx = fixture.operationContext();
+    const NamespaceString nss(timestamped ? "insert_bm" : "local", "coll");
+    invariant(fixture.storageInterface()->createCollection(opCtx, nss, CollectionOptions()));
+    invariant(fixture.storageInterface()->createIndexesOnEmptyCollection(
+        opCtx,
+        nss,
+        {BSON("v" << 2 << "key" << BSON("a" << 1) << "name"
+                  << "a_1"),
+         BSON("v" << 2 << "key" << BSON("b" << 1 << "a" << 1) << "name"
+                  << "b_1_a_1")}));
+
+    PseudoRandom random(0);
+    long long nextId = 0;
+    std::vector<InsertStatement> batch;
+    batch.reserve(batchSize);
+    for (auto _ : state) {
+        batch.clear();
+        for (size_t i = 0; i < batchSize; ++i) {
+            batch.emplace_back(BSON("_id" << nextId++ << "a" << random.nextInt64() << "b"
+                                          << random.nextInt32(1000)));
+        }
+
+        AutoGetCollection coll(opCtx, nss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        if (timestamped) {
+            auto slots = repl::getNextOpTimes(opCtx, batchSize);
+            for (size_t i = 0; i < batchSize; ++i) {
+                batch[i].oplogSlot = slots[i];
+            }
+        }
+        invariant(coll->insertDocuments(opCtx, batch.begin(), batch.end(), nullptr));
+        wuow.commit();
+    }
+
+    state.SetItemsProcessed(state.iterations() * batchSize);
+    gIndexBatchedKeyInsertion.store(batchedKeyInsertionWas);
+}
+
+BENCHMARK(BM_CollectionInsertBatch)
+    ->ArgNames({"timestamped", "batchSize", "batchedKeys"})
+    ->ArgsProduct({{0, 1}, {1, 64, 500}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace mongo
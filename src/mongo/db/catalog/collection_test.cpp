@@ -38,7 +38,9 @@
 #include "mongo/db/catalog/collection_mock.h"
 #include "mongo/db/catalog/collection_validation.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/repl/storage_interface_impl.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
@@ -341,6 +343,59 @@ TEST_F(CollectionTest, ForceSetIndexIsMultikeyRemovesUncommittedChangesOnRollbac
     }
 }
 
+TEST_F(CollectionTest, UpdateDocumentOnlyUpdatesIndexesOnModifiedPaths) {
+    NamespaceString nss("test.t");
+    auto opCtx = operationContext();
+    ASSERT_OK(storageInterface()->createCollection(opCtx, nss, CollectionOptions()));
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_X);
+        WriteUnitOfWork wuow(opCtx);
+        auto collWriter = autoColl.getWritableCollection(opCtx);
+        for (auto&& field : {"a", "b"}) {
+            ASSERT_OK(collWriter->getIndexCatalog()->createIndexOnEmptyCollection(
+                opCtx,
+                collWriter,
+                BSON("v" << 2 << "name" << (std::string(field) + "_1") << "key"
+                         << BSON(field << 1))));
+        }
+        wuow.commit();
+    }
+
+    AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+    const auto& coll = autoColl.getCollection();
+    {
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(coll->insertDocument(
+            opCtx, InsertStatement(BSON("_id" << 1 << "a" << 1 << "b" << 1)), nullptr));
+        wuow.commit();
+    }
+    const RecordId rid = coll->getCursor(opCtx)->next()->id;
+
+    // Updates the document to 'newDoc', reporting only 'modifiedPath' as modified, and checks that
+    // exactly one index key was replaced.
+    auto updateAndCheckOneKeyChanged = [&](const BSONObj& newDoc, StringData modifiedPath) {
+        FieldRefSetWithStorage modifiedPaths;
+        modifiedPaths.keepShortest(FieldRef(modifiedPath));
+        CollectionUpdateArgs args;
+        args.criteria = BSON("_id" << 1);
+        args.modifiedPaths = &modifiedPaths;
+
+        OpDebug opDebug;
+        WriteUnitOfWork wuow(opCtx);
+        coll->updateDocument(opCtx, rid, coll->docFor(opCtx, rid), newDoc, true, &opDebug, &args);
+        wuow.commit();
+        ASSERT_EQ(1, *opDebug.additiveMetrics.keysInserted);
+        ASSERT_EQ(1, *opDebug.additiveMetrics.keysDeleted);
+    };
+
+    // Only the key of the index on 'a' changes.
+    updateAndCheckOneKeyChanged(BSON("_id" << 1 << "a" << 2 << "b" << 1), "a");
+
+    // Both indexed fields change, but the update only reports 'b' as modified, so the index on 'a'
+    // is left untouched.
+    updateAndCheckOneKeyChanged(BSON("_id" << 1 << "a" << 3 << "b" << 2), "b");
+}
+
 TEST_F(CollectionTest, CheckTimeseriesBucketDocsForMixedSchemaData) {
     NamespaceString nss("test.system.buckets.ts");
     makeTimeseries(nss);
@@ -47,6 +47,8 @@ namespace mongo {
 class Client;
 class Collection;
 class CollectionPtr;
+class ExtractedKeyPaths;
+class FieldRefSetWithStorage;
 
 class IndexDescriptor;
 struct InsertDeleteOptions;
@@ -55,6 +57,9 @@ struct BsonRecord {
     RecordId id;
     Timestamp ts;
     const BSONObj* docPtr;
+
+    // If set, the indexed paths of '*docPtr', traversed once for all btree indexes.
+    const ExtractedKeyPaths* extractedKeyPaths = nullptr;
 };
 
 /**
@@ -458,6 +463,9 @@ public:
      * Both 'keysInsertedOut' and 'keysDeletedOut' are required and will be set to the number of
      * index keys inserted and deleted by this operation, respectively.
      *
+     * If 'modifiedPaths' is not null, it must contain every path that differs between 'oldDoc' and
+     * 'newDoc'. Indexes which cannot index any of those paths are skipped without generating keys.
+     *
      * This method may throw.
      */
     virtual Status updateRecord(OperationContext* opCtx,
@@ -465,6 +473,7 @@ public:
                                 const BSONObj& oldDoc,
                                 const BSONObj& newDoc,
                                 const RecordId& recordId,
+                                const FieldRefSetWithStorage* modifiedPaths,
                                 int64_t* keysInsertedOut,
                                 int64_t* keysDeletedOut) const = 0;
 
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -47,12 +48,15 @@
 #include "mongo/db/catalog/uncommitted_collections.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/shared_key_path_extractor.h"
 #include "mongo/db/index/s2_access_method.h"
 #include "mongo/db/index/s2_bucket_access_method.h"
 #include "mongo/db/index_names.h"
@@ -104,6 +108,36 @@ using IndexVersion = IndexDescriptor::IndexVersion;
 const BSONObj IndexCatalogImpl::_idObj = BSON("_id" << 1);
 
 namespace {
+
+// Counts the indexes whose keys were not regenerated on update because the update modified none
+// of the paths the index depends on.
+Counter64 updateKeyGenerationsSkipped;
+ServerStatusMetricField<Counter64> displayUpdateKeyGenerationsSkipped(
+    "index.update.keyGenerationsSkipped", &updateKeyGenerationsSkipped);
+
+/**
+ * Returns true if an update which modified the paths in 'modifiedPaths' may change the keys of
+ * 'entry', or whether the document matches its partial filter. A null 'modifiedPaths' means the
+ * modified paths are unknown.
+ */
+bool updateMayAffectIndex(const CollectionPtr& coll,
+                          const IndexCatalogEntry* entry,
+                          const FieldRefSetWithStorage* modifiedPaths) {
+    if (!modifiedPaths) {
+        return true;
+    }
+
+    const UpdateIndexData* indexedPaths =
+        CollectionQueryInfo::get(coll).getIndexKeysForIndex(entry->descriptor()->indexName());
+    if (!indexedPaths) {
+        return true;
+    }
+
+    return std::any_of(modifiedPaths->begin(), modifiedPaths->end(), [&](const FieldRef* path) {
+        return indexedPaths->mightBeIndexed(*path);
+    });
+}
+
 /**
  * Similar to _isSpecOK(), checks if the indexSpec is valid, conflicts, or already exists as a
  * clustered index.
@@ -1588,6 +1622,26 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
     // * Not write any accumulated multikey paths to the _mdb_catalog document.
     const bool manageMultikeyWrite =
         !tracker.isTrackingMultikeyPathInfo() && !bsonRecords[0].ts.isNull();
+
+    // When the collection has several btree indexes, traverse the indexed paths of each document
+    // once for all of them rather than once per index.
+    std::shared_ptr<const SharedKeyPathExtractor> extractor;
+    if (gIndexSharedKeyPathExtraction.load()) {
+        extractor = CollectionQueryInfo::get(coll).getSharedKeyPathExtractor();
+    }
+    std::vector<ExtractedKeyPaths> extractedKeyPaths;
+    std::vector<BsonRecord> recordsWithExtractedKeyPaths;
+    if (extractor) {
+        extractedKeyPaths.resize(bsonRecords.size());
+        recordsWithExtractedKeyPaths.reserve(bsonRecords.size());
+        for (size_t i = 0; i < bsonRecords.size(); ++i) {
+            extractor->extract(*bsonRecords[i].docPtr, &extractedKeyPaths[i]);
+            recordsWithExtractedKeyPaths.push_back(bsonRecords[i]);
+            recordsWithExtractedKeyPaths.back().extractedKeyPaths = &extractedKeyPaths[i];
+        }
+    }
+    const auto& records = extractor ? recordsWithExtractedKeyPaths : bsonRecords;
+
     {
         ScopeGuard stopTrackingMultikeyChanges(
             [&tracker] { tracker.stopTrackingMultikeyPathInfo(); });
@@ -1597,13 +1651,13 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
             stopTrackingMultikeyChanges.dismiss();
         }
         for (auto&& it : _readyIndexes) {
-            Status s = _indexRecords(opCtx, coll, it.get(), bsonRecords, keysInsertedOut);
+            Status s = _indexRecords(opCtx, coll, it.get(), records, keysInsertedOut);
             if (!s.isOK())
                 return s;
         }
 
         for (auto&& it : _buildingIndexes) {
-            Status s = _indexRecords(opCtx, coll, it.get(), bsonRecords, keysInsertedOut);
+            Status s = _indexRecords(opCtx, coll, it.get(), records, keysInsertedOut);
             if (!s.isOK())
                 return s;
         }
@@ -1637,6 +1691,7 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
                                       const BSONObj& oldDoc,
                                       const BSONObj& newDoc,
                                       const RecordId& recordId,
+                                      const FieldRefSetWithStorage* modifiedPaths,
                                       int64_t* const keysInsertedOut,
                                       int64_t* const keysDeletedOut) const {
     *keysInsertedOut = 0;
@@ -1647,6 +1702,10 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _readyIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
+        if (!updateMayAffectIndex(coll, entry, modifiedPaths)) {
+            updateKeyGenerationsSkipped.increment();
+            continue;
+        }
         auto status = _updateRecord(
             opCtx, coll, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
         if (!status.isOK())
@@ -1658,6 +1717,10 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _buildingIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
+        if (!updateMayAffectIndex(coll, entry, modifiedPaths)) {
+            updateKeyGenerationsSkipped.increment();
+            continue;
+        }
         auto status = _updateRecord(
             opCtx, coll, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
         if (!status.isOK())
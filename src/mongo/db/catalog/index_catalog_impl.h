@@ -247,6 +247,7 @@ public:
                         const BSONObj& oldDoc,
                         const BSONObj& newDoc,
                         const RecordId& recordId,
+                        const FieldRefSetWithStorage* modifiedPaths,
                         int64_t* keysInsertedOut,
                         int64_t* keysDeletedOut) const override;
     /**
@@ -0,0 +1,344 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kWrite
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/batched_update_stage.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+MONGO_FAIL_POINT_DEFINE(throwWriteConflictExceptionInBatchedUpdateStage);
+
+namespace {
+void incrementSSSMetricNoOverflow(AtomicWord<long long>& metric, long long value) {
+    const int64_t MAX = 1ULL << 60;
+
+    if (metric.loadRelaxed() > MAX) {
+        metric.store(value);
+    } else {
+        metric.fetchAndAdd(value);
+    }
+}
+}  // namespace
+
+/**
+ * Reports globally-aggregated batch stats.
+ */
+struct BatchedUpdatesSSS : ServerStatusSection {
+    BatchedUpdatesSSS()
+        : ServerStatusSection("batchedUpdates"), batches(0), docs(0), sizeBytes(0), timeMillis(0) {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const override {
+        BSONObjBuilder bob;
+        bob.appendNumber("batches", batches.loadRelaxed());
+        bob.appendNumber("docs", docs.loadRelaxed());
+        bob.appendNumber("sizeBytes", sizeBytes.loadRelaxed());
+        bob.append("timeMillis", timeMillis.loadRelaxed());
+
+        return bob.obj();
+    }
+
+    AtomicWord<long long> batches;
+    AtomicWord<long long> docs;
+    AtomicWord<long long> sizeBytes;
+    AtomicWord<long long> timeMillis;
+} batchedUpdatesSSS;
+
+bool BatchedUpdateStage::isBatchedUpdateEligible(OperationContext* opCtx,
+                                                 const UpdateStageParams& params,
+                                                 const CollectionPtr& collection) {
+    const auto* request = params.request;
+
+    // An unversioned write on a shard may update orphaned documents, which it marks as
+    // 'fromMigrate' so that they are hidden from change streams. The operations of a grouped
+    // applyOps entry cannot carry that flag, so such writes are not batched.
+    if (serverGlobalParams.clusterRole == ClusterRole::ShardServer &&
+        !OperationShardingState::isOperationVersioned(opCtx)) {
+        return false;
+    }
+
+    // Grouped oplog entries support neither pre-images nor transactions and retryable writes. See
+    // BatchedWriteContext::addBatchedOperation().
+    return gBatchedUpdatesEnabled.load() && request->isMulti() && !request->isUpsert() &&
+        !request->shouldReturnAnyDocs() && request->getSort().isEmpty() && !request->explain() &&
+        !request->isFromOplogApplication() && request->source() == OperationSource::kStandard &&
+        !params.numStatsForDoc && !opCtx->inMultiDocumentTransaction() &&
+        !opCtx->getTxnNumber() && !collection->getRecordPreImages() &&
+        !collection->isChangeStreamPreAndPostImagesEnabled();
+}
+
+BatchedUpdateStage::BatchedUpdateStage(ExpressionContext* expCtx,
+                                       const UpdateStageParams& params,
+                                       std::unique_ptr<BatchedUpdateStageBatchParams> batchParams,
+                                       WorkingSet* ws,
+                                       const CollectionPtr& collection,
+                                       PlanStage* child)
+    : UpdateStage(kStageType.rawData(), expCtx, params, ws, collection),
+      _batchParams(std::move(batchParams)) {
+    _children.emplace_back(child);
+
+    tassert(7803800,
+            "batched updates only support multi-document updates (multi: true)",
+            _params.request->isMulti());
+    tassert(7803801, "batched updates do not support upserts", !_params.request->isUpsert());
+    tassert(7803802,
+            "batched updates do not support returning documents",
+            !_params.request->shouldReturnAnyDocs());
+    tassert(7803803, "batched updates do not support explain", !_params.request->explain());
+    tassert(7803804,
+            "batched updates do not support the 'numStatsForDoc' parameter",
+            !_params.numStatsForDoc);
+    tassert(7803805,
+            "batch size cannot be unbounded; you must specify at least one of the following batch "
+            "parameters: 'targetBatchBytes', 'targetBatchDocs', 'targetBatchTimeMS'",
+            _batchParams->targetBatchBytes || _batchParams->targetBatchDocs ||
+                _batchParams->targetBatchTimeMS != Milliseconds(0));
+    tassert(7803806,
+            "batch size parameters must be greater than or equal to zero",
+            _batchParams->targetBatchBytes >= 0 && _batchParams->targetBatchDocs >= 0 &&
+                _batchParams->targetBatchTimeMS >= Milliseconds(0));
+}
+
+bool BatchedUpdateStage::isEOF() {
+    return UpdateStage::isEOF() && _stagedUpdatesBuffer.empty();
+}
+
+PlanStage::StageState BatchedUpdateStage::_updateBatch(WorkingSetID* out) {
+    tassert(7803807, "Expected documents for batched update", !_stagedUpdatesBuffer.empty());
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    boost::optional<repl::UnreplicatedWritesBlock> unReplBlock;
+    if (collection()->ns().isImplicitlyReplicated() && !_isUserInitiatedWrite) {
+        // Implictly replicated collections do not replicate updates.
+        unReplBlock.emplace(opCtx());
+    }
+
+    // Stats and the set of updated RecordIds are only published once the batch commits. Staged
+    // documents are never in '_updatedRecordIds', so an aborted batch can simply remove them.
+    const UpdateStats statsBeforeBatch = _specificStats;
+    ScopeGuard abortedBatchGuard([&] {
+        _specificStats = statsBeforeBatch;
+        for (const auto& stagedDocument : _stagedUpdatesBuffer) {
+            _updatedRecordIds->erase(stagedDocument.rid);
+        }
+    });
+
+    std::set<RecordId> recordsThatNoLongerMatch;
+    Timer batchTimer(opCtx()->getServiceContext()->getTickSource());
+
+    long long batchBytes = 0;
+    size_t batchIdx = 0;
+
+    try {
+        // Start a WUOW with 'groupOplogEntries' which groups an update batch into a single
+        // timestamp and applyOps oplog entry. The WUOW opened for each document by
+        // transformAndUpdate() nests inside this one.
+        WriteUnitOfWork wuow(opCtx(), true /* groupOplogEntries */);
+        for (; batchIdx < _stagedUpdatesBuffer.size(); ++batchIdx) {
+            if (MONGO_unlikely(throwWriteConflictExceptionInBatchedUpdateStage.shouldFail())) {
+                throw WriteConflictException();
+            }
+
+            auto& stagedDocument = _stagedUpdatesBuffer.at(batchIdx);
+            batchBytes += stagedDocument.doc.value().objsize();
+
+            // The PlanExecutor YieldPolicy may change snapshots between calls to 'doWork()'.
+            // Different documents may have different snapshots.
+            Snapshotted<BSONObj> doc = stagedDocument.doc;
+            bool docStillMatches = true;
+            if (opCtx()->recoveryUnit()->getSnapshotId() != doc.snapshotId()) {
+                docStillMatches = collection()->findDoc(opCtx(), stagedDocument.rid, &doc) &&
+                    (!_params.canonicalQuery ||
+                     _params.canonicalQuery->root()->matchesBSON(doc.value(), nullptr));
+            }
+
+            if (docStillMatches) {
+                const auto action = _preWriteFilter.computeAction(Document(doc.value()));
+                if (action != write_stage_common::PreWriteFilter::Action::kSkip) {
+                    RecordId recordId = stagedDocument.rid;
+                    const bool writeToOrphan =
+                        action == write_stage_common::PreWriteFilter::Action::kWriteAsFromMigrate;
+                    transformAndUpdate(doc, recordId, writeToOrphan);
+                    ++_specificStats.nMatched;
+                }
+            } else {
+                recordsThatNoLongerMatch.insert(stagedDocument.rid);
+            }
+
+            const Milliseconds elapsedMillis(batchTimer.millis());
+            if (_batchParams->targetBatchTimeMS != Milliseconds(0) &&
+                elapsedMillis >= _batchParams->targetBatchTimeMS) {
+                // Met targetBatchTimeMS after evaluating _stagedUpdatesBuffer[batchIdx].
+                break;
+            }
+        }
+
+        wuow.commit();
+    } catch (const WriteConflictException&) {
+        // Remove records that no longer match the query before retrying.
+        _stagedUpdatesBuffer.erase(
+            std::remove_if(_stagedUpdatesBuffer.begin(),
+                           _stagedUpdatesBuffer.end(),
+                           [&](const auto& stagedDocument) {
+                               return recordsThatNoLongerMatch.count(stagedDocument.rid) > 0;
+                           }),
+            _stagedUpdatesBuffer.end());
+        *out = WorkingSet::INVALID_ID;
+        _drainRemainingBuffer = true;
+        return NEED_YIELD;
+    }
+    abortedBatchGuard.dismiss();
+
+    const long long docsEvaluated = std::min(batchIdx + 1, _stagedUpdatesBuffer.size());
+    incrementSSSMetricNoOverflow(batchedUpdatesSSS.docs, docsEvaluated);
+    incrementSSSMetricNoOverflow(batchedUpdatesSSS.batches, 1);
+    incrementSSSMetricNoOverflow(batchedUpdatesSSS.sizeBytes, batchBytes);
+    incrementSSSMetricNoOverflow(batchedUpdatesSSS.timeMillis, batchTimer.millis());
+
+    if (batchIdx < _stagedUpdatesBuffer.size() - 1) {
+        // _stagedUpdatesBuffer[batchIdx] is the last document evaluated in this batch - and it is
+        // not the last element in the buffer. targetBatchTimeMS was exceeded. Remove all records
+        // that have been evaluated from the buffer before continuing.
+        _stagedUpdatesBuffer.erase(_stagedUpdatesBuffer.begin(),
+                                   _stagedUpdatesBuffer.begin() + batchIdx + 1);
+        _stagedUpdatesBufferBytes -= batchBytes;
+
+        _drainRemainingBuffer = true;
+        return _tryRestoreState(out);
+    }
+
+    _stagedUpdatesBuffer.clear();
+    _stagedUpdatesBufferBytes = 0;
+    _drainRemainingBuffer = false;
+
+    return _tryRestoreState(out);
+}
+
+PlanStage::StageState BatchedUpdateStage::doWork(WorkingSetID* out) {
+    if (!_drainRemainingBuffer) {
+        WorkingSetID id;
+        auto status = child()->work(&id);
+
+        switch (status) {
+            case PlanStage::ADVANCED:
+                break;
+
+            case PlanStage::NEED_TIME:
+                return status;
+
+            case PlanStage::NEED_YIELD:
+                *out = id;
+                return status;
+
+            case PlanStage::IS_EOF:
+                if (!_stagedUpdatesBuffer.empty()) {
+                    // Drain the outstanding updates. Only return NEED_TIME if there is more to
+                    // drain in the buffer. Otherwise, there is no more to fetch and NEED_TIME
+                    // signals all documents have been successfully updated.
+                    auto ret = _updateBatch(out);
+                    if (ret != NEED_TIME || _drainRemainingBuffer) {
+                        return ret;
+                    }
+                }
+                return status;
+
+            default:
+                MONGO_UNREACHABLE;
+        }
+
+        WorkingSetMember* member = _ws->get(id);
+
+        // Free the WSM at the end of this scope. Retries will re-fetch by the RecordId and will not
+        // need to keep the WSM around.
+        ScopeGuard memberFreer([&] { _ws->free(id); });
+
+        invariant(member->hasRecordId());
+        RecordId recordId = member->recordId;
+
+        // Updates can't have projections. This means that covering analysis will always add
+        // a fetch. We should always get fetched data, and never just key data.
+        invariant(member->hasObj());
+
+        // Skip documents that an earlier batch already updated and moved ahead of the scan.
+        if (_updatedRecordIds->count(recordId) > 0) {
+            return PlanStage::NEED_TIME;
+        }
+
+        BSONObj doc = member->doc.value().toBson().getOwned();
+        _stagedUpdatesBufferBytes += doc.objsize();
+        _stagedUpdatesBuffer.push_back({recordId, {member->doc.snapshotId(), std::move(doc)}});
+    }
+
+    if (_drainRemainingBuffer ||
+        (_batchParams->targetBatchDocs &&
+         _stagedUpdatesBuffer.size() >=
+             static_cast<unsigned long long>(_batchParams->targetBatchDocs)) ||
+        (_batchParams->targetBatchBytes &&
+         _stagedUpdatesBufferBytes >= _batchParams->targetBatchBytes)) {
+        return _updateBatch(out);
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState BatchedUpdateStage::_tryRestoreState(WorkingSetID* out) {
+    try {
+        child()->restoreState(&collection());
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    return NEED_TIME;
+}
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/exec/batched_update_stage_gen.h"
+#include "mongo/db/exec/update_stage.h"
+
+namespace mongo {
+
+/**
+ * Batch sizing parameters. A batch of documents staged for update is committed as soon as one of
+ * the targets below is met, or upon reaching EOF.
+ */
+struct BatchedUpdateStageBatchParams {
+    BatchedUpdateStageBatchParams()
+        : targetBatchBytes(gBatchedUpdatesTargetBatchBytes.load()),
+          targetBatchDocs(gBatchedUpdatesTargetBatchDocs.load()),
+          targetBatchTimeMS(Milliseconds(gBatchedUpdatesTargetBatchTimeMS.load())) {}
+
+    // Documents staged for update are processed in a batch once the size of their pre-update
+    // versions meets this target. A value of zero means unlimited.
+    long long targetBatchBytes = 0;
+    // Documents staged for update are processed in a batch once this document count target is
+    // met. A value of zero means unlimited.
+    long long targetBatchDocs = 0;
+    // A batch is committed as soon as this target execution time is met. Zero means unlimited.
+    Milliseconds targetBatchTimeMS = Milliseconds(0);
+};
+
+/**
+ * The BATCHED_UPDATE stage updates documents in batches, using the RecordIds and documents
+ * returned from its child. Each batch is applied in a single WriteUnitOfWork whose oplog entries
+ * are grouped into one applyOps entry. In comparison, the base class UpdateStage commits a storage
+ * transaction per document. The stage returns NEED_TIME after staging a document to be updated in
+ * the next batch, or after applying a batch.
+ *
+ * Only multi-updates that return no documents, are not upserts, explains, or writes from oplog
+ * application or chunk migration may be batched. See 'isBatchedUpdateEligible()'.
+ *
+ * Callers of work() must be holding a write lock (and, for replicated updates, callers must have
+ * had the replication coordinator approve the write).
+ */
+class BatchedUpdateStage final : public UpdateStage {
+    BatchedUpdateStage(const BatchedUpdateStage&) = delete;
+    BatchedUpdateStage& operator=(const BatchedUpdateStage&) = delete;
+
+public:
+    static constexpr StringData kStageType = "BATCHED_UPDATE"_sd;
+
+    /**
+     * Returns whether an update with the given parameters against 'collection' can be executed by
+     * a BatchedUpdateStage.
+     */
+    static bool isBatchedUpdateEligible(OperationContext* opCtx,
+                                        const UpdateStageParams& params,
+                                        const CollectionPtr& collection);
+
+    BatchedUpdateStage(ExpressionContext* expCtx,
+                       const UpdateStageParams& params,
+                       std::unique_ptr<BatchedUpdateStageBatchParams> batchParams,
+                       WorkingSet* ws,
+                       const CollectionPtr& collection,
+                       PlanStage* child);
+
+    bool isEOF() final;
+    StageState doWork(WorkingSetID* out) final;
+
+    StageType stageType() const final {
+        return STAGE_BATCHED_UPDATE;
+    }
+
+private:
+    /**
+     * Returns NEED_YIELD when there is a write conflict. Otherwise, returns NEED_TIME when some,
+     * or all, of the documents staged in the _stagedUpdatesBuffer are successfully updated.
+     */
+    PlanStage::StageState _updateBatch(WorkingSetID* out);
+
+    // Tries to restore the child's state. Returns NEED_TIME if the restore succeeds, NEED_YIELD
+    // upon write conflict.
+    PlanStage::StageState _tryRestoreState(WorkingSetID* out);
+
+    // Metadata of a document staged for update.
+    struct StagedDocument {
+        RecordId rid;
+
+        // The document as returned by the child, and the SnapshotId it was read at. When the
+        // snapshot changed before the batch is applied, the document is re-fetched and must still
+        // match the query.
+        Snapshotted<BSONObj> doc;
+    };
+
+    // Stores documents staged for update.
+    std::vector<StagedDocument> _stagedUpdatesBuffer;
+
+    // Total size of the documents in '_stagedUpdatesBuffer'.
+    long long _stagedUpdatesBufferBytes = 0;
+
+    // Whether there are remaining docs in the buffer from a previous call to doWork() that should
+    // be drained before fetching more documents.
+    bool _drainRemainingBuffer = false;
+
+    // Batch targeting parameters.
+    std::unique_ptr<BatchedUpdateStageBatchParams> _batchParams;
+};
+
+}  // namespace mongo
@@ -692,6 +692,10 @@ public:
                                           bool includeTimeField,
                                           bool includeMetaField) = 0;
 
+    // Advances past the next measurement without materializing it. Returns whether there are more
+    // measurements left in the bucket.
+    virtual bool skipNext() = 0;
+
     // Provides an upper bound on the number of fields in each measurement.
     virtual std::size_t numberOfFields() = 0;
 
@@ -743,6 +747,7 @@ public:
                                   const Value& metaValue,
                                   bool includeTimeField,
                                   bool includeMetaField) override;
+    bool skipNext() override;
     std::size_t numberOfFields() override;
 
 private:
@@ -850,6 +855,18 @@ void BucketUnpackerV1::extractSingleMeasurement(
     }
 }
 
+bool BucketUnpackerV1::skipNext() {
+    auto&& timeElem = _timeFieldIter.next();
+    auto& currentIdx = timeElem.fieldNameStringData();
+    for (auto&& [_, colIter] : _fieldIters) {
+        if (auto&& elem = *colIter; colIter.more() && elem.fieldNameStringData() == currentIdx) {
+            colIter.advance(elem);
+        }
+    }
+
+    return _timeFieldIter.more();
+}
+
 std::size_t BucketUnpackerV1::numberOfFields() {
     // The data fields are tracked by _fieldIters, but we need to account also for the time field
     // and possibly the meta field.
@@ -877,6 +894,7 @@ public:
                                   const Value& metaValue,
                                   bool includeTimeField,
                                   bool includeMetaField) override;
+    bool skipNext() override;
     std::size_t numberOfFields() override;
 
 private:
@@ -978,6 +996,18 @@ void BucketUnpackerV2::extractSingleMeasurement(
     }
 }
 
+bool BucketUnpackerV2::skipNext() {
+    ++_timeColumn.it;
+    for (auto& fieldColumn : _fieldColumns) {
+        uassert(7803400,
+                "Bucket unexpectedly contained fewer values than count",
+                fieldColumn.it != fieldColumn.end);
+        ++fieldColumn.it;
+    }
+
+    return _timeColumn.it != _timeColumn.end;
+}
+
 std::size_t BucketUnpackerV2::numberOfFields() {
     // The data fields are tracked by _fieldColumns, but we need to account also for the time field
     // and possibly the meta field.
@@ -1067,6 +1097,48 @@ boost::optional<HashedFieldName> BucketSpec::metaFieldHashed() const {
     return _metaFieldHashed;
 }
 
+std::vector<std::unique_ptr<MatchExpression>> BucketSpec::createPredicatesOnDataColumns(
+    const MatchExpression* matchExpr, const BucketSpec& bucketSpec) {
+    std::vector<std::unique_ptr<MatchExpression>> predicates;
+    if (!matchExpr) {
+        return predicates;
+    }
+
+    if (matchExpr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < matchExpr->numChildren(); ++i) {
+            auto childPredicates =
+                createPredicatesOnDataColumns(matchExpr->getChild(i), bucketSpec);
+            std::move(childPredicates.begin(),
+                      childPredicates.end(),
+                      std::back_inserter(predicates));
+        }
+        return predicates;
+    }
+
+    switch (matchExpr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            break;
+        default:
+            return predicates;
+    }
+
+    // Only top-level fields map to a single data column. The metaField is not stored in the data
+    // region at all, and computed fields do not exist until after unpacking.
+    auto path = matchExpr->path();
+    if (path.empty() || path.find('.') != std::string::npos ||
+        (bucketSpec.metaField() && path == *bucketSpec.metaField()) ||
+        bucketSpec.fieldIsComputed(path)) {
+        return predicates;
+    }
+
+    predicates.push_back(matchExpr->shallowClone());
+    return predicates;
+}
+
 BucketUnpacker::BucketUnpacker() = default;
 BucketUnpacker::BucketUnpacker(BucketUnpacker&& other) = default;
 BucketUnpacker::~BucketUnpacker() = default;
@@ -1106,6 +1178,8 @@ Document BucketUnpacker::getNext() {
     auto measurement = MutableDocument{2 * _unpackingImpl->numberOfFields()};
     _hasNext = _unpackingImpl->getNext(
         measurement, _spec, _metaValue, _includeTimeField, _includeMetaField);
+    ++_measurementIndex;
+    skipUnselectedMeasurements();
 
     // Add computed meta projections.
     for (auto&& name : _spec.computedMetaProjFields()) {
@@ -1150,6 +1224,8 @@ Document BucketUnpacker::extractSingleMeasurement(int j) {
 
 void BucketUnpacker::reset(BSONObj&& bucket) {
     _unpackingImpl.reset();
+    _selection.clear();
+    _measurementIndex = 0;
     _bucket = std::move(bucket);
     uassert(5346510, "An empty bucket cannot be unpacked", !_bucket.isEmpty());
 
@@ -1263,6 +1339,72 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
     // Save the measurement count for the bucket.
     _numberOfMeasurements = _unpackingImpl->measurementCount(timeFieldElem);
     _hasNext = _numberOfMeasurements > 0;
+
+    // Only compressed buckets store each field as a column that can be scanned without walking the
+    // per-measurement field names.
+    if (!_columnPredicates.empty() && version == 2 && _hasNext) {
+        computeSelection(dataRegion);
+        skipUnselectedMeasurements();
+    }
+}
+
+void BucketUnpacker::setColumnPredicates(std::vector<std::unique_ptr<MatchExpression>> predicates) {
+    // A predicate on a field which is projected out sees it as missing after unpacking, whatever
+    // the column holds, so only fields that are part of the unpacked measurements are eligible.
+    _columnPredicates.clear();
+    for (auto&& predicate : predicates) {
+        const bool inFieldSet = _spec.fieldSet().count(predicate->path().toString()) > 0;
+        if (inFieldSet == (_unpackerBehavior == Behavior::kInclude)) {
+            _columnPredicates.push_back(std::move(predicate));
+        }
+    }
+}
+
+void BucketUnpacker::computeSelection(const BSONObj& dataRegion) {
+    _selection.assign(_numberOfMeasurements, true);
+
+    for (auto&& predicate : _columnPredicates) {
+        auto columnElem = dataRegion[predicate->path()];
+        if (!columnElem) {
+            // The field is missing from every measurement in the bucket.
+            if (!predicate->matchesSingleElement(BSONElement())) {
+                std::fill(_selection.begin(), _selection.end(), false);
+                return;
+            }
+            continue;
+        }
+
+        uassert(7803401,
+                "Compressed bucket data columns must be of BinData type",
+                columnElem.type() == BSONType::BinData);
+
+        // An array value may match through one of its elements, which the predicate does not see
+        // when evaluated against the whole value, so arrays are always selected. Missing values are
+        // represented by EOO, against which the predicate behaves as for a missing field.
+        BSONColumn column(columnElem);
+        std::size_t index = 0;
+        for (auto it = column.begin(), end = column.end();
+             it != end && index < _selection.size();
+             ++it, ++index) {
+            const BSONElement& elem = *it;
+            if (_selection[index] && elem.type() != BSONType::Array &&
+                !predicate->matchesSingleElement(elem)) {
+                _selection[index] = false;
+            }
+        }
+    }
+}
+
+void BucketUnpacker::skipUnselectedMeasurements() {
+    if (_selection.empty()) {
+        return;
+    }
+
+    while (_hasNext && !_selection[_measurementIndex]) {
+        _hasNext = _unpackingImpl->skipNext();
+        ++_measurementIndex;
+        ++_numMeasurementsSkipped;
+    }
 }
 
 int BucketUnpacker::computeMeasurementCount(const BSONObj& bucket, StringData timeField) {
@@ -1343,6 +1485,9 @@ void BucketUnpacker::setBucketSpecAndBehavior(BucketSpec&& bucketSpec, Behavior
     determineIncludeTimeField();
     eraseExcludedComputedMetaProjFields();
 
+    // The column predicates were chosen for the previous set of unpacked fields.
+    _columnPredicates.clear();
+
     _includeMinTimeAsMetadata = _spec.includeMinTimeAsMetadata;
     _includeMaxTimeAsMetadata = _spec.includeMaxTimeAsMetadata;
 }
@@ -177,6 +177,17 @@ public:
         bool assumeNoMixedSchemaData,
         IneligiblePredicatePolicy policy);
 
+    /**
+     * Extracts from an event-level predicate the conjuncts which can be evaluated directly against
+     * the compressed data columns of a bucket, one measurement value at a time. These are simple
+     * comparisons ($eq, $lt, $lte, $gt, $gte) on a top-level field which is neither the metaField
+     * nor computed. A measurement failing any returned predicate is guaranteed to fail
+     * 'matchExpr', but not the other way round, so 'matchExpr' must still be applied after
+     * unpacking. Returns an empty vector if no conjunct is eligible.
+     */
+    static std::vector<std::unique_ptr<MatchExpression>> createPredicatesOnDataColumns(
+        const MatchExpression* matchExpr, const BucketSpec& bucketSpec);
+
     bool includeMinTimeAsMetadata = false;
     bool includeMaxTimeAsMetadata = false;
 
@@ -289,6 +300,28 @@ public:
         return _includeMaxTimeAsMetadata;
     }
 
+    /**
+     * Sets predicates, as produced by 'BucketSpec::createPredicatesOnDataColumns()', which are
+     * evaluated against the compressed data columns of each bucket upon 'reset()'. Measurements
+     * which fail any of them are skipped without being materialized by 'getNext()'. Buckets which
+     * are not compressed are unpacked in full. Predicates on fields which are not part of the
+     * unpacked measurements are dropped, and changing the spec or behavior clears the predicates.
+     * Passing an empty vector clears the predicates.
+     */
+    void setColumnPredicates(std::vector<std::unique_ptr<MatchExpression>> predicates);
+
+    bool hasColumnPredicates() const {
+        return !_columnPredicates.empty();
+    }
+
+    /**
+     * Returns the number of measurements skipped due to the column predicates, across all buckets
+     * this unpacker has been reset to.
+     */
+    long long numMeasurementsSkipped() const {
+        return _numMeasurementsSkipped;
+    }
+
     void setBucketSpecAndBehavior(BucketSpec&& bucketSpec, Behavior behavior);
     void setIncludeMinTimeAsMetadata();
     void setIncludeMaxTimeAsMetadata();
@@ -313,6 +346,13 @@ private:
     // Erase computed meta projection fields if they are present in the exclusion field set.
     void eraseExcludedComputedMetaProjFields();
 
+    // Evaluates '_columnPredicates' against the compressed columns of 'dataRegion' and records in
+    // '_selection' which measurements of the bucket satisfy all of them.
+    void computeSelection(const BSONObj& dataRegion);
+
+    // Advances past measurements that are not selected, updating '_hasNext' accordingly.
+    void skipUnselectedMeasurements();
+
     BucketSpec _spec;
     Behavior _unpackerBehavior;
 
@@ -357,6 +397,18 @@ private:
     // The number of measurements in the bucket.
     int32_t _numberOfMeasurements = 0;
 
+    // Predicates evaluated against the compressed data columns; see 'setColumnPredicates()'.
+    std::vector<std::unique_ptr<MatchExpression>> _columnPredicates;
+
+    // Which measurements of the current bucket satisfy '_columnPredicates'. Empty if every
+    // measurement is to be unpacked.
+    std::vector<bool> _selection;
+
+    // The position in the bucket of the measurement the next call to 'getNext()' unpacks.
+    int32_t _measurementIndex = 0;
+
+    long long _numMeasurementsSkipped = 0;
+
     // Final list of fields to include/exclude during unpacking. This is computed once during the
     // first doGetNext call so we don't have to recalculate every time we reach a new bucket.
     boost::optional<std::set<std::string>> _unpackFieldsToIncludeExclude = boost::none;
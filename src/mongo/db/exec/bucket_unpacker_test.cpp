@@ -34,6 +34,8 @@
 #include "mongo/bson/util/bsoncolumnbuilder.h"
 #include "mongo/db/exec/bucket_unpacker.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/timeseries/bucket_compression.h"
 #include "mongo/unittest/unittest.h"
 
@@ -1052,5 +1054,133 @@ TEST_F(BucketUnpackerTest, TamperedCompressedElementMismatchTimeField) {
     ASSERT_FALSE(unpacker.hasNext());
 }
 
+TEST_F(BucketUnpackerTest, CreatePredicatesOnDataColumnsKeepsOnlyEligibleConjuncts) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto spec = BucketSpec{kUserDefinedTimeName.toString(),
+                           kUserDefinedMetaName.toString(),
+                           {},
+                           {"computed"}};
+
+    auto matchExpr = uassertStatusOK(MatchExpressionParser::parse(
+        fromjson("{a: {$gt: 1}, b: 2, 'c.d': 3, myMeta: 4, computed: 5, e: {$in: [1, 2]}, "
+                 "$or: [{f: 1}, {g: 1}], time: {$lte: 10}}"),
+        expCtx));
+
+    auto predicates = BucketSpec::createPredicatesOnDataColumns(matchExpr.get(), spec);
+    std::set<std::string> paths;
+    for (auto&& predicate : predicates) {
+        paths.insert(predicate->path().toString());
+    }
+    ASSERT_TRUE((paths == std::set<std::string>{"a", "b", "time"}));
+}
+
+TEST_F(BucketUnpackerTest, ColumnPredicatesSkipMeasurementsInCompressedBucket) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto bucket = fromjson(
+        "{control: {'version': 1}, meta: {'m1': 999}, data: {_id: {'0':1, '1':2, '2':3, '3':4}, "
+        "time: {'0':1, '1':2, '2':3, '3':4}, "
+        "a:{'0':1, '1':5, '2':[1, 7], '3':9}, b:{'1':1, '3':1}}}");
+    auto matchExpr = uassertStatusOK(
+        MatchExpressionParser::parse(fromjson("{a: {$gt: 4}, b: {$lt: 2}}"), expCtx));
+
+    auto unpackAll = [&](BSONObj bucket, long long expectedSkipped) {
+        auto spec = BucketSpec{kUserDefinedTimeName.toString(), kUserDefinedMetaName.toString()};
+        BucketUnpacker unpacker{spec, BucketUnpacker::Behavior::kExclude};
+        unpacker.setColumnPredicates(
+            BucketSpec::createPredicatesOnDataColumns(matchExpr.get(), spec));
+        unpacker.reset(std::move(bucket));
+
+        std::vector<Document> unpacked;
+        while (unpacker.hasNext()) {
+            unpacked.push_back(unpacker.getNext());
+        }
+        ASSERT_EQ(unpacker.numMeasurementsSkipped(), expectedSkipped);
+        return unpacked;
+    };
+    auto filter = [&](const std::vector<Document>& measurements) {
+        std::vector<Document> matching;
+        std::copy_if(measurements.begin(),
+                     measurements.end(),
+                     std::back_inserter(matching),
+                     [&](auto&& doc) { return matchExpr->matchesBSON(doc.toBson()); });
+        return matching;
+    };
+
+    // Uncompressed buckets are unpacked in full.
+    auto expected = filter(unpackAll(bucket, 0));
+    ASSERT_EQ(expected.size(), 2U);
+
+    // In the compressed bucket the first measurement fails on 'a' and the third on 'b'. The array
+    // value in 'a' is never evaluated against the column predicate.
+    auto compressed = *timeseries::compressBucket(bucket, "time"_sd, {}, false).compressedBucket;
+    auto unpacked = unpackAll(compressed, 2);
+    ASSERT_EQ(unpacked.size(), 2U);
+
+    auto actual = filter(unpacked);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(actual[i], expected[i]);
+    }
+}
+
+TEST_F(BucketUnpackerTest, ColumnPredicateOnFieldMissingFromBucketSkipsWholeBucket) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto bucket = fromjson(
+        "{control: {'version': 1}, data: {time: {'0':1, '1':2}, a:{'0':1, '1':2}}}");
+    auto compressed = *timeseries::compressBucket(bucket, "time"_sd, {}, false).compressedBucket;
+    auto matchExpr =
+        uassertStatusOK(MatchExpressionParser::parse(fromjson("{b: {$gte: 0}}"), expCtx));
+
+    auto spec = BucketSpec{kUserDefinedTimeName.toString(), boost::none};
+    BucketUnpacker unpacker{spec, BucketUnpacker::Behavior::kExclude};
+    unpacker.setColumnPredicates(BucketSpec::createPredicatesOnDataColumns(matchExpr.get(), spec));
+    unpacker.reset(BSONObj{compressed});
+
+    ASSERT_EQ(unpacker.numberOfMeasurements(), 2);
+    ASSERT_FALSE(unpacker.hasNext());
+    ASSERT_EQ(unpacker.numMeasurementsSkipped(), 2);
+
+    // An equality to null matches a missing field, so nothing is skipped.
+    unpacker.setColumnPredicates(BucketSpec::createPredicatesOnDataColumns(
+        uassertStatusOK(MatchExpressionParser::parse(fromjson("{b: null}"), expCtx)).get(), spec));
+    unpacker.reset(BSONObj{compressed});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{time: 1, a: 1}")});
+    assertGetNext(unpacker, Document{fromjson("{time: 2, a: 2}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+
+TEST_F(BucketUnpackerTest, ColumnPredicatesOnFieldsNotUnpackedAreDropped) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto matchExpr =
+        uassertStatusOK(MatchExpressionParser::parse(fromjson("{a: {$gt: 1}}"), expCtx));
+    auto keepsPredicate = [&](std::set<std::string> fields, BucketUnpacker::Behavior behavior) {
+        auto spec = BucketSpec{kUserDefinedTimeName.toString(), boost::none, fields};
+        BucketUnpacker unpacker{spec, behavior};
+        unpacker.setColumnPredicates(
+            BucketSpec::createPredicatesOnDataColumns(matchExpr.get(), spec));
+        return unpacker.hasColumnPredicates();
+    };
+
+    ASSERT_TRUE(keepsPredicate({}, BucketUnpacker::Behavior::kExclude));
+    ASSERT_TRUE(keepsPredicate({"a"}, BucketUnpacker::Behavior::kInclude));
+    ASSERT_TRUE(keepsPredicate({"b"}, BucketUnpacker::Behavior::kExclude));
+
+    // A projected out field is missing from every unpacked measurement, whatever its column holds.
+    ASSERT_FALSE(keepsPredicate({"b"}, BucketUnpacker::Behavior::kInclude));
+    ASSERT_FALSE(keepsPredicate({"a"}, BucketUnpacker::Behavior::kExclude));
+
+    // Changing the unpacked fields clears the predicates chosen for the previous ones.
+    auto spec = BucketSpec{kUserDefinedTimeName.toString(), boost::none};
+    BucketUnpacker unpacker{spec, BucketUnpacker::Behavior::kExclude};
+    unpacker.setColumnPredicates(BucketSpec::createPredicatesOnDataColumns(matchExpr.get(), spec));
+    ASSERT_TRUE(unpacker.hasColumnPredicates());
+    unpacker.setBucketSpecAndBehavior(
+        BucketSpec{kUserDefinedTimeName.toString(), boost::none, {"b"}},
+        BucketUnpacker::Behavior::kInclude);
+    ASSERT_FALSE(unpacker.hasColumnPredicates());
+}
+
 }  // namespace
 }  // namespace mongo
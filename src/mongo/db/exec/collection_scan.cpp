@@ -121,6 +121,12 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
         // only support in the forward direction.
         invariant(params.direction == CollectionScanParams::FORWARD);
     }
+
+    if (params.shareOplogEntries && params.tailable &&
+        params.direction == CollectionScanParams::FORWARD && collection->ns().isOplog() &&
+        SharedOplogScanBuffer::isEnabled()) {
+        _sharedOplogBuffer = &SharedOplogScanBuffer::get(expCtx->opCtx->getServiceContext());
+    }
 }
 
 CollectionScan::CollectionScan(ExpressionContext* expCtx,
@@ -139,6 +145,15 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
+        if (_sharedOplogBuffer && !_lastSeenId.isNull()) {
+            if (auto entry = nextSharedOplogEntry()) {
+                // Our cursor is now positioned before '_lastSeenId'. Discard it so that it is
+                // repositioned at '_lastSeenId' once we read from storage again.
+                _cursor.reset();
+                return returnDocument(std::move(entry->id), std::move(entry->obj), out);
+            }
+        }
+
         if (needToMakeCursor) {
             const bool forward = _params.direction == CollectionScanParams::FORWARD;
 
@@ -234,29 +249,70 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    _lastSeenId = record->id;
     if (_params.assertTsHasNotFallenOffOplog) {
         assertTsHasNotFallenOffOplog(*record);
     }
+
+    BSONObj obj = record->data.releaseToBson();
+    if (_sharedOplogBuffer && !_lastSeenId.isNull() && readsMajorityCommittedSnapshot()) {
+        _sharedOplogBuffer->add(_lastSeenId, record->id, &obj);
+    }
+
+    return returnDocument(std::move(record->id), std::move(obj), out);
+}
+
+PlanStage::StageState CollectionScan::returnDocument(RecordId id, BSONObj obj, WorkingSetID* out) {
+    _lastSeenId = id;
     if (_params.shouldTrackLatestOplogTimestamp) {
-        setLatestOplogEntryTimestamp(*record);
+        setLatestOplogEntryTimestamp(obj);
     }
 
-    WorkingSetID id = _workingSet->allocate();
-    WorkingSetMember* member = _workingSet->get(id);
-    member->recordId = std::move(record->id);
-    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson());
-    _workingSet->transitionToRecordIdAndObj(id);
+    WorkingSetID memberID = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(memberID);
+    member->recordId = std::move(id);
+    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), std::move(obj));
+    _workingSet->transitionToRecordIdAndObj(memberID);
+
+    return returnIfMatches(member, memberID, out);
+}
+
+boost::optional<SharedOplogScanBuffer::Entry> CollectionScan::nextSharedOplogEntry() {
+    // Entries are read from the buffer in batches to limit contention between change streams.
+    static constexpr size_t kBatchSize = 64;
+
+    if (_sharedOplogEntries.empty()) {
+        if (!readsMajorityCommittedSnapshot()) {
+            return boost::none;
+        }
+
+        // Only return entries visible in our snapshot. Oplog entries have RecordIds equal to their
+        // timestamps.
+        const auto readTimestamp = opCtx()->recoveryUnit()->getPointInTimeReadTimestamp(opCtx());
+        if (!readTimestamp ||
+            !_sharedOplogBuffer->next(_lastSeenId,
+                                      RecordId(readTimestamp->asULL()),
+                                      kBatchSize,
+                                      &_sharedOplogEntries)) {
+            return boost::none;
+        }
+    }
+
+    auto entry = std::move(_sharedOplogEntries.front());
+    _sharedOplogEntries.pop_front();
+    return entry;
+}
 
-    return returnIfMatches(member, id, out);
+bool CollectionScan::readsMajorityCommittedSnapshot() const {
+    return opCtx()->recoveryUnit()->getTimestampReadSource() ==
+        RecoveryUnit::ReadSource::kMajorityCommitted;
 }
 
-void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
-    auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
+void CollectionScan::setLatestOplogEntryTimestamp(const BSONObj& obj) {
+    auto tsElem = obj[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
             str::stream() << "CollectionScan was asked to track latest operation time, "
                              "but found a result without a valid 'ts' field: "
-                          << record.data.toBson().toString(),
+                          << obj.toString(),
             tsElem.type() == BSONType::bsonTimestamp);
     LOGV2_DEBUG(550450,
                 5,
@@ -29,10 +29,12 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/exec/shared_oplog_scan_buffer.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 #include "mongo/s/resharding/resume_token_gen.h"
@@ -111,11 +113,29 @@ private:
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
     /**
-     * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
+     * Makes the document 'obj' with RecordId 'id' the last one seen by this scan, and returns it
+     * through 'out' if it passes our filter.
+     */
+    StageState returnDocument(RecordId id, BSONObj obj, WorkingSetID* out);
+
+    /**
+     * Returns the oplog entry following '_lastSeenId' if '_sharedOplogBuffer' has it and it is
+     * visible in our snapshot, or boost::none if it must be read from storage.
+     */
+    boost::optional<SharedOplogScanBuffer::Entry> nextSharedOplogEntry();
+
+    /**
+     * Returns true if this scan reads from a majority-committed snapshot, which is required to
+     * read oplog entries from or add them to '_sharedOplogBuffer'.
+     */
+    bool readsMajorityCommittedSnapshot() const;
+
+    /**
+     * Extracts the timestamp from the 'ts' field of 'obj', and sets '_latestOplogEntryTimestamp'
      * to that time if it isn't already greater. Throws an exception if the 'ts' field cannot be
      * extracted.
      */
-    void setLatestOplogEntryTimestamp(const Record& record);
+    void setLatestOplogEntryTimestamp(const BSONObj& obj);
 
     /**
      * Asserts that the minimum timestamp in the query filter has not already fallen off the oplog.
@@ -138,6 +158,13 @@ private:
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
 
+    // Set if this scan shares the oplog entries it reads with other scans, see
+    // CollectionScanParams::shareOplogEntries.
+    SharedOplogScanBuffer* _sharedOplogBuffer = nullptr;
+
+    // Entries read from '_sharedOplogBuffer' which follow '_lastSeenId' in the oplog.
+    std::deque<SharedOplogScanBuffer::Entry> _sharedOplogEntries;
+
     // Stats
     CollectionScanStats _specificStats;
 };
@@ -111,6 +111,10 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether a forward, tailable scan of the oplog may read the entries that other such scans
+    // have read from storage from the SharedOplogScanBuffer, and add those it reads itself.
+    bool shareOplogEntries = false;
 };
 
 }  // namespace mongo
@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for CollectionScan sharing the oplog entries it reads for change
+ * streams through SharedOplogScanBuffer.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/shared_oplog_scan_buffer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/storage/snapshot_manager.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const auto& oplogNss = NamespaceString::kRsOplogNamespace;
+
+Timestamp makeTimestamp(int inc) {
+    return Timestamp(100, inc);
+}
+
+RecordId makeRecordId(int inc) {
+    return RecordId(makeTimestamp(inc).asULL());
+}
+
+/**
+ * Returns the oplog entry with timestamp 'makeTimestamp(inc)'. Tests add the 'shared' version of
+ * an entry to the shared buffer, to tell the entries a scan reads from it from those it reads from
+ * storage.
+ */
+BSONObj makeOplogEntry(int inc, bool shared = false) {
+    return BSON("ts" << makeTimestamp(inc) << "o" << BSON("x" << inc << "shared" << shared));
+}
+
+class CollectionScanSharedOplogTest : public CatalogTestFixture {
+public:
+    CollectionScanSharedOplogTest() : CatalogTestFixture("wiredTiger") {}
+
+    SharedOplogScanBuffer& buffer() {
+        return SharedOplogScanBuffer::get(getServiceContext());
+    }
+
+    /**
+     * Writes the oplog entries 1 to 'numEntries', and majority commits them up to the entry
+     * 'majorityCommitted'.
+     */
+    void writeOplog(int numEntries, int majorityCommitted) {
+        auto opCtx = operationContext();
+        for (int inc = 1; inc <= numEntries; ++inc) {
+            ASSERT_OK(storageInterface()->insertDocument(opCtx,
+                                                         oplogNss,
+                                                         {makeOplogEntry(inc), makeTimestamp(inc)},
+                                                         repl::OpTime::kUninitializedTerm));
+        }
+
+        // All the writes have committed, so there are no oplog holes left to hide.
+        storageInterface()->oplogDiskLocRegister(
+            opCtx, makeTimestamp(numEntries), true /* orderedCommit */);
+        getServiceContext()->getStorageEngine()->getSnapshotManager()->setCommittedSnapshot(
+            makeTimestamp(majorityCommitted));
+    }
+
+    /**
+     * Adds the shared version of the oplog entry 'inc', as if another scan had read it right after
+     * the entry 'previous'.
+     */
+    void addSharedEntry(int previous, int inc) {
+        auto obj = makeOplogEntry(inc, true /* shared */);
+        buffer().add(makeRecordId(previous), makeRecordId(inc), &obj);
+    }
+
+    /**
+     * Runs the tailable oplog scan of a change stream reading with 'readSource' to the end of the
+     * oplog, and returns the entries it returned.
+     */
+    std::vector<BSONObj> scanOplog(
+        RecoveryUnit::ReadSource readSource = RecoveryUnit::ReadSource::kMajorityCommitted) {
+        auto opCtx = operationContext();
+        opCtx->recoveryUnit()->abandonSnapshot();
+        opCtx->recoveryUnit()->setTimestampReadSource(readSource);
+
+        std::vector<BSONObj> entries;
+        {
+            AutoGetCollection oplog(opCtx, oplogNss, MODE_IS);
+            auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx, oplogNss);
+
+            CollectionScanParams params;
+            params.tailable = true;
+            params.shareOplogEntries = true;
+            WorkingSet ws;
+            CollectionScan scan(expCtx.get(), oplog.getCollection(), params, &ws, nullptr);
+
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            for (auto state = scan.work(&id); state != PlanStage::IS_EOF; state = scan.work(&id)) {
+                ASSERT_NE(PlanStage::NEED_YIELD, state);
+                if (state == PlanStage::ADVANCED) {
+                    entries.push_back(ws.get(id)->doc.value().toBson().getOwned());
+                }
+            }
+        }
+
+        opCtx->recoveryUnit()->abandonSnapshot();
+        opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
+        return entries;
+    }
+
+    void assertEntries(const std::vector<BSONObj>& expected, const std::vector<BSONObj>& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(expected[i], actual[i]);
+        }
+    }
+};
+
+TEST_F(CollectionScanSharedOplogTest, SwitchesBetweenBufferAndStorage) {
+    writeOplog(5, 5);
+    addSharedEntry(1, 2);
+    addSharedEntry(2, 3);
+
+    // The scan reads the first entry from storage, as it does not know which entry precedes it,
+    // and the two following ones from the buffer. Its cursor is then repositioned at the third
+    // entry to read the rest from storage.
+    const std::vector<BSONObj> expected{makeOplogEntry(1),
+                                        makeOplogEntry(2, true),
+                                        makeOplogEntry(3, true),
+                                        makeOplogEntry(4),
+                                        makeOplogEntry(5)};
+    assertEntries(expected, scanOplog());
+
+    // The entries the scan read from storage extended the buffer.
+    std::deque<SharedOplogScanBuffer::Entry> buffered;
+    ASSERT_EQ(4U, buffer().next(makeRecordId(1), makeRecordId(5), 10, &buffered));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(4), buffered[2].obj);
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(5), buffered[3].obj);
+
+    // Another scan reads them from the buffer, then finds nothing after them in storage.
+    assertEntries(expected, scanOplog());
+}
+
+TEST_F(CollectionScanSharedOplogTest, OnlyReadsBufferedEntriesInItsSnapshot) {
+    writeOplog(5, 3);
+    for (int inc = 2; inc <= 5; ++inc) {
+        addSharedEntry(inc - 1, inc);
+    }
+
+    // The entries after the majority commit point are buffered, but not visible to the scan.
+    assertEntries({makeOplogEntry(1), makeOplogEntry(2, true), makeOplogEntry(3, true)},
+                  scanOplog());
+}
+
+TEST_F(CollectionScanSharedOplogTest, OnlySharesEntriesInMajorityCommittedSnapshots) {
+    writeOplog(3, 3);
+    addSharedEntry(1, 2);
+    const auto sizeBytes = buffer().getSizeBytes();
+
+    // Entries read without a majority-committed snapshot may be rolled back, so the scan neither
+    // reads entries from the buffer nor adds the ones it reads to it.
+    assertEntries({makeOplogEntry(1), makeOplogEntry(2), makeOplogEntry(3)},
+                  scanOplog(RecoveryUnit::ReadSource::kNoTimestamp));
+    ASSERT_EQ(sizeBytes, buffer().getSizeBytes());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/util/memory_arena.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -43,6 +44,29 @@ using std::string;
 using std::vector;
 
 namespace {
+/**
+ * Allocates a DocumentStorage cache buffer, from the calling thread's MemoryArena if one is
+ * installed. Sets 'inArena' to indicate how the buffer must be released by freeCacheBuffer().
+ */
+char* allocateCacheBuffer(size_t bytes, bool* inArena) {
+    if (auto arena = MemoryArena::current()) {
+        if (auto buffer = arena->allocate(bytes)) {
+            *inArena = true;
+            return static_cast<char*>(buffer);
+        }
+    }
+    *inArena = false;
+    return new char[bytes];
+}
+
+void freeCacheBuffer(char* buffer, bool inArena) {
+    if (inArena) {
+        MemoryArena::deallocate(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
 /**
  * Assert that a given field path does not exceed the length limit.
  */
@@ -305,13 +329,14 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_cache);
-    _cache = new char[capacity];
+    char* const oldBuf = _cache;
+    const bool oldBufInArena = _cacheInArena;
+    _cache = allocateCacheBuffer(capacity, &_cacheInArena);
     _cacheEnd = _cache + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_cache, oldBuf.get(), _usedBytes);
+        memcpy(_cache, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -319,9 +344,11 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
+
+        freeCacheBuffer(oldBuf, oldBufInArena);
     }
 }
 
@@ -338,7 +365,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _cache = new char[newSize + hashTabBytes()];
+    _cache = allocateCacheBuffer(newSize + hashTabBytes(), &_cacheInArena);
     _cacheEnd = _cache + newSize;
 }
 
@@ -350,7 +377,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         // Make a copy of the buffer with the fields.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = allocatedBytes();
-        out->_cache = new char[bufferBytes];
+        out->_cache = allocateCacheBuffer(bufferBytes, &out->_cacheInArena);
         out->_cacheEnd = out->_cache + (_cacheEnd - _cache);
         memcpy(out->_cache, _cache, bufferBytes);
 
@@ -382,11 +409,13 @@ size_t DocumentStorage::getMetadataApproximateSize() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_cache);
-
     for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    if (_cache) {
+        freeCacheBuffer(_cache, _cacheInArena);
+    }
 }
 
 void DocumentStorage::reset(const BSONObj& bson, bool stripMetadata) {
@@ -702,6 +702,9 @@ private:
     // a conversion to BSON; i.e. if there are not any modifications we can directly return _bson.
     bool _modified{false};
 
+    // Whether '_cache' was allocated from a MemoryArena rather than the heap.
+    bool _cacheInArena{false};
+
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
 
@@ -45,6 +45,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/memory_arena.h"
 
 namespace DocumentTests {
 
@@ -137,6 +138,31 @@ TEST(DocumentConstruction, FromBsonReset) {
     ASSERT_BSONOBJ_EQ(bson, toBson(newDocument));
 }
 
+TEST(DocumentConstruction, AllocatesFromCurrentMemoryArena) {
+    MemoryArena arena;
+    Document document;
+    Document clone;
+    {
+        MemoryArena::Scope scope(&arena);
+        MutableDocument md;
+        for (int i = 0; i < 10; ++i) {
+            md.addField("field" + std::to_string(i),
+                        Value("a long string value " + std::to_string(i)));
+        }
+        document = md.freeze();
+        clone = document.clone();
+        ASSERT_GT(arena.stats().bytesInUse, 0);
+    }
+
+    // Documents built from the arena remain usable after leaving the scope, and release their
+    // storage back to it when destroyed.
+    ASSERT_DOCUMENT_EQ(document, clone);
+    ASSERT_EQ(document["field9"].getString(), "a long string value 9");
+    document = Document();
+    clone = Document();
+    ASSERT_EQ(arena.stats().bytesInUse, 0);
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
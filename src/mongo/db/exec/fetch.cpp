@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
@@ -38,6 +39,9 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/str.h"
 
@@ -57,7 +61,8 @@ FetchStage::FetchStage(ExpressionContext* expCtx,
     : RequiresCollectionStage(kStageType, expCtx, collection),
       _ws(ws),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _batchSize(internalQueryFetchBatchSize.load()) {
     _children.emplace_back(std::move(child));
 }
 
@@ -69,7 +74,7 @@ bool FetchStage::isEOF() {
         return false;
     }
 
-    return child()->isEOF();
+    return _pendingFetch.empty() && _fetched.empty() && child()->isEOF();
 }
 
 PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
@@ -77,6 +82,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_batchSize > 1) {
+        return doWorkBatched(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -126,7 +135,114 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatched(WorkingSetID* out) {
+    if (!_fetched.empty()) {
+        WorkingSetID id = _fetched.front();
+        _fetched.pop_front();
+        return returnIfMatches(_ws->get(id), id, out);
+    }
+
+    // Buffer the results our child can produce right away, up to a full batch. The buffered
+    // members keep their index key data, which is validated against the documents once they are
+    // fetched, so it is fine to yield while they are pending.
+    bool childEOF = false;
+    while (_pendingFetch.size() < _batchSize && !childEOF) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->work(&id);
+        switch (status) {
+            case PlanStage::ADVANCED:
+                _pendingFetch.push_back(id);
+                break;
+            case PlanStage::IS_EOF:
+                childEOF = true;
+                break;
+            case PlanStage::NEED_YIELD:
+                *out = id;
+                return status;
+            case PlanStage::NEED_TIME:
+                return status;
+        }
+    }
+
+    if (_pendingFetch.empty()) {
+        return PlanStage::IS_EOF;
+    }
+
+    try {
+        fetchPendingBatch();
+    } catch (const WriteConflictException&) {
+        // The pending members are unmodified and will be fetched again after yielding.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    if (_fetched.empty()) {
+        return NEED_TIME;
+    }
+
+    WorkingSetID id = _fetched.front();
+    _fetched.pop_front();
+    return returnIfMatches(_ws->get(id), id, out);
+}
+
+void FetchStage::fetchPendingBatch() {
+    std::vector<WorkingSetID> toFetch;
+    for (auto id : _pendingFetch) {
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasObj()) {
+            // We need a valid RecordId to fetch from and this is the only state that has one.
+            verify(WorkingSetMember::RID_AND_IDX == member->getState());
+            verify(member->hasRecordId());
+            toFetch.push_back(id);
+        }
+    }
+
+    // Look up the records in RecordId order so that the cursor moves in a single direction.
+    std::sort(toFetch.begin(), toFetch.end(), [&](WorkingSetID lhs, WorkingSetID rhs) {
+        return _ws->get(lhs)->recordId < _ws->get(rhs)->recordId;
+    });
+    std::vector<RecordId> recordIds;
+    recordIds.reserve(toFetch.size());
+    for (auto id : toFetch) {
+        recordIds.push_back(_ws->get(id)->recordId);
+    }
+
+    const auto& coll = collection();
+    std::vector<boost::optional<Record>> records;
+    if (!recordIds.empty()) {
+        if (!_cursor)
+            _cursor = coll->getCursor(opCtx());
+        _cursor->seekExactBatch(recordIds, &records);
+    }
+
+    stdx::unordered_set<WorkingSetID> discarded;
+    for (size_t i = 0; i < toFetch.size(); ++i) {
+        if (!WorkingSetCommon::fetch(
+                opCtx(), _ws, toFetch[i], std::move(records[i]), coll, coll->ns())) {
+            discarded.insert(toFetch[i]);
+        }
+    }
+
+    _specificStats.alreadyHasObj += _pendingFetch.size() - toFetch.size();
+    for (auto id : _pendingFetch) {
+        if (discarded.count(id)) {
+            _ws->free(id);
+        } else {
+            _fetched.push_back(id);
+        }
+    }
+    _pendingFetch.clear();
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
+    // The buffered members may point into storage engine memory that is freed when we yield.
+    for (auto id : _pendingFetch) {
+        _ws->get(id)->makeObjOwnedIfNeeded();
+    }
+    for (auto id : _fetched) {
+        _ws->get(id)->makeObjOwnedIfNeeded();
+    }
+
     if (_cursor) {
         _cursor->saveUnpositioned();
     }
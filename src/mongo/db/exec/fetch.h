@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
@@ -46,6 +48,10 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * When 'internalQueryFetchBatchSize' is greater than one, the stage buffers up to that many
+ * results from its child and reads their records with a single batched cursor lookup in RecordId
+ * order, then returns them in the order the child produced them.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public RequiresCollectionStage {
@@ -86,6 +92,18 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * doWork() implementation used when fetching documents in batches.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Fetches the documents of all members in '_pendingFetch' and moves the members that are still
+     * part of the result set to '_fetched', freeing the others. Throws WriteConflictException
+     * before modifying any member.
+     */
+    void fetchPendingBatch();
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -98,6 +116,16 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // The maximum number of members to fetch in a batch. A value of one disables batching.
+    const size_t _batchSize;
+
+    // Members returned by our child that have yet to be fetched, in the order the child returned
+    // them.
+    std::vector<WorkingSetID> _pendingFetch;
+
+    // Members fetched by the last batch that have yet to be returned.
+    std::deque<WorkingSetID> _fetched;
+
     // Stats
     FetchStats _specificStats;
 };
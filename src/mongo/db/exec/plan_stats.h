@@ -784,6 +784,10 @@ struct SortStats : public SpecificStats {
 
     // The number of times that we spilled data to disk during the execution of this query.
     uint64_t spills = 0u;
+
+    // The largest amount of memory observed to be held by the operation's MemoryArena, if any,
+    // without being attributable to a live document while input was being loaded.
+    uint64_t maxDocumentArenaOverheadBytes = 0u;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -1034,6 +1038,14 @@ struct GroupStats : public SpecificStats {
 
     // The number of times that we spilled data to disk while grouping the data.
     uint64_t spills = 0u;
+
+    // The number of bytes written to disk when spilling.
+    uint64_t spilledDataStorageSize = 0u;
+
+    // The number of hash partitions spilled into, including those created by splitting a
+    // partition, and the deepest level of splitting. Zero unless spilling into hash partitions.
+    uint64_t spillPartitions = 0u;
+    uint64_t maxSpillPartitionDepth = 0u;
 };
 
 struct DocumentSourceCursorStats : public SpecificStats {
@@ -1077,6 +1089,12 @@ struct DocumentSourceLookupStats : public SpecificStats {
 
     // Tracks the summary stats in aggregate across all executions of the subpipeline.
     PlanSummaryStats planSummaryStats;
+
+    // Number of input documents whose results were served from, or had to be computed and added
+    // to, the correlated sub-pipeline result cache, and whether the cache was abandoned.
+    long long memoCacheHits = 0;
+    long long memoCacheMisses = 0;
+    bool memoCacheAbandoned = false;
 };
 
 struct UnionWithStats final : public SpecificStats {
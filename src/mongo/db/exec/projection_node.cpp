@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/projection_node.h"
 
+#include "mongo/db/query/query_knobs_gen.h"
+
 namespace mongo::projection_executor {
 using ArrayRecursionPolicy = ProjectionPolicies::ArrayRecursionPolicy;
 using ComputedFieldsPolicy = ProjectionPolicies::ComputedFieldsPolicy;
@@ -196,10 +198,12 @@ void ProjectionNode::applyExpressions(const Document& root, MutableDocument* out
         } else {
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
-            outputDoc->setField(
-                field,
-                expressionIt->second->evaluate(
-                    root, &expressionIt->second->getExpressionContext()->variables));
+            auto variables = &expressionIt->second->getExpressionContext()->variables;
+            if (auto programIt = _programs.find(field); programIt != _programs.end()) {
+                outputDoc->setField(field, programIt->second->evaluate(root, variables));
+            } else {
+                outputDoc->setField(field, expressionIt->second->evaluate(root, variables));
+            }
         }
     }
 }
@@ -265,6 +269,17 @@ void ProjectionNode::optimize() {
         childPair.second->optimize();
     }
 
+    // Lower the optimized expressions once here, so that each document is evaluated by a flat
+    // program rather than a recursive walk of the expression tree.
+    _programs.clear();
+    if (internalQueryCompileProjectionExpressions.load()) {
+        for (auto&& [fieldName, expression] : _expressions) {
+            if (auto program = ExpressionProgram::compile(expression)) {
+                _programs.emplace(fieldName, std::move(program));
+            }
+        }
+    }
+
     _maxFieldsToProject = maxFieldsToProject();
 }
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/projection_executor.h"
+#include "mongo/db/pipeline/expression_program.h"
 
 #include "mongo/db/query/projection_policies.h"
 
@@ -162,6 +163,10 @@ protected:
 
     StringMap<std::unique_ptr<ProjectionNode>> _children;
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
+    // Compiled forms of the entries in '_expressions', populated by optimize() when
+    // 'internalQueryCompileProjectionExpressions' is enabled. An expression with no entry here is
+    // evaluated by walking its tree.
+    StringMap<std::unique_ptr<ExpressionProgram>> _programs;
     StringSet _projectedFields;
     ProjectionPolicies _policies;
     std::string _pathToNode;
@@ -210,6 +215,7 @@ private:
      */
     void makeOptimizationsStale() {
         _maxFieldsToProject = boost::none;
+        _programs.clear();
     }
 
     /**
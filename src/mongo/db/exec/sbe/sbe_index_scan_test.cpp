@@ -0,0 +1,215 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for sbe::IndexScanStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <functional>
+
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/ix_scan.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/idl/server_parameter_test_util.h"
+
+namespace mongo::sbe {
+
+class IndexScanStageTest : public PlanStageTestFixture {
+public:
+    void setUp() override {
+        PlanStageTestFixture::setUp();
+
+        auto service = getServiceContext();
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(service);
+        ASSERT_OK(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+        repl::createOplog(opCtx());
+
+        ASSERT_OK(_storage.createCollection(opCtx(), _nss, CollectionOptions()));
+        ASSERT_OK(_storage.createIndexesOnEmptyCollection(
+            opCtx(), _nss, {BSON("v" << 2 << "key" << BSON("a" << 1) << "name" << kIndexName)}));
+    }
+
+    void tearDown() override {
+        _autoColl.reset();
+        PlanStageTestFixture::tearDown();
+    }
+
+    void insert(const std::vector<int>& values) {
+        for (auto a : values) {
+            ASSERT_OK(_storage.insertDocument(opCtx(),
+                                              _nss,
+                                              {BSON("_id" << a << "a" << a), Timestamp()},
+                                              repl::OpTime::kUninitializedTerm));
+        }
+    }
+
+    void remove(int a) {
+        ASSERT_OK(_storage.deleteByFilter(opCtx(), _nss, BSON("a" << a)));
+    }
+
+    /**
+     * Builds and opens a full forward scan of the index on 'a' which outputs the 'a' key, and
+     * returns the stage along with the accessor of its output.
+     */
+    std::pair<std::unique_ptr<PlanStage>, value::SlotAccessor*> openIndexScan() {
+        _autoColl.emplace(opCtx(), _nss, MODE_IS);
+
+        auto uuid = CollectionCatalog::get(opCtx())->lookupUUIDByNSS(opCtx(), _nss);
+        ASSERT(uuid);
+        auto keySlot = generateSlotId();
+        IndexKeysInclusionSet indexKeysToInclude;
+        indexKeysToInclude.set(0);
+        auto stage = makeS<IndexScanStage>(*uuid,
+                                           kIndexName,
+                                           true /* forward */,
+                                           boost::none,
+                                           boost::none,
+                                           boost::none,
+                                           indexKeysToInclude,
+                                           makeSV(keySlot),
+                                           boost::none,
+                                           boost::none,
+                                           nullptr /* yieldPolicy */,
+                                           kEmptyPlanNodeId);
+
+        _ctx = makeCompileCtx();
+        auto accessor = prepareTree(_ctx.get(), stage.get(), keySlot);
+        return {std::move(stage), accessor};
+    }
+
+    /**
+     * Returns the next 'a' key produced by the scan, or boost::none once it is exhausted.
+     */
+    boost::optional<int> next(PlanStage* stage, value::SlotAccessor* accessor) {
+        if (stage->getNext() != PlanState::ADVANCED) {
+            return boost::none;
+        }
+        auto [tag, val] = accessor->getViewOfValue();
+        return value::numericCast<int32_t>(tag, val);
+    }
+
+    std::vector<int> drain(PlanStage* stage, value::SlotAccessor* accessor) {
+        std::vector<int> results;
+        while (auto a = next(stage, accessor)) {
+            results.push_back(*a);
+        }
+        return results;
+    }
+
+    /**
+     * Yields the way a plan executor does: the scan gives up its cursor, locks and snapshot, and
+     * 'whileYielded' runs before they are acquired again.
+     */
+    void yield(PlanStage* stage, const std::function<void()>& whileYielded) {
+        stage->saveState(true /* relinquishCursor */);
+        _autoColl.reset();
+        opCtx()->recoveryUnit()->abandonSnapshot();
+
+        whileYielded();
+
+        _autoColl.emplace(opCtx(), _nss, MODE_IS);
+        stage->restoreState(true /* relinquishCursor */);
+    }
+
+protected:
+    static constexpr StringData kIndexName = "a_1"_sd;
+
+    const NamespaceString _nss{"test.sbe_index_scan"};
+    repl::StorageInterfaceImpl _storage;
+    boost::optional<AutoGetCollection> _autoColl;
+    std::unique_ptr<CompileCtx> _ctx;
+};
+
+TEST_F(IndexScanStageTest, YieldMidBatchReturnsEveryKeyOnce) {
+    RAIIServerParameterControllerForTest batchSize(
+        "internalQuerySlotBasedExecutionIndexScanBatchSize", 4);
+    insert({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    auto [stage, accessor] = openIndexScan();
+    std::vector<int> results;
+    for (int i = 0; i < 6; ++i) {
+        results.push_back(*next(stage.get(), accessor));
+        if (i % 2 == 0) {
+            yield(stage.get(), [] {});
+        }
+    }
+    auto rest = drain(stage.get(), accessor);
+    results.insert(results.end(), rest.begin(), rest.end());
+
+    ASSERT(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}) == results);
+}
+
+TEST_F(IndexScanStageTest, YieldMidBatchRepositionsAfterLastReturnedKey) {
+    RAIIServerParameterControllerForTest batchSize(
+        "internalQuerySlotBasedExecutionIndexScanBatchSize", 4);
+    insert({0, 2, 4, 6, 8, 10, 12});
+
+    auto [stage, accessor] = openIndexScan();
+    ASSERT_EQ(0, *next(stage.get(), accessor));
+    ASSERT_EQ(2, *next(stage.get(), accessor));
+
+    // The last key returned and the next key, which were both in the read-ahead batch, are
+    // removed. A key behind the scan and one inside the discarded batch are added.
+    yield(stage.get(), [&] {
+        remove(2);
+        remove(4);
+        insert({1, 5});
+    });
+
+    ASSERT(std::vector<int>({5, 6, 8, 10, 12}) == drain(stage.get(), accessor));
+}
+
+TEST_F(IndexScanStageTest, YieldAtEndOfBatchDoesNotReposition) {
+    RAIIServerParameterControllerForTest batchSize(
+        "internalQuerySlotBasedExecutionIndexScanBatchSize", 2);
+    insert({0, 1, 2, 3, 4, 5});
+
+    auto [stage, accessor] = openIndexScan();
+    ASSERT_EQ(0, *next(stage.get(), accessor));
+    ASSERT_EQ(1, *next(stage.get(), accessor));
+    ASSERT_EQ(2, *next(stage.get(), accessor));
+    const auto seeksBefore =
+        static_cast<const IndexScanStats*>(stage->getSpecificStats())->seeks;
+
+    // The batch holding 1 and 2 has been drained, so nothing needs to be read again.
+    yield(stage.get(), [] {});
+
+    ASSERT(std::vector<int>({3, 4, 5}) == drain(stage.get(), accessor));
+    ASSERT_EQ(seeksBefore, static_cast<const IndexScanStats*>(stage->getSpecificStats())->seeks);
+}
+
+}  // namespace mongo::sbe
@@ -37,6 +37,7 @@
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/trial_run_tracker.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo::sbe {
 IndexScanStage::IndexScanStage(UUID collUuid,
@@ -180,6 +181,10 @@ void IndexScanStage::doSaveState(bool relinquishCursor) {
             }
         }
 
+        // Entries read ahead from the cursor may no longer be visible once the snapshot is
+        // released, so they are read again after the yield.
+        discardBatch();
+
         if (_cursor) {
             _cursor->save();
         }
@@ -270,6 +275,12 @@ void IndexScanStage::open(bool reOpen) {
     _open = true;
     _firstGetNext = true;
 
+    _batchSize = internalQuerySlotBasedExecutionIndexScanBatchSize.load();
+    _batch.clear();
+    _batchPos = 0;
+    _batchCursorExhausted = false;
+    _needsRepositionAfterYield = false;
+
     auto entry = _weakIndexCatalogEntry.lock();
     tassert(4938502,
             str::stream() << "expected IndexCatalogEntry for index named: " << _indexName,
@@ -325,6 +336,64 @@ const KeyString::Value* IndexScanStage::getSeekKeyHigh() const {
     return value::getKeyStringView(value);
 }
 
+bool IndexScanStage::isPastSeekKeyHigh(const KeyString::Value& keyString) const {
+    auto seekKeyHigh = getSeekKeyHigh();
+    if (!seekKeyHigh) {
+        return false;
+    }
+
+    auto cmp = keyString.compare(*seekKeyHigh);
+    return _forward ? cmp > 0 : cmp < 0;
+}
+
+void IndexScanStage::discardBatch() {
+    if (_batchPos < _batch.size()) {
+        _needsRepositionAfterYield = true;
+        _batchCursorExhausted = false;
+    }
+    _batch.clear();
+    _batchPos = 0;
+}
+
+boost::optional<KeyStringEntry> IndexScanStage::nextFromBatch() {
+    if (_batchPos < _batch.size()) {
+        return std::move(_batch[_batchPos++]);
+    }
+
+    _batch.clear();
+    _batchPos = 0;
+
+    if (_needsRepositionAfterYield) {
+        tassert(7804100, "IndexScanStage discarded a batch before returning from it", _nextRecord);
+        _needsRepositionAfterYield = false;
+
+        // The last entry returned may have been removed while yielded, so seek to it, and only
+        // step past what we land on if it is that same entry.
+        auto entry = _cursor->seekForKeyString(_nextRecord->keyString);
+        ++_specificStats.seeks;
+        if (!entry || isPastSeekKeyHigh(entry->keyString)) {
+            _batchCursorExhausted = true;
+            return boost::none;
+        }
+        if (entry->keyString.compare(_nextRecord->keyString) != 0) {
+            _batch.push_back(std::move(*entry));
+        }
+    }
+
+    if (!_batchCursorExhausted) {
+        const size_t wanted = _batchSize - _batch.size();
+        if (_cursor->nextKeyStringBatch(wanted, getSeekKeyHigh(), _keyStringPool, &_batch) <
+            wanted) {
+            _batchCursorExhausted = true;
+        }
+    }
+
+    if (_batch.empty()) {
+        return boost::none;
+    }
+    return std::move(_batch[_batchPos++]);
+}
+
 PlanState IndexScanStage::getNext() {
     auto optTimer(getOptTimer(_opCtx));
 
@@ -334,10 +403,16 @@ PlanState IndexScanStage::getNext() {
 
     checkForInterrupt(_opCtx);
 
+    // Entries produced by a batch have already been checked against the high seek key by the
+    // cursor.
+    bool checkSeekKeyHigh = true;
     if (_firstGetNext) {
         _firstGetNext = false;
         _nextRecord = _cursor->seekForKeyString(getSeekKeyLow());
         ++_specificStats.seeks;
+    } else if (_batchSize > 1) {
+        _nextRecord = nextFromBatch();
+        checkSeekKeyHigh = false;
     } else {
         _nextRecord = _cursor->nextKeyString();
     }
@@ -357,18 +432,8 @@ PlanState IndexScanStage::getNext() {
         return trackPlanState(PlanState::IS_EOF);
     }
 
-    if (auto seekKeyHigh = getSeekKeyHigh(); seekKeyHigh) {
-        auto cmp = _nextRecord->keyString.compare(*seekKeyHigh);
-
-        if (_forward) {
-            if (cmp > 0) {
-                return trackPlanState(PlanState::IS_EOF);
-            }
-        } else {
-            if (cmp < 0) {
-                return trackPlanState(PlanState::IS_EOF);
-            }
-        }
+    if (checkSeekKeyHigh && isPastSeekKeyHigh(_nextRecord->keyString)) {
+        return trackPlanState(PlanState::IS_EOF);
     }
 
     // Note: we may in the future want to bump 'keysExamined' for comparisons to a key that result
@@ -400,6 +465,8 @@ void IndexScanStage::close() {
     trackClose();
 
     _cursor.reset();
+    _batch.clear();
+    _batchPos = 0;
     _coll.reset();
     _open = false;
 }
@@ -118,6 +118,23 @@ private:
     const KeyString::Value& getSeekKeyLow() const;
     const KeyString::Value* getSeekKeyHigh() const;
 
+    /**
+     * Returns true if 'keyString' lies past the high seek key in the direction of the scan.
+     */
+    bool isPastSeekKeyHigh(const KeyString::Value& keyString) const;
+
+    /**
+     * Returns the next index entry from '_batch', refilling it from '_cursor' when it has been
+     * drained. The entries returned have already been checked against the high seek key.
+     */
+    boost::optional<KeyStringEntry> nextFromBatch();
+
+    /**
+     * Discards the read-ahead entries of '_batch'. If any had not been returned yet, the cursor is
+     * repositioned just past '_nextRecord' the next time the batch is refilled.
+     */
+    void discardBatch();
+
     const UUID _collUuid;
     const std::string _indexName;
     const bool _forward;
@@ -156,6 +173,23 @@ private:
     boost::optional<Ordering> _ordering{boost::none};
     boost::optional<KeyStringEntry> _nextRecord;
 
+    // The maximum number of index entries read from '_cursor' in one nextKeyStringBatch() call. A
+    // batch size of 1 reads entries one at a time with nextKeyString() instead.
+    size_t _batchSize{1};
+
+    // Index entries read ahead from '_cursor' and the position of the next one to return. Their
+    // KeyStrings are built in '_keyStringPool'.
+    std::vector<KeyStringEntry> _batch;
+    size_t _batchPos{0};
+    SharedBufferFragmentBuilder _keyStringPool{KeyString::HeapBuilder::kHeapAllocatorDefaultBytes};
+
+    // Set once '_cursor' has returned a short batch, after which it must not be advanced again.
+    bool _batchCursorExhausted{false};
+
+    // Set when read-ahead entries were discarded on yield, so '_cursor' is no longer positioned on
+    // the last entry this stage returned.
+    bool _needsRepositionAfterYield{false};
+
     // This buffer stores values that are projected out of the index entry. Values in the
     // '_accessors' list that are pointers point to data in this buffer.
     BufBuilder _valuesBuffer;
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_scan_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedOplogScanBuffer = ServiceContext::declareDecoration<SharedOplogScanBuffer>();
+
+// Oplog entries that change streams read from the shared buffer and from storage respectively,
+// and the number of times the buffered entries were replaced by ones not adjacent to them.
+Counter64 entriesReadFromBuffer;
+Counter64 entriesReadFromStorage;
+Counter64 bufferResets;
+ServerStatusMetricField<Counter64> displayEntriesReadFromBuffer(
+    "changeStreams.sharedOplogScan.entriesReadFromBuffer", &entriesReadFromBuffer);
+ServerStatusMetricField<Counter64> displayEntriesReadFromStorage(
+    "changeStreams.sharedOplogScan.entriesReadFromStorage", &entriesReadFromStorage);
+ServerStatusMetricField<Counter64> displayBufferResets("changeStreams.sharedOplogScan.resets",
+                                                       &bufferResets);
+
+bool idLess(const SharedOplogScanBuffer::Entry& entry, const RecordId& id) {
+    return entry.id < id;
+}
+
+}  // namespace
+
+SharedOplogScanBuffer& SharedOplogScanBuffer::get(ServiceContext* service) {
+    return getSharedOplogScanBuffer(service);
+}
+
+bool SharedOplogScanBuffer::isEnabled() {
+    return internalChangeStreamSharedOplogScanBufferBytes.load() > 0;
+}
+
+void SharedOplogScanBuffer::add(const RecordId& previousId, const RecordId& id, BSONObj* obj) {
+    invariant(previousId < id);
+    entriesReadFromStorage.increment();
+
+    const auto maxSizeBytes = internalChangeStreamSharedOplogScanBufferBytes.load();
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (maxSizeBytes <= 0) {
+        // Sharing was turned off while this scan was open. Only scans opened before that still
+        // add entries, so release the memory held by the buffered ones.
+        _clear(lk);
+        return;
+    }
+
+    if (!_entries.empty() && id <= _entries.back().id) {
+        // Another scan already read this entry, or the entry is older than the buffered ones.
+        return;
+    }
+
+    const RecordId& lastId = _entries.empty() ? _firstEntryPredecessor : _entries.back().id;
+    if (lastId != previousId) {
+        // The entry does not extend the buffered ones, so start a new run of entries from it.
+        if (!_entries.empty()) {
+            bufferResets.increment();
+        }
+        _entries.clear();
+        _sizeBytes = 0;
+        _firstEntryPredecessor = previousId;
+    }
+
+    // Only copy entries we keep. Most scans read entries already buffered by another scan.
+    *obj = obj->getOwned();
+    _sizeBytes += obj->objsize();
+    _entries.push_back({id, *obj});
+    _evictIfNeeded(lk, maxSizeBytes);
+}
+
+size_t SharedOplogScanBuffer::next(const RecordId& lastSeenId,
+                                   const RecordId& maxId,
+                                   size_t maxEntries,
+                                   std::deque<Entry>* out) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_entries.empty() || lastSeenId < _firstEntryPredecessor) {
+        return 0;
+    }
+
+    auto it = _entries.begin();
+    if (lastSeenId != _firstEntryPredecessor) {
+        it = std::lower_bound(_entries.begin(), _entries.end(), lastSeenId, idLess);
+        if (it == _entries.end() || it->id != lastSeenId) {
+            return 0;
+        }
+        ++it;
+    }
+
+    size_t numEntries = 0;
+    for (; it != _entries.end() && numEntries < maxEntries && it->id <= maxId; ++it) {
+        out->push_back(*it);
+        ++numEntries;
+    }
+    entriesReadFromBuffer.increment(numEntries);
+    return numEntries;
+}
+
+size_t SharedOplogScanBuffer::getSizeBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _sizeBytes;
+}
+
+void SharedOplogScanBuffer::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _clear(lk);
+}
+
+void SharedOplogScanBuffer::_clear(WithLock) {
+    _entries.clear();
+    _sizeBytes = 0;
+    _firstEntryPredecessor = RecordId();
+}
+
+void SharedOplogScanBuffer::_evictIfNeeded(WithLock, size_t maxSizeBytes) {
+    // Always keep the latest entry so that the scans at the end of the oplog can keep extending
+    // the buffered entries.
+    while (_sizeBytes > maxSizeBytes && _entries.size() > 1) {
+        _sizeBytes -= _entries.front().obj.objsize();
+        _firstEntryPredecessor = std::move(_entries.front().id);
+        _entries.pop_front();
+    }
+}
+
+}  // namespace mongo
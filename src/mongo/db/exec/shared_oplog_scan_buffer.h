@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Retains the most recent oplog entries read by the tailable oplog scans of change streams, so
+ * that the many change streams tailing the oplog of a node share a single read of each entry from
+ * storage rather than each reading it independently.
+ *
+ * The buffer holds one run of entries known to be adjacent in the oplog, as established by the
+ * scan that read them. Callers must only add entries read in majority-committed snapshots, which
+ * cannot be rolled back, and must only read entries visible in their own snapshot. Each change
+ * stream still applies its own oplog filter to the entries it reads from the buffer.
+ */
+class SharedOplogScanBuffer {
+public:
+    struct Entry {
+        RecordId id;
+        BSONObj obj;
+    };
+
+    static SharedOplogScanBuffer& get(ServiceContext* service);
+
+    /**
+     * Returns false if sharing oplog entries is turned off by a zero
+     * internalChangeStreamSharedOplogScanBufferBytes, in which case new scans should not use the
+     * buffer.
+     */
+    static bool isEnabled();
+
+    /**
+     * Records that the oplog entry 'obj' with RecordId 'id', which was just read from storage,
+     * immediately follows the entry with RecordId 'previousId' in the oplog. Entries older than the
+     * buffered ones are ignored, while an entry that does not extend them replaces them. Only if
+     * the entry is buffered is 'obj' made owned, and its copy shared with the buffer. Once sharing
+     * is turned off, this discards the buffered entries instead.
+     */
+    void add(const RecordId& previousId, const RecordId& id, BSONObj* obj);
+
+    /**
+     * Appends to 'out' up to 'maxEntries' of the buffered entries that follow the entry with
+     * RecordId 'lastSeenId' in the oplog, stopping before the first entry after 'maxId'. Returns
+     * the number of entries appended.
+     */
+    size_t next(const RecordId& lastSeenId,
+                const RecordId& maxId,
+                size_t maxEntries,
+                std::deque<Entry>* out) const;
+
+    /**
+     * Returns the total size of the BSON of the buffered entries.
+     */
+    size_t getSizeBytes() const;
+
+    void clear();
+
+private:
+    void _clear(WithLock);
+
+    void _evictIfNeeded(WithLock, size_t maxSizeBytes);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogScanBuffer::_mutex");
+
+    // The RecordId of the entry immediately preceding the first buffered entry in the oplog.
+    RecordId _firstEntryPredecessor;
+
+    // Adjacent oplog entries in RecordId order.
+    std::deque<Entry> _entries;
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_scan_buffer.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+SharedOplogScanBuffer::Entry makeEntry(int64_t id) {
+    return {RecordId(id), BSON("ts" << Timestamp(id) << "o" << BSON("x" << id))};
+}
+
+void add(SharedOplogScanBuffer& buffer, int64_t previousId, int64_t id) {
+    auto entry = makeEntry(id);
+    buffer.add(RecordId(previousId), entry.id, &entry.obj);
+}
+
+std::vector<int64_t> readIds(const SharedOplogScanBuffer& buffer,
+                             int64_t lastSeenId,
+                             int64_t maxId,
+                             size_t maxEntries = 100) {
+    std::deque<SharedOplogScanBuffer::Entry> entries;
+    const auto numEntries =
+        buffer.next(RecordId(lastSeenId), RecordId(maxId), maxEntries, &entries);
+    ASSERT_EQ(numEntries, entries.size());
+
+    std::vector<int64_t> ids;
+    for (auto&& entry : entries) {
+        ASSERT_EQ(entry.id.getLong(), entry.obj["o"]["x"].numberLong());
+        ids.push_back(entry.id.getLong());
+    }
+    return ids;
+}
+
+TEST(SharedOplogScanBufferTest, ReturnsEntriesFollowingLastSeenEntry) {
+    SharedOplogScanBuffer buffer;
+    add(buffer, 1, 2);
+    add(buffer, 2, 3);
+    add(buffer, 3, 5);
+
+    ASSERT(std::vector<int64_t>({2, 3, 5}) == readIds(buffer, 1, 10));
+    ASSERT(std::vector<int64_t>({3, 5}) == readIds(buffer, 2, 10));
+    ASSERT(std::vector<int64_t>({5}) == readIds(buffer, 3, 10));
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 5, 10));
+
+    // Entries must be read from storage if the buffer does not know what follows the last seen
+    // entry.
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 0, 10));
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 4, 10));
+}
+
+TEST(SharedOplogScanBufferTest, ReturnsNoEntriesAfterMaxIdOrBeyondMaxEntries) {
+    SharedOplogScanBuffer buffer;
+    for (int64_t id = 1; id <= 5; ++id) {
+        add(buffer, id, id + 1);
+    }
+
+    ASSERT(std::vector<int64_t>({2, 3, 4}) == readIds(buffer, 1, 4));
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 1, 1));
+    ASSERT(std::vector<int64_t>({3, 4}) == readIds(buffer, 2, 10, 2));
+}
+
+TEST(SharedOplogScanBufferTest, IgnoresEntriesAlreadyBufferedOrOlder) {
+    SharedOplogScanBuffer buffer;
+    add(buffer, 10, 11);
+    add(buffer, 11, 12);
+
+    // Another scan reading the same entries, or entries before the buffered ones.
+    add(buffer, 10, 11);
+    add(buffer, 1, 2);
+
+    ASSERT(std::vector<int64_t>({11, 12}) == readIds(buffer, 10, 100));
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 1, 100));
+}
+
+TEST(SharedOplogScanBufferTest, OnlyCopiesEntriesItKeeps) {
+    SharedOplogScanBuffer buffer;
+    const auto entry = makeEntry(2);
+
+    BSONObj obj(entry.obj.objdata());
+    buffer.add(RecordId(1), entry.id, &obj);
+    ASSERT(obj.isOwned());
+    ASSERT_NE(entry.obj.objdata(), obj.objdata());
+    ASSERT_BSONOBJ_EQ(entry.obj, obj);
+
+    // An entry another scan already buffered is shared as is.
+    BSONObj ignored(entry.obj.objdata());
+    buffer.add(RecordId(1), entry.id, &ignored);
+    ASSERT_FALSE(ignored.isOwned());
+    ASSERT_EQ(entry.obj.objdata(), ignored.objdata());
+
+    ASSERT(std::vector<int64_t>({2}) == readIds(buffer, 1, 100));
+}
+
+TEST(SharedOplogScanBufferTest, ReplacesEntriesWithNonAdjacentEntry) {
+    SharedOplogScanBuffer buffer;
+    add(buffer, 1, 2);
+    add(buffer, 2, 3);
+
+    // The entry following 5 is not known to follow the buffered ones.
+    add(buffer, 5, 6);
+
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 1, 100));
+    ASSERT(std::vector<int64_t>({6}) == readIds(buffer, 5, 100));
+    ASSERT_EQ(static_cast<size_t>(makeEntry(6).obj.objsize()), buffer.getSizeBytes());
+}
+
+TEST(SharedOplogScanBufferTest, EvictsOldestEntriesBeyondMaxSize) {
+    const auto entrySize = makeEntry(1).obj.objsize();
+    RAIIServerParameterControllerForTest maxSize("internalChangeStreamSharedOplogScanBufferBytes",
+                                                 3 * entrySize);
+    SharedOplogScanBuffer buffer;
+    for (int64_t id = 1; id <= 5; ++id) {
+        add(buffer, id, id + 1);
+    }
+
+    ASSERT_EQ(static_cast<size_t>(3 * entrySize), buffer.getSizeBytes());
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 1, 100));
+    ASSERT(std::vector<int64_t>({4, 5, 6}) == readIds(buffer, 3, 100));
+}
+
+TEST(SharedOplogScanBufferTest, DisabledWithZeroMaxSize) {
+    SharedOplogScanBuffer buffer;
+    add(buffer, 1, 2);
+    ASSERT(SharedOplogScanBuffer::isEnabled());
+
+    RAIIServerParameterControllerForTest maxSize("internalChangeStreamSharedOplogScanBufferBytes",
+                                                 0);
+    ASSERT_FALSE(SharedOplogScanBuffer::isEnabled());
+
+    // The scans still open discard the entries buffered before sharing was turned off.
+    add(buffer, 2, 3);
+    ASSERT_EQ(0U, buffer.getSizeBytes());
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 1, 100));
+    ASSERT(std::vector<int64_t>() == readIds(buffer, 2, 100));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/util/memory_arena.h"
 
 namespace mongo {
 /**
@@ -127,6 +128,16 @@ public:
             _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
         }
         _sorter->add(sortKey, data);
+
+        // Buffered documents may pin arena chunks, so the arena's overhead is reported alongside
+        // the sorter's own memory usage.
+        if (auto arena = MemoryArena::current()) {
+            const auto overheadBytes = arena->stats().overheadBytes();
+            if (overheadBytes > 0) {
+                _stats.maxDocumentArenaOverheadBytes = std::max(
+                    _stats.maxDocumentArenaOverheadBytes, static_cast<uint64_t>(overheadBytes));
+            }
+        }
     }
 
     /**
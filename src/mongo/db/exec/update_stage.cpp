@@ -45,6 +45,7 @@
 #include "mongo/db/exec/shard_filterer_impl.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/write_stage_common.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/collection_query_info.h"
 #include "mongo/db/query/explain.h"
@@ -117,25 +118,26 @@ UpdateStage::UpdateStage(ExpressionContext* expCtx,
                          WorkingSet* ws,
                          const CollectionPtr& collection,
                          PlanStage* child)
-    : UpdateStage(expCtx, params, ws, collection) {
+    : UpdateStage(kStageType.rawData(), expCtx, params, ws, collection) {
     // We should never reach here if the request is an upsert.
     invariant(!_params.request->isUpsert());
     _children.emplace_back(child);
 }
 
 // Protected constructor.
-UpdateStage::UpdateStage(ExpressionContext* expCtx,
+UpdateStage::UpdateStage(const char* stageType,
+                         ExpressionContext* expCtx,
                          const UpdateStageParams& params,
                          WorkingSet* ws,
                          const CollectionPtr& collection)
-    : RequiresMutableCollectionStage(kStageType.rawData(), expCtx, collection),
+    : RequiresMutableCollectionStage(stageType, expCtx, collection),
       _params(params),
       _ws(ws),
       _doc(params.driver->getDocument()),
-      _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : nullptr),
-      _preWriteFilter(opCtx(), collection->ns()) {
+      _preWriteFilter(opCtx(), collection->ns()),
+      _idRetrying(WorkingSet::INVALID_ID),
+      _idReturning(WorkingSet::INVALID_ID) {
 
     // Should the modifiers validate their embedded docs via storage_validation::scanDocument()?
     // Only user updates should be checked. Any system or replication stuff should pass through.
@@ -178,6 +180,11 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
     const bool isInsert = false;
     FieldRefSet immutablePaths;
 
+    // Modifier-style updates report every path they modify, which allows the collection to skip
+    // regenerating keys for indexes that do not depend on any of those paths.
+    const bool trackModifiedPaths = driver->type() == UpdateDriver::UpdateType::kOperator;
+    FieldRefSetWithStorage modifiedPaths;
+
     if (_isUserInitiatedWrite) {
         // Documents coming directly from users should be validated for storage. It is safe to
         // access the CollectionShardingState in this write context and to throw SSV if the sharding
@@ -198,7 +205,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     } else {
         // If there was a matched field, obtain it.
         MatchDetails matchDetails;
@@ -218,7 +226,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     }
 
     if (!status.isOK()) {
@@ -231,6 +240,9 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
 
     // Ensure _id is first if it exists, and generate a new OID if appropriate.
     _ensureIdFieldIsFirst(&_doc, createIdField);
+    if (trackModifiedPaths && createIdField && !oldObj.value().hasField(idFieldName)) {
+        modifiedPaths.keepShortest(idFieldRef);
+    }
 
     // See if the changes were applied in place
     const char* source = nullptr;
@@ -275,6 +287,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
 
         // Ensure we set the type correctly
         args.source = writeToOrphan ? OperationSource::kFromMigrate : request->source();
+        args.modifiedPaths = trackModifiedPaths ? &modifiedPaths : nullptr;
 
         if (inPlace) {
             if (!request->explain()) {
@@ -600,7 +613,7 @@ void UpdateStage::doRestoreStateRequiresCollection() {
 
 unique_ptr<PlanStageStats> UpdateStage::getStats() {
     _commonStats.isEOF = isEOF();
-    unique_ptr<PlanStageStats> ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_UPDATE);
+    unique_ptr<PlanStageStats> ret = std::make_unique<PlanStageStats>(_commonStats, stageType());
     ret->specific = std::make_unique<UpdateStats>(_specificStats);
     ret->children.emplace_back(child()->getStats());
     return ret;
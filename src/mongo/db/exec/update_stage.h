@@ -107,7 +107,7 @@ public:
     bool isEOF() override;
     StageState doWork(WorkingSetID* out) override;
 
-    StageType stageType() const final {
+    StageType stageType() const override {
         return STAGE_UPDATE;
     }
 
@@ -120,7 +120,8 @@ public:
     }
 
 protected:
-    UpdateStage(ExpressionContext* expCtx,
+    UpdateStage(const char* stageType,
+                ExpressionContext* expCtx,
                 const UpdateStageParams& params,
                 WorkingSet* ws,
                 const CollectionPtr& collection);
@@ -154,7 +155,6 @@ protected:
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
 
-private:
     /**
      * Computes the result of applying mods to the document 'oldObj' at RecordId 'recordId' in
      * memory, then commits these changes to the database. Returns a possibly unowned copy
@@ -164,6 +164,33 @@ private:
                                RecordId& recordId,
                                bool writeOnOrphan);
 
+    // If the update was in-place, we may see it again.  This only matters if we're doing
+    // a multi-update; if we're not doing a multi-update we stop after one update and we
+    // won't see any more docs.
+    //
+    // For example: If we're scanning an index {x:1} and performing {$inc:{x:5}}, we'll keep
+    // moving the document forward and it will continue to reappear in our index scan.
+    // Unless the index is multikey, the underlying query machinery won't de-dup.
+    //
+    // If the update wasn't in-place we may see it again.  Our query may return the new
+    // document and we wouldn't want to update that.
+    //
+    // So, no matter what, we keep track of where the doc wound up.
+    typedef stdx::unordered_set<RecordId, RecordId::Hasher> RecordIdSet;
+    const std::unique_ptr<RecordIdSet> _updatedRecordIds;
+
+    /**
+     * This member is used to check whether the write should be performed, and if so, any other
+     * behavior that should be done as part of the write (e.g. skipping it because it affects an
+     * orphan document). A yield cannot happen between the check and the write, so the checks are
+     * embedded in the stage.
+     *
+     * It's refreshed after yielding and reacquiring the locks.
+     */
+    write_stage_common::PreWriteFilter _preWriteFilter;
+
+private:
+
     /**
      * Stores 'idToRetry' in '_idRetrying' so the update can be retried during the next call to
      * doWork(). Always returns NEED_YIELD and sets 'out' to WorkingSet::INVALID_ID.
@@ -207,31 +234,6 @@ private:
 
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
-
-    // If the update was in-place, we may see it again.  This only matters if we're doing
-    // a multi-update; if we're not doing a multi-update we stop after one update and we
-    // won't see any more docs.
-    //
-    // For example: If we're scanning an index {x:1} and performing {$inc:{x:5}}, we'll keep
-    // moving the document forward and it will continue to reappear in our index scan.
-    // Unless the index is multikey, the underlying query machinery won't de-dup.
-    //
-    // If the update wasn't in-place we may see it again.  Our query may return the new
-    // document and we wouldn't want to update that.
-    //
-    // So, no matter what, we keep track of where the doc wound up.
-    typedef stdx::unordered_set<RecordId, RecordId::Hasher> RecordIdSet;
-    const std::unique_ptr<RecordIdSet> _updatedRecordIds;
-
-    /**
-     * This member is used to check whether the write should be performed, and if so, any other
-     * behavior that should be done as part of the write (e.g. skipping it because it affects an
-     * orphan document). A yield cannot happen between the check and the write, so the checks are
-     * embedded in the stage.
-     *
-     * It's refreshed after yielding and reacquiring the locks.
-     */
-    write_stage_common::PreWriteFilter _preWriteFilter;
 };
 
 }  // namespace mongo
@@ -78,7 +78,19 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
     // state appropriately.
     invariant(member->hasRecordId());
 
-    auto record = cursor->seekExact(member->recordId);
+    return fetch(opCtx, workingSet, id, cursor->seekExact(member->recordId), collection, ns);
+}
+
+// static
+bool WorkingSetCommon::fetch(OperationContext* opCtx,
+                             WorkingSet* workingSet,
+                             WorkingSetID id,
+                             boost::optional<Record> record,
+                             const CollectionPtr& collection,
+                             const NamespaceString& ns) {
+    WorkingSetMember* member = workingSet->get(id);
+    invariant(member->hasRecordId());
+
     if (!record) {
         // The record referenced by this index entry is gone. If the query yielded some time after
         // we first examined the index entry, then it's likely that the record was deleted while we
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/namespace_string.h"
 
@@ -37,6 +39,7 @@ namespace mongo {
 class CollectionPtr;
 class OperationContext;
 class SeekableRecordCursor;
+struct Record;
 
 class WorkingSetCommon {
 public:
@@ -55,6 +58,18 @@ public:
                       SeekableRecordCursor* cursor,
                       const CollectionPtr& collection,
                       const NamespaceString& ns);
+
+    /**
+     * Same as above, using a 'record' the caller already looked up for the member's RecordId, for
+     * example with SeekableRecordCursor::seekExactBatch(). 'record' is boost::none if there is no
+     * record with that RecordId.
+     */
+    static bool fetch(OperationContext* opCtx,
+                      WorkingSet* workingSet,
+                      WorkingSetID id,
+                      boost::optional<Record> record,
+                      const CollectionPtr& collection,
+                      const NamespaceString& ns);
 };
 
 }  // namespace mongo
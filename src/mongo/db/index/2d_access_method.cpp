@@ -64,7 +64,8 @@ void TwoDAccessMethod::doGetKeys(OperationContext* opCtx,
                                  KeyStringSet* keys,
                                  KeyStringSet* multikeyMetadataKeys,
                                  MultikeyPaths* multikeyPaths,
-                                 boost::optional<RecordId> id) const {
+                                 boost::optional<RecordId> id,
+                                 const ExtractedKeyPaths* extractedKeyPaths) const {
     ExpressionKeysPrivate::get2DKeys(pooledBufferBuilder,
                                      obj,
                                      _params,
@@ -70,7 +70,8 @@ private:
                    KeyStringSet* keys,
                    KeyStringSet* multikeyMetadataKeys,
                    MultikeyPaths* multikeyPaths,
-                   boost::optional<RecordId> id) const final;
+                   boost::optional<RecordId> id,
+                   const ExtractedKeyPaths* extractedKeyPaths) const final;
 
     TwoDIndexingParams _params;
 };
@@ -80,10 +80,15 @@ void BtreeAccessMethod::doGetKeys(OperationContext* opCtx,
                                   KeyStringSet* keys,
                                   KeyStringSet* multikeyMetadataKeys,
                                   MultikeyPaths* multikeyPaths,
-                                  boost::optional<RecordId> id) const {
+                                  boost::optional<RecordId> id,
+                                  const ExtractedKeyPaths* extractedKeyPaths) const {
     const auto skipMultikey = context == GetKeysContext::kValidatingKeys &&
         !_descriptor->getEntry()->isMultikey(opCtx, collection);
-    _keyGenerator->getKeys(pooledBufferBuilder, obj, skipMultikey, keys, multikeyPaths, id);
+    const ExtractedKeyPath* extractedPaths = extractedKeyPaths
+        ? extractedKeyPaths->forIndex(_descriptor->indexName(), _descriptor->keyPattern())
+        : nullptr;
+    _keyGenerator->getKeys(
+        pooledBufferBuilder, obj, skipMultikey, keys, multikeyPaths, id, extractedPaths);
 }
 
 }  // namespace mongo
@@ -209,10 +209,11 @@ void BtreeKeyGenerator::getKeys(SharedBufferFragmentBuilder& pooledBufferBuilder
                                 bool skipMultikey,
                                 KeyStringSet* keys,
                                 MultikeyPaths* multikeyPaths,
-                                boost::optional<RecordId> id) const {
+                                boost::optional<RecordId> id,
+                                const ExtractedKeyPath* extractedPaths) const {
     if (_isIdIndex) {
         // we special case for speed
-        BSONElement e = obj["_id"];
+        BSONElement e = extractedPaths ? extractedPaths[0].element : obj["_id"];
         if (e.eoo()) {
             keys->insert(_nullKeyString);
         } else {
@@ -245,7 +246,7 @@ void BtreeKeyGenerator::getKeys(SharedBufferFragmentBuilder& pooledBufferBuilder
             invariant(multikeyPaths->empty());
             multikeyPaths->resize(_fieldNames.size());
         }
-        _getKeysWithoutArray(pooledBufferBuilder, obj, id, keys);
+        _getKeysWithoutArray(pooledBufferBuilder, obj, id, keys, extractedPaths);
     } else {
         if (multikeyPaths) {
             invariant(multikeyPaths->empty());
@@ -265,7 +266,8 @@ void BtreeKeyGenerator::getKeys(SharedBufferFragmentBuilder& pooledBufferBuilder
                           0,
                           _emptyPositionalInfo,
                           multikeyPaths,
-                          id);
+                          id,
+                          extractedPaths);
         // Put the sequence back into the set, it will sort and guarantee uniqueness, this is
         // O(NlogN)
         keys->adopt_sequence(std::move(seq));
@@ -309,13 +311,20 @@ size_t BtreeKeyGenerator::PositionalPathInfo::getApproximateSize() const {
 void BtreeKeyGenerator::_getKeysWithoutArray(SharedBufferFragmentBuilder& pooledBufferBuilder,
                                              const BSONObj& obj,
                                              boost::optional<RecordId> id,
-                                             KeyStringSet* keys) const {
+                                             KeyStringSet* keys,
+                                             const ExtractedKeyPath* extractedPaths) const {
 
     KeyString::PooledBuilder keyString{pooledBufferBuilder, _keyStringVersion, _ordering};
     size_t numNotFound{0};
 
-    for (auto&& fieldName : _fieldNames) {
-        auto elem = extractNonArrayElementAtPath(obj, fieldName);
+    for (size_t i = 0; i < _fieldNames.size(); ++i) {
+        BSONElement elem;
+        if (extractedPaths) {
+            elem = extractedPaths[i].element;
+            invariant(elem.type() != BSONType::Array);
+        } else {
+            elem = extractNonArrayElementAtPath(obj, _fieldNames[i]);
+        }
         if (elem.eoo()) {
             ++numNotFound;
         }
@@ -347,7 +356,8 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*>* fieldNames,
                                           unsigned numNotFound,
                                           const std::vector<PositionalPathInfo>& positionalInfo,
                                           MultikeyPaths* multikeyPaths,
-                                          boost::optional<RecordId> id) const {
+                                          boost::optional<RecordId> id,
+                                          const ExtractedKeyPath* extractedPaths) const {
     BSONElement arrElt;
 
     // A set containing the position of any indexed fields in the key pattern that traverse through
@@ -382,10 +392,17 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*>* fieldNames,
             continue;
         }
 
-        bool arrayNestedArray;
-        // Extract element matching fieldName[ i ] from object xor array.
-        BSONElement e =
-            _extractNextElement(obj, positionalInfo[i], &(*fieldNames)[i], &arrayNestedArray);
+        bool arrayNestedArray = false;
+        BSONElement e;
+        if (extractedPaths) {
+            // The path was already traversed from the root of the document, which cannot hold a
+            // positionally indexed element.
+            e = extractedPaths[i].element;
+            (*fieldNames)[i] = extractedPaths[i].remainingPath;
+        } else {
+            // Extract element matching fieldName[ i ] from object xor array.
+            e = _extractNextElement(obj, positionalInfo[i], &(*fieldNames)[i], &arrayNestedArray);
+        }
 
         if (e.eoo()) {
             // if field not present, set to null
@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobj_comparator_interface.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/multikey_paths.h"
+#include "mongo/db/index/shared_key_path_extractor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/storage/key_string.h"
 
@@ -74,13 +75,19 @@ public:
      * 'true' to be able to use an optimized algorithm for the index key generation. Otherwise,
      * this parameter must be set to 'false'. In this case a generic algorithm will be used, which
      * can handle both multikey and non-multikey indexes.
+     *
+     * If 'extractedPaths' is non-null, it must hold the result of traversing each field of the key
+     * pattern from the root of 'obj', in key pattern order, as produced by a
+     * SharedKeyPathExtractor. The key generator then starts from those elements instead of
+     * traversing 'obj' again.
      */
     void getKeys(SharedBufferFragmentBuilder& pooledBufferBuilder,
                  const BSONObj& obj,
                  bool skipMultikey,
                  KeyStringSet* keys,
                  MultikeyPaths* multikeyPaths,
-                 boost::optional<RecordId> id = boost::none) const;
+                 boost::optional<RecordId> id = boost::none,
+                 const ExtractedKeyPath* extractedPaths = nullptr) const;
 
     size_t getApproximateSize() const;
 
@@ -143,6 +150,10 @@ private:
     /**
      * This recursive method does the heavy-lifting for getKeys().
      * It will modify 'fieldNames' and 'fixed'.
+     *
+     * If 'extractedPaths' is non-null, then 'obj' is the root of the document and the first element
+     * of each path is taken from 'extractedPaths' rather than from 'obj'. Recursive calls always
+     * pass null.
      */
     void _getKeysWithArray(std::vector<const char*>* fieldNames,
                            std::vector<BSONElement>* fixed,
@@ -152,7 +163,8 @@ private:
                            unsigned numNotFound,
                            const std::vector<PositionalPathInfo>& positionalInfo,
                            MultikeyPaths* multikeyPaths,
-                           boost::optional<RecordId> id) const;
+                           boost::optional<RecordId> id,
+                           const ExtractedKeyPath* extractedPaths = nullptr) const;
 
     /**
      * An optimized version of the key generation algorithm to be used when it is known that 'obj'
@@ -161,7 +173,8 @@ private:
     void _getKeysWithoutArray(SharedBufferFragmentBuilder& pooledBufferBuilder,
                               const BSONObj& obj,
                               boost::optional<RecordId> id,
-                              KeyStringSet* keys) const;
+                              KeyStringSet* keys,
+                              const ExtractedKeyPath* extractedPaths) const;
 
     /**
      * A call to _getKeysWithArray() begins by calling this for each field in the key pattern. It
@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/index/btree_key_generator.h"
+#include "mongo/db/index/shared_key_path_extractor.h"
 
 #include <algorithm>
 #include <iostream>
@@ -123,7 +124,18 @@ bool testKeygen(const BSONObj& kp,
                                                       KeyString::Version::kLatestVersion,
                                                       Ordering::make(BSONObj()));
 
-    auto runTest = [&](bool skipMultikey) {
+    //
+    // Traverse the paths of 'kp' together with those of another index whose paths overlap with
+    // them, as is done when a collection has several indexes.
+    //
+    SharedKeyPathExtractor extractor(
+        {{"test", kp}, {"other", fromjson("{'a.b.c': 1, 'a.z': 1, b: 1}")}});
+    ExtractedKeyPaths extractedKeyPaths;
+    extractor.extract(obj, &extractedKeyPaths);
+    const ExtractedKeyPath* extractedPaths = extractedKeyPaths.forIndex("test", kp);
+    invariant(extractedPaths);
+
+    auto runTest = [&](bool skipMultikey, bool useExtractedPaths) {
         //
         // Ask 'keyGen' to generate index keys for the object 'obj' and report any prefixes of the
         // indexed fields that would cause the index to be multikey as a result of inserting
@@ -132,7 +144,13 @@ bool testKeygen(const BSONObj& kp,
         SharedBufferFragmentBuilder allocator(BufBuilder::kDefaultInitSizeBytes);
         KeyStringSet actualKeys;
         MultikeyPaths actualMultikeyPaths;
-        keyGen->getKeys(allocator, obj, skipMultikey, &actualKeys, &actualMultikeyPaths);
+        keyGen->getKeys(allocator,
+                        obj,
+                        skipMultikey,
+                        &actualKeys,
+                        &actualMultikeyPaths,
+                        boost::none,
+                        useExtractedPaths ? extractedPaths : nullptr);
 
         //
         // Check that the results match the expected result.
@@ -167,13 +185,13 @@ bool testKeygen(const BSONObj& kp,
         std::all_of(expectedMultikeyPaths.begin(),
                     expectedMultikeyPaths.end(),
                     [](const auto& path) { return path.empty(); })) {
-        if (!runTest(true)) {
+        if (!runTest(true, false) || !runTest(true, true)) {
             return false;
         }
     }
 
     // Test that fully general key generation path works as expected.
-    return runTest(false);
+    return runTest(false, false) && runTest(false, true);
 }
 
 //
@@ -1421,4 +1439,44 @@ TEST(BtreeKeyGeneratorTest, GetCollationAwareKeysFromNestedArray) {
         testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, false, &collator));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromFirstOfDuplicateFields) {
+    BSONObj keyPattern = fromjson("{'a.b': 1}");
+    BSONObj genKeysFrom = BSON("a" << BSON("b" << 1 << "b" << 2) << "a" << BSON("b" << 3));
+    KeyString::HeapBuilder keyString(
+        KeyString::Version::kLatestVersion, fromjson("{'': 1}"), Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString.release()};
+    MultikeyPaths expectedMultikeyPaths{MultikeyComponents{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(SharedKeyPathExtractorTest, ForIndexRequiresMatchingKeyPattern) {
+    SharedKeyPathExtractor extractor({{"a_1", fromjson("{a: 1}")}, {"b_1", fromjson("{b: 1}")}});
+    ExtractedKeyPaths extractedKeyPaths;
+    extractor.extract(fromjson("{a: 1, b: 2}"), &extractedKeyPaths);
+
+    ASSERT(extractedKeyPaths.forIndex("a_1", fromjson("{a: 1}")));
+    ASSERT_FALSE(extractedKeyPaths.forIndex("a_1", fromjson("{a: -1}")));
+    ASSERT_FALSE(extractedKeyPaths.forIndex("c_1", fromjson("{c: 1}")));
+    ASSERT_EQ(2, extractedKeyPaths.forIndex("b_1", fromjson("{b: 1}"))->element.numberInt());
+}
+
+TEST(SharedKeyPathExtractorTest, StopsAtArrayAlongPath) {
+    SharedKeyPathExtractor extractor(
+        {{"ab_1", fromjson("{'a.b': 1}")}, {"a_1_ac_1", fromjson("{a: 1, 'a.c.d': 1}")}});
+    ExtractedKeyPaths extractedKeyPaths;
+    BSONObj obj = fromjson("{a: {c: [{d: 1}]}}");
+    extractor.extract(obj, &extractedKeyPaths);
+
+    // 'a.b' does not exist.
+    auto ab = extractedKeyPaths.forIndex("ab_1", fromjson("{'a.b': 1}"));
+    ASSERT(ab->element.eoo());
+
+    // 'a' ends at the embedded object, while 'a.c.d' stops at the array 'a.c' with "d" left to
+    // traverse.
+    auto acd = extractedKeyPaths.forIndex("a_1_ac_1", fromjson("{a: 1, 'a.c.d': 1}"));
+    ASSERT_EQ(Object, acd[0].element.type());
+    ASSERT_EQ(Array, acd[1].element.type());
+    ASSERT_EQ("d"_sd, StringData(acd[1].remainingPath));
+}
+
 }  // namespace
@@ -47,7 +47,8 @@ void FTSAccessMethod::doGetKeys(OperationContext* opCtx,
                                 KeyStringSet* keys,
                                 KeyStringSet* multikeyMetadataKeys,
                                 MultikeyPaths* multikeyPaths,
-                                boost::optional<RecordId> id) const {
+                                boost::optional<RecordId> id,
+                                const ExtractedKeyPaths* extractedKeyPaths) const {
     ExpressionKeysPrivate::getFTSKeys(pooledBufferBuilder,
                                       obj,
                                       _ftsSpec,
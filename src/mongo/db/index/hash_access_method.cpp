@@ -63,7 +63,8 @@ void HashAccessMethod::doGetKeys(OperationContext* opCtx,
                                  KeyStringSet* keys,
                                  KeyStringSet* multikeyMetadataKeys,
                                  MultikeyPaths* multikeyPaths,
-                                 boost::optional<RecordId> id) const {
+                                 boost::optional<RecordId> id,
+                                 const ExtractedKeyPaths* extractedKeyPaths) const {
     ExpressionKeysPrivate::getHashKeys(pooledBufferBuilder,
                                        obj,
                                        _keyPattern,
@@ -47,11 +47,14 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/storage/execution_context.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
@@ -70,6 +73,11 @@ MONGO_FAIL_POINT_DEFINE(hangDuringIndexBuildBulkLoadYieldSecond);
 
 namespace {
 
+// Limits on the blocks of sorted keys handed to the SortedDataBuilderInterface in one
+// WriteUnitOfWork by BulkBuilderImpl::commit().
+constexpr size_t kBulkLoadBlockMaxKeys = 1000;
+constexpr size_t kBulkLoadBlockMaxBytes = 256 * 1024;
+
 /**
  * Returns true if at least one prefix of any of the indexed fields causes the index to be
  * multikey, and returns false otherwise. This function returns false if the 'multikeyPaths'
@@ -82,11 +90,19 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
 }
 
 SortOptions makeSortOptions(size_t maxMemoryUsageBytes, StringData dbName) {
+    // Resumable index builds persist their spill files and the ranges written to them across
+    // restarts, so keys are only prefix-compressed once the node can no longer be downgraded to a
+    // version which cannot read them.
+    const auto& fcv = serverGlobalParams.featureCompatibility;
+    const bool prefixCompressKeys =
+        fcv.isVersionInitialized() && feature_flags::gSorterPrefixCompressedKeys.isEnabled(fcv);
+
     return SortOptions()
         .TempDir(storageGlobalParams.dbpath + "/_tmp")
         .ExtSortAllowed()
         .MaxMemoryUsageBytes(maxMemoryUsageBytes)
-        .DBName(dbName.toString());
+        .DBName(dbName.toString())
+        .PrefixCompressKeys(prefixCompressKeys);
 }
 
 MultikeyPaths createMultikeyPaths(const std::vector<MultikeyPath>& multikeyPathsVec) {
@@ -123,6 +139,11 @@ Status SortedDataIndexAccessMethod::insert(OperationContext* opCtx,
                                            const std::vector<BsonRecord>& bsonRecords,
                                            const InsertDeleteOptions& options,
                                            int64_t* numInserted) {
+    if (bsonRecords.size() > 1 && !_indexCatalogEntry->isHybridBuilding() &&
+        gIndexBatchedKeyInsertion.load()) {
+        return _insertBatched(opCtx, pooledBuilder, coll, bsonRecords, options, numInserted);
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -146,7 +167,9 @@ Status SortedDataIndexAccessMethod::insert(OperationContext* opCtx,
                 keys.get(),
                 multikeyMetadataKeys.get(),
                 multikeyPaths.get(),
-                bsonRecord.id);
+                bsonRecord.id,
+                nullptr,
+                bsonRecord.extractedKeyPaths);
 
         Status status = _indexKeysOrWriteToSideTable(opCtx,
                                                      coll,
@@ -164,6 +187,94 @@ Status SortedDataIndexAccessMethod::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status SortedDataIndexAccessMethod::_insertBatched(OperationContext* opCtx,
+                                                   SharedBufferFragmentBuilder& pooledBuilder,
+                                                   const CollectionPtr& coll,
+                                                   const std::vector<BsonRecord>& bsonRecords,
+                                                   const InsertDeleteOptions& options,
+                                                   int64_t* numInserted) {
+    auto& executionCtx = StorageExecutionContext::get(opCtx);
+    auto keys = executionCtx.keys();
+    auto multikeyMetadataKeys = executionCtx.multikeyMetadataKeys();
+    auto multikeyPaths = executionCtx.multikeyPaths();
+
+    auto it = bsonRecords.begin();
+    while (it != bsonRecords.end()) {
+        // Keys must be written under the commit timestamp of the record they point to, so only the
+        // keys of consecutive records sharing a timestamp can be merged into one sorted insertion.
+        // Untimestamped writes, such as those to unreplicated collections, form a single run.
+        const Timestamp ts = it->ts;
+        if (!ts.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(ts);
+            if (!status.isOK())
+                return status;
+        }
+
+        KeyStringSet::sequence_type runKeys;
+        KeyStringSet runMultikeyMetadataKeys;
+        MultikeyPaths runMultikeyPaths;
+        bool shouldMarkMultikey = false;
+        size_t numMultikeyMetadataKeys = 0;
+
+        for (; it != bsonRecords.end() && it->ts == ts; ++it) {
+            invariant(it->id != RecordId());
+
+            getKeys(opCtx,
+                    coll,
+                    pooledBuilder,
+                    *it->docPtr,
+                    options.getKeysMode,
+                    GetKeysContext::kAddingKeys,
+                    keys.get(),
+                    multikeyMetadataKeys.get(),
+                    multikeyPaths.get(),
+                    it->id,
+                    nullptr,
+                    it->extractedKeyPaths);
+
+            // Multikeyness is decided per document, as a single document generating several keys
+            // is what makes an index multikey.
+            shouldMarkMultikey = shouldMarkMultikey ||
+                shouldMarkIndexAsMultikey(keys->size(), *multikeyMetadataKeys, *multikeyPaths);
+            numMultikeyMetadataKeys += multikeyMetadataKeys->size();
+
+            auto docKeys = keys->extract_sequence();
+            runKeys.insert(runKeys.end(),
+                           std::make_move_iterator(docKeys.begin()),
+                           std::make_move_iterator(docKeys.end()));
+            runMultikeyMetadataKeys.insert(multikeyMetadataKeys->begin(),
+                                           multikeyMetadataKeys->end());
+            if (runMultikeyPaths.empty()) {
+                runMultikeyPaths = *multikeyPaths;
+            } else if (!multikeyPaths->empty()) {
+                MultikeyPathTracker::mergeMultikeyPaths(&runMultikeyPaths, *multikeyPaths);
+            }
+
+            keys->clear();
+            multikeyMetadataKeys->clear();
+            multikeyPaths->clear();
+        }
+
+        // Every key embeds its RecordId, so keys from distinct records never collapse here.
+        KeyStringSet sortedKeys;
+        sortedKeys.adopt_sequence(std::move(runKeys));
+
+        int64_t inserted = 0;
+        Status status = insertKeys(opCtx, coll, sortedKeys, options, nullptr, &inserted);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (shouldMarkMultikey) {
+            _indexCatalogEntry->setMultikey(opCtx, coll, runMultikeyMetadataKeys, runMultikeyPaths);
+        }
+        if (numInserted) {
+            *numInserted += inserted + numMultikeyMetadataKeys;
+        }
+    }
+
+    return Status::OK();
+}
+
 void SortedDataIndexAccessMethod::remove(OperationContext* opCtx,
                                          SharedBufferFragmentBuilder& pooledBuilder,
                                          const CollectionPtr& coll,
@@ -843,6 +954,34 @@ Status SortedDataIndexAccessMethod::BulkBuilderImpl::commit(
 
     KeyString::Value previousKey;
 
+    // Keys are added to the builder in blocks to amortize the per-key costs of the builder and of
+    // the surrounding WriteUnitOfWork.
+    std::vector<KeyString::Value> block;
+    block.reserve(kBulkLoadBlockMaxKeys);
+    size_t blockBytes = 0;
+    auto addBlock = [&] {
+        if (block.empty()) {
+            return Status::OK();
+        }
+
+        Status status = writeConflictRetry(opCtx, "addingKeys", ns.ns(), [&] {
+            WriteUnitOfWork wunit(opCtx);
+            Status status = builder->addKeys(block);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            wunit.commit();
+            return Status::OK();
+        });
+
+        // Duplicates are checked before inserting.
+        invariant(status.code() != ErrorCodes::DuplicateKey);
+        block.clear();
+        blockBytes = 0;
+        return status;
+    };
+
     for (int64_t i = 0; it->more(); i++) {
         opCtx->checkForInterrupt();
 
@@ -900,40 +1039,37 @@ Status SortedDataIndexAccessMethod::BulkBuilderImpl::commit(
             continue;
         }
 
-        Status status = writeConflictRetry(opCtx, "addingKey", ns.ns(), [&] {
-            WriteUnitOfWork wunit(opCtx);
-            Status status = builder->addKey(data.first);
-            if (!status.isOK()) {
+        blockBytes += data.first.getSize();
+        block.push_back(data.first);
+        previousKey = data.first;
+
+        const bool yield = yieldIterations && (i + 1) % yieldIterations == 0;
+        if (isDup || yield || block.size() >= kBulkLoadBlockMaxKeys ||
+            blockBytes >= kBulkLoadBlockMaxBytes) {
+            if (auto status = addBlock(); !status.isOK()) {
                 return status;
             }
-
-            wunit.commit();
-            return Status::OK();
-        });
-
-        if (!status.isOK()) {
-            // Duplicates are checked before inserting.
-            invariant(status.code() != ErrorCodes::DuplicateKey);
-            return status;
         }
 
-        previousKey = data.first;
-
         if (isDup) {
-            status = onDuplicateKeyInserted(data.first);
+            Status status = onDuplicateKeyInserted(data.first);
             if (!status.isOK())
                 return status;
         }
 
         // Starts yielding locks after the first non-zero 'yieldIterations' inserts.
-        if (yieldIterations && (i + 1) % yieldIterations == 0) {
+        if (yield) {
             _yield(opCtx, &collection, ns);
         }
 
-        // If we're here either it's a dup and we're cool with it or the addKey went just fine.
+        // If we're here either it's a dup and we're cool with it or the key was added just fine.
         pm.hit();
     }
 
+    if (auto status = addBlock(); !status.isOK()) {
+        return status;
+    }
+
     pm.finished();
 
     LOGV2(20685,
@@ -957,7 +1093,8 @@ void SortedDataIndexAccessMethod::getKeys(OperationContext* opCtx,
                                           KeyStringSet* multikeyMetadataKeys,
                                           MultikeyPaths* multikeyPaths,
                                           boost::optional<RecordId> id,
-                                          OnSuppressedErrorFn&& onSuppressedError) const {
+                                          OnSuppressedErrorFn&& onSuppressedError,
+                                          const ExtractedKeyPaths* extractedKeyPaths) const {
     invariant(!id || _newInterface->rsKeyFormat() != KeyFormat::String || id->isStr(),
               fmt::format("RecordId is not in the same string format as its RecordStore; id: {}",
                           id->toString()));
@@ -975,7 +1112,8 @@ void SortedDataIndexAccessMethod::getKeys(OperationContext* opCtx,
                   keys,
                   multikeyMetadataKeys,
                   multikeyPaths,
-                  id);
+                  id,
+                  extractedKeyPaths);
     } catch (const AssertionException& ex) {
         // Suppress all indexing errors when mode is kRelaxConstraints.
         if (mode == InsertDeleteOptions::ConstraintEnforcementMode::kEnforceConstraints) {
@@ -47,6 +47,7 @@
 namespace mongo {
 
 class BSONObjBuilder;
+class ExtractedKeyPaths;
 class MatchExpression;
 struct UpdateTicket;
 struct InsertDeleteOptions;
@@ -368,6 +369,8 @@ public:
      *
      * If any key generation errors are encountered and suppressed due to the provided GetKeysMode,
      * 'onSuppressedErrorFn' is called.
+     *
+     * 'extractedKeyPaths', if non-null, is passed through to doGetKeys().
      */
     using OnSuppressedErrorFn =
         std::function<void(Status status, const BSONObj& obj, boost::optional<RecordId> loc)>;
@@ -381,7 +384,8 @@ public:
                  KeyStringSet* multikeyMetadataKeys,
                  MultikeyPaths* multikeyPaths,
                  boost::optional<RecordId> id,
-                 OnSuppressedErrorFn&& onSuppressedError = nullptr) const;
+                 OnSuppressedErrorFn&& onSuppressedError = nullptr,
+                 const ExtractedKeyPaths* extractedKeyPaths = nullptr) const;
 
     /**
      * Inserts the specified keys into the index. Does not attempt to determine whether the
@@ -558,6 +562,10 @@ protected:
      * BSONObjSet with any multikey metadata keys generated while processing the document. These
      * keys are not associated with the document itself, but instead represent multi-key path
      * information that must be stored in a reserved keyspace within the index.
+     *
+     * If 'extractedKeyPaths' is non-null, it holds the paths of 'obj' already traversed on behalf
+     * of several indexes of the collection, which implementations may use instead of traversing
+     * 'obj' again.
      */
     virtual void doGetKeys(OperationContext* opCtx,
                            const CollectionPtr& collection,
@@ -567,7 +575,8 @@ protected:
                            KeyStringSet* keys,
                            KeyStringSet* multikeyMetadataKeys,
                            MultikeyPaths* multikeyPaths,
-                           boost::optional<RecordId> id) const = 0;
+                           boost::optional<RecordId> id,
+                           const ExtractedKeyPaths* extractedKeyPaths) const = 0;
 
     const IndexCatalogEntry* const _indexCatalogEntry;  // owned by IndexCatalog
     const IndexDescriptor* const _descriptor;
@@ -591,6 +600,20 @@ private:
                                const KeyString::Value& dataKey,
                                const RecordIdHandlerFn& onDuplicateRecord);
 
+    /**
+     * Inserts the keys of 'bsonRecords' into the index one run of records sharing a commit
+     * timestamp at a time. The keys of every record in a run are generated up front and inserted
+     * in sorted order, and the index is marked multikey at most once per run.
+     *
+     * Must not be used while the index is being built with side writes.
+     */
+    Status _insertBatched(OperationContext* opCtx,
+                          SharedBufferFragmentBuilder& pooledBuilder,
+                          const CollectionPtr& coll,
+                          const std::vector<BsonRecord>& bsonRecords,
+                          const InsertDeleteOptions& options,
+                          int64_t* numInserted);
+
     Status _indexKeysOrWriteToSideTable(OperationContext* opCtx,
                                         const CollectionPtr& coll,
                                         const KeyStringSet& keys,
@@ -34,6 +34,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/index/btree_key_generator.h"
+#include "mongo/db/index/shared_key_path_extractor.h"
 
 namespace mongo {
 namespace {
@@ -165,6 +166,91 @@ void BM_KeyGenArrayOfArray(benchmark::State& state, int32_t elements) {
     }
 }
 
+/**
+ * Generates keys for 'numIndexes' compound indexes over a wide document whose fields are nested
+ * in 'numLevels' levels of embedded documents. All indexes share the leading field of their key
+ * patterns, as is common for collections indexed on e.g. a tenant or a timestamp. When
+ * 'sharedTraversal' is true the indexed paths are traversed once per document for all indexes,
+ * as done on insert, rather than once per index.
+ */
+void BM_KeyGenMultiIndex(benchmark::State& state, bool sharedTraversal) {
+    const int numIndexes = state.range(0);
+    const int numLevels = state.range(1);
+    constexpr int kNumFields = 32;
+
+    // Build {f0: 0, ..., f31: 31, s: {f0: 0, ..., f31: 31, s: {...}}}.
+    BSONObj obj;
+    for (int level = 0; level < numLevels; ++level) {
+        BSONObjBuilder builder;
+        for (int i = 0; i < kNumFields; ++i) {
+            builder.append("f" + std::to_string(i), i);
+        }
+        if (!obj.isEmpty()) {
+            builder.append("s", obj);
+        }
+        obj = builder.obj();
+    }
+
+    std::string prefix;
+    for (int level = 1; level < numLevels; ++level) {
+        prefix += "s.";
+    }
+
+    std::vector<std::pair<std::string, BSONObj>> indexes;
+    std::vector<std::unique_ptr<BtreeKeyGenerator>> generators;
+    for (int i = 0; i < numIndexes; ++i) {
+        BSONObjBuilder keyPattern;
+        keyPattern.append(prefix + "f0", 1);
+        keyPattern.append(prefix + "f" + std::to_string(1 + i % (kNumFields / 2 - 1)), 1);
+        keyPattern.append("f" + std::to_string(kNumFields / 2 + i % (kNumFields / 2)), 1);
+        BSONObj keyPatternObj = keyPattern.obj();
+
+        std::vector<const char*> fieldNames;
+        std::vector<BSONElement> fixed;
+        for (auto&& elem : keyPatternObj) {
+            fieldNames.push_back(elem.fieldName());
+            fixed.push_back(BSONElement{});
+        }
+        indexes.emplace_back("index" + std::to_string(i), keyPatternObj);
+        generators.push_back(
+            std::make_unique<BtreeKeyGenerator>(fieldNames,
+                                                fixed,
+                                                false,
+                                                nullptr,
+                                                KeyString::Version::kLatestVersion,
+                                                Ordering::make(keyPatternObj)));
+    }
+
+    SharedKeyPathExtractor extractor(indexes);
+    ExtractedKeyPaths extractedKeyPaths;
+
+    SharedBufferFragmentBuilder allocator(kMemBlockSize,
+                                          SharedBufferFragmentBuilder::ConstantGrowStrategy());
+    KeyStringSet keys;
+    MultikeyPaths multikeyPaths;
+
+    for (auto _ : state) {
+        if (sharedTraversal) {
+            extractor.extract(obj, &extractedKeyPaths);
+        }
+        for (int i = 0; i < numIndexes; ++i) {
+            generators[i]->getKeys(
+                allocator,
+                obj,
+                true,
+                &keys,
+                &multikeyPaths,
+                boost::none,
+                sharedTraversal
+                    ? extractedKeyPaths.forIndex(indexes[i].first, indexes[i].second)
+                    : nullptr);
+            benchmark::ClobberMemory();
+            keys.clear();
+            multikeyPaths.clear();
+        }
+    }
+}
+
 BENCHMARK_CAPTURE(BM_KeyGenBasic, Generic, false);
 BENCHMARK_CAPTURE(BM_KeyGenBasic, SkipMultikey, true);
 
@@ -180,5 +266,16 @@ BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 10x10, 10);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 100x100, 100);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 1Kx1K, 1000);
 
+BENCHMARK_CAPTURE(BM_KeyGenMultiIndex, PerIndex, false)
+    ->Args({2, 1})
+    ->Args({8, 1})
+    ->Args({8, 3})
+    ->Args({32, 3});
+BENCHMARK_CAPTURE(BM_KeyGenMultiIndex, SharedTraversal, true)
+    ->Args({2, 1})
+    ->Args({8, 1})
+    ->Args({8, 3})
+    ->Args({32, 3});
+
 }  // namespace
 }  // namespace mongo
@@ -123,7 +123,8 @@ void S2BucketAccessMethod::doGetKeys(OperationContext* opCtx,
                                      KeyStringSet* keys,
                                      KeyStringSet* multikeyMetadataKeys,
                                      MultikeyPaths* multikeyPaths,
-                                     boost::optional<RecordId> id) const {
+                                     boost::optional<RecordId> id,
+                                     const ExtractedKeyPaths* extractedKeyPaths) const {
     ExpressionKeysPrivate::getS2Keys(pooledBufferBuilder,
                                      obj,
                                      _descriptor->keyPattern(),
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/shared_key_path_extractor.h"
+
+#include <boost/container/small_vector.hpp>
+#include <cstring>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+SharedKeyPathExtractor::SharedKeyPathExtractor(
+    const std::vector<std::pair<std::string, BSONObj>>& indexes) {
+    _nodes.emplace_back();
+
+    for (const auto& [indexName, keyPattern] : indexes) {
+        IndexInfo info{keyPattern.getOwned(), _numSlots};
+        for (auto&& elem : info.keyPattern) {
+            _addPath(elem.fieldName(), _numSlots++);
+        }
+        bool inserted = _indexes.emplace(indexName, std::move(info)).second;
+        invariant(inserted);
+    }
+}
+
+void SharedKeyPathExtractor::_addPath(const char* path, size_t slot) {
+    size_t nodeIdx = 0;
+    const char* component = path;
+    while (true) {
+        const char* dot = strchr(component, '.');
+        nodeIdx = _findOrAddChild(nodeIdx,
+                                  dot ? StringData(component, dot - component)
+                                      : StringData(component));
+        if (!dot) {
+            _nodes[nodeIdx].terminalSlots.push_back(slot);
+            return;
+        }
+        _nodes[nodeIdx].continuingSlots.emplace_back(slot, dot + 1);
+        component = dot + 1;
+    }
+}
+
+size_t SharedKeyPathExtractor::_findOrAddChild(size_t parent, StringData fieldName) {
+    for (auto child : _nodes[parent].children) {
+        if (_nodes[child].fieldName == fieldName) {
+            return child;
+        }
+    }
+
+    // Adding a node may reallocate '_nodes', so no reference to a node is held across this call.
+    _nodes.emplace_back();
+    size_t child = _nodes.size() - 1;
+    _nodes[child].fieldName = fieldName;
+    _nodes[parent].children.push_back(child);
+    return child;
+}
+
+void SharedKeyPathExtractor::extract(const BSONObj& obj, ExtractedKeyPaths* out) const {
+    out->_extractor = this;
+    out->_paths.assign(_numSlots, ExtractedKeyPath{});
+    _extractChildren(_nodes.front(), obj, out->_paths.data());
+}
+
+void SharedKeyPathExtractor::_extractChildren(const Node& node,
+                                              const BSONObj& obj,
+                                              ExtractedKeyPath* out) const {
+    if (node.children.empty()) {
+        return;
+    }
+
+    // Like BSONObj::getField(), only the first field with a given name is considered.
+    boost::container::small_vector<bool, 16> matched(node.children.size(), false);
+    size_t numUnmatched = node.children.size();
+
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < node.children.size(); ++i) {
+            const Node& child = _nodes[node.children[i]];
+            if (!matched[i] && child.fieldName == fieldName) {
+                matched[i] = true;
+                --numUnmatched;
+                _extractAtNode(child, elem, out);
+                break;
+            }
+        }
+        if (numUnmatched == 0) {
+            return;
+        }
+    }
+}
+
+void SharedKeyPathExtractor::_extractAtNode(const Node& node,
+                                            const BSONElement& elem,
+                                            ExtractedKeyPath* out) const {
+    for (auto slot : node.terminalSlots) {
+        out[slot].element = elem;
+    }
+
+    if (elem.type() == Array) {
+        for (const auto& [slot, remainingPath] : node.continuingSlots) {
+            out[slot].element = elem;
+            out[slot].remainingPath = remainingPath;
+        }
+    } else if (elem.type() == Object) {
+        _extractChildren(node, elem.embeddedObject(), out);
+    }
+}
+
+const SharedKeyPathExtractor::IndexInfo* SharedKeyPathExtractor::_findIndex(
+    StringData indexName, const BSONObj& keyPattern) const {
+    auto it = _indexes.find(indexName);
+    if (it == _indexes.end() || !it->second.keyPattern.binaryEqual(keyPattern)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+const ExtractedKeyPath* ExtractedKeyPaths::forIndex(StringData indexName,
+                                                    const BSONObj& keyPattern) const {
+    if (!_extractor) {
+        return nullptr;
+    }
+    auto info = _extractor->_findIndex(indexName, keyPattern);
+    return info ? _paths.data() + info->offset : nullptr;
+}
+
+}  // namespace mongo
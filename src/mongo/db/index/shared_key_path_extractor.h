@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class ExtractedKeyPaths;
+
+/**
+ * The result of traversing an indexed path from the root of a document, as computed by
+ * dotted_path_support::extractElementAtPathOrArrayAlongPath().
+ */
+struct ExtractedKeyPath {
+    // The element at the end of the path, or the first array found along the path. EOO if the path
+    // does not exist in the document.
+    BSONElement element;
+
+    // The part of the path that remains to be traversed inside 'element' when it is an array
+    // found along the path, and the empty string otherwise.
+    const char* remainingPath = "";
+};
+
+/**
+ * Traverses the key pattern paths of several btree indexes of a collection in a single pass over
+ * a document, instead of walking the document once per indexed field.
+ *
+ * The paths of all key patterns are merged into a trie, so a path prefix shared by several
+ * indexed fields, such as "a" for {"a.b": 1} and {"a.c": 1, d: 1}, is looked up once, and the
+ * fields of each embedded object are scanned once for all of its indexed children. The traversal
+ * stops at arrays; expanding them is left to the key generator of each index.
+ *
+ * Immutable once constructed, and therefore safe to share between threads.
+ */
+class SharedKeyPathExtractor {
+public:
+    /**
+     * Builds the trie over the key patterns of the given (index name, key pattern) pairs.
+     */
+    explicit SharedKeyPathExtractor(const std::vector<std::pair<std::string, BSONObj>>& indexes);
+
+    /**
+     * Traverses every indexed path in 'obj' and stores the results in 'out'. The elements in 'out'
+     * point into 'obj', and 'out' must not outlive this extractor.
+     */
+    void extract(const BSONObj& obj, ExtractedKeyPaths* out) const;
+
+    /**
+     * Returns the number of indexes whose paths this extractor traverses.
+     */
+    size_t numIndexes() const {
+        return _indexes.size();
+    }
+
+private:
+    friend class ExtractedKeyPaths;
+
+    struct IndexInfo {
+        // An owned copy of the key pattern. The field names of its elements are the indexed paths.
+        BSONObj keyPattern;
+
+        // The position of the first indexed path of this index among the extracted paths.
+        size_t offset;
+    };
+
+    struct Node {
+        // The path component matched by this node.
+        StringData fieldName;
+
+        // Positions of the child nodes in '_nodes'.
+        std::vector<size_t> children;
+
+        // The slots of the indexed paths which end at this node.
+        std::vector<size_t> terminalSlots;
+
+        // The slots of the indexed paths which continue below this node, along with the remainder
+        // of each path after this node's component.
+        std::vector<std::pair<size_t, const char*>> continuingSlots;
+    };
+
+    void _addPath(const char* path, size_t slot);
+
+    size_t _findOrAddChild(size_t parent, StringData fieldName);
+
+    /**
+     * Matches each child of 'node' against the first field of 'obj' with the same name, in a
+     * single pass over the fields of 'obj'.
+     */
+    void _extractChildren(const Node& node, const BSONObj& obj, ExtractedKeyPath* out) const;
+
+    void _extractAtNode(const Node& node, const BSONElement& elem, ExtractedKeyPath* out) const;
+
+    const IndexInfo* _findIndex(StringData indexName, const BSONObj& keyPattern) const;
+
+    StringMap<IndexInfo> _indexes;
+
+    // The trie of indexed paths. The root is the first node and matches no field name.
+    std::vector<Node> _nodes;
+
+    size_t _numSlots = 0;
+};
+
+/**
+ * The paths of one document traversed by a SharedKeyPathExtractor.
+ */
+class ExtractedKeyPaths {
+public:
+    /**
+     * Returns the traversed paths of the index named 'indexName', one per field of 'keyPattern',
+     * or nullptr if the extractor did not traverse the paths of that index. The key pattern is
+     * checked so that an extractor built for an older version of the index catalog is never
+     * applied to an index whose key pattern differs.
+     */
+    const ExtractedKeyPath* forIndex(StringData indexName, const BSONObj& keyPattern) const;
+
+private:
+    friend class SharedKeyPathExtractor;
+
+    const SharedKeyPathExtractor* _extractor = nullptr;
+    std::vector<ExtractedKeyPath> _paths;
+};
+
+}  // namespace mongo
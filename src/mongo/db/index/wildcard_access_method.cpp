@@ -69,7 +69,8 @@ void WildcardAccessMethod::doGetKeys(OperationContext* opCtx,
                                      KeyStringSet* keys,
                                      KeyStringSet* multikeyMetadataKeys,
                                      MultikeyPaths* multikeyPaths,
-                                     boost::optional<RecordId> id) const {
+                                     boost::optional<RecordId> id,
+                                     const ExtractedKeyPaths* extractedKeyPaths) const {
     _keyGen.generateKeys(pooledBufferBuilder, obj, keys, multikeyMetadataKeys, id);
 }
 }  // namespace mongo
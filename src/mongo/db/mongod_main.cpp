@@ -174,6 +174,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/system_index.h"
+#include "mongo/db/timeseries/bucket_compaction.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/ttl.h"
 #include "mongo/db/user_write_block_mode_op_observer.h"
@@ -738,6 +739,7 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
                 "http://dochub.mongodb.org/core/ttlcollections");
         } else {
             startTTLMonitor(serviceContext);
+            startTimeseriesBucketCompactor(serviceContext);
         }
 
         if (replSettings.usingReplSets() || !gInternalValidateFeaturesAsPrimary) {
@@ -1401,6 +1403,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2(4784928, "Shutting down the TTL monitor");
     shutdownTTLMonitor(serviceContext);
 
+    LOGV2(7803607, "Shutting down the time-series bucket compactor");
+    shutdownTimeseriesBucketCompactor(serviceContext);
+
     LOGV2(6278511, "Shutting down the Change Stream Expired Pre-images Remover");
     shutdownChangeStreamExpiredPreImagesRemover(serviceContext);
 
@@ -56,6 +56,7 @@
 #include "mongo/db/op_observer_util.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/change_stream_pre_image_helpers.h"
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
 #include "mongo/db/pipeline/change_stream_preimage_gen.h"
 #include "mongo/db/read_write_concern_defaults.h"
 #include "mongo/db/repl/image_collection_entry_gen.h"
@@ -632,10 +633,24 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
     const bool inMultiDocumentTransaction =
         txnParticipant && opCtx->writesAreReplicated() && txnParticipant.transactionIsOpen();
 
+    auto& batchedWriteContext = BatchedWriteContext::get(opCtx);
+    const bool inBatchedWrite = batchedWriteContext.writesAreBatched();
+
     ShardingWriteRouter shardingWriteRouter(opCtx, args.nss, Grid::get(opCtx)->catalogCache());
 
     OpTimeBundle opTime;
-    if (inMultiDocumentTransaction) {
+    if (inBatchedWrite) {
+        // Grouped operations cannot carry the 'fromMigrate' flag. See
+        // BatchedUpdateStage::isBatchedUpdateEligible().
+        tassert(7803808,
+                "Orphaned documents cannot be updated in a batched write",
+                args.updateArgs->source != OperationSource::kFromMigrate);
+        auto operation = MutableOplogEntry::makeUpdateOperation(
+            args.nss, args.uuid, args.updateArgs->update, args.updateArgs->criteria);
+        operation.setDestinedRecipient(
+            shardingWriteRouter.getReshardingDestinedRecipient(args.updateArgs->updatedDoc));
+        batchedWriteContext.addBatchedOperation(opCtx, operation);
+    } else if (inMultiDocumentTransaction) {
         const bool inRetryableInternalTransaction =
             isInternalSessionForRetryableWrite(*opCtx->getLogicalSessionId());
 
@@ -2191,6 +2206,10 @@ void OpObserverImpl::_onReplicationRollback(OperationContext* opCtx,
     BucketCatalog::get(opCtx).clear([&timeseriesNamespaces](const NamespaceString& bucketNs) {
         return timeseriesNamespaces.contains(bucketNs);
     });
+
+    // The pre-images written after the stable timestamp were rolled back, so the truncate markers
+    // no longer match the pre-images collection and have to be rebuilt.
+    ChangeStreamPreImagesTruncateMarkers::get(opCtx->getServiceContext()).clear();
 }
 
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer_impl.h"
 #include "mongo/db/op_observer_registry.h"
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
 #include "mongo/db/pipeline/change_stream_preimage_gen.h"
 #include "mongo/db/read_write_concern_defaults.h"
 #include "mongo/db/read_write_concern_defaults_cache_lookup_mock.h"
@@ -2494,6 +2495,57 @@ TEST_F(BatchedWriteOutputsTest, TestApplyOpsGrouping) {
     }
 }
 
+// Verifies updates issued within a grouped WUOW are logged as a single applyOps entry, and may
+// share that entry with deletes.
+TEST_F(BatchedWriteOutputsTest, TestApplyOpsGroupingUpdates) {
+    // Setup.
+    auto opCtxRaii = cc().makeOperationContext();
+    OperationContext* opCtx = opCtxRaii.get();
+    reset(opCtx, NamespaceString::kRsOplogNamespace);
+    auto opObserverRegistry = std::make_unique<OpObserverRegistry>();
+    opObserverRegistry->addObserver(std::make_unique<OpObserverImpl>());
+    opCtx->getServiceContext()->setOpObserver(std::move(opObserverRegistry));
+
+    const auto nDocsToUpdate = 3;
+    {
+        WriteUnitOfWork wuow(opCtx, true /* groupOplogEntries */);
+        AutoGetCollection locks(opCtx, _nss, LockMode::MODE_IX);
+
+        for (int doc = 0; doc < nDocsToUpdate; doc++) {
+            CollectionUpdateArgs updateArgs;
+            updateArgs.criteria = BSON("_id" << doc);
+            updateArgs.update = BSON("$set" << BSON("x" << doc));
+            updateArgs.updatedDoc = BSON("_id" << doc << "x" << doc);
+            OplogUpdateEntryArgs update(&updateArgs, _nss, _uuid);
+            opCtx->getServiceContext()->getOpObserver()->onUpdate(opCtx, update);
+        }
+
+        documentKeyDecoration(opCtx).emplace(BSON("_id" << nDocsToUpdate), boost::none);
+        const OplogDeleteEntryArgs args;
+        opCtx->getServiceContext()->getOpObserver()->onDelete(
+            opCtx, _nss, _uuid, kUninitializedStmtId, args);
+
+        wuow.commit();
+    }
+
+    std::vector<BSONObj> oplogs = getNOplogEntries(opCtx, 1);
+    auto oplogEntryParsed = assertGet(OplogEntry::parse(oplogs.back()));
+    ASSERT(oplogEntryParsed.getCommandType() == OplogEntry::CommandType::kApplyOps);
+    std::vector<repl::OplogEntry> innerEntries;
+    repl::ApplyOps::extractOperationsTo(
+        oplogEntryParsed, oplogEntryParsed.getEntry().toBSON(), &innerEntries);
+    ASSERT_EQ(innerEntries.size(), nDocsToUpdate + 1);
+
+    for (int opIdx = 0; opIdx < nDocsToUpdate; opIdx++) {
+        const auto& innerEntry = innerEntries[opIdx];
+        ASSERT(innerEntry.getOpType() == repl::OpTypeEnum::kUpdate);
+        ASSERT(innerEntry.getNss() == _nss);
+        ASSERT_BSONOBJ_EQ(innerEntry.getObject(), BSON("$set" << BSON("x" << opIdx)));
+        ASSERT_BSONOBJ_EQ(*innerEntry.getObject2(), BSON("_id" << opIdx));
+    }
+    ASSERT(innerEntries.back().getOpType() == repl::OpTypeEnum::kDelete);
+}
+
 // Verifies an empty WUOW doesn't generate an oplog entry.
 TEST_F(BatchedWriteOutputsTest, testEmptyWUOW) {
     // Setup.
@@ -3822,6 +3874,19 @@ TEST_F(OpObserverTest, OnRollbackInvalidatesDefaultRWConcernCache) {
     ASSERT_EQ(Date_t::fromMillisSinceEpoch(5678), *newCachedDefaults.getUpdateWallClockTime());
 }
 
+TEST_F(OpObserverTest, OnRollbackClearsPreImagesTruncateMarkers) {
+    auto& truncateMarkers = ChangeStreamPreImagesTruncateMarkers::get(getServiceContext());
+    truncateMarkers.beginInitialization();
+    truncateMarkers.finishInitialization();
+    ASSERT_TRUE(truncateMarkers.isInitialized());
+
+    auto opCtx = getClient()->makeOperationContext();
+    OpObserverImpl opObserver;
+    OpObserver::RollbackObserverInfo rbInfo;
+    opObserver.onReplicationRollback(opCtx.get(), rbInfo);
+    ASSERT_FALSE(truncateMarkers.isInitialized());
+}
+
 TEST_F(OpObserverTest, OnInsertChecksIfTenantMigrationIsBlockingWrites) {
     auto opCtx = cc().makeOperationContext();
     const std::string kTenantId = "tenantId";
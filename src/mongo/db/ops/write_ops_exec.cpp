@@ -497,14 +497,19 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
 
     if (shouldProceedWithBatchInsert) {
         try {
-            if (!collection->getCollection()->isCapped() && !inTxn && batch.size() > 1) {
+            const auto& coll = collection->getCollection();
+            const bool canBatchIntoCapped =
+                !coll->isCapped() || !coll->getIndexCatalog()->haveAnyIndexes();
+            if (canBatchIntoCapped && !inTxn && batch.size() > 1) {
                 checkCollectionUUIDMismatch(opCtx,
                                             wholeOp.getNamespace(),
                                             collection->getCollection(),
                                             wholeOp.getCollectionUUID());
 
                 // First try doing it all together. If all goes well, this is all we need to do.
-                // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+                // See Collection::_insertDocuments for why we do inserts into indexed capped
+                // collections one-at-a-time. Unindexed capped collections, such as clustered
+                // capped collections without secondary indexes, can take the batched path.
                 lastOpFixer->startingOp();
                 insertDocuments(opCtx,
                                 collection->getCollection(),
@@ -532,7 +537,8 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
     }
 
     // Try to insert the batch one-at-a-time. This path is executed for singular batches,
-    // multi-statement transactions, capped collections, and if we failed all-at-once inserting.
+    // multi-statement transactions, indexed capped collections, and if we failed all-at-once
+    // inserting.
     for (auto it = batch.begin(); it != batch.end(); ++it) {
         globalOpCounters.gotInsert();
         ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
@@ -37,9 +37,11 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/change_stream_options_manager.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
 #include "mongo/db/pipeline/change_stream_preimage_gen.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/record_id_helpers.h"
@@ -102,6 +104,21 @@ boost::optional<Date_t> getPreImageExpirationTime(OperationContext* opCtx, Date_
 
 namespace {
 
+// Statistics of the passes of the periodic expired pre-images removal job.
+Counter64 purgingJobPasses;
+Counter64 purgingJobDocsDeleted;
+Counter64 purgingJobBytesDeleted;
+Counter64 purgingJobTimeElapsedMillis;
+
+ServerStatusMetricField<Counter64> displayPurgingJobPasses(
+    "changeStreamPreImages.purgingJob.totalPass", &purgingJobPasses);
+ServerStatusMetricField<Counter64> displayPurgingJobDocsDeleted(
+    "changeStreamPreImages.purgingJob.docsDeleted", &purgingJobDocsDeleted);
+ServerStatusMetricField<Counter64> displayPurgingJobBytesDeleted(
+    "changeStreamPreImages.purgingJob.bytesDeleted", &purgingJobBytesDeleted);
+ServerStatusMetricField<Counter64> displayPurgingJobTimeElapsedMillis(
+    "changeStreamPreImages.purgingJob.timeElapsedMillis", &purgingJobTimeElapsedMillis);
+
 RecordId toRecordId(ChangeStreamPreImageId id) {
     return record_id_helpers::keyForElem(
         BSON(ChangeStreamPreImage::kIdFieldName << id.toBSON()).firstElement());
@@ -321,45 +338,178 @@ private:
     const boost::optional<Date_t> _preImageExpirationTime;
 };
 
-void deleteExpiredChangeStreamPreImages(Client* client, Date_t currentTimeForTimeBasedExpiration) {
+/**
+ * Builds the truncate markers of the pre-images collection by scanning it.
+ */
+void initializeTruncateMarkers(OperationContext* opCtx,
+                               const CollectionPtr& preImagesColl,
+                               ChangeStreamPreImagesTruncateMarkers& truncateMarkers) {
     const auto startTime = Date_t::now();
-    auto opCtx = client->makeOperationContext();
+    truncateMarkers.beginInitialization();
+
+    auto exec = InternalPlanner::collectionScan(opCtx,
+                                                &preImagesColl,
+                                                PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
+                                                InternalPlanner::Direction::FORWARD);
+    BSONObj preImageObj;
+    RecordId recordId;
+    while (exec->getNext(&preImageObj, &recordId) == PlanExecutor::ADVANCED) {
+        auto preImage =
+            ChangeStreamPreImage::parse(IDLParserErrorContext("pre-image"), preImageObj);
+        truncateMarkers.updateFromScan(preImage.getId().getNsUUID(),
+                                       recordId,
+                                       preImage.getId().getTs(),
+                                       preImage.getOperationTime(),
+                                       preImageObj.objsize());
+    }
 
-    // Acquire intent-exclusive lock on the pre-images collection. Early exit if the collection
-    // doesn't exist.
-    AutoGetCollection autoColl(
-        opCtx.get(), NamespaceString::kChangeStreamPreImagesNamespace, MODE_IX);
-    const auto& preImagesColl = autoColl.getCollection();
-    if (!preImagesColl) {
+    truncateMarkers.finishInitialization();
+    if (!truncateMarkers.isInitialized()) {
+        // The markers were cleared by a rollback while the scan yielded.
         return;
     }
+    LOGV2(7804800,
+          "Initialized the truncate markers of the pre-images collection",
+          "duration"_attr = Date_t::now() - startTime);
+}
 
-    // Do not run the job on secondaries.
-    if (!repl::ReplicationCoordinator::get(opCtx.get())
-             ->canAcceptWritesForDatabase(opCtx.get(), NamespaceString::kAdminDb)) {
-        return;
+/**
+ * Truncates the range [minRecordId, maxRecordId] of the pre-images collection, adjusting the size
+ * of the collection by the given number of records and bytes.
+ */
+void truncatePreImages(OperationContext* opCtx,
+                       const CollectionPtr& preImagesColl,
+                       const RecordId& minRecordId,
+                       const RecordId& maxRecordId,
+                       int64_t records,
+                       int64_t bytes) {
+    writeConflictRetry(opCtx,
+                       "ChangeStreamExpiredPreImagesRemover",
+                       NamespaceString::kChangeStreamPreImagesNamespace.ns(),
+                       [&] {
+                           WriteUnitOfWork wuow(opCtx);
+                           uassertStatusOK(preImagesColl->getRecordStore()->rangeTruncate(
+                               opCtx, minRecordId, maxRecordId, -bytes, -records));
+                           wuow.commit();
+                       });
+}
+
+/**
+ * Scans the pre-images of 'collectionUUID' from the first one and truncates those that have
+ * expired, up to the first pre-image that has not.
+ */
+void truncateExpiredPrefix(OperationContext* opCtx,
+                           const CollectionPtr& preImagesColl,
+                           const UUID& collectionUUID,
+                           Timestamp earliestOplogEntryTimestamp,
+                           boost::optional<Date_t> preImageExpirationTime,
+                           ChangeStreamPreImagesTruncateMarkers& truncateMarkers,
+                           int64_t* docsDeleted,
+                           int64_t* bytesDeleted) {
+    const auto minRecordId = toRecordId(ChangeStreamPreImageId(collectionUUID, Timestamp(), 0));
+    ChangeStreamPreImagesTruncateMarkers::TruncatedPrefix prefix;
+    {
+        auto exec = InternalPlanner::collectionScan(
+            opCtx,
+            &preImagesColl,
+            PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+            InternalPlanner::Direction::FORWARD,
+            boost::none,
+            RecordIdBound(minRecordId),
+            RecordIdBound(toRecordId(ChangeStreamPreImageId(
+                collectionUUID, Timestamp::max(), std::numeric_limits<int64_t>::max()))));
+        BSONObj preImageObj;
+        RecordId recordId;
+        while (exec->getNext(&preImageObj, &recordId) == PlanExecutor::ADVANCED) {
+            auto preImage =
+                ChangeStreamPreImage::parse(IDLParserErrorContext("pre-image"), preImageObj);
+            preImageRemoverInternal::PreImageAttributes attributes{
+                collectionUUID, preImage.getId().getTs(), preImage.getOperationTime()};
+            if (!attributes.isExpiredPreImage(preImageExpirationTime,
+                                              earliestOplogEntryTimestamp)) {
+                prefix.firstRemainingTs = attributes.ts;
+                prefix.firstRemainingOperationTime = attributes.operationTime;
+                break;
+            }
+            prefix.lastRecord = recordId;
+            ++prefix.records;
+            prefix.bytes += preImageObj.objsize();
+        }
     }
 
-    // Get the timestamp of the ealiest oplog entry.
-    const auto currentEarliestOplogEntryTs =
-        repl::StorageInterface::get(client->getServiceContext())
-            ->getEarliestOplogTimestamp(opCtx.get());
+    if (prefix.records > 0) {
+        truncatePreImages(
+            opCtx, preImagesColl, minRecordId, prefix.lastRecord, prefix.records, prefix.bytes);
+    }
+    truncateMarkers.removeTruncatedPrefix(collectionUUID, prefix);
+    *docsDeleted += prefix.records;
+    *bytesDeleted += prefix.bytes;
+}
+
+/**
+ * Truncates the ranges of expired pre-images covered by the truncate markers of the pre-images
+ * collection. Truncates are not replicated: each node keeps its own pre-images and removes them.
+ */
+void truncateExpiredChangeStreamPreImages(OperationContext* opCtx,
+                                          const CollectionPtr& preImagesColl,
+                                          Timestamp earliestOplogEntryTimestamp,
+                                          boost::optional<Date_t> preImageExpirationTime,
+                                          int64_t* docsDeleted,
+                                          int64_t* bytesDeleted) {
+    auto& truncateMarkers = ChangeStreamPreImagesTruncateMarkers::get(opCtx->getServiceContext());
+    if (!truncateMarkers.isInitialized()) {
+        initializeTruncateMarkers(opCtx, preImagesColl, truncateMarkers);
+        if (!truncateMarkers.isInitialized()) {
+            return;
+        }
+    }
 
+    for (const auto& range :
+         truncateMarkers.getExpiredRanges(earliestOplogEntryTimestamp, preImageExpirationTime)) {
+        if (range.numMarkers > 0) {
+            truncatePreImages(
+                opCtx,
+                preImagesColl,
+                toRecordId(ChangeStreamPreImageId(range.collectionUUID, Timestamp(), 0)),
+                range.lastRecord,
+                range.records,
+                range.bytes);
+            truncateMarkers.removeTruncatedMarkers(range);
+            *docsDeleted += range.records;
+            *bytesDeleted += range.bytes;
+        }
+
+        if (range.nextMarkerHasExpiredPrefix) {
+            truncateExpiredPrefix(opCtx,
+                                  preImagesColl,
+                                  range.collectionUUID,
+                                  earliestOplogEntryTimestamp,
+                                  preImageExpirationTime,
+                                  truncateMarkers,
+                                  docsDeleted,
+                                  bytesDeleted);
+        }
+    }
+}
+
+/**
+ * Deletes the expired pre-images from the pre-images collection with replicated deletes.
+ */
+void deleteExpiredChangeStreamPreImages(OperationContext* opCtx,
+                                        const CollectionPtr& preImagesColl,
+                                        Timestamp earliestOplogEntryTimestamp,
+                                        boost::optional<Date_t> preImageExpirationTime,
+                                        int64_t* docsDeleted) {
     const bool isBatchedRemoval = gBatchedExpiredChangeStreamPreImageRemoval.load();
     const bool isMultiDeletesFeatureFlagEnabled =
         feature_flags::gBatchMultiDeletes.isEnabled(serverGlobalParams.featureCompatibility);
-    size_t numberOfRemovals = 0;
 
     ChangeStreamExpiredPreImageIterator expiredPreImages(
-        opCtx.get(),
-        &preImagesColl,
-        currentEarliestOplogEntryTs,
-        ::mongo::preImageRemoverInternal::getPreImageExpirationTime(
-            opCtx.get(), currentTimeForTimeBasedExpiration));
+        opCtx, &preImagesColl, earliestOplogEntryTimestamp, preImageExpirationTime);
 
     for (const auto& collectionRange : expiredPreImages) {
         writeConflictRetry(
-            opCtx.get(),
+            opCtx,
             "ChangeStreamExpiredPreImagesRemover",
             NamespaceString::kChangeStreamPreImagesNamespace.ns(),
             [&] {
@@ -372,7 +522,7 @@ void deleteExpiredChangeStreamPreImages(Client* client, Date_t currentTimeForTim
                 }
 
                 auto exec = InternalPlanner::deleteWithCollectionScan(
-                    opCtx.get(),
+                    opCtx,
                     &preImagesColl,
                     std::move(params),
                     PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
@@ -380,14 +530,77 @@ void deleteExpiredChangeStreamPreImages(Client* client, Date_t currentTimeForTim
                     RecordIdBound(collectionRange.first),
                     RecordIdBound(collectionRange.second),
                     std::move(batchParams));
-                numberOfRemovals += exec->executeDelete();
+                *docsDeleted += exec->executeDelete();
             });
     }
+}
+
+void removeExpiredChangeStreamPreImages(Client* client, Date_t currentTimeForTimeBasedExpiration) {
+    const auto startTime = Date_t::now();
+    auto opCtx = client->makeOperationContext();
+    const bool useTruncates = gTruncateExpiredChangeStreamPreImages.load();
+
+    // Acquire intent-exclusive lock on the pre-images collection. Early exit if the collection
+    // doesn't exist.
+    AutoGetCollection autoColl(
+        opCtx.get(), NamespaceString::kChangeStreamPreImagesNamespace, MODE_IX);
+    const auto& preImagesColl = autoColl.getCollection();
+    auto& truncateMarkers = ChangeStreamPreImagesTruncateMarkers::get(client->getServiceContext());
+    if (!preImagesColl) {
+        truncateMarkers.clear();
+        return;
+    }
+
+    // The markers do not track the pre-images removed by replicated deletes, so they are rebuilt
+    // once truncates are used again.
+    if (!useTruncates) {
+        truncateMarkers.clear();
+    }
+
+    // Expired pre-images are deleted by the primary, unless they are truncated, which every node
+    // does for itself.
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx.get());
+    if (!replCoord->canAcceptWritesForDatabase(opCtx.get(), NamespaceString::kAdminDb) &&
+        !(useTruncates && replCoord->getMemberState().secondary())) {
+        return;
+    }
+
+    // Get the timestamp of the ealiest oplog entry.
+    const auto currentEarliestOplogEntryTs =
+        repl::StorageInterface::get(client->getServiceContext())
+            ->getEarliestOplogTimestamp(opCtx.get());
+    const auto preImageExpirationTime = ::mongo::preImageRemoverInternal::getPreImageExpirationTime(
+        opCtx.get(), currentTimeForTimeBasedExpiration);
+
+    int64_t docsDeleted = 0;
+    int64_t bytesDeleted = 0;
+    if (useTruncates) {
+        truncateExpiredChangeStreamPreImages(opCtx.get(),
+                                             preImagesColl,
+                                             currentEarliestOplogEntryTs,
+                                             preImageExpirationTime,
+                                             &docsDeleted,
+                                             &bytesDeleted);
+    } else {
+        deleteExpiredChangeStreamPreImages(opCtx.get(),
+                                           preImagesColl,
+                                           currentEarliestOplogEntryTs,
+                                           preImageExpirationTime,
+                                           &docsDeleted);
+    }
+
+    const auto jobDuration = Date_t::now() - startTime;
+    purgingJobPasses.increment();
+    purgingJobDocsDeleted.increment(docsDeleted);
+    purgingJobBytesDeleted.increment(bytesDeleted);
+    purgingJobTimeElapsedMillis.increment(durationCount<Milliseconds>(jobDuration));
 
     LOGV2(5869104,
           "Periodic expired pre-images removal job finished executing",
-          "numberOfRemovals"_attr = numberOfRemovals,
-          "jobDuration"_attr = (Date_t::now() - startTime).toString());
+          "numberOfRemovals"_attr = docsDeleted,
+          "bytesRemoved"_attr = bytesDeleted,
+          "usedTruncates"_attr = useTruncates,
+          "jobDuration"_attr = jobDuration.toString());
 }
 
 void performExpiredChangeStreamPreImagesRemovalPass(Client* client) {
@@ -407,7 +620,7 @@ void performExpiredChangeStreamPreImagesRemovalPass(Client* client) {
                 currentTimeForTimeBasedExpiration = currentTimeElem.Date();
             }
         });
-        deleteExpiredChangeStreamPreImages(client, currentTimeForTimeBasedExpiration);
+        removeExpiredChangeStreamPreImages(client, currentTimeForTimeBasedExpiration);
     } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
         LOGV2_WARNING(5869105, "Periodic expired pre-images removal job was interrupted");
     } catch (const DBException& exception) {
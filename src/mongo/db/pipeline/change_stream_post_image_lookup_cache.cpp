@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_post_image_lookup_cache.h"
+
+#include <boost/container_hash/hash.hpp>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getChangeStreamPostImageLookupCache =
+    ServiceContext::declareDecoration<ChangeStreamPostImageLookupCache>();
+
+// Lookups served from the cache and lookups that had to be made by the change stream.
+Counter64 cacheHits;
+Counter64 cacheMisses;
+ServerStatusMetricField<Counter64> displayCacheHits("changeStreams.postImageLookupCache.hits",
+                                                    &cacheHits);
+ServerStatusMetricField<Counter64> displayCacheMisses("changeStreams.postImageLookupCache.misses",
+                                                      &cacheMisses);
+
+size_t getMaxSizeBytes() {
+    return static_cast<size_t>(internalChangeStreamPostImageLookupCacheBytes.load());
+}
+
+}  // namespace
+
+size_t ChangeStreamPostImageLookupCache::Key::Hasher::operator()(const Key& key) const {
+    size_t hash = UUID::Hash{}(key.collectionUUID);
+    boost::hash_combine(hash, key.clusterTime.asULL());
+    boost::hash_combine(hash, SimpleBSONObjComparator::kInstance.hash(key.documentKey));
+    return hash;
+}
+
+bool ChangeStreamPostImageLookupCache::Key::operator==(const Key& other) const {
+    return collectionUUID == other.collectionUUID && clusterTime == other.clusterTime &&
+        documentKey.binaryEqual(other.documentKey);
+}
+
+ChangeStreamPostImageLookupCache::ChangeStreamPostImageLookupCache()
+    : _maxSizeBytes(getMaxSizeBytes()), _entries(_maxSizeBytes) {}
+
+ChangeStreamPostImageLookupCache& ChangeStreamPostImageLookupCache::get(ServiceContext* service) {
+    return getChangeStreamPostImageLookupCache(service);
+}
+
+std::uint64_t ChangeStreamPostImageLookupCache::beginLookup() const {
+    return _completedLookups.load();
+}
+
+std::uint64_t ChangeStreamPostImageLookupCache::endLookup() {
+    return _completedLookups.addAndFetch(1);
+}
+
+bool ChangeStreamPostImageLookupCache::lookup(const Key& key,
+                                              Date_t now,
+                                              std::uint64_t* lastLookupEnd,
+                                              boost::optional<Document>* postImage) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto entry = _entries.get(key);
+    if (!entry.isOK()) {
+        cacheMisses.increment();
+        return false;
+    }
+
+    if (entry.getValue()->expiresAt <= now) {
+        _entries.erase(key);
+        cacheMisses.increment();
+        return false;
+    }
+
+    if (entry.getValue()->lookupBegin < *lastLookupEnd) {
+        // The cached lookup may have read an older snapshot than the caller's previous lookup, and
+        // returned an older version of the document than the caller already did.
+        cacheMisses.increment();
+        return false;
+    }
+
+    cacheHits.increment();
+    if (const auto& cached = entry.getValue()->postImage) {
+        *postImage = Document(*cached);
+    } else {
+        *postImage = boost::none;
+    }
+    *lastLookupEnd = entry.getValue()->lookupEnd;
+    return true;
+}
+
+void ChangeStreamPostImageLookupCache::insert(const Key& key,
+                                              Date_t now,
+                                              std::uint64_t lookupBegin,
+                                              std::uint64_t lookupEnd,
+                                              const boost::optional<Document>& postImage) {
+    const auto maxSizeBytes = getMaxSizeBytes();
+    const auto ttl = Milliseconds(internalChangeStreamPostImageLookupCacheTTLMillis.load());
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (maxSizeBytes != _maxSizeBytes) {
+        _maxSizeBytes = maxSizeBytes;
+        _entries.reset(_maxSizeBytes);
+    }
+    if (_maxSizeBytes == 0) {
+        return;
+    }
+
+    if (auto entry = _entries.get(key);
+        entry.isOK() && entry.getValue()->lookupBegin > lookupBegin) {
+        // A concurrent lookup which began later completed first.
+        return;
+    }
+
+    boost::optional<BSONObj> ownedPostImage;
+    if (postImage) {
+        ownedPostImage = postImage->toBson();
+    }
+    const size_t approximateSize = sizeof(Key) + sizeof(Entry) + key.documentKey.objsize() +
+        (ownedPostImage ? ownedPostImage->objsize() : 0);
+    _entries.add({key.collectionUUID, key.clusterTime, key.documentKey.getOwned()},
+                 new Entry{std::move(ownedPostImage), now + ttl, lookupBegin, lookupEnd,
+                           approximateSize});
+}
+
+size_t ChangeStreamPostImageLookupCache::size() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _entries.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A short-lived, memory-bounded cache of the documents looked up for the 'fullDocument' field of
+ * update events by change streams opened with {fullDocument: 'updateLookup'}. Many change streams
+ * watching the same collection on a node see the same update events, and share the result of the
+ * first lookup for each event rather than each looking up the document again.
+ *
+ * A cached document is the most recent majority-committed version of the document at or after
+ * the event as of when it was looked up, which is what updateLookup guarantees. Entries expire
+ * after 'internalChangeStreamPostImageLookupCacheTTLMillis', which bounds how much more recent
+ * versions a cached document can miss.
+ *
+ * Without the cache, each lookup of a change stream reads a later snapshot than the previous one,
+ * so the versions of a document it returns never go back in time. To preserve this, the lookups
+ * made on this node are ordered by a counter which each of them advances when it completes, and a
+ * change stream only uses a cached lookup that began after its own previous lookup, cached or
+ * not, completed.
+ *
+ * The cache stores the looked up documents as owned BSON and returns a new Document for each hit,
+ * as a Document lazily fills caches in its storage when read and cannot be shared across threads.
+ */
+class ChangeStreamPostImageLookupCache {
+public:
+    /**
+     * Identifies the lookup for one update event.
+     */
+    struct Key {
+        struct Hasher {
+            size_t operator()(const Key& key) const;
+        };
+
+        bool operator==(const Key& other) const;
+
+        UUID collectionUUID;
+        Timestamp clusterTime;
+        BSONObj documentKey;
+    };
+
+    ChangeStreamPostImageLookupCache();
+
+    static ChangeStreamPostImageLookupCache& get(ServiceContext* service);
+
+    /**
+     * Returns the position in the order of lookups of a lookup beginning now: it follows all the
+     * lookups for which endLookup() has returned.
+     */
+    std::uint64_t beginLookup() const;
+
+    /**
+     * Returns the position in the order of lookups of a lookup which just completed: it precedes
+     * all the lookups for which beginLookup() has not been called yet.
+     */
+    std::uint64_t endLookup();
+
+    /**
+     * Returns true and sets 'postImage' to the cached result of the lookup for 'key', which is
+     * boost::none if the document was not found, if there is one that has not expired as of 'now'
+     * and began after the position '*lastLookupEnd' where the caller's previous lookup completed.
+     * Advances '*lastLookupEnd' to where the cached lookup completed. Returns false otherwise.
+     */
+    bool lookup(const Key& key,
+                Date_t now,
+                std::uint64_t* lastLookupEnd,
+                boost::optional<Document>* postImage);
+
+    /**
+     * Caches 'postImage' as the result of the lookup for 'key', which was made at 'now' between
+     * the positions 'lookupBegin' and 'lookupEnd' in the order of lookups. Keeps the cached lookup
+     * for 'key' instead if it began later.
+     */
+    void insert(const Key& key,
+                Date_t now,
+                std::uint64_t lookupBegin,
+                std::uint64_t lookupEnd,
+                const boost::optional<Document>& postImage);
+
+    /**
+     * Returns the number of cached lookups, expired or not.
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        boost::optional<BSONObj> postImage;
+        Date_t expiresAt;
+        std::uint64_t lookupBegin;
+        std::uint64_t lookupEnd;
+        size_t approximateSize;
+    };
+
+    struct EntryBudgetEstimator {
+        size_t operator()(const Entry& entry) {
+            return entry.approximateSize;
+        }
+    };
+
+    // The number of lookups completed, which orders them.
+    AtomicWord<std::uint64_t> _completedLookups{0};
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChangeStreamPostImageLookupCache::_mutex");
+
+    // The maximum total approximate size of the cached entries the cache was last configured with.
+    size_t _maxSizeBytes;
+    LRUKeyValue<Key, Entry, EntryBudgetEstimator, Key::Hasher> _entries;
+};
+
+}  // namespace mongo
@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/change_stream_post_image_lookup_cache.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Key = ChangeStreamPostImageLookupCache::Key;
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(100000);
+
+// Looks up 'key' for a change stream which has not looked up any document yet.
+bool lookup(ChangeStreamPostImageLookupCache& cache,
+            const Key& key,
+            Date_t now,
+            boost::optional<Document>* postImage) {
+    std::uint64_t lastLookupEnd = 0;
+    return cache.lookup(key, now, &lastLookupEnd, postImage);
+}
+
+// Caches 'postImage' as the result of a lookup completed just now.
+void insert(ChangeStreamPostImageLookupCache& cache,
+            const Key& key,
+            Date_t now,
+            const boost::optional<Document>& postImage) {
+    const auto lookupBegin = cache.beginLookup();
+    cache.insert(key, now, lookupBegin, cache.endLookup(), postImage);
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, LookupReturnsInsertedPostImage) {
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+    boost::optional<Document> postImage;
+    ASSERT_FALSE(lookup(cache, key, kNow, &postImage));
+
+    insert(cache, key, kNow, Document{{"_id", 1}, {"x", 2}});
+    ASSERT_TRUE(lookup(cache, key, kNow, &postImage));
+    ASSERT_TRUE(postImage);
+    ASSERT_DOCUMENT_EQ(*postImage, (Document{{"_id", 1}, {"x", 2}}));
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, CachesDocumentNotFound) {
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+    insert(cache, key, kNow, boost::none);
+
+    boost::optional<Document> postImage = Document{{"_id", 0}};
+    ASSERT_TRUE(lookup(cache, key, kNow, &postImage));
+    ASSERT_FALSE(postImage);
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, ConcurrentHitsReturnSeparateDocuments) {
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+    insert(cache, key, kNow, Document{{"_id", 1}, {"a", 1}, {"b", 2}});
+
+    // Reading fields of a Document caches them in its storage, so each change stream must be
+    // handed a Document that no other thread reads.
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 100; ++j) {
+                boost::optional<Document> postImage;
+                ASSERT_TRUE(lookup(cache, key, kNow, &postImage));
+                ASSERT_VALUE_EQ((*postImage)["b"], Value(2));
+                ASSERT_VALUE_EQ((*postImage)["a"], Value(1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, KeyDistinguishesCollectionTimeAndDocument) {
+    ChangeStreamPostImageLookupCache cache;
+    const auto uuid = UUID::gen();
+    insert(cache, {uuid, Timestamp(10, 1), fromjson("{_id: 1}")}, kNow, Document{{"_id", 1}});
+
+    boost::optional<Document> postImage;
+    ASSERT_FALSE(
+        lookup(cache, {UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")}, kNow, &postImage));
+    ASSERT_FALSE(lookup(cache, {uuid, Timestamp(10, 2), fromjson("{_id: 1}")}, kNow, &postImage));
+    ASSERT_FALSE(lookup(cache, {uuid, Timestamp(10, 1), fromjson("{_id: 2}")}, kNow, &postImage));
+    ASSERT_FALSE(
+        lookup(cache, {uuid, Timestamp(10, 1), fromjson("{_id: 1, sk: 1}")}, kNow, &postImage));
+    ASSERT_TRUE(lookup(cache, {uuid, Timestamp(10, 1), fromjson("{_id: 1}")}, kNow, &postImage));
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, EntriesExpire) {
+    RAIIServerParameterControllerForTest ttl{"internalChangeStreamPostImageLookupCacheTTLMillis",
+                                             1000};
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+    insert(cache, key, kNow, Document{{"_id", 1}});
+
+    boost::optional<Document> postImage;
+    ASSERT_TRUE(lookup(cache, key, kNow + Milliseconds(999), &postImage));
+    ASSERT_FALSE(lookup(cache, key, kNow + Milliseconds(1000), &postImage));
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, OnlyUsesLookupsBeganAfterPreviousLookupCompleted) {
+    ChangeStreamPostImageLookupCache cache;
+    const auto uuid = UUID::gen();
+    const Key firstUpdate{uuid, Timestamp(10, 1), fromjson("{_id: 1}")};
+    const Key secondUpdate{uuid, Timestamp(10, 2), fromjson("{_id: 1}")};
+    std::uint64_t lastLookupEnd = cache.beginLookup();
+    std::uint64_t otherLastLookupEnd = cache.beginLookup();
+
+    // Another change stream looks up the document for the second update.
+    const auto otherLookupBegin = cache.beginLookup();
+    otherLastLookupEnd = cache.endLookup();
+    cache.insert(
+        secondUpdate, kNow, otherLookupBegin, otherLastLookupEnd, Document{{"_id", 1}, {"x", 2}});
+
+    // We look up the document for the first update afterwards, and find a later version of it.
+    boost::optional<Document> postImage;
+    ASSERT_FALSE(cache.lookup(firstUpdate, kNow, &lastLookupEnd, &postImage));
+    const auto lookupBegin = cache.beginLookup();
+    lastLookupEnd = cache.endLookup();
+    cache.insert(firstUpdate, kNow, lookupBegin, lastLookupEnd, Document{{"_id", 1}, {"x", 3}});
+
+    // The cached version for the second update is older than the one we returned already.
+    ASSERT_FALSE(cache.lookup(secondUpdate, kNow, &lastLookupEnd, &postImage));
+
+    // The other change stream can use our lookup, which began after its own completed.
+    ASSERT_TRUE(cache.lookup(firstUpdate, kNow, &otherLastLookupEnd, &postImage));
+    ASSERT_DOCUMENT_EQ(*postImage, (Document{{"_id", 1}, {"x", 3}}));
+    ASSERT_EQ(otherLastLookupEnd, lastLookupEnd);
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, KeepsLookupThatBeganLast) {
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+
+    // Two lookups run concurrently, and the one which began last completes first. Another lookup
+    // completed between the times they began.
+    const auto earlierBegin = cache.beginLookup();
+    cache.endLookup();
+    const auto laterBegin = cache.beginLookup();
+    cache.insert(key, kNow, laterBegin, cache.endLookup(), Document{{"_id", 1}, {"x", 2}});
+    cache.insert(key, kNow, earlierBegin, cache.endLookup(), Document{{"_id", 1}, {"x", 1}});
+
+    boost::optional<Document> postImage;
+    ASSERT_TRUE(lookup(cache, key, kNow, &postImage));
+    ASSERT_DOCUMENT_EQ(*postImage, (Document{{"_id", 1}, {"x", 2}}));
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    RAIIServerParameterControllerForTest bytes{"internalChangeStreamPostImageLookupCacheBytes",
+                                               4 * 1024};
+    ChangeStreamPostImageLookupCache cache;
+    const auto uuid = UUID::gen();
+    const std::string padding(512, 'x');
+    for (int i = 0; i < 32; ++i) {
+        insert(cache, {uuid, Timestamp(10, i), BSON("_id" << i)},
+                     kNow,
+                     Document{{"_id", i}, {"padding", padding}});
+    }
+    ASSERT_LT(cache.size(), 32U);
+
+    boost::optional<Document> postImage;
+    ASSERT_FALSE(lookup(cache, {uuid, Timestamp(10, 0), BSON("_id" << 0)}, kNow, &postImage));
+    ASSERT_TRUE(lookup(cache, {uuid, Timestamp(10, 31), BSON("_id" << 31)}, kNow, &postImage));
+}
+
+TEST(ChangeStreamPostImageLookupCacheTest, DisabledWithZeroBudget) {
+    RAIIServerParameterControllerForTest bytes{"internalChangeStreamPostImageLookupCacheBytes", 0};
+    ChangeStreamPostImageLookupCache cache;
+    const Key key{UUID::gen(), Timestamp(10, 1), fromjson("{_id: 1}")};
+    insert(cache, key, kNow, Document{{"_id", 1}});
+
+    boost::optional<Document> postImage;
+    ASSERT_FALSE(lookup(cache, key, kNow, &postImage));
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,8 @@
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
+#include "mongo/db/record_id_helpers.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -54,11 +56,24 @@ void writeToChangeStreamPreImagesCollection(OperationContext* opCtx,
     // on the pre-images collection also waits for oplog visibility.
     AllowLockAcquisitionOnTimestampedUnitOfWork allowLockAcquisition(opCtx->lockState());
     AutoGetCollection preimagesCollectionRaii(opCtx, collectionNamespace, LockMode::MODE_IX);
-    UpdateResult res = Helpers::upsert(opCtx, collectionNamespace.toString(), preImage.toBSON());
+    const auto preImageObj = preImage.toBSON();
+    UpdateResult res = Helpers::upsert(opCtx, collectionNamespace.toString(), preImageObj);
     tassert(5868601,
             str::stream() << "Failed to insert a new document into the pre-images collection: ts: "
                           << preImage.getId().getTs().toString()
                           << ", applyOpsIndex: " << preImage.getId().getApplyOpsIndex(),
             !res.existing && !res.upsertedId.isEmpty());
+
+    // Account for the pre-image in the truncate markers used to remove expired pre-images.
+    opCtx->recoveryUnit()->onCommit(
+        [serviceContext = opCtx->getServiceContext(),
+         collectionUUID = preImage.getId().getNsUUID(),
+         recordId = record_id_helpers::keyForElem(preImageObj[ChangeStreamPreImage::kIdFieldName]),
+         ts = preImage.getId().getTs(),
+         operationTime = preImage.getOperationTime(),
+         bytes = preImageObj.objsize()](auto) {
+            ChangeStreamPreImagesTruncateMarkers::get(serviceContext)
+                .updateOnInsert(collectionUUID, recordId, ts, operationTime, bytes);
+        });
 }
 }  // namespace mongo
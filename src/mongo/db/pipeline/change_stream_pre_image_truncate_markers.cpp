@@ -0,0 +1,292 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
+
+#include "mongo/db/pipeline/change_stream_preimage_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getChangeStreamPreImagesTruncateMarkers =
+    ServiceContext::declareDecoration<ChangeStreamPreImagesTruncateMarkers>();
+
+using Marker = ChangeStreamPreImagesTruncateMarkers::Marker;
+
+Marker makeMarker(const RecordId& recordId, Timestamp ts, Date_t operationTime, int64_t bytes) {
+    return Marker{recordId, ts, operationTime, 1, bytes, ts, operationTime};
+}
+
+bool isExpired(const Marker& marker,
+               Timestamp earliestOplogEntryTimestamp,
+               const boost::optional<Date_t>& preImageExpirationTime) {
+    return marker.lastTs < earliestOplogEntryTimestamp ||
+        (preImageExpirationTime && marker.maxOperationTime <= *preImageExpirationTime);
+}
+
+bool isFirstPreImageExpired(const Marker& marker,
+                            Timestamp earliestOplogEntryTimestamp,
+                            const boost::optional<Date_t>& preImageExpirationTime) {
+    return marker.firstTs < earliestOplogEntryTimestamp ||
+        (preImageExpirationTime && marker.firstOperationTime <= *preImageExpirationTime);
+}
+
+}  // namespace
+
+ChangeStreamPreImagesTruncateMarkers& ChangeStreamPreImagesTruncateMarkers::get(
+    ServiceContext* service) {
+    return getChangeStreamPreImagesTruncateMarkers(service);
+}
+
+void ChangeStreamPreImagesTruncateMarkers::_add(CollectionMarkers* collectionMarkers,
+                                                const Marker& records) {
+    // Pre-images are added as their writes commit, which is not the order of their timestamps, so
+    // the bounds of the marker only ever widen.
+    auto& current = collectionMarkers->current;
+    if (current.records == 0 || records.firstTs < current.firstTs) {
+        current.firstTs = records.firstTs;
+        current.firstOperationTime = records.firstOperationTime;
+    }
+    current.lastRecord = std::max(current.lastRecord, records.lastRecord);
+    current.lastTs = std::max(current.lastTs, records.lastTs);
+    current.maxOperationTime = std::max(current.maxOperationTime, records.maxOperationTime);
+    current.records += records.records;
+    current.bytes += records.bytes;
+
+    if (current.bytes >= gChangeStreamPreImageTruncateMarkerBytes.load()) {
+        collectionMarkers->markers.push_back(std::move(current));
+        current = Marker{};
+    }
+}
+
+void ChangeStreamPreImagesTruncateMarkers::updateOnInsert(const UUID& collectionUUID,
+                                                          const RecordId& recordId,
+                                                          Timestamp ts,
+                                                          Date_t operationTime,
+                                                          int64_t bytes) {
+    const auto record = makeMarker(recordId, ts, operationTime, bytes);
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state) {
+        case State::kUninitialized:
+            // The scan that initializes the markers will find the pre-image.
+            return;
+        case State::kInitializing: {
+            auto [it, inserted] = _insertedDuringInitialization.try_emplace(
+                collectionUUID, InsertedDuringInitialization{recordId, Marker{}});
+            auto& records = it->second.records;
+            if (inserted) {
+                records = record;
+                return;
+            }
+            if (ts < records.firstTs) {
+                it->second.firstRecord = recordId;
+                records.firstTs = ts;
+                records.firstOperationTime = operationTime;
+            }
+            records.lastRecord = std::max(records.lastRecord, recordId);
+            records.lastTs = std::max(records.lastTs, ts);
+            records.maxOperationTime = std::max(records.maxOperationTime, operationTime);
+            records.records += 1;
+            records.bytes += bytes;
+            return;
+        }
+        case State::kInitialized:
+            _add(&_collections[collectionUUID], record);
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void ChangeStreamPreImagesTruncateMarkers::updateFromScan(const UUID& collectionUUID,
+                                                          const RecordId& recordId,
+                                                          Timestamp ts,
+                                                          Date_t operationTime,
+                                                          int64_t bytes) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state != State::kInitializing) {
+        // The markers were cleared while the scan yielded.
+        return;
+    }
+    if (auto it = _insertedDuringInitialization.find(collectionUUID);
+        it != _insertedDuringInitialization.end() && recordId >= it->second.firstRecord) {
+        return;
+    }
+    _add(&_collections[collectionUUID], makeMarker(recordId, ts, operationTime, bytes));
+}
+
+bool ChangeStreamPreImagesTruncateMarkers::isInitialized() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _state == State::kInitialized;
+}
+
+void ChangeStreamPreImagesTruncateMarkers::beginInitialization() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _collections.clear();
+    _insertedDuringInitialization.clear();
+    _state = State::kInitializing;
+}
+
+void ChangeStreamPreImagesTruncateMarkers::finishInitialization() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state != State::kInitializing) {
+        return;
+    }
+    for (auto&& [collectionUUID, inserted] : _insertedDuringInitialization) {
+        _add(&_collections[collectionUUID], inserted.records);
+    }
+    _insertedDuringInitialization.clear();
+    _state = State::kInitialized;
+}
+
+void ChangeStreamPreImagesTruncateMarkers::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _collections.clear();
+    _insertedDuringInitialization.clear();
+    _state = State::kUninitialized;
+}
+
+std::vector<ChangeStreamPreImagesTruncateMarkers::ExpiredRange>
+ChangeStreamPreImagesTruncateMarkers::getExpiredRanges(
+    Timestamp earliestOplogEntryTimestamp, boost::optional<Date_t> preImageExpirationTime) {
+    std::vector<ExpiredRange> expiredRanges;
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_state == State::kInitialized);
+    for (auto&& [collectionUUID, collectionMarkers] : _collections) {
+        auto& markers = collectionMarkers.markers;
+        auto firstUnexpired =
+            std::find_if(markers.begin(), markers.end(), [&](const Marker& marker) {
+                return !isExpired(marker, earliestOplogEntryTimestamp, preImageExpirationTime);
+            });
+
+        auto& current = collectionMarkers.current;
+        if (firstUnexpired == markers.end() && current.records > 0 &&
+            isExpired(current, earliestOplogEntryTimestamp, preImageExpirationTime)) {
+            markers.push_back(std::move(current));
+            current = Marker{};
+            firstUnexpired = markers.end();
+        }
+
+        // The marker that follows the expired ones, if any, may start with expired pre-images.
+        const Marker* next = nullptr;
+        if (firstUnexpired != markers.end()) {
+            next = &*firstUnexpired;
+        } else if (current.records > 0) {
+            next = &current;
+        }
+        const bool nextMarkerHasExpiredPrefix = next &&
+            isFirstPreImageExpired(*next, earliestOplogEntryTimestamp, preImageExpirationTime);
+        if (firstUnexpired == markers.begin() && !nextMarkerHasExpiredPrefix) {
+            continue;
+        }
+
+        ExpiredRange range{collectionUUID, RecordId(), 0, 0, 0, nextMarkerHasExpiredPrefix};
+        if (firstUnexpired != markers.begin()) {
+            range.lastRecord = std::prev(firstUnexpired)->lastRecord;
+        }
+        for (auto it = markers.begin(); it != firstUnexpired; ++it) {
+            range.records += it->records;
+            range.bytes += it->bytes;
+            ++range.numMarkers;
+        }
+        expiredRanges.push_back(std::move(range));
+    }
+    return expiredRanges;
+}
+
+void ChangeStreamPreImagesTruncateMarkers::removeTruncatedMarkers(const ExpiredRange& range) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _collections.find(range.collectionUUID);
+    if (it == _collections.end()) {
+        return;
+    }
+
+    auto& collectionMarkers = it->second;
+    invariant(range.numMarkers <= collectionMarkers.markers.size());
+    collectionMarkers.markers.erase(collectionMarkers.markers.begin(),
+                                    collectionMarkers.markers.begin() + range.numMarkers);
+    if (collectionMarkers.markers.empty() && collectionMarkers.current.records == 0) {
+        _collections.erase(it);
+    }
+}
+
+void ChangeStreamPreImagesTruncateMarkers::removeTruncatedPrefix(const UUID& collectionUUID,
+                                                                 const TruncatedPrefix& prefix) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _collections.find(collectionUUID);
+    if (it == _collections.end()) {
+        return;
+    }
+
+    auto& collectionMarkers = it->second;
+    auto& markers = collectionMarkers.markers;
+    auto& current = collectionMarkers.current;
+    int64_t records = prefix.records;
+    int64_t bytes = prefix.bytes;
+    if (records > 0) {
+        // The prefix covers whole markers whose pre-images expired by different criteria.
+        while (!markers.empty() && markers.front().lastRecord <= prefix.lastRecord) {
+            records -= markers.front().records;
+            bytes -= markers.front().bytes;
+            markers.pop_front();
+        }
+        if (markers.empty() && current.records > 0 && current.lastRecord <= prefix.lastRecord) {
+            current = Marker{};
+        }
+    }
+
+    Marker* front = nullptr;
+    if (!markers.empty()) {
+        front = &markers.front();
+    } else if (current.records > 0) {
+        front = &current;
+    } else {
+        _collections.erase(it);
+        return;
+    }
+
+    // The front marker ends after the prefix, so at least its last pre-image remains.
+    front->records = std::max<int64_t>(front->records - records, 1);
+    front->bytes = std::max<int64_t>(front->bytes - bytes, 0);
+    if (prefix.firstRemainingTs) {
+        front->firstTs = *prefix.firstRemainingTs;
+        front->firstOperationTime = prefix.firstRemainingOperationTime;
+    }
+}
+
+size_t ChangeStreamPreImagesTruncateMarkers::numMarkers(const UUID& collectionUUID) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _collections.find(collectionUUID);
+    return it == _collections.end() ? 0 : it->second.markers.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Keeps in-memory truncate markers over the pre-images of each collection in the node's
+ * 'config.system.preimages' collection, so that expired pre-images can be removed by truncating
+ * whole ranges of the collection instead of deleting them one by one. This is the pre-images
+ * counterpart of the oplog stones kept by the WiredTiger oplog record store.
+ *
+ * The pre-images of one collection are clustered by (nsUUID, ts, applyOpsIndex), so a marker only
+ * needs the RecordId of the last pre-image it covers: truncating from the first possible RecordId
+ * of the collection's pre-images through that RecordId removes the marker and every marker before
+ * it. The record and byte counts of the markers are approximate. The expired pre-images at the
+ * front of the oldest marker that has not expired as a whole are truncated too, after a scan finds
+ * where they end, so that collections which accumulate pre-images slowly or whose pre-images
+ * expire by operation time are not left waiting for a full marker to expire.
+ *
+ * The markers are not persisted. They are built by scanning the pre-images collection the first
+ * time they are needed after startup, and then kept up to date as pre-images are inserted.
+ */
+class ChangeStreamPreImagesTruncateMarkers {
+public:
+    struct Marker {
+        RecordId lastRecord;        // RecordId of the last pre-image covered by the marker.
+        Timestamp lastTs;           // Timestamp of the last pre-image covered by the marker.
+        Date_t maxOperationTime;    // Latest operation time of the pre-images in the marker.
+        int64_t records = 0;        // Approximate number of pre-images covered by the marker.
+        int64_t bytes = 0;          // Approximate size of the pre-images covered by the marker.
+        Timestamp firstTs;          // Timestamp of the first pre-image covered by the marker.
+        Date_t firstOperationTime;  // Operation time of the first pre-image in the marker.
+    };
+
+    /**
+     * A range of expired pre-images of one collection that can be truncated, which ends at
+     * 'lastRecord' and is made up of the collection's 'numMarkers' oldest markers. If
+     * 'nextMarkerHasExpiredPrefix' is set, the first pre-image after the range has expired too,
+     * and the expired pre-images that follow the range have to be found by a scan. 'numMarkers'
+     * may then be 0, in which case 'lastRecord' is null.
+     */
+    struct ExpiredRange {
+        UUID collectionUUID;
+        RecordId lastRecord;
+        int64_t records;
+        int64_t bytes;
+        size_t numMarkers;
+        bool nextMarkerHasExpiredPrefix;
+    };
+
+    /**
+     * The expired pre-images at the front of a collection's pre-images which were found by a scan
+     * and truncated. They end at 'lastRecord', and 'firstRemainingTs' and
+     * 'firstRemainingOperationTime' describe the pre-image that follows them, if any.
+     */
+    struct TruncatedPrefix {
+        RecordId lastRecord;
+        int64_t records = 0;
+        int64_t bytes = 0;
+        boost::optional<Timestamp> firstRemainingTs;
+        Date_t firstRemainingOperationTime;
+    };
+
+    static ChangeStreamPreImagesTruncateMarkers& get(ServiceContext* service);
+
+    /**
+     * Accounts for a pre-image inserted by a committed write. Called as the writes commit, which
+     * may not be the order of the timestamps of their pre-images.
+     */
+    void updateOnInsert(const UUID& collectionUUID,
+                        const RecordId& recordId,
+                        Timestamp ts,
+                        Date_t operationTime,
+                        int64_t bytes);
+
+    /**
+     * Accounts for a pre-image found by the scan that initializes the markers. Pre-images inserted
+     * after the scan started are accounted for by updateOnInsert() instead, and ignored here.
+     */
+    void updateFromScan(const UUID& collectionUUID,
+                        const RecordId& recordId,
+                        Timestamp ts,
+                        Date_t operationTime,
+                        int64_t bytes);
+
+    bool isInitialized() const;
+
+    /**
+     * Marks the beginning of the scan that initializes the markers. Any markers are discarded.
+     */
+    void beginInitialization();
+
+    /**
+     * Marks the end of the scan that initializes the markers. The markers stay uninitialized if
+     * they were cleared while the scan was in progress.
+     */
+    void finishInitialization();
+
+    /**
+     * Discards all the markers, which have to be initialized again before they are used. Called
+     * when the pre-images collection changes in ways the markers do not track, such as a rollback
+     * or the removal of pre-images with replicated deletes.
+     */
+    void clear();
+
+    /**
+     * Returns, for each collection, the range made up of its oldest markers whose pre-images have
+     * all expired, given that pre-images with a timestamp before 'earliestOplogEntryTimestamp' or
+     * an operation time at or before 'preImageExpirationTime' are expired. The pre-images a
+     * collection has accumulated since its last full marker become a marker of their own once
+     * they have all expired. A range is also returned for a collection whose oldest unexpired
+     * marker starts with an expired pre-image, so that the expired prefix of that marker is
+     * truncated after a scan.
+     */
+    std::vector<ExpiredRange> getExpiredRanges(Timestamp earliestOplogEntryTimestamp,
+                                               boost::optional<Date_t> preImageExpirationTime);
+
+    /**
+     * Removes the markers of 'range' after it has been truncated.
+     */
+    void removeTruncatedMarkers(const ExpiredRange& range);
+
+    /**
+     * Accounts for the truncation of 'prefix' from the pre-images of 'collectionUUID', which were
+     * found by a scan after the markers of its ExpiredRange were removed.
+     */
+    void removeTruncatedPrefix(const UUID& collectionUUID, const TruncatedPrefix& prefix);
+
+    /**
+     * Returns the number of full markers kept for 'collectionUUID'. Used in tests.
+     */
+    size_t numMarkers(const UUID& collectionUUID) const;
+
+private:
+    struct CollectionMarkers {
+        // Full markers, oldest first.
+        std::deque<Marker> markers;
+
+        // The pre-images inserted since the last full marker.
+        Marker current;
+    };
+
+    // Adds the pre-images summarized by 'records' to the current marker of 'collectionMarkers',
+    // widening its bounds to cover them, and makes it a full marker if it is big enough.
+    static void _add(CollectionMarkers* collectionMarkers, const Marker& records);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChangeStreamPreImagesTruncateMarkers::_mutex");
+
+    enum class State { kUninitialized, kInitializing, kInitialized };
+    State _state = State::kUninitialized;
+
+    stdx::unordered_map<UUID, CollectionMarkers, UUID::Hash> _collections;
+
+    // The pre-images inserted since the scan that initializes the markers started. They are added
+    // to the markers once the scan finishes.
+    struct InsertedDuringInitialization {
+        RecordId firstRecord;
+        Marker records;
+    };
+    stdx::unordered_map<UUID, InsertedDuringInitialization, UUID::Hash>
+        _insertedDuringInitialization;
+};
+
+}  // namespace mongo
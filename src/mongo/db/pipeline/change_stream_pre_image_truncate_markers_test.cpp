@@ -0,0 +1,304 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_pre_image_truncate_markers.h"
+
+#include "mongo/db/pipeline/change_stream_preimage_gen.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class ChangeStreamPreImagesTruncateMarkersTest : public unittest::Test {
+protected:
+    // Inserts the pre-image with timestamp (i, 0), operation time 'i' seconds and size 40 bytes,
+    // so that with 100 bytes per marker every third pre-image completes a marker.
+    void insert(const UUID& collectionUUID, int i) {
+        _markers.updateOnInsert(collectionUUID,
+                                RecordId(i),
+                                Timestamp(i, 0),
+                                Date_t::fromMillisSinceEpoch(i * 1000),
+                                40);
+    }
+
+    void initialize() {
+        _markers.beginInitialization();
+        _markers.finishInitialization();
+    }
+
+    // Reports the truncation of the pre-images inserted by insert() up to 'last', the first
+    // 'records' of which remained.
+    void removeTruncatedPrefix(int last, int records) {
+        ChangeStreamPreImagesTruncateMarkers::TruncatedPrefix prefix;
+        prefix.lastRecord = RecordId(last);
+        prefix.records = records;
+        prefix.bytes = records * 40;
+        prefix.firstRemainingTs = Timestamp(last + 1, 0);
+        prefix.firstRemainingOperationTime = Date_t::fromMillisSinceEpoch((last + 1) * 1000);
+        _markers.removeTruncatedPrefix(_collectionUUID, prefix);
+    }
+
+    ChangeStreamPreImagesTruncateMarkers _markers;
+    const UUID _collectionUUID = UUID::gen();
+
+private:
+    RAIIServerParameterControllerForTest _markerBytes{"changeStreamPreImageTruncateMarkerBytes",
+                                                      100};
+};
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, InsertsCreateMarkers) {
+    initialize();
+    for (int i = 1; i <= 7; ++i) {
+        insert(_collectionUUID, i);
+    }
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 2U);
+    ASSERT_EQ(_markers.numMarkers(UUID::gen()), 0U);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, InsertsCommittedOutOfTimestampOrder) {
+    initialize();
+    insert(_collectionUUID, 2);
+    insert(_collectionUUID, 3);
+    insert(_collectionUUID, 1);
+
+    // The marker spans from the earliest to the latest pre-image. It only starts with an expired
+    // prefix until the latest one has expired.
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+    auto ranges = _markers.getExpiredRanges(Timestamp(3, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].numMarkers, 0U);
+    ASSERT_TRUE(ranges[0].nextMarkerHasExpiredPrefix);
+
+    ranges = _markers.getExpiredRanges(Timestamp(4, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(3));
+    ASSERT_EQ(ranges[0].records, 3);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, InsertsDuringInitializationOutOfTimestampOrder) {
+    _markers.beginInitialization();
+    insert(_collectionUUID, 3);
+    insert(_collectionUUID, 2);
+    for (int i = 1; i <= 3; ++i) {
+        _markers.updateFromScan(_collectionUUID,
+                                RecordId(i),
+                                Timestamp(i, 0),
+                                Date_t::fromMillisSinceEpoch(i * 1000),
+                                40);
+    }
+    _markers.finishInitialization();
+
+    // The scan only accounted for the first pre-image, which the inserts did not cover.
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+    auto ranges = _markers.getExpiredRanges(Timestamp(10, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(3));
+    ASSERT_EQ(ranges[0].records, 3);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, IgnoresInsertsBeforeInitialization) {
+    for (int i = 1; i <= 3; ++i) {
+        insert(_collectionUUID, i);
+    }
+    ASSERT_FALSE(_markers.isInitialized());
+
+    initialize();
+    ASSERT_TRUE(_markers.isInitialized());
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 0U);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, ScanSkipsPreImagesInsertedDuringInitialization) {
+    _markers.beginInitialization();
+    insert(_collectionUUID, 3);
+    insert(_collectionUUID, 4);
+    for (int i = 1; i <= 4; ++i) {
+        _markers.updateFromScan(_collectionUUID,
+                                RecordId(i),
+                                Timestamp(i, 0),
+                                Date_t::fromMillisSinceEpoch(i * 1000),
+                                40);
+    }
+    ASSERT_FALSE(_markers.isInitialized());
+    _markers.finishInitialization();
+
+    // The scan accounted for 2 pre-images and the inserts for 2 more, so there is one marker.
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+    auto ranges = _markers.getExpiredRanges(Timestamp(10, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(4));
+    ASSERT_EQ(ranges[0].records, 4);
+    ASSERT_EQ(ranges[0].bytes, 160);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, ExpiredRangeEndsAtLastExpiredMarker) {
+    initialize();
+    for (int i = 1; i <= 10; ++i) {
+        insert(_collectionUUID, i);
+    }
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 3U);
+
+    // Only the first two markers end before the earliest oplog entry.
+    auto ranges = _markers.getExpiredRanges(Timestamp(7, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].collectionUUID, _collectionUUID);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(6));
+    ASSERT_EQ(ranges[0].records, 6);
+    ASSERT_EQ(ranges[0].bytes, 240);
+    ASSERT_EQ(ranges[0].numMarkers, 2U);
+
+    _markers.removeTruncatedMarkers(ranges[0]);
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+    ASSERT(_markers.getExpiredRanges(Timestamp(7, 0), boost::none).empty());
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, ExpiresMarkersByOperationTime) {
+    initialize();
+    for (int i = 1; i <= 6; ++i) {
+        insert(_collectionUUID, i);
+    }
+
+    auto ranges = _markers.getExpiredRanges(Timestamp(1, 0), Date_t::fromMillisSinceEpoch(5000));
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(3));
+    ASSERT_EQ(ranges[0].numMarkers, 1U);
+
+    // The first pre-image of the second marker has expired too.
+    ASSERT_TRUE(ranges[0].nextMarkerHasExpiredPrefix);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, TruncatesExpiredPrefixOfMarker) {
+    initialize();
+    for (int i = 1; i <= 5; ++i) {
+        insert(_collectionUUID, i);
+    }
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+
+    // The first marker has not expired as a whole, but starts with an expired pre-image.
+    auto ranges = _markers.getExpiredRanges(Timestamp(2, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].numMarkers, 0U);
+    ASSERT_TRUE(ranges[0].lastRecord.isNull());
+    ASSERT_TRUE(ranges[0].nextMarkerHasExpiredPrefix);
+
+    _markers.removeTruncatedMarkers(ranges[0]);
+    removeTruncatedPrefix(1, 1);
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 1U);
+    ASSERT(_markers.getExpiredRanges(Timestamp(2, 0), boost::none).empty());
+
+    // The rest of the marker is accounted for once it expires.
+    ranges = _markers.getExpiredRanges(Timestamp(4, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(3));
+    ASSERT_EQ(ranges[0].records, 2);
+    ASSERT_EQ(ranges[0].bytes, 80);
+    ASSERT_EQ(ranges[0].numMarkers, 1U);
+    ASSERT_FALSE(ranges[0].nextMarkerHasExpiredPrefix);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, TruncatedPrefixCanCoverWholeMarkers) {
+    initialize();
+    for (int i = 1; i <= 5; ++i) {
+        insert(_collectionUUID, i);
+    }
+
+    removeTruncatedPrefix(4, 4);
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 0U);
+    ASSERT(_markers.getExpiredRanges(Timestamp(5, 0), boost::none).empty());
+
+    auto ranges = _markers.getExpiredRanges(Timestamp(6, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(5));
+    ASSERT_EQ(ranges[0].records, 1);
+    ASSERT_EQ(ranges[0].bytes, 40);
+
+    _markers.removeTruncatedMarkers(ranges[0]);
+    ASSERT(_markers.getExpiredRanges(Timestamp(6, 0), boost::none).empty());
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, TruncatesExpiredPartialMarker) {
+    initialize();
+    insert(_collectionUUID, 1);
+    insert(_collectionUUID, 2);
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 0U);
+
+    // The pre-images are not all expired yet, only the first of them is.
+    auto ranges = _markers.getExpiredRanges(Timestamp(2, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].numMarkers, 0U);
+    ASSERT_TRUE(ranges[0].nextMarkerHasExpiredPrefix);
+
+    ranges = _markers.getExpiredRanges(Timestamp(3, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].lastRecord, RecordId(2));
+    ASSERT_EQ(ranges[0].records, 2);
+
+    _markers.removeTruncatedMarkers(ranges[0]);
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 0U);
+    ASSERT(_markers.getExpiredRanges(Timestamp(3, 0), boost::none).empty());
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, TracksCollectionsSeparately) {
+    initialize();
+    const auto otherCollectionUUID = UUID::gen();
+    for (int i = 1; i <= 3; ++i) {
+        insert(_collectionUUID, i);
+        insert(otherCollectionUUID, i + 10);
+    }
+
+    auto ranges = _markers.getExpiredRanges(Timestamp(5, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 1U);
+    ASSERT_EQ(ranges[0].collectionUUID, _collectionUUID);
+
+    ranges = _markers.getExpiredRanges(Timestamp(20, 0), boost::none);
+    ASSERT_EQ(ranges.size(), 2U);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, ClearRequiresInitialization) {
+    initialize();
+    insert(_collectionUUID, 1);
+    _markers.clear();
+    ASSERT_FALSE(_markers.isInitialized());
+    ASSERT_EQ(_markers.numMarkers(_collectionUUID), 0U);
+}
+
+TEST_F(ChangeStreamPreImagesTruncateMarkersTest, ClearDuringInitialization) {
+    _markers.beginInitialization();
+    _markers.clear();
+    _markers.updateFromScan(
+        _collectionUUID, RecordId(1), Timestamp(1, 0), Date_t::fromMillisSinceEpoch(1000), 40);
+    _markers.finishInitialization();
+    ASSERT_FALSE(_markers.isInitialized());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -273,6 +273,18 @@ Pipeline::SourceContainer::iterator DocumentSource::optimizeAt(
     return doOptimizeAt(itr, container);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    for (size_t produced = 0; produced < maxBatchSize; ++produced) {
+        auto next = doGetNext();
+        if (!next.isAdvanced()) {
+            return next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 void DocumentSource::serializeToArray(vector<Value>& array,
                                       boost::optional<ExplainOptions::Verbosity> explain) const {
     Value entry = serialize(explain);
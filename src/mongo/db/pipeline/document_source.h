@@ -344,6 +344,44 @@ public:
         return next;
     }
 
+    /**
+     * Batched variant of getNext(). Appends up to 'maxBatchSize' results to 'batch' and returns
+     * kAdvanced if at least one result was appended and the stage may have more to produce. A stage
+     * is free to end a kAdvanced batch short of 'maxBatchSize', e.g. when it runs out of buffered
+     * input, so callers must not treat a short batch as exhausted and should call again. kEOF and
+     * kPauseExecution may be returned along with results appended before that status was reached;
+     * those documents must be consumed before acting on the status.
+     *
+     * Mixing calls to getNext() and getNextBatch() on the same stage is allowed, the stage resumes
+     * where the last call of either kind left off.
+     */
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch, size_t maxBatchSize) {
+        pExpCtx->checkForInterrupt();
+
+        if (MONGO_likely(!pExpCtx->shouldCollectDocumentSourceExecStats())) {
+            return doGetNextBatch(batch, maxBatchSize);
+        }
+
+        auto serviceCtx = pExpCtx->opCtx->getServiceContext();
+        invariant(serviceCtx);
+        auto fcs = serviceCtx->getFastClockSource();
+        invariant(fcs);
+
+        invariant(_commonStats.executionTimeMillis);
+        ScopedTimer timer(fcs, _commonStats.executionTimeMillis.get_ptr());
+
+        // Account for the batch as the equivalent sequence of getNext() calls.
+        const auto sizeBefore = batch->size();
+        auto status = doGetNextBatch(batch, maxBatchSize);
+        const auto advanced = batch->size() - sizeBefore;
+        _commonStats.advanced += advanced;
+        _commonStats.works += advanced;
+        if (status != GetNextResult::ReturnStatus::kAdvanced) {
+            ++_commonStats.works;
+        }
+        return status;
+    }
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -672,6 +710,16 @@ protected:
      */
     virtual GetNextResult doGetNext() = 0;
 
+    /**
+     * The batched execution API of a DocumentSource. See comment at getNextBatch().
+     *
+     * The default implementation adapts doGetNext(). Stages which can process their input a batch
+     * at a time, such as those that transform or filter each document independently, should
+     * override this to avoid paying a virtual call per document per stage.
+     */
+    virtual GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                                       size_t maxBatchSize);
+
     /**
      * Attempt to perform an optimization with the following source in the pipeline. 'container'
      * refers to the entire pipeline, and 'itr' points to this stage within the pipeline.
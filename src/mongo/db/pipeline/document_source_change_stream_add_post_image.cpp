@@ -34,6 +34,7 @@
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/pipeline/change_stream_helpers_legacy.h"
+#include "mongo/db/pipeline/change_stream_post_image_lookup_cache.h"
 #include "mongo/db/pipeline/document_source_change_stream_add_pre_image.h"
 #include "mongo/db/update/update_driver.h"
 
@@ -73,6 +74,12 @@ DocumentSourceChangeStreamAddPostImage::createFromBson(
 }
 
 DocumentSource::GetNextResult DocumentSourceChangeStreamAddPostImage::doGetNext() {
+    if (!_lastPostImageLookupEnd) {
+        _lastPostImageLookupEnd =
+            ChangeStreamPostImageLookupCache::get(pExpCtx->opCtx->getServiceContext())
+                .beginLookup();
+    }
+
     auto input = pSource->getNext();
     if (!input.isAdvanced()) {
         return input;
@@ -191,7 +198,7 @@ boost::optional<Document> DocumentSourceChangeStreamAddPostImage::generatePostIm
 }
 
 boost::optional<Document> DocumentSourceChangeStreamAddPostImage::lookupLatestPostImage(
-    const Document& updateOp) const {
+    const Document& updateOp) {
     // Make sure we have a well-formed input.
     auto nss = assertValidNamespace(updateOp);
 
@@ -208,12 +215,39 @@ boost::optional<Document> DocumentSourceChangeStreamAddPostImage::lookupLatestPo
                             << "majority"
                             << "afterClusterTime" << resumeTokenData.clusterTime);
 
+    // Other change streams may already have looked up the document for this event. The cache is
+    // not used with a non-simple collation, under which the lookup may match a different document.
+    invariant(resumeTokenData.uuid);
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    auto& cache = ChangeStreamPostImageLookupCache::get(serviceContext);
+    const bool useCache = !pExpCtx->getCollator();
+    const ChangeStreamPostImageLookupCache::Key cacheKey{
+        *resumeTokenData.uuid, resumeTokenData.clusterTime, documentKey.toBson()};
+    boost::optional<Document> postImage;
+    if (useCache &&
+        cache.lookup(cacheKey,
+                     serviceContext->getFastClockSource()->now(),
+                     &*_lastPostImageLookupEnd,
+                     &postImage)) {
+        return postImage;
+    }
+
     // Update lookup queries sent from mongoS to shards are allowed to use speculative majority
     // reads. Even if the lookup itself succeeded, it may not have returned any results if the
     // document was deleted in the time since the update op.
-    invariant(resumeTokenData.uuid);
-    return pExpCtx->mongoProcessInterface->lookupSingleDocument(
+    const auto lookupBegin = cache.beginLookup();
+    postImage = pExpCtx->mongoProcessInterface->lookupSingleDocument(
         pExpCtx, nss, *resumeTokenData.uuid, documentKey, std::move(readConcern));
+    _lastPostImageLookupEnd = cache.endLookup();
+
+    if (useCache) {
+        cache.insert(cacheKey,
+                     serviceContext->getFastClockSource()->now(),
+                     lookupBegin,
+                     *_lastPostImageLookupEnd,
+                     postImage);
+    }
+    return postImage;
 }
 
 Value DocumentSourceChangeStreamAddPostImage::serialize(
@@ -139,7 +139,7 @@ private:
     boost::optional<Document> generatePostImage(const Document& updateOp) const;
 
     // Retrieves the current version of the document for the update event.
-    boost::optional<Document> lookupLatestPostImage(const Document& updateOp) const;
+    boost::optional<Document> lookupLatestPostImage(const Document& updateOp);
 
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
@@ -152,6 +152,11 @@ private:
     // and whether to return a point-in-time post-image or the most current majority-committed
     // version of the updated document.
     FullDocumentModeEnum _fullDocumentMode = FullDocumentModeEnum::kDefault;
+
+    // Where our previous post-image lookup completed in the order of the lookups made through the
+    // ChangeStreamPostImageLookupCache. Set when we are first asked for an event, so that we do not
+    // use the lookups cached before this change stream was opened or resumed.
+    boost::optional<std::uint64_t> _lastPostImageLookupEnd;
 };
 
 }  // namespace mongo
@@ -122,6 +122,28 @@ DocumentSource::GetNextResult DocumentSourceCursor::doGetNext() {
     return _currentBatch.dequeue();
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // The oplog timestamp must be observed after each document, so fall back to single-document
+    // execution when tracking it.
+    if (_trackOplogTS) {
+        return DocumentSource::doGetNextBatch(batch, maxBatchSize);
+    }
+
+    if (_currentBatch.isEmpty()) {
+        loadBatch();
+    }
+
+    if (_currentBatch.isEmpty()) {
+        return GetNextResult::ReturnStatus::kEOF;
+    }
+
+    for (size_t produced = 0; produced < maxBatchSize && !_currentBatch.isEmpty(); ++produced) {
+        batch->push_back(_currentBatch.dequeue());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 void DocumentSourceCursor::loadBatch() {
     if (!_exec || _exec->isDisposed()) {
         // No more documents.
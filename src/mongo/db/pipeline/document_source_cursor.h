@@ -141,6 +141,12 @@ protected:
 
     GetNextResult doGetNext() final;
 
+    /**
+     * Serves the batch directly out of '_currentBatch', loading a new batch from '_exec' as needed.
+     */
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) final;
+
     ~DocumentSourceCursor();
 
     /**
@@ -40,8 +40,10 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/memory_arena.h"
 
 namespace mongo {
 
@@ -133,6 +135,13 @@ const char* DocumentSourceGroup::getSourceName() const {
 }
 
 bool DocumentSourceGroup::shouldSpillWithAttemptToSaveMemory() {
+    // Memory which the operation's arena holds but which is not attributable to any live document,
+    // such as chunks pinned by a few surviving group keys, counts against the $group budget too.
+    // The key cannot collide with an accumulator, since output field names may not start with '$'.
+    if (auto arena = MemoryArena::current()) {
+        _memoryTracker.set("$documentArena"_sd, arena->stats().overheadBytes());
+    }
+
     if (!_memoryTracker._allowDiskUse &&
         (_memoryTracker.currentMemoryBytes() >
          static_cast<long long>(_memoryTracker._maxAllowedMemoryUsageBytes))) {
@@ -181,7 +190,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
     }
 
     if (_spilled) {
-        return getNextSpilled();
+        return _numSpillPartitions < 2 ? getNextSpilled() : getNextPartitioned();
     } else {
         return getNextStandard();
     }
@@ -249,6 +258,7 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _spillPartitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -333,6 +343,13 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
             Value(static_cast<long long>(_stats.totalOutputDataSizeBytes));
         out["usedDisk"] = Value(_stats.spills > 0);
         out["spills"] = Value(static_cast<long long>(_stats.spills));
+        out["spilledDataStorageSize"] =
+            Value(static_cast<long long>(_stats.spilledDataStorageSize));
+        if (_stats.spillPartitions > 0) {
+            out["spillPartitions"] = Value(static_cast<long long>(_stats.spillPartitions));
+            out["maxSpillPartitionDepth"] =
+                Value(static_cast<long long>(_stats.maxSpillPartitionDepth));
+        }
     }
 
     return Value(out.freezeToValue());
@@ -422,6 +439,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(expCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
+      _numSpillPartitions(internalDocumentSourceGroupSpillPartitions.load()),
       _sbeCompatible(false) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
@@ -548,6 +566,10 @@ private:
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+    if (const auto batchSize = internalPipelineExecutionBatchSize.load(); batchSize > 0) {
+        return initializeFromBatches(batchSize);
+    }
+
     GetNextResult input = pSource->getNext();
     return initializeSelf(input);
 }
@@ -556,72 +578,106 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 // prevent stack overflows.
 MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initializeSelf(
     GetNextResult input) {
-    const size_t numAccumulators = _accumulatedFields.size();
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (shouldSpillWithAttemptToSaveMemory()) {
-            _sortedFiles.push_back(spill());
-        }
-
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<AccumulatorState>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        vector<uint64_t> oldAccumMemUsage(numAccumulators, 0);
-        if (inserted) {
-            _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
-
-            // Initialize and add the accumulators
-            Value expandedId = expandId(id);
-            Document idDoc =
-                expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                auto accum = accumulatedField.makeAccumulator();
-                Value initializerValue =
-                    accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
-                accum->startNewGroup(initializerValue);
-                group.push_back(accum);
-            }
+        processDocument(input.releaseDocument());
+    }
+
+    return finishInitialization(std::move(input));
+}
+
+MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initializeFromBatches(
+    size_t batchSize) {
+    std::vector<Document> batch;
+    batch.reserve(batchSize);
+
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced) {
+        batch.clear();
+        status = pSource->getNextBatch(&batch, batchSize);
+        for (auto&& document : batch) {
+            // As in initializeSelf(), release each document before processing it.
+            processDocument(std::exchange(document, Document{}));
         }
+    }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
-        for (size_t i = 0; i < numAccumulators; i++) {
-            // Only process the input and update the memory footprint if the current accumulator
-            // needs more input.
-            if (group[i]->needsInput()) {
-                const auto prevMemUsage = inserted ? 0 : group[i]->getMemUsage();
-                group[i]->process(_accumulatedFields[i].expr.argument->evaluate(
-                                      rootDocument, &pExpCtx->variables),
-                                  _doingMerge);
-                _memoryTracker.update(_accumulatedFields[i].fieldName,
-                                      group[i]->getMemUsage() - prevMemUsage);
-            }
+    return finishInitialization(status == GetNextResult::ReturnStatus::kEOF
+                                    ? GetNextResult::makeEOF()
+                                    : GetNextResult::makePauseExecution());
+}
+
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::findOrCreateGroup(const Value& id,
+                                                                         bool* inserted) {
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    vector<intrusive_ptr<AccumulatorState>>& group = (*_groups)[id];
+    *inserted = _groups->size() != oldSize;
+
+    if (*inserted) {
+        _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
+
+        // Initialize and add the accumulators
+        Value expandedId = expandId(id);
+        Document idDoc =
+            expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
+        group.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            auto accum = accumulatedField.makeAccumulator();
+            Value initializerValue =
+                accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
+            accum->startNewGroup(initializerValue);
+            group.push_back(accum);
         }
+    }
+    return group;
+}
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&           // is a dup
-                !pExpCtx->inMongos &&  // can't spill to disk in mongos
-                !_memoryTracker
-                     ._allowDiskUse &&       // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+void DocumentSourceGroup::processDocument(Document&& rootDocument) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    if (shouldSpillWithAttemptToSaveMemory()) {
+        spillGroups();
+    }
 
-                _sortedFiles.push_back(spill());
-            }
+    Value id = computeId(rootDocument);
+    bool inserted;
+    auto& group = findOrCreateGroup(id, &inserted);
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        // Only process the input and update the memory footprint if the current accumulator
+        // needs more input.
+        if (group[i]->needsInput()) {
+            const auto prevMemUsage = inserted ? 0 : group[i]->getMemUsage();
+            group[i]->process(_accumulatedFields[i].expr.argument->evaluate(
+                                  rootDocument, &pExpCtx->variables),
+                              _doingMerge);
+            _memoryTracker.update(_accumulatedFields[i].fieldName,
+                                  group[i]->getMemUsage() - prevMemUsage);
+        }
+    }
+
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&           // is a dup
+            !pExpCtx->inMongos &&  // can't spill to disk in mongos
+            !_memoryTracker
+                 ._allowDiskUse &&   // don't change behavior when testing external sort
+            _stats.spills < 20) {  // don't open too many FDs
+
+            spillGroups();
         }
     }
+}
 
+DocumentSource::GetNextResult DocumentSourceGroup::finishInitialization(GetNextResult input) {
+    const size_t numAccumulators = _accumulatedFields.size();
     switch (input.getStatus()) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
@@ -631,7 +687,14 @@ MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initi
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (!_spillPartitions.empty()) {
+                // Partitions are re-aggregated one at a time by getNextPartitioned().
+                _spilled = true;
+                if (!_groups->empty()) {
+                    spillGroupsToPartitions(0);
+                }
+                groupsIterator = _groups->end();
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -665,6 +728,18 @@ MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initi
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceGroup::spillGroups() {
+    if (_numSpillPartitions < 2) {
+        _sortedFiles.push_back(spill());
+        return;
+    }
+
+    if (_spillPartitions.empty()) {
+        addSpillPartitions(0);
+    }
+    spillGroupsToPartitions(0);
+}
+
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     _stats.spills++;
 
@@ -676,6 +751,7 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
+    const auto startOffset = _file->currentOffset();
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir), _file);
     switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
         case 0:                           // no values, essentially a distinct
@@ -714,9 +790,173 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     }
 
     Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
+    _stats.spilledDataStorageSize += _file->currentOffset() - startOffset;
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
+void DocumentSourceGroup::addSpillPartitions(size_t depth) {
+    for (size_t i = 0; i < _numSpillPartitions; ++i) {
+        _spillPartitions.push_back(
+            {std::make_shared<Sorter<Value, Value>::File>(pExpCtx->tempDir + "/" + nextFileName()),
+             {},
+             depth});
+    }
+    _stats.spillPartitions += _numSpillPartitions;
+    _stats.maxSpillPartitionDepth = std::max<uint64_t>(_stats.maxSpillPartitionDepth, depth);
+}
+
+size_t DocumentSourceGroup::partitionOf(const Value& id, size_t depth) const {
+    // Mix the hash with a different salt at each depth, so that the groups which shared a
+    // partition at one depth are spread across all partitions at the next.
+    uint64_t hash = pExpCtx->getValueComparator().hash(id) + depth * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash % _numSpillPartitions;
+}
+
+Value DocumentSourceGroup::getSpillState(const Accumulators& accums) const {
+    switch (accums.size()) {  // mirrors switch in spill()
+        case 0:
+            return Value();
+        case 1:
+            return accums[0]->getValue(/*toBeMerged=*/true);
+        default: {
+            vector<Value> states;
+            states.reserve(accums.size());
+            for (auto&& accum : accums) {
+                states.push_back(accum->getValue(/*toBeMerged=*/true));
+            }
+            return Value(std::move(states));
+        }
+    }
+}
+
+void DocumentSourceGroup::spillGroupsToPartitions(size_t firstPartition) {
+    _stats.spills++;
+
+    // Write the groups out one partition at a time, since the runs of a partition file have to be
+    // written sequentially.
+    const auto depth = _spillPartitions[firstPartition].depth;
+    vector<vector<const GroupsMap::value_type*>> groupsByPartition(_numSpillPartitions);
+    for (auto&& group : *_groups) {
+        groupsByPartition[partitionOf(group.first, depth)].push_back(&group);
+    }
+
+    for (size_t i = 0; i < _numSpillPartitions; ++i) {
+        if (groupsByPartition[i].empty()) {
+            continue;
+        }
+
+        auto& partition = _spillPartitions[firstPartition + i];
+        const auto startOffset = partition.file->currentOffset();
+        SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir),
+                                              partition.file);
+        for (auto group : groupsByPartition[i]) {
+            writer.addAlreadySorted(group->first, getSpillState(group->second));
+        }
+        partition.runs.emplace_back(writer.done());
+        _stats.spilledDataStorageSize += partition.file->currentOffset() - startOffset;
+    }
+
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
+    metricsCollector.incrementSorterSpills(1);
+
+    _groups->clear();
+    _memoryTracker.resetCurrent();
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    while (groupsIterator == _groups->end()) {
+        if (_spillPartitions.empty()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+
+        // Take the most recently created partition first, so that the partitions split off from a
+        // partition which did not fit in memory are processed while still in the page cache.
+        auto partition = std::move(_spillPartitions.back());
+        _spillPartitions.pop_back();
+        loadPartition(partition);
+        groupsIterator = _groups->begin();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return out;
+}
+
+void DocumentSourceGroup::loadPartition(SpillPartition& partition) {
+    _groups->clear();
+    _memoryTracker.resetCurrent();
+
+    for (size_t run = 0; run < partition.runs.size(); ++run) {
+        while (partition.runs[run]->more()) {
+            auto next = partition.runs[run]->next();
+            mergeSpilledGroup(next.first, next.second);
+
+            // Split the partition further if its groups do not fit in memory. Past the maximum
+            // depth, hashing is no longer separating the groups, which are then merged in memory
+            // just as when merging sorted runs.
+            if (!_memoryTracker.withinMemoryLimit() &&
+                partition.depth + 1 < kMaxSpillPartitionDepth) {
+                repartition(partition, run);
+                return;
+            }
+        }
+    }
+}
+
+void DocumentSourceGroup::repartition(SpillPartition& partition, size_t currentRun) {
+    const auto firstChild = _spillPartitions.size();
+    const auto childDepth = partition.depth + 1;
+    addSpillPartitions(childDepth);
+    spillGroupsToPartitions(firstChild);
+
+    // Stream the rest of the partition's records directly into the new partitions. Each of them
+    // has its own file, so their writers can be open at the same time.
+    vector<std::unique_ptr<SortedFileWriter<Value, Value>>> writers(_numSpillPartitions);
+    vector<std::streamoff> startOffsets(_numSpillPartitions);
+    for (size_t run = currentRun; run < partition.runs.size(); ++run) {
+        while (partition.runs[run]->more()) {
+            auto next = partition.runs[run]->next();
+            const auto i = partitionOf(next.first, childDepth);
+            if (!writers[i]) {
+                auto& file = _spillPartitions[firstChild + i].file;
+                startOffsets[i] = file->currentOffset();
+                writers[i] = std::make_unique<SortedFileWriter<Value, Value>>(
+                    SortOptions().TempDir(pExpCtx->tempDir), file);
+            }
+            writers[i]->addAlreadySorted(next.first, next.second);
+        }
+    }
+
+    for (size_t i = 0; i < _numSpillPartitions; ++i) {
+        if (writers[i]) {
+            auto& child = _spillPartitions[firstChild + i];
+            child.runs.emplace_back(writers[i]->done());
+            _stats.spilledDataStorageSize += child.file->currentOffset() - startOffsets[i];
+        }
+    }
+}
+
+void DocumentSourceGroup::mergeSpilledGroup(const Value& id, const Value& state) {
+    bool inserted;
+    auto& group = findOrCreateGroup(id, &inserted);
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t i = 0; i < numAccumulators; ++i) {
+        // Mirrors the encoding of getSpillState().
+        const auto& accumState = numAccumulators == 1 ? state : state.getArray()[i];
+        const auto prevMemUsage = inserted ? 0 : group[i]->getMemUsage();
+        group[i]->process(accumState, /*merging=*/true);
+        _memoryTracker.update(_accumulatedFields[i].fieldName,
+                              group[i]->getMemUsage() - prevMemUsage);
+    }
+}
+
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
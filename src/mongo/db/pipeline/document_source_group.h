@@ -216,6 +216,7 @@ private:
      */
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
+    GetNextResult getNextPartitioned();
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
@@ -235,6 +236,23 @@ private:
      */
     GetNextResult initializeSelf(GetNextResult input);
 
+    /**
+     * Variant of initializeSelf() which pulls the input from 'pSource' in batches of 'batchSize'
+     * documents.
+     */
+    GetNextResult initializeFromBatches(size_t batchSize);
+
+    /**
+     * Adds 'rootDocument' to the group it belongs to, spilling first if needed.
+     */
+    void processDocument(Document&& rootDocument);
+
+    /**
+     * Prepares this $group to produce results once its input has been consumed up to 'input',
+     * which must be either kEOF or kPauseExecution. Returns 'input'.
+     */
+    GetNextResult finishInitialization(GetNextResult input);
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -242,6 +260,74 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Spills the groups map to disk, either as a sorted run via spill() or, if
+     * 'internalDocumentSourceGroupSpillPartitions' was set, into hash partitions.
+     */
+    void spillGroups();
+
+    /**
+     * When spilling into hash partitions, the groups map is split into '_numSpillPartitions'
+     * partitions by the hash of the group key. Each partition is a file holding any number of runs
+     * of partially aggregated groups, each run written by a single spill. Once the input is
+     * exhausted the partitions are re-aggregated one at a time, so that only the groups of a single
+     * partition need to fit in memory, without having to sort or merge any runs. A partition whose
+     * groups do not fit in memory either is split again into '_numSpillPartitions' partitions one
+     * level deeper, up to 'kMaxSpillPartitionDepth'.
+     */
+    struct SpillPartition {
+        std::shared_ptr<Sorter<Value, Value>::File> file;
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> runs;
+        size_t depth;
+    };
+
+    /**
+     * Appends '_numSpillPartitions' new, empty partitions at 'depth' to '_spillPartitions'.
+     */
+    void addSpillPartitions(size_t depth);
+
+    /**
+     * Returns the index within its level of the partition which the group with key 'id' belongs
+     * to at 'depth'.
+     */
+    size_t partitionOf(const Value& id, size_t depth) const;
+
+    /**
+     * Writes a run of the groups map into each of the '_numSpillPartitions' partitions starting at
+     * '_spillPartitions[firstPartition]', and clears the groups map.
+     */
+    void spillGroupsToPartitions(size_t firstPartition);
+
+    /**
+     * Re-aggregates the runs of 'partition' into the groups map, which must not contain any groups
+     * which still need to be returned. If the groups do not fit in memory, splits the partition by
+     * calling repartition(), leaving the groups map empty.
+     */
+    void loadPartition(SpillPartition& partition);
+
+    /**
+     * Splits 'partition', which has been merged into the groups map up to the current position
+     * of run 'currentRun', into new partitions one level deeper.
+     */
+    void repartition(SpillPartition& partition, size_t currentRun);
+
+    /**
+     * Returns the state of 'accums' in the format in which they are spilled, which is a single
+     * Value for a single accumulator or an array of Values otherwise.
+     */
+    Value getSpillState(const Accumulators& accums) const;
+
+    /**
+     * Merges the spilled accumulator state 'state' into the group with key 'id'.
+     */
+    void mergeSpilledGroup(const Value& id, const Value& state);
+
+    /**
+     * Returns the accumulators of the group with key 'id', creating and initializing the group if
+     * it does not exist yet, in which case 'inserted' is set to true.
+     */
+    Accumulators& findOrCreateGroup(const Value& id, bool* inserted);
+
     /**
      * If we ran out of memory, finish all the pending operations so that some memory
      * can be freed.
@@ -314,6 +400,14 @@ private:
 
     std::pair<Value, Value> _firstPartOfNextGroup;
 
+    // The number of hash partitions to spill into, or less than 2 to spill sorted runs instead.
+    const size_t _numSpillPartitions;
+
+    // The hash partitions spilled so far. Once the input is exhausted, the partitions which have
+    // not been returned yet. Only used when spilling into hash partitions.
+    std::vector<SpillPartition> _spillPartitions;
+    static constexpr size_t kMaxSpillPartitionDepth = 4;
+
     bool _sbeCompatible;
 };
 
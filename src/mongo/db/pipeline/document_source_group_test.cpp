@@ -52,9 +52,11 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/memory_arena.h"
 
 namespace mongo {
 
@@ -148,6 +150,99 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldReaggregateHashPartitionsWhenSpillingIntoPartitions) {
+    RAIIServerParameterControllerForTest partitions("internalDocumentSourceGroupSpillPartitions",
+                                                    4);
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    auto&& [parser, _1, _2, _3] = AccumulationStatement::getParser("$sum");
+    auto accumulatorArg = BSON("" << 1);
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement countStatement{"count", accExpr};
+    auto groupByExpression =
+        ExpressionFieldPath::parse(expCtx.get(), "$key", expCtx->variablesParseState);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {countStatement}, maxMemoryUsageBytes);
+
+    // Many more groups than fit in memory, each of which is seen several times, so that partially
+    // aggregated groups are spilled repeatedly and need to be merged.
+    const int kNumGroups = 200;
+    const int kDocsPerGroup = 5;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < kNumGroups * kDocsPerGroup; ++i) {
+        inputs.emplace_back(Document{{"key", i % kNumGroups}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["count"].coerceToInt(), kDocsPerGroup);
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(kNumGroups));
+
+    auto stats = static_cast<const GroupStats*>(group->getSpecificStats());
+    ASSERT_GT(stats->spills, 0U);
+    ASSERT_GT(stats->spilledDataStorageSize, 0U);
+    ASSERT_GTE(stats->spillPartitions, 4U);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldNotSpillRepeatedlyForDrainedArenaChunks) {
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 40 * 1024;
+
+    auto&& [parser, _1, _2, _3] = AccumulationStatement::getParser("$push");
+    auto accumulatorArg = BSON(""
+                               << "$str");
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement pushStatement{"strs", accExpr};
+    auto groupByExpression =
+        ExpressionFieldPath::parse(expCtx.get(), "$_id", expCtx->variablesParseState);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {pushStatement}, maxMemoryUsageBytes);
+
+    // Build the input and run the $group with an arena installed, so that the pushed strings live
+    // in arena chunks which drain each time the $group spills.
+    MemoryArena arena(4096);
+    MemoryArena::Scope scope(&arena);
+
+    const int kNumDocs = 200;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"str", std::string(800, 'a' + i % 26)}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["strs"].getArrayLength(), 1U);
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+    }
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(kNumDocs));
+
+    // Once the $group has spilled, the chunks its data was drained from are not charged to it, so
+    // it goes on to fill its budget again rather than spilling on every subsequent document.
+    auto stats = static_cast<const GroupStats*>(group->getSpecificStats());
+    ASSERT_GT(stats->spills, 1U);
+    ASSERT_LT(stats->spills, 20U);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
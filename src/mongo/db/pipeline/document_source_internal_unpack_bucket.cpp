@@ -58,6 +58,7 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
@@ -477,6 +478,10 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
             out.addField("sample", Value{static_cast<long long>(*_sampleSize)});
             out.addField("bucketMaxCount", Value{_bucketMaxCount});
         }
+        if (_bucketUnpacker.hasColumnPredicates() &&
+            *explain >= ExplainOptions::Verbosity::kExecStats) {
+            out.addField("measurementsSkipped", Value{_bucketUnpacker.numMeasurementsSkipped()});
+        }
         array.push_back(Value(DOC(getSourceName() << out.freeze())));
     }
 }
@@ -491,15 +496,20 @@ DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
     }
 
     auto nextResult = pSource->getNext();
-    if (nextResult.isAdvanced()) {
+    while (nextResult.isAdvanced()) {
         auto bucket = nextResult.getDocument().toBson();
         _bucketUnpacker.reset(std::move(bucket));
         uassert(5346509,
                 str::stream() << "A bucket with _id "
                               << _bucketUnpacker.bucket()[timeseries::kBucketIdFieldName].toString()
                               << " contains an empty data region",
-                _bucketUnpacker.hasNext());
-        return _bucketUnpacker.getNext();
+                _bucketUnpacker.numberOfMeasurements() > 0);
+        if (_bucketUnpacker.hasNext()) {
+            return _bucketUnpacker.getNext();
+        }
+
+        // Every measurement in the bucket was rejected by the column predicates.
+        nextResult = pSource->getNext();
     }
 
     return nextResult;
@@ -638,99 +648,157 @@ DocumentSourceInternalUnpackBucket::rewriteGroupByMinMax(Pipeline::SourceContain
     }
 
     const auto& idFields = groupPtr->getIdFields();
-    if (idFields.size() != 1 || !_bucketUnpacker.bucketSpec().metaField().has_value()) {
+    if (idFields.size() != 1) {
         return {};
     }
 
-    const auto& exprId = idFields.cbegin()->second;
-    const auto* exprIdPath = dynamic_cast<const ExpressionFieldPath*>(exprId.get());
-    if (exprIdPath == nullptr) {
-        return {};
-    }
+    // Maps a path on the metaField of a measurement to the corresponding path in the bucket.
+    auto makeBucketMetaPath = [&](const FieldPath& path) {
+        std::ostringstream os;
+        os << timeseries::kBucketMetaFieldName;
+        for (size_t index = 2; index < path.getPathLength(); index++) {
+            os << "." << path.getFieldName(index);
+        }
+        return ExpressionFieldPath::createPathFromString(
+            pExpCtx.get(), os.str(), pExpCtx->variablesParseState);
+    };
+
+    // The control block and meta value of a bucket describe the fields as stored in the bucket.
+    // They cannot stand in for a field which the unpacker projects out, or replaces with a value
+    // computed from the metaField.
+    const auto& spec = _bucketUnpacker.bucketSpec();
+    auto isUnpackedAsStored = [&](StringData field) {
+        if (spec.fieldIsComputed(field)) {
+            return false;
+        }
+        if (field == spec.timeField()) {
+            return _bucketUnpacker.includeTimeField();
+        }
+        if (spec.metaField() && field == *spec.metaField()) {
+            return _bucketUnpacker.includeMetaField();
+        }
+        const bool inFieldSet = spec.fieldSet().count(field.toString()) > 0;
+        return inFieldSet == (_bucketUnpacker.behavior() == BucketUnpacker::Behavior::kInclude);
+    };
 
-    const auto& idPath = exprIdPath->getFieldPath();
-    if (idPath.getPathLength() < 2 ||
-        idPath.getFieldName(1) != _bucketUnpacker.bucketSpec().metaField().get()) {
+    // The group key must be the same for every measurement in a bucket: either a constant, or a
+    // path on the metaField.
+    const auto& exprId = idFields.cbegin()->second;
+    boost::intrusive_ptr<Expression> newExprId;
+    if (dynamic_cast<const ExpressionConstant*>(exprId.get())) {
+        newExprId = exprId;
+    } else if (const auto* exprIdPath = dynamic_cast<const ExpressionFieldPath*>(exprId.get())) {
+        const auto& idPath = exprIdPath->getFieldPath();
+        if (!spec.metaField() || idPath.getPathLength() < 2 ||
+            idPath.getFieldName(1) != spec.metaField().get() ||
+            !isUnpackedAsStored(idPath.getFieldName(1))) {
+            return {};
+        }
+        newExprId = makeBucketMetaPath(idPath);
+    } else {
         return {};
     }
 
-    bool suitable = true;
+    const auto& timeField = spec.timeField();
     std::vector<AccumulationStatement> accumulationStatements;
     for (const AccumulationStatement& stmt : groupPtr->getAccumulatedFields()) {
         const auto op = stmt.expr.name;
         const bool isMin = op == "$min";
         const bool isMax = op == "$max";
-
-        // Rewrite is valid only for min and max aggregates.
-        if (!isMin && !isMax) {
-            suitable = false;
-            break;
-        }
-
+        const bool isSum = op == AccumulatorSum::kName;
         const auto* exprArg = stmt.expr.argument.get();
-        if (const auto* exprArgPath = dynamic_cast<const ExpressionFieldPath*>(exprArg)) {
-            const auto& path = exprArgPath->getFieldPath();
-            if (path.getPathLength() <= 1 ||
-                path.getFieldName(1) == _bucketUnpacker.bucketSpec().timeField()) {
-                // Rewrite not valid for time field. We want to eliminate the bucket
-                // unpack stage here.
-                suitable = false;
-                break;
-            }
 
-            // Update aggregates to reference the control field.
-            std::ostringstream os;
-            if (isMin) {
-                os << timeseries::kControlMinFieldNamePrefix;
-            } else {
-                os << timeseries::kControlMaxFieldNamePrefix;
+        AccumulationExpression accExpr = stmt.expr;
+        if (isSum) {
+            // Only a count of measurements, as in {$sum: 1} or {$count: {}}, can be answered from
+            // the bucket: summing the number of measurements in each bucket gives the same total.
+            // Compressed buckets always record their count, and for uncompressed ones it is the
+            // number of entries in the time column. The unpacker yields every measurement whatever
+            // fields it projects, so the count does not depend on them.
+            const auto* exprArgConst = dynamic_cast<const ExpressionConstant*>(exprArg);
+            if (!exprArgConst || exprArgConst->getValue().getType() != NumberInt ||
+                exprArgConst->getValue().getInt() != 1) {
+                return {};
             }
 
-            for (size_t index = 1; index < path.getPathLength(); index++) {
-                if (index > 1) {
-                    os << ".";
-                }
-                os << path.getFieldName(index);
-            }
+            accExpr.argument = Expression::parseOperand(
+                pExpCtx.get(),
+                BSON("$ifNull" << BSON_ARRAY(
+                         "$" + timeseries::kBucketControlFieldName + "." +
+                             timeseries::kBucketControlCountFieldName
+                         << BSON("$size" << BSON("$objectToArray"
+                                                 << "$" + timeseries::kDataFieldNamePrefix +
+                                                        timeField))))
+                    .firstElement(),
+                pExpCtx->variablesParseState);
+            accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+            continue;
+        }
 
-            const auto& newExpr = ExpressionFieldPath::createPathFromString(
-                pExpCtx.get(), os.str(), pExpCtx->variablesParseState);
+        // Otherwise the rewrite is valid only for min and max aggregates on a field path.
+        const auto* exprArgPath = dynamic_cast<const ExpressionFieldPath*>(exprArg);
+        if ((!isMin && !isMax) || !exprArgPath) {
+            return {};
+        }
+
+        const auto& path = exprArgPath->getFieldPath();
+        if (path.getPathLength() <= 1) {
+            return {};
+        }
 
-            AccumulationExpression accExpr = stmt.expr;
-            accExpr.argument = newExpr;
+        // The control.min value of the time field is rounded down to the bucket's granularity, so
+        // only the maximum can be taken from the control block. The time field has no subfields.
+        if (path.getFieldName(1) == timeField && (isMin || path.getPathLength() > 2)) {
+            return {};
+        }
+        if (!isUnpackedAsStored(path.getFieldName(1))) {
+            return {};
+        }
+
+        // The meta value is the same for every measurement in a bucket.
+        if (auto&& metaField = spec.metaField();
+            metaField && path.getFieldName(1) == *metaField) {
+            accExpr.argument = makeBucketMetaPath(path);
             accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+            continue;
         }
-    }
 
-    if (suitable) {
+        // Update aggregates to reference the control field.
         std::ostringstream os;
-        os << timeseries::kBucketMetaFieldName;
-        for (size_t index = 2; index < idPath.getPathLength(); index++) {
-            os << "." << idPath.getFieldName(index);
+        if (isMin) {
+            os << timeseries::kControlMinFieldNamePrefix;
+        } else {
+            os << timeseries::kControlMaxFieldNamePrefix;
         }
-        auto exprId1 = ExpressionFieldPath::createPathFromString(
+
+        for (size_t index = 1; index < path.getPathLength(); index++) {
+            if (index > 1) {
+                os << ".";
+            }
+            os << path.getFieldName(index);
+        }
+
+        accExpr.argument = ExpressionFieldPath::createPathFromString(
             pExpCtx.get(), os.str(), pExpCtx->variablesParseState);
+        accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+    }
 
-        auto newGroup = DocumentSourceGroup::create(pExpCtx,
-                                                    std::move(exprId1),
-                                                    std::move(accumulationStatements),
-                                                    groupPtr->getMaxMemoryUsageBytes());
+    auto newGroup = DocumentSourceGroup::create(pExpCtx,
+                                                std::move(newExprId),
+                                                std::move(accumulationStatements),
+                                                groupPtr->getMaxMemoryUsageBytes());
 
-        // Erase current stage and following group stage, and replace with updated
-        // group.
-        container->erase(std::next(itr));
-        *itr = std::move(newGroup);
+    // Erase current stage and following group stage, and replace with updated group.
+    container->erase(std::next(itr));
+    *itr = std::move(newGroup);
 
-        if (itr == container->begin()) {
-            // Optimize group stage.
-            return {true, itr};
-        } else {
-            // Give chance of the previous stage to optimize against group stage.
-            return {true, std::prev(itr)};
-        }
+    if (itr == container->begin()) {
+        // Optimize group stage.
+        return {true, itr};
+    } else {
+        // Give chance of the previous stage to optimize against group stage.
+        return {true, std::prev(itr)};
     }
-
-    return {};
 }
 
 bool DocumentSourceInternalUnpackBucket::haveComputedMetaField() const {
@@ -1060,6 +1128,16 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
         }
     }
 
+    // Evaluate the eligible parts of a subsequent $match against the compressed columns of each
+    // bucket, so that measurements which cannot match are not unpacked. The $match itself stays in
+    // the pipeline since the column predicates are only a subset of it.
+    _bucketUnpacker.setColumnPredicates({});
+    if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get());
+        nextMatch && !_sampleSize && internalQueryTimeseriesPushdownColumnPredicates.load()) {
+        _bucketUnpacker.setColumnPredicates(BucketSpec::createPredicatesOnDataColumns(
+            nextMatch->getMatchExpression(), _bucketUnpacker.bucketSpec()));
+    }
+
     // Attempt to push down a $project on the metaField past $_internalUnpackBucket.
     if (!haveComputedMetaField) {
         if (auto [metaProject, deleteRemainder] = extractProjectForPushDown(std::next(itr)->get());
@@ -185,9 +185,11 @@ public:
     std::pair<BSONObj, bool> extractProjectForPushDown(DocumentSource* src) const;
 
     /**
-     * Helper method which checks if we can avoid unpacking if we have a group stage with min/max
-     * aggregates. If a rewrite is possible, 'container' is modified, and we returns result value
-     * for 'doOptimizeAt'.
+     * Helper method which checks if we can avoid unpacking if we have a group stage, keyed by a
+     * constant or by the metaField, whose aggregates can be answered exactly from the bucket:
+     * $min/$max on measurement fields (other than $min on the time field), and measurement counts
+     * such as {$sum: 1} or {$count: {}}. If a rewrite is possible, 'container' is modified, and we
+     * returns result value for 'doOptimizeAt'.
      */
     std::pair<bool, Pipeline::SourceContainer::iterator> rewriteGroupByMinMax(
         Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container);
@@ -47,12 +47,13 @@ TEST_F(InternalUnpackBucketGroupReorder, OptimizeForCount) {
     pipeline->optimizePipeline();
 
     auto serialized = pipeline->serializeToBson();
-    // $count gets rewritten to $group + $project.
-    ASSERT_EQ(3, serialized.size());
+    // $count gets rewritten to $group + $project, and the $group counts the measurements of each
+    // bucket without unpacking it.
+    ASSERT_EQ(2, serialized.size());
 
     auto optimized = fromjson(
-        "{$_internalUnpackBucket: { include: [], timeField: 't', metaField: 'meta', "
-        "bucketMaxSpanSeconds: 3600}}");
+        "{$group: {_id: {$const: null}, foo: {$sum: {$ifNull: ['$control.count', {$size: "
+        "[{$objectToArray: ['$data.t']}]}]}}}}");
     ASSERT_BSONOBJ_EQ(optimized, serialized[0]);
 }
 
@@ -77,8 +78,8 @@ TEST_F(InternalUnpackBucketGroupReorder, OptimizeForCountNegative) {
 
 TEST_F(InternalUnpackBucketGroupReorder, MinMaxGroupOnMetadata) {
     auto unpackSpecObj = fromjson(
-        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
-        "bucketMaxSpanSeconds: 3600}}");
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c', 'meta1'], metaField: 'meta1', "
+        "timeField: 't', bucketMaxSpanSeconds: 3600}}");
     auto groupSpecObj =
         fromjson("{$group: {_id: '$meta1.a.b', accmin: {$min: '$b'}, accmax: {$max: '$c'}}}");
 
@@ -126,5 +127,116 @@ TEST_F(InternalUnpackBucketGroupReorder, MinMaxGroupOnMetadataNegative1) {
     ASSERT_BSONOBJ_EQ(groupSpecObj, serialized[1]);
 }
 
+TEST_F(InternalUnpackBucketGroupReorder, CountAndMaxTimeGroupOnMetadata) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c', 't', 'meta'], metaField: 'meta', "
+        "timeField: 't', bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson(
+        "{$group: {_id: '$meta.region', n: {$sum: 1}, c: {$count: {}}, last: {$max: '$t'}, "
+        "m: {$min: '$meta.x'}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(1, serialized.size());
+
+    auto optimized = fromjson(
+        "{$group: {_id: '$meta.region', "
+        "n: {$sum: {$ifNull: ['$control.count', {$size: [{$objectToArray: ['$data.t']}]}]}}, "
+        "c: {$sum: {$ifNull: ['$control.count', {$size: [{$objectToArray: ['$data.t']}]}]}}, "
+        "last: {$max: '$control.max.t'}, m: {$min: '$meta.x'}}}");
+    ASSERT_BSONOBJ_EQ(optimized, serialized[0]);
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, MinMaxGroupOnConstant) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson("{$group: {_id: null, accmin: {$min: '$a'}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(1, serialized.size());
+
+    auto optimized = fromjson("{$group: {_id: {$const: null}, accmin: {$min: '$control.min.a'}}}");
+    ASSERT_BSONOBJ_EQ(optimized, serialized[0]);
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelAggregatesNegative) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], timeField: 't', metaField: 'meta', "
+        "bucketMaxSpanSeconds: 3600}}");
+
+    // The minimum time is rounded down in the control block, and sums other than a count of
+    // measurements need every value.
+    for (auto&& groupSpecObj : {fromjson("{$group: {_id: '$meta', accmin: {$min: '$t'}}}"),
+                                fromjson("{$group: {_id: '$meta', s: {$sum: '$a'}}}"),
+                                fromjson("{$group: {_id: '$meta', s: {$sum: 2}}}"),
+                                fromjson("{$group: {_id: '$meta', m: {$max: {$add: ['$a', 1]}}}}"),
+                                fromjson("{$group: {_id: {$add: ['$meta', 1]}, n: {$sum: 1}}}")}) {
+        auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+        pipeline->optimizePipeline();
+
+        auto serialized = pipeline->serializeToBson();
+        ASSERT_EQ(2, serialized.size());
+        ASSERT_BSONOBJ_EQ(unpackSpecObj, serialized[0]);
+    }
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelAggregatesAfterProjectNegative) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], metaField: 'meta', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+
+    // The fields projected out or computed from the metaField before the $group are missing or
+    // differ from those described by the control block and meta value of the bucket.
+    auto project = fromjson("{$project: {b: 1}}");
+    std::vector<std::vector<BSONObj>> stages{
+        {project, fromjson("{$group: {_id: null, m: {$max: '$a'}}}")},
+        {project, fromjson("{$group: {_id: null, last: {$max: '$t'}}}")},
+        {project, fromjson("{$group: {_id: null, m: {$min: '$meta.x'}}}")},
+        {project, fromjson("{$group: {_id: '$meta', m: {$max: '$b'}}}")},
+        {project, fromjson("{$group: {_id: null, n: {$count: {}}, m: {$max: '$a'}}}")},
+        {fromjson("{$project: {a: 0}}"), fromjson("{$group: {_id: null, m: {$max: '$a'}}}")},
+        {fromjson("{$addFields: {a: '$meta.x'}}"),
+         fromjson("{$group: {_id: null, m: {$max: '$a'}}}")}};
+    for (auto&& stagesAfterUnpack : stages) {
+        auto pipelineObjs = makeVector(unpackSpecObj);
+        pipelineObjs.insert(pipelineObjs.end(), stagesAfterUnpack.begin(), stagesAfterUnpack.end());
+        auto pipeline = Pipeline::parse(pipelineObjs, getExpCtx());
+        pipeline->optimizePipeline();
+
+        // The buckets are still unpacked. A computed meta projection is pushed down before it.
+        auto serialized = pipeline->serializeToBson();
+        ASSERT(std::any_of(serialized.begin(), serialized.end(), [](const BSONObj& stage) {
+            return stage.firstElementFieldNameStringData() == "$_internalUnpackBucket"_sd;
+        }));
+    }
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, OptimizeForCountAfterProject) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], metaField: 'meta', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+
+    // Every measurement is unpacked whatever fields are projected, so they can still be counted
+    // from the bucket.
+    auto pipeline = Pipeline::parse(
+        makeVector(unpackSpecObj, fromjson("{$project: {b: 1}}"), fromjson("{$count: 'foo'}")),
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2, serialized.size());
+
+    auto optimized = fromjson(
+        "{$group: {_id: {$const: null}, foo: {$sum: {$ifNull: ['$control.count', {$size: "
+        "[{$objectToArray: ['$data.t']}]}]}}}}");
+    ASSERT_BSONOBJ_EQ(optimized, serialized[0]);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,9 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/timeseries/bucket_compression.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
 
 namespace mongo {
@@ -925,5 +928,42 @@ TEST_F(InternalUnpackBucketExecTest, ParserRoundtripsComputedMetaProjFieldOverri
     unpackBucket->serializeToArray(array);
     ASSERT_BSONOBJ_EQ(array[0].getDocument().toBson(), bson);
 }
+
+TEST_F(InternalUnpackBucketExecTest, ColumnPredicatesIgnoreFieldsProjectedOut) {
+    auto bucket = fromjson(
+        "{control: {'version': 1}, data: {_id: {'0':1, '1':2, '2':3}, time: {'0':1, '1':2, '2':3}, "
+        "a: {'0':1, '1':2, '2':3}, b: {'0':1, '2':3}}}");
+    auto compressed = *timeseries::compressBucket(bucket, "time"_sd, {}, false).compressedBucket;
+    auto unpack = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], timeField: 'time', bucketMaxSpanSeconds: 3600}}");
+
+    // 'a' is projected out before the $match, so it matches a null comparison in every
+    // measurement even though the column holds no nulls.
+    auto runPipeline = [&](BSONObj project, BSONObj match) {
+        auto pipeline = Pipeline::parse(makeVector(unpack, project, match), getExpCtx());
+        pipeline->optimizePipeline();
+        pipeline->addInitialSource(
+            DocumentSourceMock::createForTest(Document(compressed), getExpCtx()));
+
+        std::vector<Document> results;
+        while (auto next = pipeline->getNext()) {
+            results.push_back(*next);
+        }
+        return results;
+    };
+
+    auto results = runPipeline(fromjson("{$project: {b: 1}}"), fromjson("{$match: {a: null}}"));
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{_id: 1, b: 1}")));
+    ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{_id: 2}")));
+    ASSERT_DOCUMENT_EQ(results[2], Document(fromjson("{_id: 3, b: 3}")));
+
+    results = runPipeline(fromjson("{$project: {a: 0}}"), fromjson("{$match: {a: {$lte: null}}}"));
+    ASSERT_EQ(results.size(), 3U);
+
+    results = runPipeline(fromjson("{$project: {a: 0}}"), fromjson("{$match: {a: {$gte: null}}}"));
+    ASSERT_EQ(results.size(), 3U);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace {
@@ -72,6 +73,24 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Returns true if 'obj' contains a stage or operator anywhere within it whose output may differ
+ * between two runs over the same input.
+ */
+bool containsNonDeterministicOperator(const BSONObj& obj) {
+    static const StringDataSet kNonDeterministicOperators{
+        "$sample", "$sampleRate", "$rand", "$function", "$accumulator", "$where"};
+    for (auto&& elem : obj) {
+        if (kNonDeterministicOperators.count(elem.fieldNameStringData())) {
+            return true;
+        }
+        if (elem.isABSONObj() && containsNonDeterministicOperator(elem.Obj())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void lookupPipeValidator(const Pipeline& pipeline) {
     const auto& sources = pipeline.getSources();
     std::for_each(sources.begin(), sources.end(), [](auto& src) {
@@ -453,6 +472,24 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         _resolvedPipeline[*_fieldMatchPipelineIdx] = matchStage;
     }
 
+    boost::optional<std::string> memoKey;
+    if (auto memoCache = getMemoCache()) {
+        memoKey = makeMemoCacheKey(inputDoc);
+        auto cachedResults = memoCache->find(*memoKey);
+        _stats.memoCacheHits = memoCache->hits();
+        _stats.memoCacheMisses = memoCache->misses();
+        _stats.memoCacheAbandoned = memoCache->isAbandoned();
+
+        if (cachedResults) {
+            MutableDocument output(std::move(inputDoc));
+            output.setNestedField(_as, *cachedResults);
+            return output.freeze();
+        }
+        if (memoCache->isAbandoned()) {
+            memoKey = boost::none;
+        }
+    }
+
     std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
     try {
         pipeline = buildPipeline(inputDoc);
@@ -492,11 +529,68 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
     }
 
     accumulatePipelinePlanSummaryStats(*pipeline, _stats.planSummaryStats);
+    Value resultsValue(std::move(results));
+    if (memoKey) {
+        _memoCache->insert(std::move(*memoKey), resultsValue);
+    }
+
     MutableDocument output(std::move(inputDoc));
-    output.setNestedField(_as, Value(std::move(results)));
+    output.setNestedField(_as, std::move(resultsValue));
     return output.freeze();
 }
 
+LookupMemoCache* DocumentSourceLookUp::getMemoCache() {
+    if (!_memoCacheInitialized) {
+        _memoCacheInitialized = true;
+        const auto maxSizeBytes = internalLookupMemoCacheSizeBytes.load();
+        if (maxSizeBytes > 0 && canMemoizeResults()) {
+            _memoCache.emplace(maxSizeBytes,
+                               internalLookupMemoCacheHitRateSampleSize.load(),
+                               internalLookupMemoCacheMinHitRate.load());
+        }
+    }
+
+    return _memoCache && !_memoCache->isAbandoned() ? _memoCache.get_ptr() : nullptr;
+}
+
+bool DocumentSourceLookUp::canMemoizeResults() const {
+    if (_unwindSrc || (!hasLocalFieldForeignFieldJoin() && _letVariables.empty())) {
+        return false;
+    }
+
+    for (auto&& stage : _resolvedPipeline) {
+        if (containsNonDeterministicOperator(stage)) {
+            return false;
+        }
+    }
+
+    BSONObjBuilder letBuilder;
+    for (auto&& letVar : _letVariables) {
+        letVar.expression->serialize(false).addToBsonObj(&letBuilder, letVar.name);
+    }
+    return !containsNonDeterministicOperator(letBuilder.done());
+}
+
+std::string DocumentSourceLookUp::makeMemoCacheKey(const Document& inputDoc) const {
+    BSONObjBuilder keyBuilder;
+    if (hasLocalFieldForeignFieldJoin()) {
+        keyBuilder.append("", _resolvedPipeline[*_fieldMatchPipelineIdx]);
+    }
+
+    // Missing values are left out, so that they do not share an entry with any value.
+    for (auto&& letVar : _letVariables) {
+        auto value = letVar.expression->evaluate(inputDoc, &pExpCtx->variables);
+        if (!value.missing()) {
+            value.addToBsonObj(&keyBuilder, letVar.name);
+        }
+    }
+
+    // Compare keys byte by byte, since values which compare equal, such as 1 and 1.0, or strings
+    // which are equal under the collation, may still produce different sub-pipeline results.
+    auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipelineFromViewDefinition(
     std::vector<BSONObj> serializedPipeline,
     ExpressionContext::ResolvedNamespace resolvedNamespace) {
@@ -1015,6 +1109,12 @@ void DocumentSourceLookUp::appendSpecificExecStats(MutableDocument& doc) const {
                    std::back_inserter(indexesUsedVec),
                    [](std::string idx) -> Value { return Value(idx); });
     doc["indexesUsed"] = Value{std::move(indexesUsedVec)};
+
+    if (_memoCache) {
+        doc["memoCache"] = Value(Document{{"hits", _stats.memoCacheHits},
+                                          {"misses", _stats.memoCacheMisses},
+                                          {"abandoned", _stats.memoCacheAbandoned}});
+    }
 }
 
 void DocumentSourceLookUp::serializeToArray(
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_memo_cache.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 
 namespace mongo {
@@ -350,6 +351,25 @@ private:
      */
     void addCacheStageAndOptimize(Pipeline& pipeline);
 
+    /**
+     * Returns the cache of sub-pipeline results keyed by join value, creating it on first use, or
+     * nullptr if the results of this $lookup cannot be or are no longer being memoized.
+     */
+    LookupMemoCache* getMemoCache();
+
+    /**
+     * Returns true if the sub-pipeline results depend only on the join value of the local document
+     * and may therefore be memoized: that is, if this is a correlated $lookup which has not
+     * absorbed an $unwind and whose sub-pipeline and 'let' variables are deterministic.
+     */
+    bool canMemoizeResults() const;
+
+    /**
+     * Encodes the values that 'inputDoc' contributes to the sub-pipeline as a memo cache key. Must
+     * be called after the local/foreignField $match, if any, has been built for 'inputDoc'.
+     */
+    std::string makeMemoCacheKey(const Document& inputDoc) const;
+
     /**
      * Given a mutable document, appends execution stats such as 'totalDocsExamined',
      * 'totalKeysExamined', 'collectionScans', 'indexesUsed', etc. to it.
@@ -392,6 +412,12 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // Remembers the results of a correlated sub-pipeline for the join values seen so far, so that
+    // repeated join values do not re-run the sub-pipeline. Created on the first call to
+    // getMemoCache() if canMemoizeResults() allows it.
+    boost::optional<LookupMemoCache> _memoCache;
+    bool _memoCacheInitialized = false;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -50,6 +50,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/idl/server_parameter_test_util.h"
 
 namespace mongo {
 namespace {
@@ -1397,6 +1398,82 @@ TEST_F(DocumentSourceLookUpTest,
         secondResult.getDocument());
 }
 
+TEST_F(DocumentSourceLookUpTest, ShouldServeRepeatedJoinValuesFromMemoCache) {
+    RAIIServerParameterControllerForTest memoCacheSize("internalLookupMemoCacheSizeBytes",
+                                                       1024 * 1024);
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "coll");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"x", 0}},
+                                                             Document{{"x", 1}}};
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(mockForeignContents);
+
+    auto docSource = DocumentSourceLookUp::createFromBson(
+        fromjson("{$lookup: {let: {var1: '$v'}, pipeline: [{$addFields: {varField: {$sum: ['$x', "
+                 "'$$var1']}}}], from: 'coll', as: 'as'}}")
+            .firstElement(),
+        expCtx);
+    auto lookupStage = static_cast<DocumentSourceLookUp*>(docSource.get());
+    ASSERT(lookupStage);
+
+    // The second and fourth documents repeat join values. The last one has an equal but not
+    // identical join value, which must not be served from the cache.
+    auto mockLocalSource = DocumentSourceMock::createForTest({Document{{"_id", 0}, {"v", 1}},
+                                                              Document{{"_id", 1}, {"v", 1}},
+                                                              Document{{"_id", 2}, {"v", 2}},
+                                                              Document{{"_id", 3}, {"v", 2}},
+                                                              Document{{"_id", 4}, {"v", 2.0}}},
+                                                             expCtx);
+    lookupStage->setSource(mockLocalSource.get());
+
+    for (int id = 0; id < 5; ++id) {
+        auto next = lookupStage->getNext();
+        ASSERT(next.isAdvanced());
+        const int v = id < 2 ? 1 : 2;
+        ASSERT_VALUE_EQ(next.getDocument()["as"],
+                        Value(std::vector<Value>{Value(Document{{"x", 0}, {"varField", v}}),
+                                                 Value(Document{{"x", 1}, {"varField", v + 1}})}));
+    }
+    ASSERT(lookupStage->getNext().isEOF());
+
+    auto stats = static_cast<const DocumentSourceLookupStats*>(lookupStage->getSpecificStats());
+    ASSERT_EQ(stats->memoCacheHits, 2);
+    ASSERT_EQ(stats->memoCacheMisses, 3);
+    ASSERT_FALSE(stats->memoCacheAbandoned);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotMemoizeNonDeterministicSubPipeline) {
+    RAIIServerParameterControllerForTest memoCacheSize("internalLookupMemoCacheSizeBytes",
+                                                       1024 * 1024);
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "coll");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{Document{{"x", 0}}});
+
+    auto docSource = DocumentSourceLookUp::createFromBson(
+        fromjson("{$lookup: {let: {var1: '$v'}, pipeline: [{$addFields: {r: {$rand: {}}, y: "
+                 "'$$var1'}}], from: 'coll', as: 'as'}}")
+            .firstElement(),
+        expCtx);
+    auto lookupStage = static_cast<DocumentSourceLookUp*>(docSource.get());
+    ASSERT(lookupStage);
+
+    auto mockLocalSource = DocumentSourceMock::createForTest(
+        {Document{{"_id", 0}, {"v", 1}}, Document{{"_id", 1}, {"v", 1}}}, expCtx);
+    lookupStage->setSource(mockLocalSource.get());
+
+    ASSERT(lookupStage->getNext().isAdvanced());
+    ASSERT(lookupStage->getNext().isAdvanced());
+
+    auto stats = static_cast<const DocumentSourceLookupStats*>(lookupStage->getSpecificStats());
+    ASSERT_EQ(stats->memoCacheHits, 0);
+    ASSERT_EQ(stats->memoCacheMisses, 0);
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldNotCacheIfCorrelatedStageIsAbsorbedIntoPlanExecutor) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "coll");
@@ -92,14 +92,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (_matches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -114,6 +107,47 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // The user facing error should have been generated earlier.
+    massert(7802800, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
+
+    const auto batchStart = batch->size();
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (batch->size() - batchStart < maxBatchSize &&
+           status == GetNextResult::ReturnStatus::kAdvanced) {
+        // Let our source append directly to the output, then compact the documents which pass the
+        // filter towards the front of the newly appended range.
+        const auto inputStart = batch->size();
+        status = pSource->getNextBatch(batch, maxBatchSize - (inputStart - batchStart));
+
+        auto out = batch->begin() + inputStart;
+        for (auto in = out; in != batch->end(); ++in) {
+            if (_matches(*in)) {
+                if (out != in) {
+                    *out = std::move(*in);
+                }
+                ++out;
+            }
+        }
+
+        // Releasing the rejected documents here keeps them from being copied on write downstream.
+        batch->erase(out, batch->end());
+    }
+
+    return status;
+}
+
+bool DocumentSourceMatch::_matches(const Document& document) const {
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? document.toBson()
+        : document_path_support::documentToBsonWithPaths(document, _dependencies.fields);
+
+    return _expression->matchesBSON(toMatch);
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
@@ -691,6 +691,28 @@ TEST_F(DocumentSourceMatchTest, ShouldCorrectlyEvaluateJSONSchemaPredicate) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, GetNextBatchShouldReturnOnlyMatchingDocuments) {
+    const auto match = DocumentSourceMatch::create(fromjson("{a: {$gte: 2}}"), getExpCtx());
+    const auto mock = DocumentSourceMock::createForTest(
+        {"{a: 1}", "{a: 2}", "{a: 3}", "{a: 0}", "{a: 4}", "{a: 5}"}, getExpCtx());
+    match->setSource(mock.get());
+
+    // The first batch should be filled up from several batches of input.
+    std::vector<Document> batch;
+    ASSERT(match->getNextBatch(&batch, 3) == DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 3U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 2}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 3}}));
+    ASSERT_DOCUMENT_EQ(batch[2], (Document{{"a", 4}}));
+
+    // The last matching document is returned along with EOF.
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 3) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 5}}));
+    ASSERT_TRUE(match->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldShowOptimizationsInExplainOutputWhenOptimized) {
     const auto match = DocumentSourceMatch::create(fromjson("{$and: [{a: 1}]}"), getExpCtx());
 
@@ -72,6 +72,23 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::doGetN
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceSingleDocumentTransformation::
+    doGetNextBatch(std::vector<Document>* batch, size_t maxBatchSize) {
+    if (!_parsedTransform) {
+        return GetNextResult::ReturnStatus::kEOF;
+    }
+
+    const auto batchStart = batch->size();
+    auto status = pSource->getNextBatch(batch, maxBatchSize);
+
+    // Transform the documents in place, releasing each input as it is replaced by its output.
+    for (auto it = batch->begin() + batchStart; it != batch->end(); ++it) {
+        *it = _parsedTransform->applyTransformation(std::exchange(*it, Document{}));
+    }
+
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     if (_parsedTransform) {
         _parsedTransform->optimize();
@@ -334,6 +334,10 @@ void DocumentSourceSort::serializeToArray(
             Value(static_cast<long long>(stats.totalDataSizeBytes));
         mutDoc["usedDisk"] = Value(stats.spills > 0);
         mutDoc["spills"] = Value(static_cast<long long>(stats.spills));
+        if (stats.maxDocumentArenaOverheadBytes > 0) {
+            mutDoc["maxDocumentArenaOverheadBytes"] =
+                Value(static_cast<long long>(stats.maxDocumentArenaOverheadBytes));
+        }
     }
 
     array.push_back(Value(mutDoc.freeze()));
@@ -206,7 +206,7 @@ DocumentSource::GetNextResult DocumentSourceUnwind::doGetNext() {
     while (nextOut.isEOF()) {
         // No more elements in array currently being unwound. This will loop if the input
         // document is missing the unwind field or has an empty array.
-        auto nextInput = pSource->getNext();
+        auto nextInput = getNextInput();
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
@@ -219,6 +219,55 @@ DocumentSource::GetNextResult DocumentSourceUnwind::doGetNext() {
     return nextOut;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceUnwind::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    for (size_t produced = 0; produced < maxBatchSize; ++produced) {
+        auto nextOut = _unwinder->getNext();
+        while (nextOut.isEOF()) {
+            auto nextInput = getNextInput(maxBatchSize);
+            if (!nextInput.isAdvanced()) {
+                // Hand back what we have so far; the status is returned by the next call.
+                if (produced > 0) {
+                    _pendingInputStatus = nextInput.getStatus();
+                    return GetNextResult::ReturnStatus::kAdvanced;
+                }
+                return nextInput.getStatus();
+            }
+
+            _unwinder->resetDocument(nextInput.releaseDocument());
+            nextOut = _unwinder->getNext();
+        }
+        batch->push_back(nextOut.releaseDocument());
+    }
+
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
+DocumentSource::GetNextResult DocumentSourceUnwind::getNextInput(size_t batchSize) {
+    if (_inputBufferPos == _inputBuffer.size()) {
+        if (_pendingInputStatus) {
+            auto status = *std::exchange(_pendingInputStatus, boost::none);
+            return status == GetNextResult::ReturnStatus::kEOF ? GetNextResult::makeEOF()
+                                                               : GetNextResult::makePauseExecution();
+        }
+        if (batchSize == 0) {
+            return pSource->getNext();
+        }
+
+        _inputBuffer.clear();
+        _inputBufferPos = 0;
+        auto status = pSource->getNextBatch(&_inputBuffer, batchSize);
+        if (status != GetNextResult::ReturnStatus::kAdvanced) {
+            _pendingInputStatus = status;
+        }
+        if (_inputBuffer.empty()) {
+            return getNextInput(batchSize);
+        }
+    }
+
+    return std::exchange(_inputBuffer[_inputBufferPos++], Document{});
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceUnwind::getModifiedPaths() const {
     std::set<std::string> modifiedFields{_unwindPath.fullPath()};
     if (_indexPath) {
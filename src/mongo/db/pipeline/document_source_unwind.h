@@ -110,6 +110,15 @@ private:
                          bool strict);
 
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) final;
+
+    /**
+     * Returns the next input document, draining any documents buffered by doGetNextBatch() before
+     * pulling from 'pSource'. If 'batchSize' is non-zero and the buffer is empty, the buffer is
+     * refilled with up to 'batchSize' documents from 'pSource'.
+     */
+    GetNextResult getNextInput(size_t batchSize = 0);
 
     // Checks if a sort is eligible to be moved before the unwind.
     bool canPushSortBack(const DocumentSourceSort* sort) const;
@@ -130,6 +139,12 @@ private:
     class Unwinder;
     std::unique_ptr<Unwinder> _unwinder;
 
+    // Input documents pulled from 'pSource' in batched mode which have not been unwound yet, and
+    // the status which ended the last input batch, if it has not yet been returned.
+    std::vector<Document> _inputBuffer;
+    size_t _inputBufferPos = 0;
+    boost::optional<GetNextResult::ReturnStatus> _pendingInputStatus;
+
     // If preserveNullAndEmptyArrays is true and unwind is followed by a limit, we can duplicate
     // the limit before the unwind. We only want to do this if we've found a limit smaller than the
     // one we already pushed down. boost::none means no push down has occurred yet.
@@ -709,6 +709,39 @@ TEST_F(UnwindStageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(unwind->getNext().isEOF());
 }
 
+TEST_F(UnwindStageTest, GetNextBatchMayReturnShortAdvancedBatches) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "array", false, boost::none);
+    auto source =
+        DocumentSourceMock::createForTest({Document{{"array", vector<Value>{Value(1), Value(2)}}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"array", vector<Value>{Value(3)}}}},
+                                          getExpCtx());
+    unwind->setSource(source.get());
+
+    // The input runs out before the batch is full, so the unwound documents are handed back as a
+    // short kAdvanced batch and the pause is deferred to the next call.
+    std::vector<Document> batch;
+    ASSERT(unwind->getNextBatch(&batch, 5) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 2U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"array", 1}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"array", 2}}));
+
+    batch.clear();
+    ASSERT(unwind->getNextBatch(&batch, 5) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 0U);
+
+    ASSERT(unwind->getNextBatch(&batch, 5) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 1U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"array", 3}}));
+
+    batch.clear();
+    ASSERT(unwind->getNextBatch(&batch, 5) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 0U);
+}
+
 TEST_F(UnwindStageTest, UnwindOnlyModifiesUnwoundPathWhenNotIncludingIndex) {
     const bool includeNullIfEmptyOrMissing = false;
     const boost::optional<std::string> includeArrayIndex = boost::none;
@@ -335,7 +335,14 @@ StatusWith<Value> ExpressionAdd::apply(Value lhs, Value rhs) {
     }
 }
 
-Value ExpressionAdd::evaluate(const Document& root, Variables* variables) const {
+namespace {
+/**
+ * Shared implementation of ExpressionAdd::evaluate() and ExpressionAdd::evaluateOperands().
+ * 'getOperand' is invoked lazily, in order, for each of the 'n' operands so that evaluation stops
+ * at the first nullish operand.
+ */
+template <typename GetOperand>
+Value addOperands(size_t n, GetOperand&& getOperand) {
     // We'll try to return the narrowest possible result value while avoiding overflow, loss
     // of precision due to intermediate rounding or implicit use of decimal types. To do that,
     // compute a compensated sum for non-decimal values and a separate decimal sum for decimal
@@ -345,9 +352,8 @@ Value ExpressionAdd::evaluate(const Document& root, Variables* variables) const
     BSONType totalType = NumberInt;
     bool haveDate = false;
 
-    const size_t n = _children.size();
     for (size_t i = 0; i < n; ++i) {
-        Value val = _children[i]->evaluate(root, variables);
+        Value val = getOperand(i);
 
         switch (val.getType()) {
             case NumberDecimal:
@@ -409,6 +415,16 @@ Value ExpressionAdd::evaluate(const Document& root, Variables* variables) const
             massert(16417, "$add resulted in a non-numeric type", false);
     }
 }
+}  // namespace
+
+Value ExpressionAdd::evaluate(const Document& root, Variables* variables) const {
+    return addOperands(_children.size(),
+                       [&](size_t i) { return _children[i]->evaluate(root, variables); });
+}
+
+Value ExpressionAdd::evaluateOperands(const Value* operands, size_t n) {
+    return addOperands(n, [&](size_t i) { return operands[i]; });
+}
 
 REGISTER_STABLE_EXPRESSION(add, ExpressionAdd::parse);
 const char* ExpressionAdd::getOpName() const {
@@ -3252,7 +3268,18 @@ Value ExpressionMultiply::evaluate(const Document& root, Variables* variables) c
         if (val.nullish())
             return Value(BSONNULL);
         uassertStatusOK(checkMultiplyNumeric(val));
-        state *= child->evaluate(root, variables);
+        state *= val;
+    }
+    return state.getValue();
+}
+
+Value ExpressionMultiply::evaluateOperands(const Value* operands, size_t n) {
+    MultiplyState state;
+    for (size_t i = 0; i < n; ++i) {
+        if (operands[i].nullish())
+            return Value(BSONNULL);
+        uassertStatusOK(checkMultiplyNumeric(operands[i]));
+        state *= operands[i];
     }
     return state.getValue();
 }
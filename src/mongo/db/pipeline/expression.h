@@ -918,6 +918,13 @@ public:
      */
     static StatusWith<Value> apply(Value lhs, Value rhs);
 
+    /**
+     * Sums 'n' already-evaluated operands with exactly the semantics of evaluate(), including
+     * support for a single date operand. Used by compiled expression programs, which evaluate
+     * children into registers rather than recursively.
+     */
+    static Value evaluateOperands(const Value* operands, size_t n);
+
     explicit ExpressionAdd(ExpressionContext* const expCtx)
         : ExpressionVariadic<ExpressionAdd>(expCtx) {}
 
@@ -2350,6 +2357,11 @@ public:
      */
     static StatusWith<Value> apply(Value lhs, Value rhs);
 
+    /**
+     * Multiplies 'n' already-evaluated operands with exactly the semantics of evaluate().
+     */
+    static Value evaluateOperands(const Value* operands, size_t n);
+
     explicit ExpressionMultiply(ExpressionContext* const expCtx)
         : ExpressionVariadic<ExpressionMultiply>(expCtx) {}
     ExpressionMultiply(ExpressionContext* const expCtx, ExpressionVector&& children)
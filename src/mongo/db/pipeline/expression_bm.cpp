@@ -31,10 +31,16 @@
 
 #include <benchmark/benchmark.h>
 
+#include "mongo/bson/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/expression_program.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -503,5 +509,121 @@ BENCHMARK(BM_SetDifference);
 BENCHMARK(BM_SetEquals);
 BENCHMARK(BM_SetUnion);
 
+/**
+ * Tests performance of evaluating 'expressionSpec' over a set of documents, either by walking the
+ * expression tree (benchmark argument 0) or through a compiled ExpressionProgram (argument 1).
+ */
+void benchmarkCompiledExpression(BSONObj expressionSpec, benchmark::State& state) {
+    QueryTestServiceContext testServiceContext;
+    auto opContext = testServiceContext.makeOperationContext();
+    NamespaceString nss("test.bm");
+    auto exprContext = make_intrusive<ExpressionContextForTest>(opContext.get(), nss);
+
+    auto expression = Expression::parseExpression(
+        exprContext.get(), expressionSpec, exprContext->variablesParseState);
+    expression = expression->optimize();
+    auto program = state.range(0) ? ExpressionProgram::compile(expression) : nullptr;
+    auto variables = &(exprContext->variables);
+
+    std::vector<Document> documents;
+    for (int i = 0; i < 1000; ++i) {
+        documents.push_back(Document{{"a", i}, {"b", i % 7}, {"c", i * 0.5}, {"s", "string"_sd}});
+    }
+
+    for (auto keepRunning : state) {
+        for (const auto& document : documents) {
+            benchmark::DoNotOptimize(program ? program->evaluate(document, variables)
+                                             : expression->evaluate(document, variables));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * documents.size());
+}
+
+void BM_CompiledArithmetic(benchmark::State& state) {
+    benchmarkCompiledExpression(
+        fromjson("{$add: [{$multiply: ['$a', 2]}, {$subtract: ['$b', 1]}, '$c']}"), state);
+}
+
+void BM_CompiledConditional(benchmark::State& state) {
+    benchmarkCompiledExpression(
+        fromjson("{$cond: [{$and: [{$gte: ['$a', 10]}, {$lt: ['$b', 5]}]}, '$c', "
+                 "{$multiply: ['$a', '$b']}]}"),
+        state);
+}
+
+void BM_CompiledWithFallback(benchmark::State& state) {
+    benchmarkCompiledExpression(
+        fromjson("{$add: [{$strLenCP: '$s'}, {$multiply: ['$a', '$b']}]}"), state);
+}
+
+BENCHMARK(BM_CompiledArithmetic)->Arg(0)->Arg(1);
+BENCHMARK(BM_CompiledConditional)->Arg(0)->Arg(1);
+BENCHMARK(BM_CompiledWithFallback)->Arg(0)->Arg(1);
+
+/**
+ * Tests performance of running 'pipelineSpec' end-to-end over 'kNumDocuments' documents. The
+ * benchmark argument is the batch size passed to Pipeline::getNextBatch(), where 0 means that
+ * documents are pulled through the pipeline one at a time.
+ */
+void benchmarkPipeline(const std::vector<BSONObj>& pipelineSpec, benchmark::State& state) {
+    const int kNumDocuments = 10000;
+    const size_t batchSize = state.range(0);
+
+    // Stages which consume their whole input, such as $group, consult the knob directly.
+    const auto originalBatchSize = internalPipelineExecutionBatchSize.load();
+    internalPipelineExecutionBatchSize.store(batchSize);
+    ON_BLOCK_EXIT([&] { internalPipelineExecutionBatchSize.store(originalBatchSize); });
+
+    QueryTestServiceContext testServiceContext;
+    auto opContext = testServiceContext.makeOperationContext();
+    NamespaceString nss("test.bm");
+    auto exprContext = make_intrusive<ExpressionContextForTest>(opContext.get(), nss);
+
+    std::deque<DocumentSource::GetNextResult> documents;
+    for (int i = 0; i < kNumDocuments; ++i) {
+        documents.emplace_back(Document{{"_id", i},
+                                        {"a", i % 100},
+                                        {"b", BSON_ARRAY(1 << 2 << 3)},
+                                        {"c", "str"_sd}});
+    }
+
+    std::vector<Document> batch;
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto pipeline = Pipeline::parse(pipelineSpec, exprContext);
+        pipeline->addInitialSource(DocumentSourceMock::createForTest(documents, exprContext));
+        state.ResumeTiming();
+
+        if (batchSize == 0) {
+            while (auto next = pipeline->getNext()) {
+                benchmark::DoNotOptimize(next);
+            }
+        } else {
+            do {
+                batch.clear();
+            } while (pipeline->getNextBatch(&batch, batchSize));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+void BM_PipelineMatchProject(benchmark::State& state) {
+    benchmarkPipeline({fromjson("{$match: {a: {$gte: 10}}}"),
+                       fromjson("{$project: {_id: 0, a: 1, d: {$add: ['$a', 1]}}}")},
+                      state);
+}
+
+void BM_PipelineAddFieldsUnwindGroup(benchmark::State& state) {
+    benchmarkPipeline({fromjson("{$addFields: {d: {$multiply: ['$a', 2]}}}"),
+                       fromjson("{$unwind: '$b'}"),
+                       fromjson("{$group: {_id: '$a', total: {$sum: '$b'}, max: {$max: '$d'}}}")},
+                      state);
+}
+
+BENCHMARK(BM_PipelineMatchProject)->Arg(0)->Arg(128);
+BENCHMARK(BM_PipelineAddFieldsUnwindGroup)->Arg(0)->Arg(128);
+
 }  // namespace
 }  // namespace mongo
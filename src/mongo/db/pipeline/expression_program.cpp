@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+std::unique_ptr<ExpressionProgram> ExpressionProgram::compile(
+    boost::intrusive_ptr<Expression> expr) {
+    invariant(expr);
+    std::unique_ptr<ExpressionProgram> program(new ExpressionProgram(std::move(expr)));
+
+    // Nothing is gained by wrapping a tree which must be evaluated entirely by the fallback.
+    if (program->_instructions.size() == 1 &&
+        program->_instructions.front().opCode == OpCode::kEvaluate) {
+        return nullptr;
+    }
+    return program;
+}
+
+ExpressionProgram::ExpressionProgram(boost::intrusive_ptr<Expression> expr)
+    : _expression(std::move(expr)) {
+    const auto result = allocateRegisters(1);
+    compileInto(_expression.get(), result);
+}
+
+uint32_t ExpressionProgram::allocateRegisters(size_t count) {
+    const auto first = static_cast<uint32_t>(_registers.size());
+    _registers.resize(_registers.size() + count);
+    return first;
+}
+
+void ExpressionProgram::loadConstant(uint32_t dst, Value value) {
+    _constants.push_back(std::move(value));
+    emit({OpCode::kLoadConstant, dst, static_cast<uint32_t>(_constants.size() - 1)});
+}
+
+size_t ExpressionProgram::emit(Instruction instruction) {
+    _instructions.push_back(instruction);
+    return _instructions.size() - 1;
+}
+
+void ExpressionProgram::patchJumpTarget(size_t jumpInstruction) {
+    _instructions[jumpInstruction].arg2 = static_cast<uint32_t>(_instructions.size());
+}
+
+void ExpressionProgram::compileInto(const Expression* expr, uint32_t dst) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        loadConstant(dst, constant->getValue());
+        return;
+    }
+
+    if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        // Only a single top-level field of $$ROOT (or an unmodified $$CURRENT) is read directly.
+        // Dotted paths must handle implicit array traversal and are left to the fallback.
+        if (fieldPath->getVariableId() == Variables::kRootId &&
+            fieldPath->getFieldPath().getPathLength() == 2) {
+            Instruction instruction{OpCode::kGetField, dst};
+            instruction.expr = expr;
+            emit(instruction);
+            return;
+        }
+    } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expr)) {
+        const auto operands = allocateRegisters(2);
+        compileInto(expr->getChildren()[0].get(), operands);
+        compileInto(expr->getChildren()[1].get(), operands + 1);
+        Instruction instruction{OpCode::kCompare,
+                                dst,
+                                operands,
+                                operands + 1,
+                                static_cast<uint32_t>(compare->getOp())};
+        instruction.expr = expr;
+        emit(instruction);
+        return;
+    } else if (dynamic_cast<const ExpressionNot*>(expr)) {
+        const auto operand = allocateRegisters(1);
+        compileInto(expr->getChildren()[0].get(), operand);
+        emit({OpCode::kNot, dst, operand});
+        return;
+    } else if (dynamic_cast<const ExpressionAnd*>(expr)) {
+        compileBooleanConnective(expr, dst, true /* isAnd */);
+        return;
+    } else if (dynamic_cast<const ExpressionOr*>(expr)) {
+        compileBooleanConnective(expr, dst, false /* isAnd */);
+        return;
+    } else if (dynamic_cast<const ExpressionCond*>(expr)) {
+        const auto& children = expr->getChildren();
+        const auto condition = allocateRegisters(1);
+        compileInto(children[0].get(), condition);
+        const auto toElse = emit({OpCode::kJumpIfFalse, 0, condition});
+        compileInto(children[1].get(), dst);
+        const auto toEnd = emit({OpCode::kJump});
+        patchJumpTarget(toElse);
+        compileInto(children[2].get(), dst);
+        patchJumpTarget(toEnd);
+        return;
+    } else if (dynamic_cast<const ExpressionAdd*>(expr)) {
+        compileArithmetic(expr, dst, OpCode::kAdd);
+        return;
+    } else if (dynamic_cast<const ExpressionMultiply*>(expr)) {
+        compileArithmetic(expr, dst, OpCode::kMultiply);
+        return;
+    } else if (dynamic_cast<const ExpressionSubtract*>(expr)) {
+        const auto operands = allocateRegisters(2);
+        compileInto(expr->getChildren()[0].get(), operands);
+        compileInto(expr->getChildren()[1].get(), operands + 1);
+        emit({OpCode::kSubtract, dst, operands, operands + 1});
+        return;
+    }
+
+    Instruction instruction{OpCode::kEvaluate, dst};
+    instruction.expr = expr;
+    emit(instruction);
+    ++_numFallbacks;
+}
+
+void ExpressionProgram::compileBooleanConnective(const Expression* expr,
+                                                 uint32_t dst,
+                                                 bool isAnd) {
+    // Each operand is evaluated into the same scratch register, and the first one which decides
+    // the result jumps over the remaining operands.
+    const auto operand = allocateRegisters(1);
+    std::vector<size_t> shortCircuits;
+    for (auto&& child : expr->getChildren()) {
+        compileInto(child.get(), operand);
+        shortCircuits.push_back(
+            emit({isAnd ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue, 0, operand}));
+    }
+    loadConstant(dst, Value(isAnd));
+    const auto toEnd = emit({OpCode::kJump});
+    for (auto jump : shortCircuits) {
+        patchJumpTarget(jump);
+    }
+    loadConstant(dst, Value(!isAnd));
+    patchJumpTarget(toEnd);
+}
+
+void ExpressionProgram::compileArithmetic(const Expression* expr, uint32_t dst, OpCode opCode) {
+    const auto& children = expr->getChildren();
+    const auto operands = allocateRegisters(children.size());
+    std::vector<size_t> earlyExits;
+    for (size_t i = 0; i < children.size(); ++i) {
+        compileInto(children[i].get(), operands + i);
+        earlyExits.push_back(emit({opCode == OpCode::kAdd ? OpCode::kCheckSummand
+                                                          : OpCode::kCheckFactor,
+                                   dst,
+                                   static_cast<uint32_t>(operands + i),
+                                   static_cast<uint32_t>(i + 1)}));
+    }
+    emit({opCode, dst, operands, static_cast<uint32_t>(children.size())});
+    for (auto exit : earlyExits) {
+        patchJumpTarget(exit);
+    }
+}
+
+Value ExpressionProgram::evaluate(const Document& root, Variables* variables) const {
+    auto& reg = _registers;
+    const size_t numInstructions = _instructions.size();
+    for (size_t pc = 0; pc < numInstructions;) {
+        const Instruction& instruction = _instructions[pc++];
+        switch (instruction.opCode) {
+            case OpCode::kLoadConstant:
+                reg[instruction.dst] = _constants[instruction.arg0];
+                break;
+            case OpCode::kGetField: {
+                auto fieldPath = static_cast<const ExpressionFieldPath*>(instruction.expr);
+                reg[instruction.dst] = root[fieldPath->getFieldPath().getFieldNameHashed(1)];
+                break;
+            }
+            case OpCode::kEvaluate:
+                reg[instruction.dst] = instruction.expr->evaluate(root, variables);
+                break;
+            case OpCode::kNot:
+                reg[instruction.dst] = Value(!reg[instruction.arg0].coerceToBool());
+                break;
+            case OpCode::kCompare: {
+                const auto& comparator =
+                    instruction.expr->getExpressionContext()->getValueComparator();
+                const int cmp = comparator.compare(reg[instruction.arg0], reg[instruction.arg1]);
+                switch (static_cast<ExpressionCompare::CmpOp>(instruction.arg2)) {
+                    case ExpressionCompare::EQ:
+                        reg[instruction.dst] = Value(cmp == 0);
+                        break;
+                    case ExpressionCompare::NE:
+                        reg[instruction.dst] = Value(cmp != 0);
+                        break;
+                    case ExpressionCompare::GT:
+                        reg[instruction.dst] = Value(cmp > 0);
+                        break;
+                    case ExpressionCompare::GTE:
+                        reg[instruction.dst] = Value(cmp >= 0);
+                        break;
+                    case ExpressionCompare::LT:
+                        reg[instruction.dst] = Value(cmp < 0);
+                        break;
+                    case ExpressionCompare::LTE:
+                        reg[instruction.dst] = Value(cmp <= 0);
+                        break;
+                    case ExpressionCompare::CMP:
+                        reg[instruction.dst] = Value(cmp < 0 ? -1 : (cmp > 0 ? 1 : 0));
+                        break;
+                }
+                break;
+            }
+            case OpCode::kAdd:
+                reg[instruction.dst] =
+                    ExpressionAdd::evaluateOperands(&reg[instruction.arg0], instruction.arg1);
+                break;
+            case OpCode::kMultiply:
+                reg[instruction.dst] =
+                    ExpressionMultiply::evaluateOperands(&reg[instruction.arg0], instruction.arg1);
+                break;
+            case OpCode::kSubtract:
+                reg[instruction.dst] = uassertStatusOK(ExpressionSubtract::apply(
+                    std::move(reg[instruction.arg0]), std::move(reg[instruction.arg1])));
+                break;
+            case OpCode::kJump:
+                pc = instruction.arg2;
+                break;
+            case OpCode::kJumpIfTrue:
+                if (reg[instruction.arg0].coerceToBool()) {
+                    pc = instruction.arg2;
+                }
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!reg[instruction.arg0].coerceToBool()) {
+                    pc = instruction.arg2;
+                }
+                break;
+            case OpCode::kCheckSummand:
+            case OpCode::kCheckFactor: {
+                const Value& operand = reg[instruction.arg0];
+                const bool valid = operand.numeric() ||
+                    (instruction.opCode == OpCode::kCheckSummand && operand.getType() == Date);
+                if (!valid) {
+                    const Value* operands = &reg[instruction.arg0 + 1 - instruction.arg1];
+                    reg[instruction.dst] = instruction.opCode == OpCode::kCheckSummand
+                        ? ExpressionAdd::evaluateOperands(operands, instruction.arg1)
+                        : ExpressionMultiply::evaluateOperands(operands, instruction.arg1);
+                    pc = instruction.arg2;
+                }
+                break;
+            }
+        }
+    }
+
+    // Release any references into 'root' held by intermediate registers, so that they do not
+    // prevent in-place modification of the document by later stages.
+    Value result = std::move(reg[0]);
+    for (auto&& value : reg) {
+        value = Value();
+    }
+    return result;
+}
+
+}  // namespace mongo
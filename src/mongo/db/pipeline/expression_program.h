@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * A flat, register-based lowering of a classic Expression tree.
+ *
+ * Expression::evaluate() is a recursive virtual tree walk which materializes a Value at every
+ * node. An ExpressionProgram is compiled once per query from an optimized Expression tree into a
+ * linear sequence of instructions operating on a fixed register file, so that evaluation of the
+ * common arithmetic, comparison, boolean and field-access operators is a single dispatch loop.
+ *
+ * Operators without a dedicated instruction are not an error: the whole unsupported subtree is
+ * evaluated through its own Expression::evaluate() by a fallback instruction, so any expression
+ * can be compiled and produces results identical to the tree walk. Short-circuiting operators
+ * ($and, $or, $cond, and the null checks of $add and $multiply) are compiled to forward jumps and
+ * do not evaluate operands which the tree walk would have skipped.
+ *
+ * A program holds a reference to the Expression it was compiled from, and must be recompiled if
+ * that tree is re-optimized or otherwise replaced. Evaluation reuses the register file, so a
+ * program must not be evaluated concurrently from multiple threads; like the expression tree
+ * itself it is owned by a single pipeline stage.
+ */
+class ExpressionProgram {
+public:
+    /**
+     * Lowers 'expr' into a program. Returns nullptr if no part of the tree can be compiled, in
+     * which case the caller should continue to use 'expr' directly.
+     */
+    static std::unique_ptr<ExpressionProgram> compile(boost::intrusive_ptr<Expression> expr);
+
+    /**
+     * Evaluates the program against 'root'. Equivalent to calling evaluate() on the expression
+     * from which this program was compiled.
+     */
+    Value evaluate(const Document& root, Variables* variables) const;
+
+    size_t numInstructions() const {
+        return _instructions.size();
+    }
+
+    size_t numRegisters() const {
+        return _registers.size();
+    }
+
+    /**
+     * Returns the number of subtrees which are evaluated through Expression::evaluate() because
+     * they contain operators the program cannot express.
+     */
+    size_t numFallbacks() const {
+        return _numFallbacks;
+    }
+
+private:
+    enum class OpCode : uint8_t {
+        kLoadConstant,     // reg[dst] = constants[arg0]
+        kGetField,         // reg[dst] = root[<single field of 'expr'>]
+        kEvaluate,         // reg[dst] = expr->evaluate(root, variables)
+        kNot,              // reg[dst] = !reg[arg0].coerceToBool()
+        kCompare,          // reg[dst] = compare(reg[arg0], reg[arg1]) using the CmpOp in arg2
+        kAdd,              // reg[dst] = sum of reg[arg0], ..., reg[arg0 + arg1 - 1]
+        kMultiply,         // reg[dst] = product of reg[arg0], ..., reg[arg0 + arg1 - 1]
+        kSubtract,         // reg[dst] = reg[arg0] - reg[arg1]
+        kJump,             // pc = arg2
+        kJumpIfTrue,       // if (reg[arg0].coerceToBool()) pc = arg2
+        kJumpIfFalse,      // if (!reg[arg0].coerceToBool()) pc = arg2
+        kCheckSummand,     // if reg[arg0] is not a number or date, finish $add early; see below
+        kCheckFactor,      // if reg[arg0] is not a number, finish $multiply early; see below
+    };
+
+    // kCheckSummand and kCheckFactor guard operand 'arg1 - 1' of an n-ary $add or $multiply,
+    // held in register 'arg0'. If the operand would stop the tree walk (a nullish value or a type
+    // error), the result is computed from the first 'arg1' operands alone, exactly as the tree walk
+    // would have done, and control jumps to 'arg2' without evaluating the remaining operands.
+
+    struct Instruction {
+        OpCode opCode;
+        uint32_t dst = 0;
+        uint32_t arg0 = 0;
+        uint32_t arg1 = 0;
+        uint32_t arg2 = 0;
+
+        // The expression node this instruction was compiled from, if the instruction needs it at
+        // runtime. Kept alive by '_expression'.
+        const Expression* expr = nullptr;
+    };
+
+    explicit ExpressionProgram(boost::intrusive_ptr<Expression> expr);
+
+    uint32_t allocateRegisters(size_t count);
+    void loadConstant(uint32_t dst, Value value);
+    size_t emit(Instruction instruction);
+    void patchJumpTarget(size_t jumpInstruction);
+
+    /**
+     * Emits instructions which leave the value of 'expr' in register 'dst'.
+     */
+    void compileInto(const Expression* expr, uint32_t dst);
+    void compileBooleanConnective(const Expression* expr, uint32_t dst, bool isAnd);
+    void compileArithmetic(const Expression* expr, uint32_t dst, OpCode opCode);
+
+    // The tree this program was compiled from. Any fallback instruction refers into this tree.
+    boost::intrusive_ptr<Expression> _expression;
+
+    std::vector<Instruction> _instructions;
+    std::vector<Value> _constants;
+    size_t _numFallbacks = 0;
+
+    // Working space for evaluate(). Register 0 always holds the result.
+    mutable std::vector<Value> _registers;
+};
+
+}  // namespace mongo
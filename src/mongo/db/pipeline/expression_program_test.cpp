@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/expression_program.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class ExpressionProgramTest : public unittest::Test {
+protected:
+    boost::intrusive_ptr<Expression> parse(StringData spec) {
+        return Expression::parseOperand(_expCtx.get(),
+                                        BSON("" << fromjson(spec.toString())).firstElement(),
+                                        _expCtx->variablesParseState);
+    }
+
+    /**
+     * Evaluates 'expr' against 'doc' both by walking the tree and through 'program', and asserts
+     * that both produce the same value of the same type, or fail with the same error code.
+     */
+    void assertSameResult(const boost::intrusive_ptr<Expression>& expr,
+                          const ExpressionProgram& program,
+                          const Document& doc) {
+        auto variables = &_expCtx->variables;
+        StatusWith<Value> expected = Status::OK();
+        StatusWith<Value> actual = Status::OK();
+        try {
+            expected = expr->evaluate(doc, variables);
+        } catch (const DBException& ex) {
+            expected = ex.toStatus();
+        }
+        try {
+            actual = program.evaluate(doc, variables);
+        } catch (const DBException& ex) {
+            actual = ex.toStatus();
+        }
+
+        ASSERT_EQ(expected.isOK(), actual.isOK()) << doc.toString();
+        if (!expected.isOK()) {
+            ASSERT_EQ(expected.getStatus().code(), actual.getStatus().code()) << doc.toString();
+            return;
+        }
+        ASSERT_VALUE_EQ(expected.getValue(), actual.getValue());
+        ASSERT_EQ(expected.getValue().getType(), actual.getValue().getType()) << doc.toString();
+    }
+
+    boost::intrusive_ptr<ExpressionContextForTest> _expCtx{new ExpressionContextForTest()};
+};
+
+TEST_F(ExpressionProgramTest, CompiledProgramMatchesTreeEvaluation) {
+    const std::vector<StringData> specs = {
+        "{$add: ['$a', '$b', 1]}",
+        "{$add: ['$d', '$a']}",
+        "{$multiply: ['$a', '$b', 2]}",
+        "{$subtract: ['$a', '$b']}",
+        "{$cond: [{$gt: ['$a', '$b']}, '$a', '$b']}",
+        "{$and: ['$a', {$not: ['$b']}]}",
+        "{$or: [{$eq: ['$a', 1]}, {$lte: ['$b', 2]}]}",
+        "{$cmp: ['$a', '$b']}",
+        "{$ne: [{$multiply: ['$a', '$a']}, {$add: ['$b', '$b']}]}",
+    };
+    const std::vector<Document> docs = {
+        Document{fromjson("{a: 1, b: 2}")},
+        Document{fromjson("{a: 2.5, b: {$numberLong: '9223372036854775807'}}")},
+        Document{fromjson("{a: {$numberDecimal: '1.5'}, b: 3}")},
+        Document{fromjson("{a: null, b: 1}")},
+        Document{fromjson("{b: 1}")},
+        Document{fromjson("{a: 'str', b: 1}")},
+        Document{fromjson("{a: 3, b: 1, d: {$date: 1000}}")},
+        Document{fromjson("{a: 3, b: {$date: 1000}, d: {$date: 1000}}")},
+    };
+
+    for (auto&& spec : specs) {
+        auto expr = parse(spec);
+        auto program = ExpressionProgram::compile(expr);
+        ASSERT(program) << spec;
+        ASSERT_EQ(program->numFallbacks(), 0U) << spec;
+        for (auto&& doc : docs) {
+            assertSameResult(expr, *program, doc);
+        }
+    }
+}
+
+TEST_F(ExpressionProgramTest, CompiledProgramShortCircuitsLikeTreeEvaluation) {
+    // Each of these would fail with a division by zero if its last operand were evaluated.
+    const std::vector<StringData> specs = {
+        "{$and: ['$a', {$divide: [1, 0]}]}",
+        "{$or: [{$not: ['$a']}, {$divide: [1, 0]}]}",
+        "{$cond: ['$a', {$divide: [1, 0]}, 1]}",
+        "{$add: ['$missing', {$divide: [1, 0]}]}",
+        "{$multiply: ['$b', {$divide: [1, 0]}]}",
+    };
+    const Document doc{fromjson("{a: false, b: null}")};
+
+    for (auto&& spec : specs) {
+        auto expr = parse(spec);
+        auto program = ExpressionProgram::compile(expr);
+        ASSERT(program) << spec;
+        program->evaluate(doc, &_expCtx->variables);
+        assertSameResult(expr, *program, doc);
+    }
+}
+
+TEST_F(ExpressionProgramTest, UnsupportedSubtreesFallBackToTreeEvaluation) {
+    auto expr = parse("{$add: [{$strLenCP: '$s'}, '$a.b', 1]}");
+    auto program = ExpressionProgram::compile(expr);
+    ASSERT(program);
+    ASSERT_EQ(program->numFallbacks(), 2U);
+
+    const Document doc{fromjson("{s: 'abc', a: {b: 2}}")};
+    ASSERT_VALUE_EQ(program->evaluate(doc, &_expCtx->variables), Value(6));
+    assertSameResult(expr, *program, doc);
+
+    // A tree which is entirely unsupported is not worth compiling.
+    ASSERT_FALSE(ExpressionProgram::compile(parse("{$strLenCP: '$s'}")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_memo_cache.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const Value* LookupMemoCache::find(const std::string& key) {
+    if (_abandoned) {
+        ++_misses;
+        return nullptr;
+    }
+
+    auto& byKey = _container.get<1>();
+    auto it = byKey.find(key);
+    const bool hit = it != byKey.end();
+    if (hit) {
+        ++_hits;
+        ++_windowHits;
+    } else {
+        ++_misses;
+    }
+
+    if (++_windowLookups == _hitRateSampleSize) {
+        const auto hitRate = static_cast<double>(_windowHits) / _windowLookups;
+        _windowLookups = 0;
+        _windowHits = 0;
+        if (hitRate < _minHitRate) {
+            abandon();
+            return nullptr;
+        }
+    }
+
+    if (!hit) {
+        return nullptr;
+    }
+
+    _container.relocate(_container.begin(), _container.project<0>(it));
+    return &it->results;
+}
+
+void LookupMemoCache::insert(std::string key, Value results) {
+    if (_abandoned) {
+        return;
+    }
+
+    const size_t entrySize = key.size() + results.getApproximateSize();
+    if (entrySize > _maxSizeBytes) {
+        return;
+    }
+
+    while (_sizeBytes + entrySize > _maxSizeBytes) {
+        evictOne();
+    }
+
+    auto inserted =
+        _container.push_front(Entry{std::move(key), std::move(results), entrySize}).second;
+    invariant(inserted);
+    _sizeBytes += entrySize;
+}
+
+void LookupMemoCache::abandon() {
+    _abandoned = true;
+    _container.clear();
+    _sizeBytes = 0;
+}
+
+void LookupMemoCache::evictOne() {
+    invariant(!_container.empty());
+    _sizeBytes -= _container.back().sizeBytes;
+    _container.pop_back();
+    ++_evictions;
+}
+
+}  // namespace mongo
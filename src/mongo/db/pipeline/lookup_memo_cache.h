@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <string>
+
+#include "mongo/db/exec/document_value/value.h"
+
+namespace mongo {
+
+/**
+ * A least-recently-used cache from the values of the correlated variables of a $lookup
+ * sub-pipeline to the results of running the sub-pipeline with those values. The keys are opaque
+ * byte strings, so two sets of values only share an entry if their encodings are identical.
+ *
+ * The cache is bounded by an approximate memory budget, evicting the least recently used entries
+ * to make room for new ones. Since a cache which rarely hits only adds overhead, the hit rate is
+ * sampled over windows of 'hitRateSampleSize' lookups, and the cache abandons itself once a window
+ * falls below 'minHitRate'. An abandoned cache holds no entries and misses on every lookup.
+ */
+class LookupMemoCache {
+    LookupMemoCache(const LookupMemoCache&) = delete;
+    LookupMemoCache& operator=(const LookupMemoCache&) = delete;
+
+public:
+    LookupMemoCache(size_t maxSizeBytes, size_t hitRateSampleSize, double minHitRate)
+        : _maxSizeBytes(maxSizeBytes),
+          _hitRateSampleSize(hitRateSampleSize),
+          _minHitRate(minHitRate) {}
+
+    /**
+     * Returns the cached results for 'key' and marks them as most recently used, or nullptr if
+     * there are none. Counts towards the hit rate, and may abandon the cache. The returned pointer
+     * is invalidated by the next call to any non-const method.
+     */
+    const Value* find(const std::string& key);
+
+    /**
+     * Caches 'results' under 'key', which must not already be present, evicting the least recently
+     * used entries as needed to stay within budget. Results which would not fit in an empty cache
+     * are not cached. Does nothing if the cache has been abandoned.
+     */
+    void insert(std::string key, Value results);
+
+    /**
+     * Releases all entries, and stops caching any more.
+     */
+    void abandon();
+
+    bool isAbandoned() const {
+        return _abandoned;
+    }
+
+    size_t count() const {
+        return _container.size();
+    }
+
+    size_t sizeBytes() const {
+        return _sizeBytes;
+    }
+
+    size_t maxSizeBytes() const {
+        return _maxSizeBytes;
+    }
+
+    long long hits() const {
+        return _hits;
+    }
+
+    long long misses() const {
+        return _misses;
+    }
+
+    long long evictions() const {
+        return _evictions;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        Value results;
+        size_t sizeBytes;
+    };
+
+    // Sequenced in order of use, most recent first, with a unique index on the key.
+    using IndexedContainer = boost::multi_index::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::member<Entry, std::string, &Entry::key>>>>;
+
+    void evictOne();
+
+    const size_t _maxSizeBytes;
+    const size_t _hitRateSampleSize;
+    const double _minHitRate;
+
+    IndexedContainer _container;
+    size_t _sizeBytes = 0;
+    bool _abandoned = false;
+
+    long long _hits = 0;
+    long long _misses = 0;
+    long long _evictions = 0;
+
+    // Lookups and hits within the current hit rate sampling window.
+    size_t _windowLookups = 0;
+    size_t _windowHits = 0;
+};
+
+}  // namespace mongo
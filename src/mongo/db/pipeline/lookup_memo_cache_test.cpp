@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/lookup_memo_cache.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Returns the number of bytes the cache accounts for an entry with 'key' and 'results'.
+size_t entrySize(const std::string& key, const Value& results) {
+    return key.size() + results.getApproximateSize();
+}
+
+TEST(LookupMemoCacheTest, FindReturnsInsertedResults) {
+    LookupMemoCache cache(1024 * 1024, 0, 0.0);
+    ASSERT_FALSE(cache.find("a"));
+
+    cache.insert("a", Value(1));
+    cache.insert("b", Value(2));
+
+    ASSERT(cache.find("a"));
+    ASSERT_VALUE_EQ(*cache.find("a"), Value(1));
+    ASSERT_VALUE_EQ(*cache.find("b"), Value(2));
+    ASSERT_FALSE(cache.find("c"));
+
+    ASSERT_EQ(cache.count(), 2U);
+    ASSERT_EQ(cache.sizeBytes(), entrySize("a", Value(1)) + entrySize("b", Value(2)));
+    ASSERT_EQ(cache.hits(), 4);
+    ASSERT_EQ(cache.misses(), 2);
+}
+
+TEST(LookupMemoCacheTest, EvictsLeastRecentlyUsedEntriesToStayWithinBudget) {
+    LookupMemoCache cache(2 * entrySize("a", Value(1)), 0, 0.0);
+    cache.insert("a", Value(1));
+    cache.insert("b", Value(2));
+
+    // Using "a" makes "b" the least recently used entry, which has to make room for "c".
+    ASSERT(cache.find("a"));
+    cache.insert("c", Value(3));
+
+    ASSERT(cache.find("a"));
+    ASSERT_FALSE(cache.find("b"));
+    ASSERT(cache.find("c"));
+    ASSERT_EQ(cache.count(), 2U);
+    ASSERT_EQ(cache.evictions(), 1);
+    ASSERT_LTE(cache.sizeBytes(), cache.maxSizeBytes());
+}
+
+TEST(LookupMemoCacheTest, DoesNotCacheResultsLargerThanTheBudget) {
+    LookupMemoCache cache(entrySize("a", Value(1)), 0, 0.0);
+    cache.insert("a", Value(1));
+
+    cache.insert("b", Value(std::string(1024, 'x')));
+    ASSERT_FALSE(cache.find("b"));
+
+    // The entry which was already cached is not evicted.
+    ASSERT(cache.find("a"));
+    ASSERT_EQ(cache.evictions(), 0);
+}
+
+TEST(LookupMemoCacheTest, AbandonsWhenHitRateIsBelowMinimum) {
+    LookupMemoCache cache(1024 * 1024, 4, 0.5);
+    cache.insert("a", Value(1));
+
+    // One hit out of four lookups is below the minimum hit rate.
+    ASSERT(cache.find("a"));
+    ASSERT_FALSE(cache.find("b"));
+    ASSERT_FALSE(cache.find("c"));
+    ASSERT_FALSE(cache.find("d"));
+
+    ASSERT_TRUE(cache.isAbandoned());
+    ASSERT_EQ(cache.count(), 0U);
+    ASSERT_EQ(cache.sizeBytes(), 0U);
+
+    // An abandoned cache neither serves nor accepts any more results.
+    cache.insert("b", Value(2));
+    ASSERT_FALSE(cache.find("a"));
+    ASSERT_FALSE(cache.find("b"));
+    ASSERT_EQ(cache.misses(), 5);
+}
+
+TEST(LookupMemoCacheTest, KeepsCachingWhenHitRateMeetsMinimum) {
+    LookupMemoCache cache(1024 * 1024, 4, 0.5);
+    cache.insert("a", Value(1));
+
+    for (int window = 0; window < 3; ++window) {
+        ASSERT(cache.find("a"));
+        ASSERT(cache.find("a"));
+        ASSERT_FALSE(cache.find("b"));
+        ASSERT_FALSE(cache.find("c"));
+        ASSERT_FALSE(cache.isAbandoned());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
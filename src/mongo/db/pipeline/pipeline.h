@@ -289,6 +289,12 @@ public:
      */
     boost::optional<Document> getNext();
 
+    /**
+     * Appends up to 'maxBatchSize' results from the pipeline to 'batch'. Returns false once the
+     * pipeline is exhausted, in which case nothing more will be appended by this or later calls.
+     */
+    bool getNextBatch(std::vector<Document>* batch, size_t maxBatchSize);
+
     /**
      * Write the pipeline's operators to a std::vector<Value>, providing the level of detail
      * specified by 'verbosity'.
@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/pipeline_d.h"
 #include "mongo/db/pipeline/plan_explainer_pipeline.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 
 namespace mongo {
@@ -59,6 +60,10 @@ PlanExecutorPipeline::PlanExecutorPipeline(boost::intrusive_ptr<ExpressionContex
         // For a resumable scan, set the initial _latestOplogTimestamp and _postBatchResumeToken.
         _initializeResumableScanState();
     }
+
+    if (auto chunkSizeBytes = internalQueryDocumentArenaChunkSizeBytes.load(); chunkSizeBytes > 0) {
+        _memoryArena = std::make_unique<MemoryArena>(std::max(chunkSizeBytes, 1024));
+    }
 }
 
 PlanExecutor::ExecState PlanExecutorPipeline::getNext(BSONObj* objOut, RecordId* recordIdOut) {
@@ -115,6 +120,10 @@ bool PlanExecutorPipeline::isEOF() {
 }
 
 boost::optional<Document> PlanExecutorPipeline::_getNext() {
+    // Storage for the documents produced while pulling from the pipeline comes from the arena, if
+    // there is one. Documents which outlive this call, such as those buffered by blocking stages,
+    // simply keep their arena chunks alive.
+    MemoryArena::Scope arenaScope(_memoryArena.get());
     auto nextDoc = _tryGetNext();
     if (!nextDoc) {
         _pipelineIsEof = true;
@@ -127,7 +136,26 @@ boost::optional<Document> PlanExecutorPipeline::_getNext() {
 }
 
 boost::optional<Document> PlanExecutorPipeline::_tryGetNext() try {
-    return _pipeline->getNext();
+    // Resumable scans must observe the pipeline's state after every document, so they are always
+    // executed one document at a time.
+    const auto batchSize = internalPipelineExecutionBatchSize.load();
+    if (_batchPos == _batch.size() &&
+        (batchSize == 0 || ResumableScanType::kNone != _resumableScanType)) {
+        return _pipeline->getNext();
+    }
+
+    if (_batchPos == _batch.size()) {
+        if (_batchIsEof) {
+            return boost::none;
+        }
+        _batch.clear();
+        _batchPos = 0;
+        _batchIsEof = !_pipeline->getNextBatch(&_batch, batchSize);
+        if (_batch.empty()) {
+            return boost::none;
+        }
+    }
+    return std::exchange(_batch[_batchPos++], Document{});
 } catch (const ExceptionFor<ErrorCodes::ChangeStreamTopologyChange>& ex) {
     // This exception contains the next document to be returned by the pipeline.
     const auto extraInfo = ex.extraInfo<ChangeStreamTopologyChangeInfo>();
@@ -30,11 +30,13 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/plan_explainer_pipeline.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/util/memory_arena.h"
 
 namespace mongo {
 
@@ -223,6 +225,16 @@ private:
 
     std::queue<BSONObj> _stash;
 
+    // Results pulled from '_pipeline' in batched mode which have not been returned yet. Only used
+    // when 'internalPipelineExecutionBatchSize' is non-zero and this is not a resumable scan.
+    std::vector<Document> _batch;
+    size_t _batchPos = 0;
+    bool _batchIsEof = false;
+
+    // Arena from which the pipeline allocates Document and string storage while it is executing.
+    // Only present when 'internalQueryDocumentArenaChunkSizeBytes' is non-zero.
+    std::unique_ptr<MemoryArena> _memoryArena;
+
     // If _killStatus has a non-OK value, then we have been killed and the value represents the
     // reason for the kill.
     Status _killStatus = Status::OK();
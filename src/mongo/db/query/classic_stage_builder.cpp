@@ -87,6 +87,8 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             params.resumeAfterRecordId = csn->resumeAfterRecordId;
             params.stopApplyingFilterAfterFirstMatch = csn->stopApplyingFilterAfterFirstMatch;
             params.boundInclusion = csn->boundInclusion;
+            // Change streams tailing the oplog share the entries they read with each other.
+            params.shareOplogEntries = csn->tailable && expCtx->changeStreamSpec.has_value();
             return std::make_unique<CollectionScan>(
                 expCtx, _collection, params, _ws, csn->filter.get());
         }
@@ -401,6 +403,7 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             return qds;
         }
         case STAGE_BATCHED_DELETE:
+        case STAGE_BATCHED_UPDATE:
         case STAGE_CACHED_PLAN:
         case STAGE_COUNT:
         case STAGE_DELETE:
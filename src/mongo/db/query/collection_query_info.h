@@ -30,11 +30,13 @@
 #pragma once
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/index/shared_key_path_extractor.h"
 #include "mongo/db/query/classic_plan_cache.h"
 #include "mongo/db/query/plan_cache_indexability.h"
 #include "mongo/db/query/plan_cache_invalidator.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -85,6 +87,21 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Returns the paths indexed by the index named 'indexName', or nullptr if the index was not
+     * present when the index data was last rebuilt.
+     */
+    const UpdateIndexData* getIndexKeysForIndex(StringData indexName) const;
+
+    /**
+     * Returns an extractor which traverses the key pattern paths of all btree indexes other than
+     * the _id index in a single pass over a document, or nullptr if there are fewer than two such
+     * indexes.
+     */
+    std::shared_ptr<const SharedKeyPathExtractor> getSharedKeyPathExtractor() const {
+        return _sharedKeyPathExtractor;
+    }
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog.
      */
@@ -151,6 +168,10 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    // The same information as '_indexedPaths', kept separately for each index by name.
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
+
+    std::shared_ptr<const SharedKeyPathExtractor> _sharedKeyPathExtractor;
 
     std::shared_ptr<PlanCacheState> _planCacheState;
 };
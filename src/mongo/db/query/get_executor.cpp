@@ -40,6 +40,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/exec/batched_update_stage.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
@@ -1848,11 +1849,21 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpda
 
     updateStageParams.canonicalQuery = cq.get();
     const bool isUpsert = updateStageParams.request->isUpsert();
-    root = (isUpsert
-                ? std::make_unique<UpsertStage>(
-                      cq->getExpCtxRaw(), updateStageParams, ws.get(), collection, root.release())
-                : std::make_unique<UpdateStage>(
-                      cq->getExpCtxRaw(), updateStageParams, ws.get(), collection, root.release()));
+    if (isUpsert) {
+        root = std::make_unique<UpsertStage>(
+            cq->getExpCtxRaw(), updateStageParams, ws.get(), collection, root.release());
+    } else if (BatchedUpdateStage::isBatchedUpdateEligible(opCtx, updateStageParams, collection)) {
+        root = std::make_unique<BatchedUpdateStage>(
+            cq->getExpCtxRaw(),
+            updateStageParams,
+            std::make_unique<BatchedUpdateStageBatchParams>(),
+            ws.get(),
+            collection,
+            root.release());
+    } else {
+        root = std::make_unique<UpdateStage>(
+            cq->getExpCtxRaw(), updateStageParams, ws.get(), collection, root.release());
+    }
 
     if (projection) {
         root = std::make_unique<ProjectionStageDefault>(
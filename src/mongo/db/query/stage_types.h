@@ -50,6 +50,7 @@ enum StageType {
     STAGE_AND_HASH,
     STAGE_AND_SORTED,
     STAGE_BATCHED_DELETE,
+    STAGE_BATCHED_UPDATE,
     STAGE_CACHED_PLAN,
     STAGE_COLLSCAN,
     STAGE_COLUMN_IXSCAN,
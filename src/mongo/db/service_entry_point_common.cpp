@@ -44,6 +44,7 @@
 #include "mongo/db/auth/ldap_cumulative_operation_stats.h"
 #include "mongo/db/auth/security_token.h"
 #include "mongo/db/client.h"
+#include "mongo/db/client_strand.h"
 #include "mongo/db/command_can_run_here.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
@@ -90,6 +91,7 @@
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/transaction_validation.h"
 #include "mongo/db/vector_clock.h"
+#include "mongo/db/write_concern.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -716,6 +718,7 @@ private:
     void _waitForWriteConcern(BSONObjBuilder& bb);
     Future<void> _handleError(Status status);
     Future<void> _checkWriteConcern();
+    Future<void> _flushJournalForWriteConcern();
 
     const std::shared_ptr<HandleRequest::ExecutionContext> _execContext;
 
@@ -1265,22 +1268,81 @@ Future<void> RunCommandAndWaitForWriteConcern::_handleError(Status status) {
 }
 
 Future<void> RunCommandAndWaitForWriteConcern::_checkWriteConcern() {
+    return _flushJournalForWriteConcern().then([this] {
+        auto opCtx = _execContext->getOpCtx();
+        auto bb = _execContext->getReplyBuilder()->getBodyBuilder();
+        _waitForWriteConcern(bb);
+
+        // With the exception of getMores inheriting the WriteConcern from the originating command,
+        // nothing in run() should change the writeConcern.
+        if (_execContext->getCommand()->getLogicalOp() == LogicalOp::opGetMore) {
+            dassert(!_extractedWriteConcern,
+                    "opGetMore contained unexpected extracted write concern");
+        } else {
+            dassert(_extractedWriteConcern, "no extracted write concern");
+            dassert(opCtx->getWriteConcern() == _extractedWriteConcern,
+                    "opCtx wc: {} extracted wc: {}"_format(
+                        opCtx->getWriteConcern().toBSON().jsonString(),
+                        _extractedWriteConcern->toBSON().jsonString()));
+        }
+    });
+}
+
+Future<void> RunCommandAndWaitForWriteConcern::_flushJournalForWriteConcern() {
     auto opCtx = _execContext->getOpCtx();
-    auto bb = _execContext->getReplyBuilder()->getBodyBuilder();
-    _waitForWriteConcern(bb);
+    auto client = opCtx->getClient();
 
-    // With the exception of getMores inheriting the WriteConcern from the originating command,
-    // nothing in run() should change the writeConcern.
-    if (_execContext->getCommand()->getLogicalOp() == LogicalOp::opGetMore) {
-        dassert(!_extractedWriteConcern, "opGetMore contained unexpected extracted write concern");
-    } else {
-        dassert(_extractedWriteConcern, "no extracted write concern");
-        dassert(
-            opCtx->getWriteConcern() == _extractedWriteConcern,
-            "opCtx wc: {} extracted wc: {}"_format(opCtx->getWriteConcern().toBSON().jsonString(),
-                                                   _extractedWriteConcern->toBSON().jsonString()));
+    // Only a command that wrote will wait for its write concern, and a direct client blocks on its
+    // nested command while its Client is bound.
+    if (!transport::ServiceExecutorContext::mayCompleteAsynchronously(opCtx) ||
+        client->isInDirectClient() || !_ecd->getInvocation()->ns().isReplicated() ||
+        repl::ReplClientInfo::forClient(client).getLastOp() == *_lastOpBeforeRun) {
+        return Status::OK();
     }
-    return Status::OK();
+
+    auto strand = ClientStrand::get(client);
+    if (!strand) {
+        return Status::OK();
+    }
+
+    boost::optional<SharedSemiFuture<void>> flushed;
+    try {
+        flushed = requestJournalFlushForWriteConcern(opCtx, opCtx->getWriteConcern());
+    } catch (const DBException&) {
+        // The wait for write concern runs into the same error and reports it.
+        return Status::OK();
+    }
+    if (!flushed) {
+        return Status::OK();
+    }
+
+    // Rather than block this thread until the flush round that the write joined completes, resume
+    // the command on the Client's executor afterwards. The flush round is bounded by the journal
+    // commit interval, and the wait for write concern checks for interruption once resumed.
+    auto executor = transport::ServiceExecutorContext::get(client)->getServiceExecutor();
+    auto pf = makePromiseFuture<bool>();
+    auto promise = std::make_shared<Promise<bool>>(std::move(pf.promise));
+    flushed->unsafeToInlineFuture().getAsync([strand, executor, promise](Status flushStatus) {
+        // This runs on the journal flusher thread, which must not be held up by the command.
+        auto scheduleStatus = executor->scheduleTask(
+            [strand, promise, journalFlushed = flushStatus.isOK()] {
+                strand->run([&] { promise->emplaceValue(journalFlushed); });
+            },
+            transport::ServiceExecutor::ScheduleFlags{});
+        if (!scheduleStatus.isOK()) {
+            strand->run([&] { promise->setError(scheduleStatus); });
+        }
+    });
+
+    return std::move(pf.future).then([this](bool journalFlushed) {
+        auto opCtx = _execContext->getOpCtx();
+        opCtx->lockState()->updateThreadIdToCurrentThread();
+
+        // If the round failed, e.g. due to a stepdown, the wait for write concern flushes again.
+        if (journalFlushed) {
+            setJournalFlushedForWriteConcern(opCtx);
+        }
+    });
 }
 
 void ExecCommandDatabase::_initiateCommand() {
@@ -33,6 +33,8 @@
 
 #include "mongo/db/service_entry_point_mongod.h"
 
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
 #include "mongo/db/commands/fsync_locked.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/curop.h"
@@ -48,6 +50,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/sharding_metadata.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_cannot_refresh_due_to_locks_held_exception.h"
 #include "mongo/s/stale_exception.h"
@@ -277,4 +280,87 @@ Future<DbResponse> ServiceEntryPointMongod::handleRequest(OperationContext* opCt
     return ServiceEntryPointCommon::handleRequest(opCtx, m, std::make_unique<Hooks>());
 }
 
+bool ServiceEntryPointMongod::isPipelinableRequest(Client* client,
+                                                   const Message& request) noexcept try {
+    if (request.operation() != dbMsg || OpMsg::isFlagSet(request, OpMsg::kMoreToCome) ||
+        OpMsg::isFlagSet(request, OpMsg::kExhaustSupported)) {
+        return false;
+    }
+
+    const auto opMsg = OpMsgRequest::parse(request);
+    const auto commandName = opMsg.getCommandName();
+
+    // A getMore depends on the position left behind by the requests before it on the same cursor.
+    if (commandName == "getMore"_sd) {
+        return false;
+    }
+
+    auto command = CommandHelpers::findCommand(commandName);
+    if (!command || command->getReadWriteType() != Command::ReadWriteType::kRead) {
+        return false;
+    }
+
+    // Transactions and retryable writes rely on the order in which statements arrive.
+    if (opMsg.body.hasField("txnNumber") || opMsg.body.hasField("startTransaction") ||
+        opMsg.body.hasField("autocommit")) {
+        return false;
+    }
+
+    // Aggregations count as reads, but $out and $merge make them writes.
+    if (auto pipeline = opMsg.body["pipeline"]; pipeline.type() == Array) {
+        for (auto&& stage : pipeline.Obj()) {
+            if (stage.type() != Object) {
+                return false;
+            }
+            auto stageName = stage.Obj().firstElementFieldNameStringData();
+            if (stageName == "$out"_sd || stageName == "$merge"_sd) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+} catch (const DBException&) {
+    // Let the regular path report malformed requests.
+    return false;
+}
+
+namespace {
+
+std::vector<UserName> getAuthenticatedUserNames(Client* client) {
+    std::vector<UserName> userNames;
+    for (auto it = AuthorizationSession::get(client)->getAuthenticatedUserNames(); it.more();) {
+        userNames.push_back(it.next());
+    }
+    return userNames;
+}
+
+}  // namespace
+
+Status ServiceEntryPointMongod::initPipelinedClient(Client* client,
+                                                   ServiceContext::UniqueClient& pipelinedClient) {
+    const auto userNames = getAuthenticatedUserNames(client);
+
+    if (userNames.empty()) {
+        return Status::OK();
+    }
+
+    AlternativeClientRegion acr(pipelinedClient);
+    auto opCtx = cc().makeOperationContext();
+    auto authSession = AuthorizationSession::get(opCtx->getClient());
+    for (const auto& userName : userNames) {
+        if (auto status = authSession->addAndAuthorizeUser(opCtx.get(), userName); !status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+bool ServiceEntryPointMongod::isPipelinedClientCurrent(Client* client, Client* pipelinedClient) {
+    // The users are authorized once per pipelined Client. Their privileges are kept up to date by
+    // the AuthorizationSession, but authenticating or logging out needs a new Client.
+    return getAuthenticatedUserNames(client) == getAuthenticatedUserNames(pipelinedClient);
+}
+
 }  // namespace mongo
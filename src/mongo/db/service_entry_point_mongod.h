@@ -45,6 +45,13 @@ public:
     Future<DbResponse> handleRequest(OperationContext* opCtx,
                                      const Message& request) noexcept override;
 
+    bool isPipelinableRequest(Client* client, const Message& request) noexcept override;
+
+    Status initPipelinedClient(Client* client,
+                               ServiceContext::UniqueClient& pipelinedClient) override;
+
+    bool isPipelinedClientCurrent(Client* client, Client* pipelinedClient) override;
+
 private:
     class Hooks;
 };
@@ -61,6 +61,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/type_traits.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/str.h"
@@ -116,6 +117,18 @@ EncryptionHooks* getEncryptionHooksIfEnabled() {
 
 constexpr std::size_t kSortedFileBufferSize = 64 * 1024;
 
+template <typename Key>
+using RelativeSerializeForSorter = decltype(std::declval<const Key&>().serializeForSorter(
+    std::declval<BufBuilder&>(), std::declval<std::string*>()));
+
+/**
+ * Whether Keys are written to disk relative to the previous Key in the same block, see
+ * sorter.h.
+ */
+template <typename Key>
+constexpr bool kSerializesRelativeToPreviousKey =
+    stdx::is_detected_v<RelativeSerializeForSorter, Key>;
+
 }  // namespace
 
 namespace sorter {
@@ -213,14 +226,20 @@ public:
                  std::streamoff fileEndOffset,
                  const Settings& settings,
                  const boost::optional<std::string>& dbName,
-                 const uint32_t checksum)
+                 const uint32_t checksum,
+                 bool prefixCompressedKeys)
         : _settings(settings),
+          _prefixCompressedKeys(prefixCompressedKeys),
           _file(std::move(file)),
           _fileStartOffset(fileStartOffset),
           _fileCurrentOffset(fileStartOffset),
           _fileEndOffset(fileEndOffset),
           _dbName(dbName),
-          _originalChecksum(checksum) {}
+          _originalChecksum(checksum) {
+        uassert(7804501,
+                "Sorted data range has keys that cannot be deserialized relative to each other",
+                !_prefixCompressedKeys || kSerializesRelativeToPreviousKey<Key>);
+    }
 
     void openSource() {}
 
@@ -254,7 +273,7 @@ public:
         // buffer. Since Key comes before Value in the _bufferReader, and C++ makes no function
         // parameter evaluation order guarantees, we cannot deserialize Key and Value straight into
         // the Data constructor
-        auto first = Key::deserializeForSorter(*_bufferReader, _settings.first);
+        auto first = _deserializeKey();
         auto second = Value::deserializeForSorter(*_bufferReader, _settings.second);
 
         // The difference of _bufferReader's position before and after reading the data
@@ -272,10 +291,24 @@ public:
     }
 
     SorterRange getRange() const {
-        return {_fileStartOffset, _fileEndOffset, _originalChecksum};
+        SorterRange range{_fileStartOffset, _fileEndOffset, _originalChecksum};
+        if (_prefixCompressedKeys) {
+            range.setPrefixCompressedKeys(true);
+        }
+        return range;
     }
 
 private:
+    Key _deserializeKey() {
+        if constexpr (kSerializesRelativeToPreviousKey<Key>) {
+            if (_prefixCompressedKeys) {
+                return Key::deserializeForSorter(
+                    *_bufferReader, _settings.first, &_previousKeyInBlock);
+            }
+        }
+        return Key::deserializeForSorter(*_bufferReader, _settings.first);
+    }
+
     /**
      * Attempts to refill the _bufferReader if it is empty. Expects _done to be false.
      */
@@ -296,6 +329,9 @@ private:
         if (_done)
             return;
 
+        // Keys are only ever serialized relative to keys in the same block.
+        _previousKeyInBlock.clear();
+
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
@@ -363,6 +399,11 @@ private:
     const Settings _settings;
     bool _done = false;
 
+    // Whether each key was written relative to the previous key in the same block, whose bytes
+    // are then tracked in '_previousKeyInBlock'.
+    const bool _prefixCompressedKeys;
+    std::string _previousKeyInBlock;
+
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _bufferReader;
     std::shared_ptr<typename Sorter<Key, Value>::File>
@@ -713,7 +754,8 @@ public:
                                range.getEndOffset(),
                                this->_settings,
                                this->_opts.dbName,
-                               range.getChecksum());
+                               range.getChecksum(),
+                               range.getPrefixCompressedKeys().value_or(false));
                        });
         this->_numSpills = this->_iters.size();
     }
@@ -1266,7 +1308,8 @@ SortedFileWriter<Key, Value>::SortedFileWriter(
     : _settings(settings),
       _file(std::move(file)),
       _fileStartOffset(_file->currentOffset()),
-      _dbName(opts.dbName) {
+      _dbName(opts.dbName),
+      _prefixCompressKeys(opts.prefixCompressKeys && kSerializesRelativeToPreviousKey<Key>) {
     // This should be checked by consumers, but if we get here don't allow writes.
     uassert(
         16946, "Attempting to use external sort from mongos. This is not allowed.", !isMongos());
@@ -1283,7 +1326,15 @@ void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value&
     int _nextObjPos = _buffer.len();
 
     // Add serialized key and value to the buffer.
-    key.serializeForSorter(_buffer);
+    if constexpr (kSerializesRelativeToPreviousKey<Key>) {
+        if (_prefixCompressKeys) {
+            key.serializeForSorter(_buffer, &_previousKeyInBlock);
+        } else {
+            key.serializeForSorter(_buffer);
+        }
+    } else {
+        key.serializeForSorter(_buffer);
+    }
     val.serializeForSorter(_buffer);
 
     // Serializing the key and value grows the buffer, but _buffer.buf() still points to the
@@ -1337,14 +1388,20 @@ void SortedFileWriter<Key, Value>::spill() {
     _file->write(outBuffer, std::abs(size));
 
     _buffer.reset();
+    _previousKeyInBlock.clear();
 }
 
 template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
 
-    return new sorter::FileIterator<Key, Value>(
-        _file, _fileStartOffset, _file->currentOffset(), _settings, _dbName, _checksum);
+    return new sorter::FileIterator<Key, Value>(_file,
+                                                _fileStartOffset,
+                                                _file->currentOffset(),
+                                                _settings,
+                                                _dbName,
+                                                _checksum,
+                                                _prefixCompressKeys);
 }
 
 template <typename Key, typename Value, typename Comparator, typename BoundMaker>
@@ -66,6 +66,15 @@
  * // How much memory is used by your type? Include sizeof(*this) and any memory you reference.
  * int memUsageForSorter() const;
  *
+ * // Optional, and only used for Keys. Serialize and deserialize this object relative to the Key
+ * // before it in the same block of a spill file, e.g. prefix-compressed. 'previous' holds whatever
+ * // bytes the previous Key left in it, is empty for the first Key of a block, and is updated for
+ * // the next Key. The Sorter only uses these when SortOptions::prefixCompressKeys is set.
+ * void serializeForSorter(BufBuilder& buf, std::string* previous) const;
+ * static Type deserializeForSorter(BufReader& buf,
+ *                                  const Type::SorterDeserializeSettings&,
+ *                                  std::string* previous);
+ *
  * // For types with owned and unowned states, such as BSON, return an owned version. The Sorter
  * // is responsible for converting any unowned data to an owned state if it needs to be buffered.
  * // Return *this if your type doesn't have an unowned state.
@@ -122,11 +131,17 @@ struct SortOptions {
     // instead of copying.
     bool moveSortedDataIntoIterator;
 
+    // If set to true, Keys that support it are written to spill files relative to the previous Key
+    // in the same block. Such files cannot be read by versions that predate this format, so it
+    // must only be set when the spilled data cannot outlive an upgrade to such a version.
+    bool prefixCompressKeys;
+
     SortOptions()
         : limit(0),
           maxMemoryUsageBytes(64 * 1024 * 1024),
           extSortAllowed(false),
-          moveSortedDataIntoIterator(false) {}
+          moveSortedDataIntoIterator(false),
+          prefixCompressKeys(false) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -159,6 +174,11 @@ struct SortOptions {
         moveSortedDataIntoIterator = newMoveSortedDataIntoIterator;
         return *this;
     }
+
+    SortOptions& PrefixCompressKeys(bool newPrefixCompressKeys = true) {
+        prefixCompressKeys = newPrefixCompressKeys;
+        return *this;
+    }
 };
 
 /**
@@ -583,6 +603,13 @@ private:
     std::streamoff _fileStartOffset;
 
     boost::optional<std::string> _dbName;
+
+    // Whether keys are serialized relative to the previous key in the same block. If so, the
+    // bytes the next key is compared against are kept in '_previousKeyInBlock', which is reused
+    // across keys so that adding a key only copies the part it does not share with its
+    // predecessor.
+    const bool _prefixCompressKeys;
+    std::string _previousKeyInBlock;
 };
 }  // namespace mongo
 
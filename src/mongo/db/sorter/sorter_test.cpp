@@ -972,6 +972,110 @@ TEST_F(SorterMakeFromExistingRangesTest, RoundTrip) {
     }
 }
 
+/**
+ * A string Key which can be written to spill files relative to the previous Key in the same block.
+ */
+class PrefixCompressibleString {
+public:
+    PrefixCompressibleString(std::string str = "") : _str(std::move(str)) {}
+
+    const std::string& str() const {
+        return _str;
+    }
+
+    /// members for Sorter
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(static_cast<int>(_str.size()));
+        buf.appendStr(_str, false /* includeEndingNull */);
+    }
+    void serializeForSorter(BufBuilder& buf, std::string* previous) const {
+        size_t shared = 0;
+        while (shared < std::min(_str.size(), previous->size()) &&
+               _str[shared] == (*previous)[shared]) {
+            ++shared;
+        }
+        buf.appendNum(static_cast<int>(shared));
+        PrefixCompressibleString(_str.substr(shared)).serializeForSorter(buf);
+        *previous = _str;
+    }
+    static PrefixCompressibleString deserializeForSorter(BufReader& buf,
+                                                         const SorterDeserializeSettings&) {
+        const int size = buf.read<LittleEndian<int>>();
+        return std::string(static_cast<const char*>(buf.skip(size)), size);
+    }
+    static PrefixCompressibleString deserializeForSorter(BufReader& buf,
+                                                         const SorterDeserializeSettings& settings,
+                                                         std::string* previous) {
+        const int shared = buf.read<LittleEndian<int>>();
+        ASSERT_LTE(shared, previous->size());
+        previous->resize(shared);
+        *previous += deserializeForSorter(buf, settings).str();
+        return *previous;
+    }
+    int memUsageForSorter() const {
+        return sizeof(PrefixCompressibleString) + _str.capacity();
+    }
+    PrefixCompressibleString getOwned() const {
+        return *this;
+    }
+
+private:
+    std::string _str;
+};
+
+using PrefixCompressibleStringSorter = Sorter<PrefixCompressibleString, IntWrapper>;
+
+class PrefixCompressibleStringComparator {
+public:
+    int operator()(const PrefixCompressibleStringSorter::Data& lhs,
+                   const PrefixCompressibleStringSorter::Data& rhs) const {
+        return lhs.first.str().compare(rhs.first.str());
+    }
+};
+
+TEST(SorterPrefixCompressedKeysTest, RoundTripWithAndWithoutPrefixCompression) {
+    const std::vector<std::string> keys = {"abc", "abcd", "abd", "b", "bcd", "bcd", ""};
+    std::vector<std::string> sortedKeys = keys;
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    for (bool prefixCompressKeys : {false, true}) {
+        unittest::TempDir tempDir("sorterPrefixCompressedKeysTest");
+        auto opts = SortOptions()
+                        .ExtSortAllowed()
+                        .TempDir(tempDir.path())
+                        .PrefixCompressKeys(prefixCompressKeys);
+
+        PrefixCompressibleStringSorter::PersistedState state;
+        {
+            auto sorter = std::unique_ptr<PrefixCompressibleStringSorter>(
+                PrefixCompressibleStringSorter::make(opts, PrefixCompressibleStringComparator()));
+            for (size_t i = 0; i < keys.size(); ++i) {
+                sorter->add(keys[i], static_cast<int>(i));
+            }
+            state = sorter->persistDataForShutdown();
+        }
+
+        // Ranges written without prefix compression must remain readable by versions which do not
+        // know about the field.
+        ASSERT_EQ(1U, state.ranges.size());
+        ASSERT_EQ(prefixCompressKeys, state.ranges[0].toBSON().hasField("prefixCompressedKeys"))
+            << state.ranges[0].toBSON();
+
+        auto sorter = std::unique_ptr<PrefixCompressibleStringSorter>(
+            PrefixCompressibleStringSorter::makeFromExistingRanges(
+                state.fileName, state.ranges, opts, PrefixCompressibleStringComparator()));
+        auto iter = std::unique_ptr<PrefixCompressibleStringSorter::Iterator>(sorter->done());
+        iter->openSource();
+        for (const auto& key : sortedKeys) {
+            ASSERT(iter->more());
+            ASSERT_EQ(key, iter->next().first.str());
+        }
+        ASSERT_FALSE(iter->more());
+        iter->closeSource();
+    }
+}
+
 class BoundedSorterTest : public unittest::Test {
 public:
     using Key = IntWrapper;
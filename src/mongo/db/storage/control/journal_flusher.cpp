@@ -34,6 +34,7 @@
 #include "mongo/db/storage/control/journal_flusher.h"
 
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/storage_options.h"
@@ -51,6 +52,24 @@ const auto getJournalFlusher = ServiceContext::declareDecoration<std::unique_ptr
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherBeforeFlush);
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherThread);
 
+class JournalFlusherSSS : public ServerStatusSection {
+public:
+    JournalFlusherSSS() : ServerStatusSection("journalFlusher") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder bob;
+        if (auto& journalFlusher = getJournalFlusher(opCtx->getServiceContext())) {
+            journalFlusher->appendStats(&bob);
+        }
+        return bob.obj();
+    }
+} journalFlusherSSS;
+
 }  // namespace
 
 JournalFlusher* JournalFlusher::get(ServiceContext* serviceCtx) {
@@ -115,6 +134,7 @@ void JournalFlusher::run() {
 
             // Signal the waiters that a round completed.
             _currentSharedPromise->emplaceValue();
+            _recordCompletedRound(/*flushed*/ true);
         } catch (const AssertionException& e) {
             // Can be caused by killOp.
             if (e.code() == ErrorCodes::Interrupted) {
@@ -137,6 +157,7 @@ void JournalFlusher::run() {
 
             // Signal the waiters that the fsync was interrupted.
             _currentSharedPromise->setError(e.toStatus());
+            _recordCompletedRound(/*flushed*/ false);
         }
 
         // Wait until either journalCommitIntervalMs passes or an immediate journal flush is
@@ -186,9 +207,12 @@ void JournalFlusher::run() {
             return;
         }
 
-        // Take the next promise as current and reset the next promise.
+        // Take the next promise as current and reset the next promise. The requests that joined
+        // the next round move along with it.
         _currentSharedPromise =
             std::exchange(_nextSharedPromise, std::make_unique<SharedPromise<void>>());
+        _currentRoundRequestTicks.clear();
+        std::swap(_currentRoundRequestTicks, _nextRoundRequestTicks);
     }
 }
 
@@ -234,9 +258,12 @@ void JournalFlusher::triggerJournalFlush() {
 }
 
 void JournalFlusher::waitForJournalFlush() {
+    const auto requestTicks = getGlobalServiceContext()->getTickSource()->getTicks();
     while (true) {
         try {
-            _waitForJournalFlushNoRetry();
+            // Throws on error if the flusher round is interrupted or the flusher thread is
+            // shutdown.
+            _requestJournalFlush(requestTicks).get();
             break;
         } catch (const ExceptionFor<ErrorCodes::InterruptedDueToReplStateChange>&) {
             // Do nothing and let the while-loop retry the operation.
@@ -247,6 +274,10 @@ void JournalFlusher::waitForJournalFlush() {
     }
 }
 
+SharedSemiFuture<void> JournalFlusher::requestJournalFlush() {
+    return _requestJournalFlush(getGlobalServiceContext()->getTickSource()->getTicks());
+}
+
 void JournalFlusher::interruptJournalFlusherForReplStateChange() {
     stdx::lock_guard<Latch> lk(_opCtxMutex);
     if (_uniqueCtx) {
@@ -255,17 +286,45 @@ void JournalFlusher::interruptJournalFlusherForReplStateChange() {
     }
 }
 
-void JournalFlusher::_waitForJournalFlushNoRetry() {
-    auto myFuture = [&]() {
-        stdx::unique_lock<Latch> lk(_stateMutex);
-        if (!_flushJournalNow) {
-            _flushJournalNow = true;
-            _flushJournalNowCV.notify_one();
-        }
-        return _nextSharedPromise->getFuture();
-    }();
-    // Throws on error if the flusher round is interrupted or the flusher thread is shutdown.
-    myFuture.get();
+void JournalFlusher::appendStats(BSONObjBuilder* builder) const {
+    builder->append("rounds", _completedRounds.load());
+    builder->append("requests", _completedRequests.load());
+    {
+        stdx::lock_guard<Latch> lk(_stateMutex);
+        builder->append("pendingRequests", static_cast<long long>(_nextRoundRequestTicks.size()));
+    }
+    appendHistogram(*builder, _groupSizeHistogram, "groupSize");
+    appendHistogram(*builder, _waitMicrosHistogram, "waitMicros");
+}
+
+SharedSemiFuture<void> JournalFlusher::_requestJournalFlush(TickSource::Tick requestTicks) {
+    stdx::unique_lock<Latch> lk(_stateMutex);
+    if (!_flushJournalNow) {
+        _flushJournalNow = true;
+        _flushJournalNowCV.notify_one();
+    }
+    _nextRoundRequestTicks.push_back(requestTicks);
+    return _nextSharedPromise->getFuture();
+}
+
+void JournalFlusher::_recordCompletedRound(bool flushed) {
+    _completedRounds.fetchAndAdd(1);
+    if (!flushed || _currentRoundRequestTicks.empty()) {
+        // Either the requests will be counted by the round that completes their retry, or this is
+        // a periodic round that no caller was waiting for.
+        _currentRoundRequestTicks.clear();
+        return;
+    }
+
+    auto tickSource = getGlobalServiceContext()->getTickSource();
+    const auto now = tickSource->getTicks();
+    for (auto requestTicks : _currentRoundRequestTicks) {
+        _waitMicrosHistogram.increment(
+            durationCount<Microseconds>(tickSource->ticksTo<Microseconds>(now - requestTicks)));
+    }
+    _groupSizeHistogram.increment(_currentRoundRequestTicks.size());
+    _completedRequests.fetchAndAdd(_currentRoundRequestTicks.size());
+    _currentRoundRequestTicks.clear();
 }
 
 }  // namespace mongo
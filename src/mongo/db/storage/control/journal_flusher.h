@@ -29,10 +29,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/future.h"
+#include "mongo/util/histogram.h"
+#include "mongo/util/tick_source.h"
 
 namespace mongo {
 
@@ -115,12 +120,30 @@ public:
      */
     void waitForJournalFlush();
 
+    /**
+     * Signals an immediate journal flush and returns a future that becomes ready once it has
+     * completed, so that the caller does not have to hold a thread while the flush is in progress.
+     *
+     * Unlike waitForJournalFlush(), this does not retry: the future is set with
+     * InterruptedDueToReplStateChange if the round is interrupted by a replication state change,
+     * or with an ErrorCodes::isShutdownError error if the flusher thread is being stopped. Any
+     * continuation that is run inline must not block, since it runs on the flusher thread.
+     */
+    SharedSemiFuture<void> requestJournalFlush();
+
     /**
      * Interrupts the journal flusher thread via its operation context with an
      * InterruptedDueToReplStateChange error.
      */
     void interruptJournalFlusherForReplStateChange();
 
+    /**
+     * Appends the number of completed flush rounds and requests, the number of requests waiting
+     * for the next round, and histograms of the number of requests completed per round and of the
+     * time those requests spent waiting.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
     // Journal flusher internal states.
     enum class States {
@@ -130,12 +153,23 @@ private:
     };
 
     /**
-     * Signals an immediate journal flush and waits for it to complete before returning.
+     * Signals an immediate journal flush and returns a future for its completion. Every request
+     * made before a round starts joins that round's group, which is completed in bulk by a single
+     * data flush. 'requestTicks' is when the caller first asked for a flush, so that retries are
+     * not counted as separate requests.
      *
-     * Will throw ErrorCodes::isShutdownError if the flusher thread is being stopped.
-     * Will throw InterruptedDueToReplStateChange if a flusher round is interrupted by stepdown.
+     * The future is set with ErrorCodes::isShutdownError if the flusher thread is being stopped,
+     * or with InterruptedDueToReplStateChange if a flusher round is interrupted by stepdown.
+     */
+    SharedSemiFuture<void> _requestJournalFlush(TickSource::Tick requestTicks);
+
+    /**
+     * Counts a finished round. If the round flushed successfully, also records the group size and
+     * the wait times of the requests it completed. The requests of a failed round are dropped
+     * because their callers either retry, and are counted by the round that completes them, or
+     * give up. Only called by the flusher thread.
      */
-    void _waitForJournalFlushNoRetry();
+    void _recordCompletedRound(bool flushed);
 
     // Serializes setting/resetting _uniqueCtx and marking _uniqueCtx killed.
     mutable Mutex _opCtxMutex = MONGO_MAKE_LATCH("JournalFlusherOpCtxMutex");
@@ -170,6 +204,18 @@ private:
     std::unique_ptr<SharedPromise<void>> _nextSharedPromise =
         std::make_unique<SharedPromise<void>>();
 
+    // The times at which requests joined the next round, and those of the round in progress. The
+    // latter is swapped in together with the shared promise and is only accessed by the flusher
+    // thread afterwards.
+    std::vector<TickSource::Tick> _nextRoundRequestTicks;
+    std::vector<TickSource::Tick> _currentRoundRequestTicks;
+
+    // Flushing statistics, reported through serverStatus.
+    AtomicWord<long long> _completedRounds{0};
+    AtomicWord<long long> _completedRequests{0};
+    Histogram<int64_t> _groupSizeHistogram{{2, 4, 8, 16, 32, 64, 128}};
+    Histogram<int64_t> _waitMicrosHistogram{{100, 500, 1000, 5000, 10000, 50000, 100000}};
+
     // Controls whether to ignore the 'storageGlobalParams.journalCommitIntervalMs' setting. If set,
     // data flushes will only be executed upon explicit request, no longer periodically in addition
     // to upon request.
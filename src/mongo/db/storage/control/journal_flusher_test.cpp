@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/db/storage/control/journal_flusher.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+class JournalFlusherTest : public ServiceContextMongoDTest {
+protected:
+    void setUp() override {
+        ServiceContextMongoDTest::setUp();
+
+        // Let the flusher finish its startup rounds so that every test request below runs exactly
+        // one round.
+        flusher()->waitForJournalFlush();
+    }
+
+    JournalFlusher* flusher() {
+        return JournalFlusher::get(getServiceContext());
+    }
+
+    BSONObj stats() {
+        BSONObjBuilder bob;
+        flusher()->appendStats(&bob);
+        return bob.obj();
+    }
+
+    void waitForPendingRequests(long long count) {
+        while (stats()["pendingRequests"].numberLong() < count) {
+            sleepmillis(1);
+        }
+    }
+};
+
+TEST_F(JournalFlusherTest, ConcurrentRequestsShareOneRound) {
+    const auto before = stats();
+
+    // Requests made while the flusher is paused all join the next round.
+    const int kNumWaiters = 5;
+    flusher()->pause();
+    std::vector<stdx::thread> waiters;
+    for (int i = 0; i < kNumWaiters; ++i) {
+        waiters.emplace_back([&] { flusher()->waitForJournalFlush(); });
+    }
+    waitForPendingRequests(kNumWaiters);
+
+    flusher()->resume();
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+
+    const auto after = stats();
+    ASSERT_EQ(after["rounds"].numberLong(), before["rounds"].numberLong() + 1) << after;
+    ASSERT_EQ(after["requests"].numberLong(), before["requests"].numberLong() + kNumWaiters)
+        << after;
+    ASSERT_EQ(after["pendingRequests"].numberLong(), 0) << after;
+
+    const auto groupSize = after["groupSize"].Obj();
+    ASSERT_EQ(groupSize["[4, 8)"]["count"].numberLong(),
+              before["groupSize"]["[4, 8)"]["count"].numberLong() + 1)
+        << after;
+    ASSERT_EQ(groupSize["totalCount"].numberLong(),
+              before["groupSize"]["totalCount"].numberLong() + 1)
+        << after;
+    ASSERT_EQ(after["waitMicros"]["totalCount"].numberLong(),
+              before["waitMicros"]["totalCount"].numberLong() + kNumWaiters)
+        << after;
+}
+
+TEST_F(JournalFlusherTest, RequestsDoNotBlockAndShareARoundWithWaiters) {
+    const auto before = stats();
+
+    flusher()->pause();
+    auto first = flusher()->requestJournalFlush();
+    auto second = flusher()->requestJournalFlush();
+    stdx::thread waiter([&] { flusher()->waitForJournalFlush(); });
+    waitForPendingRequests(3);
+    ASSERT_FALSE(first.isReady());
+    ASSERT_FALSE(second.isReady());
+
+    flusher()->resume();
+    waiter.join();
+    first.get();
+    second.get();
+
+    const auto after = stats();
+    ASSERT_EQ(after["rounds"].numberLong(), before["rounds"].numberLong() + 1) << after;
+    ASSERT_EQ(after["requests"].numberLong(), before["requests"].numberLong() + 3) << after;
+    ASSERT_EQ(after["groupSize"]["[2, 4)"]["count"].numberLong(),
+              before["groupSize"]["[2, 4)"]["count"].numberLong() + 1)
+        << after;
+}
+
+TEST_F(JournalFlusherTest, RequestsAfterARoundStartsJoinTheNextRound) {
+    const auto before = stats();
+
+    flusher()->waitForJournalFlush();
+    flusher()->waitForJournalFlush();
+
+    const auto after = stats();
+    ASSERT_EQ(after["rounds"].numberLong(), before["rounds"].numberLong() + 2) << after;
+    ASSERT_EQ(after["requests"].numberLong(), before["requests"].numberLong() + 2) << after;
+    ASSERT_EQ(after["groupSize"]["(-inf, 2)"]["count"].numberLong(),
+              before["groupSize"]["(-inf, 2)"]["count"].numberLong() + 2)
+        << after;
+}
+
+TEST_F(JournalFlusherTest, ServerStatusSection) {
+    flusher()->waitForJournalFlush();
+
+    auto registry = ServerStatusSectionRegistry::get();
+    auto it = std::find_if(registry->begin(), registry->end(), [](auto&& entry) {
+        return entry.first == "journalFlusher";
+    });
+    ASSERT(it != registry->end());
+    ASSERT(it->second->includeByDefault());
+
+    auto opCtx = makeOperationContext();
+    const auto section = it->second->generateSection(opCtx.get(), BSONElement());
+    ASSERT_GTE(section["rounds"].numberLong(), 1) << section;
+    ASSERT_GTE(section["requests"].numberLong(), 1) << section;
+    ASSERT_EQ(section["pendingRequests"].numberLong(), 0) << section;
+    ASSERT_EQ(section["groupSize"].type(), BSONType::Object) << section;
+    ASSERT_GTE(section["groupSize"]["totalCount"].numberLong(), 1) << section;
+    ASSERT_EQ(section["waitMicros"].type(), BSONType::Object) << section;
+    ASSERT_GTE(section["waitMicros"]["totalCount"].numberLong(), 1) << section;
+}
+
+}  // namespace
+}  // namespace mongo
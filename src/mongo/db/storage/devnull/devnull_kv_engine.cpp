@@ -148,6 +148,14 @@ public:
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) {}
 
+    virtual Status rangeTruncate(OperationContext* opCtx,
+                                 const RecordId& minRecordId,
+                                 const RecordId& maxRecordId,
+                                 int64_t hintDataSizeIncrement,
+                                 int64_t hintNumRecordsIncrement) {
+        return Status::OK();
+    }
+
     virtual void appendNumericCustomStats(OperationContext* opCtx,
                                           BSONObjBuilder* result,
                                           double scale) const {
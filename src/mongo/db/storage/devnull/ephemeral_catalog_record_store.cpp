@@ -507,6 +507,23 @@ void EphemeralForTestRecordStore::cappedTruncateAfter(OperationContext* opCtx,
     }
 }
 
+Status EphemeralForTestRecordStore::rangeTruncate(OperationContext* opCtx,
+                                                  const RecordId& minRecordId,
+                                                  const RecordId& maxRecordId,
+                                                  int64_t hintDataSizeIncrement,
+                                                  int64_t hintNumRecordsIncrement) {
+    stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
+    Records::iterator it = _data->records.lower_bound(minRecordId);
+    Records::iterator end = _data->records.upper_bound(maxRecordId);
+    while (it != end) {
+        opCtx->recoveryUnit()->registerChange(
+            std::make_unique<RemoveChange>(opCtx, _data, it->first, it->second));
+        _data->dataSize -= it->second.size;
+        _data->records.erase(it++);
+    }
+    return Status::OK();
+}
+
 int64_t EphemeralForTestRecordStore::storageSize(OperationContext* opCtx,
                                                  BSONObjBuilder* extraInfo,
                                                  int infoLevel) const {
@@ -92,6 +92,12 @@ public:
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
 
+    virtual Status rangeTruncate(OperationContext* opCtx,
+                                 const RecordId& minRecordId,
+                                 const RecordId& maxRecordId,
+                                 int64_t hintDataSizeIncrement,
+                                 int64_t hintNumRecordsIncrement);
+
     virtual void appendNumericCustomStats(OperationContext* opCtx,
                                           BSONObjBuilder* result,
                                           double scale) const {}
@@ -291,6 +291,31 @@ void RecordStore::cappedTruncateAfter(OperationContext* opCtx, RecordId end, boo
     wuow.commit();
 }
 
+Status RecordStore::rangeTruncate(OperationContext* opCtx,
+                                  const RecordId& minRecordId,
+                                  const RecordId& maxRecordId,
+                                  int64_t hintDataSizeIncrement,
+                                  int64_t hintNumRecordsIncrement) {
+    // The size information is kept exact by the SizeAdjuster, so the hints are not needed.
+    auto ru = RecoveryUnit::get(opCtx);
+    StringStore* workingCopy(ru->getHead());
+    auto recordIt = workingCopy->lower_bound(createKey(_ident, minRecordId));
+    auto endIt = workingCopy->upper_bound(createKey(_ident, maxRecordId));
+
+    while (recordIt != endIt) {
+        SizeAdjuster adjuster(opCtx, this);
+
+        // Don't need to increment the iterator because the iterator gets revalidated and placed on
+        // the next item after the erase.
+        workingCopy->erase(recordIt->first);
+
+        // Tree modifications are bound to happen here so we need to reposition our end cursor.
+        endIt.repositionIfChanged();
+        ru->makeDirty();
+    }
+    return Status::OK();
+}
+
 void RecordStore::updateStatsAfterRepair(OperationContext* opCtx,
                                          long long numRecords,
                                          long long dataSize) {
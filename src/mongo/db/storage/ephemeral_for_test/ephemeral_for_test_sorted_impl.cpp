@@ -518,6 +518,10 @@ public:
                                                 RequestedInfo parts = kKeyAndLoc) override;
     virtual boost::optional<KeyStringEntry> seekForKeyString(
         const KeyString::Value& keyStringValue) override;
+    virtual size_t nextKeyStringBatch(size_t maxEntries,
+                                      const KeyString::Value* endKey,
+                                      SharedBufferFragmentBuilder& memoryPool,
+                                      std::vector<KeyStringEntry>* out) override;
     virtual void save() override;
     virtual void restore() override;
     virtual void detachFromOperationContext() override;
@@ -794,6 +798,34 @@ boost::optional<KeyStringEntry> CursorBase<CursorImpl>::seekForKeyString(
     return seekAfterProcessing(keyStringValue);
 }
 
+template <class CursorImpl>
+size_t CursorBase<CursorImpl>::nextKeyStringBatch(size_t maxEntries,
+                                                  const KeyString::Value* endKey,
+                                                  SharedBufferFragmentBuilder& memoryPool,
+                                                  std::vector<KeyStringEntry>* out) {
+    // Entries are decoded from the radix store into KeyStrings of their own, so 'memoryPool' is
+    // not used.
+    size_t appended = 0;
+    while (appended < maxEntries) {
+        auto entry = static_cast<CursorImpl*>(this)->nextKeyString();
+        if (!entry) {
+            break;
+        }
+
+        if (endKey) {
+            const int cmp = entry->keyString.compare(*endKey);
+            if (_forward ? cmp > 0 : cmp < 0) {
+                _atEOF = true;
+                break;
+            }
+        }
+
+        out->push_back(std::move(*entry));
+        ++appended;
+    }
+    return appended;
+}
+
 template <class CursorImpl>
 void CursorBase<CursorImpl>::save() {
     _atEOF = false;
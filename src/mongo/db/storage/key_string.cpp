@@ -243,10 +243,17 @@ const uint8_t kGreater = 254;
 // some utility functions
 namespace {
 
+// May be used in place, with 'dst' equal to 'src'.
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+
+    // Flip a word at a time, then finish off the tail a byte at a time.
+    for (; end - input >= static_cast<ptrdiff_t>(sizeof(uint64_t));
+         input += sizeof(uint64_t), output += sizeof(uint64_t)) {
+        DataView(output).write<uint64_t>(~ConstDataView(input).read<uint64_t>());
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -298,10 +305,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     keyStringAssert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -328,10 +333,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
-
+    memcpy_flipBits(&out[0], out.data(), out.size());
     return out;
 }
 }  // namespace
@@ -2704,14 +2706,30 @@ int compare(const char* leftBuf, const char* rightBuf, size_t leftSize, size_t r
     else if (MONGO_unlikely(rightSize == 0))
         return 1;
 
-    int min = std::min(leftSize, rightSize);
-
-    int cmp = memcmp(leftBuf, rightBuf, min);
+    const size_t min = std::min(leftSize, rightSize);
+
+    if (min >= sizeof(uint64_t) && min <= 2 * sizeof(uint64_t)) {
+        // Most index keys are short enough to be compared as two, possibly overlapping, big-endian
+        // words, which is much cheaper than calling memcmp. When the first words are equal, any
+        // overlap of the second with the first is equal too, so the first difference between the
+        // second words is the first difference between the keys.
+        uint64_t left = ConstDataView(leftBuf).read<BigEndian<uint64_t>>();
+        uint64_t right = ConstDataView(rightBuf).read<BigEndian<uint64_t>>();
+        if (left == right) {
+            left = ConstDataView(leftBuf + min - sizeof(uint64_t)).read<BigEndian<uint64_t>>();
+            right = ConstDataView(rightBuf + min - sizeof(uint64_t)).read<BigEndian<uint64_t>>();
+        }
+        if (left != right) {
+            return left < right ? -1 : 1;
+        }
+    } else {
+        int cmp = memcmp(leftBuf, rightBuf, min);
 
-    if (cmp) {
-        if (cmp < 0)
-            return -1;
-        return 1;
+        if (cmp) {
+            if (cmp < 0)
+                return -1;
+            return 1;
+        }
     }
 
     // keys match
@@ -2798,6 +2816,78 @@ void Value::serializeWithoutRecordIdStr(BufBuilder& buf) const {
     buf.appendBuf(_buffer.get() + _ksSize, _buffer.size() - _ksSize);  // Serialize TypeBits
 }
 
+namespace {
+
+// Sizes below this are written in a single byte by appendCompactSize().
+constexpr uint8_t kCompactSizeEscape = 0xFF;
+
+void appendCompactSize(BufBuilder& buf, int32_t size) {
+    if (size < kCompactSizeEscape) {
+        buf.appendUChar(static_cast<uint8_t>(size));
+    } else {
+        buf.appendUChar(kCompactSizeEscape);
+        buf.appendNum(size);
+    }
+}
+
+int32_t readCompactSize(BufReader& buf) {
+    const uint8_t size = buf.read<uint8_t>();
+    if (size < kCompactSizeEscape) {
+        return size;
+    }
+    return buf.read<LittleEndian<int32_t>>();
+}
+
+}  // namespace
+
+void Value::serializeForSorter(BufBuilder& buf, std::string* previous) const {
+    const int32_t maxSharedSize = std::min(_ksSize, static_cast<int32_t>(previous->size()));
+    const char* buffer = _buffer.get();
+    int32_t sharedSize = 0;
+    while (sharedSize < maxSharedSize && buffer[sharedSize] == (*previous)[sharedSize]) {
+        ++sharedSize;
+    }
+
+    appendCompactSize(buf, sharedSize);
+    appendCompactSize(buf, _ksSize - sharedSize);
+    // Serialize the KeyString suffix and the TypeBits.
+    buf.appendBuf(buffer + sharedSize, _buffer.size() - sharedSize);
+
+    // Only the suffix needs to be copied for the next key to share a prefix with.
+    previous->resize(sharedSize);
+    previous->append(buffer + sharedSize, _ksSize - sharedSize);
+}
+
+Value Value::deserializeForSorter(BufReader& buf,
+                                  const SorterDeserializeSettings& settings,
+                                  std::string* previous) {
+    const int32_t sharedSize = readCompactSize(buf);
+    const int32_t suffixSize = readCompactSize(buf);
+    uassert(7804500,
+            "Prefix-compressed KeyString shares more bytes than the previous key has",
+            sharedSize <= static_cast<int32_t>(previous->size()));
+    const char* suffixPtr = static_cast<const char*>(buf.skip(suffixSize));
+
+    previous->resize(sharedSize);
+    previous->append(suffixPtr, suffixSize);
+
+    BufBuilder newBuf(sharedSize + suffixSize + 1);
+    newBuf.appendBuf(previous->data(), previous->size());
+
+    auto typeBits = TypeBits::fromBuffer(settings.keyStringVersion, &buf);  // advances the buf
+    if (typeBits.isAllZeros()) {
+        newBuf.appendChar(0);
+    } else {
+        newBuf.appendBuf(typeBits.getBuffer(), typeBits.getSize());
+    }
+    // Note: this variable is needed to make sure that no method is called on 'newBuf'
+    // after a call on its 'release' method.
+    const size_t newBufLen = newBuf.len();
+    return {settings.keyStringVersion,
+            sharedSize + suffixSize,
+            SharedBufferFragment(newBuf.release(), newBufLen)};
+}
+
 size_t Value::getApproximateSize() const {
     auto size = sizeof(Value);
     size += !_buffer.isShared() ? SharedBuffer::kHolderSize + _buffer.size() : 0;
@@ -432,6 +432,20 @@ public:
         return deserialize(buf, settings.keyStringVersion);
     }
 
+    /**
+     * Prefix-compressed variants of the above, which the Sorter uses for runs of sorted keys it
+     * writes to disk. The leading KeyString bytes this Value shares with 'previous', the KeyString
+     * of the key serialized just before it in the same block, are not written again. 'previous' is
+     * empty for the first key of a block, and both functions leave this Value's KeyString in it.
+     * The serialized format takes the following form:
+     *   [shared prefix size][keystring suffix size][keystring suffix][typebits encoding]
+     * where both sizes take a single byte when less than 255.
+     */
+    void serializeForSorter(BufBuilder& buf, std::string* previous) const;
+    static Value deserializeForSorter(BufReader& buf,
+                                      const SorterDeserializeSettings& settings,
+                                      std::string* previous);
+
     int memUsageForSorter() const {
         // Ideally we want to always use the buffer capacity as a more accurate measure of memory
         // usage here. But when built using the PooledBuilder we cannot do that as the buffer is
@@ -552,6 +566,28 @@ public:
         return {version, _buffer().len(), SharedBufferFragment(newBuf.release(), newBufLen)};
     }
 
+    /**
+     * Like getValueCopy(), but places the copy in a fragment of 'memoryPool' so that many Values
+     * can share a single allocation.
+     */
+    Value getValueCopy(SharedBufferFragmentBuilder& memoryPool) {
+        _doneAppending();
+
+        const int32_t ksSize = _buffer().len();
+        const bool typeBitsAllZeros = _typeBits.isAllZeros();
+        const size_t totalSize = ksSize + (typeBitsAllZeros ? 1 : _typeBits.getSize());
+
+        memoryPool.start(totalSize);
+        char* out = memoryPool.get();
+        memcpy(out, _buffer().buf(), ksSize);
+        if (typeBitsAllZeros) {
+            out[ksSize] = 0;
+        } else {
+            memcpy(out + ksSize, _typeBits.getBuffer(), _typeBits.getSize());
+        }
+        return {version, ksSize, memoryPool.finish(totalSize)};
+    }
+
     void appendRecordId(RecordId loc);
     void appendTypeBits(const TypeBits& bits);
 
@@ -48,6 +48,7 @@ const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
+const Ordering ONE_DESCENDING = Ordering::make(BSON("a" << -1));
 
 struct BsonsAndKeyStrings {
     int bsonSize = 0;
@@ -97,13 +98,14 @@ BSONObj generateBson(BsonValueType bsonValueType) {
 }
 
 static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType,
-                                                     KeyString::Version version) {
+                                                     KeyString::Version version,
+                                                     Ordering ord = ALL_ASCENDING) {
     BsonsAndKeyStrings result;
     result.bsonSize = 0;
     result.keystringSize = 0;
     for (int i = 0; i < kSampleSize; i++) {
         BSONObj bson = generateBson(bsonValueType);
-        KeyString::Builder ks(version, bson, ALL_ASCENDING);
+        KeyString::Builder ks(version, bson, ord);
         result.bsonSize += bson.objsize();
         result.keystringSize += ks.getSize();
         result.bsons[i] = bson;
@@ -135,8 +137,10 @@ void BM_BSONToKeyString(benchmark::State& state,
 
 void BM_KeyStringToBSON(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        Ordering ord = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ord);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (size_t i = 0; i < kSampleSize; i++) {
@@ -144,7 +148,7 @@ void BM_KeyStringToBSON(benchmark::State& state,
             benchmark::DoNotOptimize(
                 KeyString::toBson(bsonsAndKeyStrings.keystrings[i].get(),
                                   bsonsAndKeyStrings.keystringLens[i],
-                                  ALL_ASCENDING,
+                                  ord,
                                   KeyString::TypeBits::fromBuffer(version, &buf)));
         }
     }
@@ -152,6 +156,27 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+// Compares each sampled key with the next one, as index cursors, sorter merges and unique checks
+// do.
+void BM_KeyStringCompare(benchmark::State& state, BsonValueType bsonType) {
+    // The KeyString version does not matter for this test.
+    const auto version = KeyString::Version::V1;
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 1; i < kSampleSize; i++) {
+            benchmark::DoNotOptimize(
+                KeyString::compare(bsonsAndKeyStrings.keystrings[i - 1].get(),
+                                   bsonsAndKeyStrings.keystrings[i].get(),
+                                   bsonsAndKeyStrings.keystringLens[i - 1],
+                                   bsonsAndKeyStrings.keystringLens[i]));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.keystringSize);
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+}
+
 void BM_KeyStringValueAssign(benchmark::State& state, BsonValueType bsonType) {
     // The KeyString version does not matter for this test.
     const auto version = KeyString::Version::V1;
@@ -207,6 +232,31 @@ void BM_KeyStringStackBuilderCopy(benchmark::State& state, BsonValueType bsonTyp
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+// Copies keys out of a reused builder the way an index cursor returns its entries, either into an
+// allocation per key or packed into a shared pool as a batched cursor does.
+void BM_KeyStringBuilderValueCopy(benchmark::State& state, BsonValueType bsonType, bool pooled) {
+    // The KeyString version does not matter for this test.
+    const auto version = KeyString::Version::V1;
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+
+    KeyString::Builder builder(version);
+    std::vector<KeyString::Value> values;
+    values.reserve(kSampleSize);
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        SharedBufferFragmentBuilder pool(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
+        values.clear();
+        for (size_t i = 0; i < kSampleSize; i++) {
+            builder.resetFromBuffer(bsonsAndKeyStrings.keystrings[i].get(),
+                                    bsonsAndKeyStrings.keystringLens[i]);
+            values.push_back(pooled ? builder.getValueCopy(pool) : builder.getValueCopy());
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.keystringSize);
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+}
+
 void BM_KeyStringRecordIdStrAppend(benchmark::State& state, const size_t size) {
     const auto buf = std::string(size, 'a');
     auto rid = RecordId(buf.c_str(), size);
@@ -245,6 +295,13 @@ BENCHMARK_CAPTURE(BM_KeyStringStackBuilderCopy, Decimal, DECIMAL);
 BENCHMARK_CAPTURE(BM_KeyStringStackBuilderCopy, String, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringStackBuilderCopy, Array, ARRAY);
 
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, Int, INT, false);
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, PooledInt, INT, true);
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, String, STRING, false);
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, PooledString, STRING, true);
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, Array, ARRAY, false);
+BENCHMARK_CAPTURE(BM_KeyStringBuilderValueCopy, PooledArray, ARRAY, true);
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -265,6 +322,23 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
 
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Int_Descending, KeyString::Version::V1, INT, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Double_Descending, KeyString::Version::V1, DOUBLE, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Decimal_Descending, KeyString::Version::V1, DECIMAL, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_String_Descending, KeyString::Version::V1, STRING, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Array_Descending, KeyString::Version::V1, ARRAY, ONE_DESCENDING);
+
+BENCHMARK_CAPTURE(BM_KeyStringCompare, Int, INT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, Double, DOUBLE);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, Decimal, DECIMAL);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, String, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, Array, ARRAY);
+
 BENCHMARK_CAPTURE(BM_KeyStringRecordIdStrAppend, 16B, 16);
 BENCHMARK_CAPTURE(BM_KeyStringRecordIdStrAppend, 512B, 512);
 BENCHMARK_CAPTURE(BM_KeyStringRecordIdStrAppend, 1kB, 1024);
@@ -598,6 +598,47 @@ TEST_F(KeyStringBuilderTest, KeyStringValue) {
     ASSERT(data2.compare(dataCopy) == 0);
 }
 
+TEST_F(KeyStringBuilderTest, KeyStringValuePrefixCompressedForSorter) {
+    // Test that a run of Values serialized relative to each other for the Sorter deserializes into
+    // the same Values, including their TypeBits.
+    std::vector<KeyString::Value> values;
+    auto addValue = [&](const BSONObj& obj) {
+        values.push_back(
+            KeyString::HeapBuilder(KeyString::Version::V1, obj, ALL_ASCENDING).release());
+    };
+    addValue(BSON("" << 1 << ""
+                     << "abc"));
+    addValue(BSON("" << 1 << ""
+                     << "abd"));
+    addValue(BSON("" << 1.0 << ""
+                     << "abd"));
+    addValue(BSON("" << 2 << "" << std::string(1000, 'x')));
+    addValue(BSON("" << 2 << "" << std::string(1000, 'x') + "y"));
+    addValue(BSON("" << 3));
+
+    BufBuilder compressed;
+    BufBuilder uncompressed;
+    std::string previous;
+    for (const auto& value : values) {
+        value.serializeForSorter(compressed, &previous);
+        value.serializeForSorter(uncompressed);
+        ASSERT_EQ(StringData(value.getBuffer(), value.getSize()), previous);
+    }
+
+    // Values sharing long prefixes take less space.
+    ASSERT_LT(compressed.len(), uncompressed.len());
+
+    BufReader reader(compressed.buf(), compressed.len());
+    KeyString::Value::SorterDeserializeSettings settings(KeyString::Version::V1);
+    std::string previousDeserialized;
+    for (const auto& value : values) {
+        auto deserialized =
+            KeyString::Value::deserializeForSorter(reader, settings, &previousDeserialized);
+        ASSERT_EQ(0, deserialized.compareWithTypeBits(value));
+    }
+    ASSERT(reader.atEof());
+}
+
 #define COMPARE_KS_BSON(ks, bson, order)                             \
     do {                                                             \
         const BSONObj _converted = toBsonAndCheckKeySize(ks, order); \
@@ -639,6 +680,21 @@ TEST_F(KeyStringBuilderTest, KeyStringGetValueCopyTest) {
     COMPARE_KS_BSON(data2, BSON("" << 1), ALL_ASCENDING);
 }
 
+TEST_F(KeyStringBuilderTest, KeyStringGetPooledValueCopyTest) {
+    // Test that copies made into a pool are adjacent and keep their TypeBits.
+    SharedBufferFragmentBuilder pool(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
+    KeyString::Builder ks(KeyString::Version::V1, BSON("" << 1.0), ALL_ASCENDING);
+    KeyString::Value data1 = ks.getValueCopy(pool);
+    ks.resetToKey(BSON("" << 2), ALL_ASCENDING);
+    KeyString::Value data2 = ks.getValueCopy(pool);
+
+    ASSERT_EQ(data1.getBuffer() + data1.getSize() + data1.getTypeBits().getSize(),
+              data2.getBuffer());
+
+    COMPARE_KS_BSON(data1, BSON("" << 1.0), ALL_ASCENDING);
+    COMPARE_KS_BSON(data2, BSON("" << 2), ALL_ASCENDING);
+}
+
 TEST_F(KeyStringBuilderTest, KeyStringBuilderAppendBsonElement) {
     // Test that appendBsonElement works.
     {
@@ -1888,6 +1944,51 @@ TEST_F(KeyStringBuilderTest, RandomizedInputsForToBsonSafe) {
     }
 }
 
+TEST_F(KeyStringBuilderTest, CompareMatchesMemcmpOrder) {
+    // Buffers share a prefix and differ at a random position, so that every length takes both
+    // the word-at-a-time and the memcmp paths with differences in either word.
+    std::mt19937 gen(newSeed());
+    auto sign = [](int x) { return x < 0 ? -1 : x > 0 ? 1 : 0; };
+    for (int i = 0; i < 10000; i++) {
+        std::string left(gen() % 40, 'k');
+        std::string right = left;
+        if (!right.empty() && gen() % 4) {
+            right[gen() % right.size()] = static_cast<char>(gen());
+        }
+        if (gen() % 4 == 0) {
+            right.resize(gen() % 40, 'k');
+        }
+
+        const size_t min = std::min(left.size(), right.size());
+        int expected = sign(memcmp(left.data(), right.data(), min));
+        if (expected == 0) {
+            expected = sign(static_cast<int>(left.size()) - static_cast<int>(right.size()));
+        }
+        ASSERT_EQ(
+            KeyString::compare(left.data(), right.data(), left.size(), right.size()), expected);
+        ASSERT_EQ(
+            KeyString::compare(right.data(), left.data(), right.size(), left.size()), -expected);
+    }
+}
+
+TEST_F(KeyStringBuilderTest, DescendingStringsAcrossWordBoundaries) {
+    // Inverted strings are flipped back a word at a time; check lengths on either side of a word,
+    // with and without embedded NUL bytes.
+    for (size_t len = 0; len < 20; len++) {
+        std::string str(len, 'a');
+        for (size_t i = 0; i < len; i++) {
+            str[i] += i;
+        }
+        ROUNDTRIP_ORDER(version, BSON("" << str), ONE_DESCENDING);
+        ROUNDTRIP_ORDER(version, BSON("" << BSON(str << 1)), ONE_DESCENDING);
+        if (len > 0) {
+            str[len / 2] = '\0';
+            ROUNDTRIP_ORDER(version, BSON("" << str), ONE_DESCENDING);
+            ROUNDTRIP_ORDER(version, BSON("" << BSONSymbol(str)), ONE_DESCENDING);
+        }
+    }
+}
+
 namespace {
 const uint64_t kMinPerfMicros = 20 * 1000;
 const uint64_t kMinPerfSamples = 50 * 1000;
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/db/exec/collection_scan_common.h"
@@ -182,6 +183,27 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Looks up the Records with the provided ids, which must be sorted in ascending order, and
+     * appends one entry per id to 'out' in the same order: the Record, with owned data, or
+     * boost::none if no Record exists with that id. Looking up a batch of nearby ids in order lets
+     * implementations reuse the cursor position between lookups instead of seeking to each id from
+     * scratch.
+     *
+     * The resulting position of the cursor is unspecified.
+     */
+    virtual void seekExactBatch(const std::vector<RecordId>& ids,
+                                std::vector<boost::optional<Record>>* out) {
+        out->reserve(out->size() + ids.size());
+        for (const auto& id : ids) {
+            auto record = seekExact(id);
+            if (record) {
+                record->data.makeOwned();
+            }
+            out->push_back(std::move(record));
+        }
+    }
+
     /**
      * Positions this cursor near 'start' or an adjacent record if 'start' does not exist. If there
      * is not an exact match, the cursor is positioned on the directionally previous Record. If no
@@ -458,6 +480,19 @@ public:
      */
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) = 0;
 
+    /**
+     * Removes all records with RecordIds in the range ['minRecordId', 'maxRecordId'], neither of
+     * which needs to exist. The caller must hold a write lock on the collection and be in a
+     * WriteUnitOfWork. Engines that cannot cheaply count the records removed adjust the record
+     * store's size information by the caller's estimates 'hintDataSizeIncrement' and
+     * 'hintNumRecordsIncrement' instead.
+     */
+    virtual Status rangeTruncate(OperationContext* opCtx,
+                                 const RecordId& minRecordId,
+                                 const RecordId& maxRecordId,
+                                 int64_t hintDataSizeIncrement,
+                                 int64_t hintNumRecordsIncrement) = 0;
+
     /**
      * does this RecordStore support the compact operation?
      *
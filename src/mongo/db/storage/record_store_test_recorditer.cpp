@@ -479,5 +479,62 @@ TEST(RecordStoreTestHarness, SeekExactForMissingRecordReturnsNone) {
     ASSERT_FALSE(recordStore->findRecord(opCtx.get(), recordIds[1], &outputData));
 }
 
+// seekExactBatch() must return one entry per requested RecordId, in order, with boost::none for
+// the ids that do not exist.
+TEST(RecordStoreTestHarness, SeekExactBatchReturnsRecordsInRequestOrder) {
+    const auto harnessHelper{newRecordStoreHarnessHelper()};
+    auto recordStore = harnessHelper->newRecordStore();
+    ServiceContext::UniqueOperationContext opCtx{harnessHelper->newOperationContext()};
+
+    const int nToInsert = 10;
+    RecordId recordIds[nToInsert];
+    std::string datas[nToInsert];
+    for (int i = 0; i < nToInsert; ++i) {
+        StringBuilder sb;
+        sb << "record " << i;
+        datas[i] = sb.str();
+
+        WriteUnitOfWork uow{opCtx.get()};
+        auto res = recordStore->insertRecord(
+            opCtx.get(), datas[i].c_str(), datas[i].size() + 1, Timestamp{});
+        ASSERT_OK(res.getStatus());
+        recordIds[i] = res.getValue();
+        uow.commit();
+    }
+
+    // Delete a record in the middle and the last record.
+    for (int i : {4, nToInsert - 1}) {
+        WriteUnitOfWork uow{opCtx.get()};
+        recordStore->deleteRecord(opCtx.get(), recordIds[i]);
+        uow.commit();
+    }
+
+    // Request adjacent, distant and deleted records. The last record is also beyond every record
+    // remaining in the record store.
+    const std::vector<int> requested{0, 1, 2, 4, 5, 8, nToInsert - 1};
+    std::vector<RecordId> ids;
+    for (int i : requested) {
+        ids.push_back(recordIds[i]);
+    }
+
+    auto cursor = recordStore->getCursor(opCtx.get());
+    std::vector<boost::optional<Record>> records;
+    cursor->seekExactBatch(ids, &records);
+
+    // Reposition the cursor to make sure the returned data does not depend on its position.
+    ASSERT(cursor->seekExact(recordIds[0]));
+
+    ASSERT_EQ(requested.size(), records.size());
+    for (size_t i = 0; i < requested.size(); ++i) {
+        if (requested[i] == 4 || requested[i] == nToInsert - 1) {
+            ASSERT(!records[i]);
+            continue;
+        }
+        ASSERT(records[i]);
+        ASSERT_EQ(recordIds[requested[i]], records[i]->id);
+        ASSERT_EQ(datas[requested[i]], records[i]->data.data());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -114,5 +114,45 @@ TEST(RecordStoreTestHarness, TruncateNonEmpty) {
     }
 }
 
+// Insert multiple records, and verify that calling rangeTruncate() removes exactly the records in
+// the range, whether or not its bounds exist.
+TEST(RecordStoreTestHarness, RangeTruncate) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newRecordStore());
+
+    std::vector<RecordId> recordIds;
+    const string data = "record";
+    for (int i = 0; i < 10; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        recordIds.push_back(res.getValue());
+        uow.commit();
+    }
+
+    const auto rangeTruncate = [&](const RecordId& min, const RecordId& max, int64_t numRecords) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->rangeTruncate(
+            opCtx.get(), min, max, -numRecords * int64_t(data.size() + 1), -numRecords));
+        uow.commit();
+    };
+    rangeTruncate(recordIds[2], recordIds[6], 5);
+    rangeTruncate(recordIds[8], RecordId::maxLong(), 2);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_EQUALS(3, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(3 * int64_t(data.size() + 1), rs->dataSize(opCtx.get()));
+
+    std::vector<RecordId> remaining;
+    auto cursor = rs->getCursor(opCtx.get());
+    while (auto record = cursor->next()) {
+        remaining.push_back(record->id);
+    }
+    ASSERT(remaining == std::vector<RecordId>({recordIds[0], recordIds[1], recordIds[7]}));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -276,6 +277,24 @@ public:
         virtual boost::optional<IndexKeyEntry> next(RequestedInfo parts = kKeyAndLoc) = 0;
         virtual boost::optional<KeyStringEntry> nextKeyString() = 0;
 
+        /**
+         * Moves forward up to 'maxEntries' times, appending each entry to 'out' as nextKeyString()
+         * would return it. Returns the number of entries appended, which is less than
+         * 'maxEntries' only when the scan is exhausted.
+         *
+         * If 'endKey' is non-null it is an additional end bound, with discriminator information
+         * encoded, that is checked by the cursor itself: the first entry past it in the direction
+         * of the scan is not returned and ends the scan. The cursor's position after ending the
+         * scan on 'endKey' is unspecified until it is next sought.
+         *
+         * Implementations may build the returned KeyStrings out of 'memoryPool' so that the
+         * entries of a batch share a small number of allocations.
+         */
+        virtual size_t nextKeyStringBatch(size_t maxEntries,
+                                          const KeyString::Value* endKey,
+                                          SharedBufferFragmentBuilder& memoryPool,
+                                          std::vector<KeyStringEntry>* out) = 0;
+
         //
         // Seeking
         //
@@ -416,6 +435,20 @@ public:
      * any parent WriteUnitOfWork.
      */
     virtual Status addKey(const KeyString::Value& keyString) = 0;
+
+    /**
+     * Adds a block of 'keyStrings' to intermediate storage, as if by calling addKey() for each of
+     * them in order, and returns the first error encountered. Storage engines may override this
+     * to amortize per-key costs over the block.
+     */
+    virtual Status addKeys(const std::vector<KeyString::Value>& keyStrings) {
+        for (const auto& keyString : keyStrings) {
+            if (auto status = addKey(keyString); !status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
 };
 
 }  // namespace mongo
@@ -347,5 +347,111 @@ TEST(SortedDataInterfaceBoundaryTest, NonUniqueBackwardWithInclusiveBoundaries)
     testBoundaries(/*unique*/ false, /*forward*/ false, /*inclusive*/ true);
 }
 
+void testBatchBoundaries(bool unique, bool forward, bool inclusive) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(unique, /*partial=*/false));
+
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT(sorted->isEmpty(opCtx.get()));
+
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        WriteUnitOfWork uow(opCtx.get());
+        BSONObj key = BSON("" << i);
+        RecordId loc(42 + i * 2);
+        ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key, loc), true));
+        uow.commit();
+    }
+
+    {
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(
+            sorted->newCursor(opCtx.get(), forward));
+        int startVal = 1;
+        int endVal = 8;
+        if (!forward)
+            std::swap(startVal, endVal);
+
+        // The end bound sorts just past the last key in range in the direction of the scan, which
+        // is where a seek key in the opposite direction lands.
+        auto endKey = makeKeyStringForSeek(sorted.get(), BSON("" << endVal), !forward, inclusive);
+        auto entry = cursor->seekForKeyString(
+            makeKeyStringForSeek(sorted.get(), BSON("" << startVal), forward, inclusive));
+
+        SharedBufferFragmentBuilder pool(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
+        std::vector<KeyStringEntry> entries;
+        ASSERT(entry);
+        entries.push_back(std::move(*entry));
+
+        const size_t batchSize = 3;
+        while (cursor->nextKeyStringBatch(batchSize, &endKey, pool, &entries) == batchSize) {
+        }
+
+        // Check that the batches returned exactly the values in range, in order.
+        int step = forward ? 1 : -1;
+        auto it = entries.begin();
+        for (int i = startVal + (inclusive ? 0 : step); i != endVal + (inclusive ? step : 0);
+             i += step) {
+            ASSERT(it != entries.end());
+            ASSERT_EQ(it->keyString,
+                      makeKeyString(sorted.get(), BSON("" << i), RecordId(42 + i * 2)));
+            ASSERT_EQ(it->loc, RecordId(42 + i * 2));
+            ++it;
+        }
+        ASSERT(it == entries.end());
+    }
+}
+
+TEST(SortedDataInterfaceBoundaryTest, UniqueForwardBatchWithNonInclusiveBoundaries) {
+    testBatchBoundaries(/*unique*/ true, /*forward*/ true, /*inclusive*/ false);
+}
+
+TEST(SortedDataInterfaceBoundaryTest, NonUniqueForwardBatchWithInclusiveBoundaries) {
+    testBatchBoundaries(/*unique*/ false, /*forward*/ true, /*inclusive*/ true);
+}
+
+TEST(SortedDataInterfaceBoundaryTest, UniqueBackwardBatchWithInclusiveBoundaries) {
+    testBatchBoundaries(/*unique*/ true, /*forward*/ false, /*inclusive*/ true);
+}
+
+TEST(SortedDataInterfaceBoundaryTest, NonUniqueBackwardBatchWithNonInclusiveBoundaries) {
+    testBatchBoundaries(/*unique*/ false, /*forward*/ false, /*inclusive*/ false);
+}
+
+// Verify that a batch stops at the end of the index when no end bound is given, and that the
+// cursor stays exhausted afterwards.
+TEST(SortedDataInterface, ExhaustCursorInBatches) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(sorted->insert(
+            opCtx.get(), makeKeyString(sorted.get(), BSON("" << i), RecordId(42, i * 2)), true));
+        uow.commit();
+    }
+
+    const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+    auto entry =
+        cursor->seekForKeyString(makeKeyStringForSeek(sorted.get(), BSONObj(), true, true));
+    ASSERT(entry);
+
+    SharedBufferFragmentBuilder pool(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
+    std::vector<KeyStringEntry> entries;
+    ASSERT_EQ(cursor->nextKeyStringBatch(4, nullptr, pool, &entries), 4U);
+    ASSERT_EQ(cursor->nextKeyStringBatch(8, nullptr, pool, &entries), 5U);
+    ASSERT_EQ(entries.size(), 9U);
+    for (int i = 1; i < nToInsert; i++) {
+        ASSERT_EQ(entries[i - 1].loc, RecordId(42, i * 2));
+    }
+
+    // Cursor at EOF should remain at EOF when advanced
+    ASSERT_EQ(cursor->nextKeyStringBatch(4, nullptr, pool, &entries), 0U);
+    ASSERT(!cursor->nextKeyString());
+}
+
 }  // namespace
 }  // namespace mongo
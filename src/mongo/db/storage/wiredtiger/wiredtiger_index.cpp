@@ -771,6 +771,21 @@ public:
         : BulkBuilder(idx, opCtx), _idx(idx) {}
 
     Status addKey(const KeyString::Value& keyString) override {
+        _insert(keyString, ResourceConsumption::MetricsCollector::get(_opCtx));
+        return Status::OK();
+    }
+
+    Status addKeys(const std::vector<KeyString::Value>& keyStrings) override {
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        for (const auto& keyString : keyStrings) {
+            _insert(keyString, metricsCollector);
+        }
+        return Status::OK();
+    }
+
+private:
+    void _insert(const KeyString::Value& keyString,
+                 ResourceConsumption::MetricsCollector& metricsCollector) {
         dassertRecordIdAtEnd(keyString, _idx->rsKeyFormat());
 
         // Can't use WiredTigerCursor since we aren't using the cache.
@@ -786,13 +801,9 @@ public:
 
         invariantWTOK(wiredTigerCursorInsert(_opCtx, _cursor), _cursor->session);
 
-        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
         metricsCollector.incrementOneIdxEntryWritten(item.size);
-
-        return Status::OK();
     }
 
-private:
     WiredTigerIndex* _idx;
 };
 
@@ -960,6 +971,32 @@ public:
         return getKeyStringEntry();
     }
 
+    size_t nextKeyStringBatch(size_t maxEntries,
+                              const KeyString::Value* endKey,
+                              SharedBufferFragmentBuilder& memoryPool,
+                              std::vector<KeyStringEntry>* out) override {
+        size_t appended = 0;
+        while (appended < maxEntries) {
+            if (!advanceNext() || _eof) {
+                break;
+            }
+
+            if (endKey) {
+                // Like _endPosition, 'endKey' carries a discriminator so it never equals a legal
+                // index key, with or without the RecordId appended.
+                const int cmp = _key.compare(*endKey);
+                if (_forward ? cmp > 0 : cmp < 0) {
+                    _eof = true;
+                    break;
+                }
+            }
+
+            out->push_back(getKeyStringEntry(&memoryPool));
+            ++appended;
+        }
+        return appended;
+    }
+
     void setEndPosition(const BSONObj& key, bool inclusive) override {
         LOGV2_TRACE_CURSOR(20098,
                            "setEndPosition inclusive: {inclusive} {key}",
@@ -1302,7 +1339,9 @@ protected:
         return true;
     }
 
-    KeyStringEntry getKeyStringEntry() {
+    // If 'memoryPool' is non-null, the returned KeyString is built in it rather than in an
+    // allocation of its own.
+    KeyStringEntry getKeyStringEntry(SharedBufferFragmentBuilder* memoryPool = nullptr) {
         // Most keys will have a RecordId appended to the end, with the exception of the _id index
         // and timestamp unsafe unique indexes. The contract of this function is to always return a
         // KeyString with a RecordId, so append one if it does not exists already.
@@ -1321,13 +1360,16 @@ protected:
                                "returning {keyWithRecordId} {id}",
                                "keyWithRecordId"_attr = keyWithRecordId,
                                "id"_attr = _id);
-            return KeyStringEntry(keyWithRecordId.getValueCopy(), _id);
+            return KeyStringEntry(memoryPool ? keyWithRecordId.getValueCopy(*memoryPool)
+                                             : keyWithRecordId.getValueCopy(),
+                                  _id);
         }
 
         _key.setTypeBits(_typeBits);
 
         LOGV2_TRACE_CURSOR(20091, "returning {key} {id}", "key"_attr = _key, "id"_attr = _id);
-        return KeyStringEntry(_key.getValueCopy(), _id);
+        return KeyStringEntry(memoryPool ? _key.getValueCopy(*memoryPool) : _key.getValueCopy(),
+                              _id);
     }
 
     OperationContext* _opCtx;
@@ -720,6 +720,15 @@ void WiredTigerKVEngine::cleanShutdown() {
         return;
     }
 
+    // Persist the oplog truncate markers for the shutdown checkpoint, before the oplog record store
+    // is released below.
+    if (!_readOnly) {
+        stdx::lock_guard<Latch> oplogManagerLock(_oplogManagerMutex);
+        if (_oplogRecordStore) {
+            _oplogRecordStore->persistOplogTruncateMarkers();
+        }
+    }
+
     // these must be the last things we do before _conn->close();
     haltOplogManager(/*oplogRecordStore=*/nullptr, /*shuttingDown=*/true);
     if (_sessionSweeper) {
@@ -1938,6 +1947,14 @@ void WiredTigerKVEngine::_checkpoint(WT_SESSION* session) {
     // After the checkpoint, this value will be published such that actors which truncate the oplog
     // can read an updated value.
     try {
+        // Persist the oplog truncate markers so that the checkpoint includes them.
+        {
+            stdx::lock_guard<Latch> oplogManagerLock(_oplogManagerMutex);
+            if (_oplogRecordStore) {
+                _oplogRecordStore->persistOplogTruncateMarkers();
+            }
+        }
+
         // Three cases:
         //
         // First, initialDataTimestamp is Timestamp(0, 1) -> Take full checkpoint. This is when
@@ -2601,22 +2618,22 @@ bool WiredTigerKVEngine::supportsOplogStones() const {
 void WiredTigerKVEngine::startOplogManager(OperationContext* opCtx,
                                            WiredTigerRecordStore* oplogRecordStore) {
     stdx::lock_guard<Latch> lock(_oplogManagerMutex);
-    // Halt visibility thread if running on previous record store
+    // Halt visibility updates if running on previous record store
     if (_oplogRecordStore) {
-        _oplogManager->haltVisibilityThread();
+        _oplogManager->halt();
     }
 
-    _oplogManager->startVisibilityThread(opCtx, oplogRecordStore);
+    _oplogManager->start(opCtx, oplogRecordStore);
     _oplogRecordStore = oplogRecordStore;
 }
 
 void WiredTigerKVEngine::haltOplogManager(WiredTigerRecordStore* oplogRecordStore,
                                           bool shuttingDown) {
     stdx::unique_lock<Latch> lock(_oplogManagerMutex);
-    // Halt the visibility thread if we're in shutdown or the request matches the current record
+    // Halt the visibility updates if we're in shutdown or the request matches the current record
     // store.
     if (shuttingDown || _oplogRecordStore == oplogRecordStore) {
-        _oplogManager->haltVisibilityThread();
+        _oplogManager->halt();
         _oplogRecordStore = nullptr;
     }
 }
@@ -39,20 +39,20 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/mutex.h"
-#include "mongo/util/concurrency/idle_thread_block.h"
-#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
-MONGO_FAIL_POINT_DEFINE(WTPauseOplogVisibilityUpdateLoop);
+MONGO_FAIL_POINT_DEFINE(WTPauseOplogVisibilityUpdates);
 
 // Arbitrary. Using the storageGlobalParams.journalCommitIntervalMs default, which used to
 // dynamically control the visibility thread's delay back when the visibility thread also flushed
-// the journal.
+// the journal. Callers waiting for oplog visibility refresh it at this interval themselves, in case
+// the oplog read timestamp is held back by writes that do not update it when they finish.
 const int kDelayMillis = 100;
 
-void WiredTigerOplogManager::startVisibilityThread(OperationContext* opCtx,
-                                                   WiredTigerRecordStore* oplogRecordStore) {
+void WiredTigerOplogManager::start(OperationContext* opCtx,
+                                   WiredTigerRecordStore* oplogRecordStore) {
     invariant(!_isRunning);
     // Prime the oplog read timestamp.
     std::unique_ptr<SeekableRecordCursor> reverseOplogCursor =
@@ -74,48 +74,66 @@ void WiredTigerOplogManager::startVisibilityThread(OperationContext* opCtx,
         setOplogReadTimestamp(Timestamp(StorageEngine::kMinimumTimestamp));
     }
 
-    // Need to obtain the mutex before starting the thread, as otherwise it may race ahead
-    // see _shuttingDown as true and quit prematurely.
     stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-    _oplogVisibilityThread = stdx::thread(&WiredTigerOplogManager::_updateOplogVisibilityLoop,
-                                          this,
-                                          WiredTigerRecoveryUnit::get(opCtx)->getSessionCache(),
-                                          oplogRecordStore);
-
+    _sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    _oplogRecordStore = oplogRecordStore;
     _isRunning = true;
-    _shuttingDown = false;
 }
 
-void WiredTigerOplogManager::haltVisibilityThread() {
+void WiredTigerOplogManager::halt() {
+    // This is called from two places; on clean shutdown and when the record store for the oplog is
+    // destroyed. The first call stops the updates and the second call is a no-op. Calling this on
+    // clean shutdown is necessary because the oplog manager makes calls into WiredTiger to retrieve
+    // the all durable timestamp. Lock Free Reads introduced shared collections which can offset
+    // when their respective destructors run. This created a scenario where oplog writes could
+    // finish and update the oplog visibility after the storage engine has shutdown.
+    //
+    // The updates query WiredTiger without holding the mutex, so wait for the one in progress, if
+    // any, to finish.
+    stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
+    if (_isRunning) {
+        LOGV2(22372, "Oplog visibility updates shutting down.");
+    }
+    _isRunning = false;
+    _oplogVisibilityUpdateFinishedCV.wait(lk, [&] { return !_oplogVisibilityUpdateInProgress; });
+    _sessionCache = nullptr;
+    _oplogRecordStore = nullptr;
+}
+
+void WiredTigerOplogManager::beginOplogWrite(Timestamp ts) {
+    stdx::lock_guard<Latch> lk(_oplogWritesMutex);
+    invariant(_oplogWrites.emplace(ts, boost::none).second,
+              str::stream() << "Oplog write already in progress at " << ts.toString());
+}
+
+void WiredTigerOplogManager::endOplogWrite(Timestamp ts) {
     {
-        stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-        if (!_isRunning) {
-            // This is called from two places; on clean shutdown and when the record store for the
-            // oplog is destroyed. We will perform the actual shutdown on the first call and the
-            // second call will be a no-op. Calling this on clean shutdown is necessary because the
-            // oplog manager makes calls into WiredTiger to retrieve the all durable timestamp. Lock
-            // Free Reads introduced shared collections which can offset when their respective
-            // destructors run. This created a scenario where the oplog manager visibility loop can
-            // be executed after the storage engine has shutdown.
+        stdx::lock_guard<Latch> lk(_oplogWritesMutex);
+        auto it = _oplogWrites.find(ts);
+        invariant(it != _oplogWrites.end(),
+                  str::stream() << "No oplog write in progress at " << ts.toString());
+
+        const auto now = curTimeMicros64();
+        it->second = now;
+        if (it != _oplogWrites.begin()) {
+            // An earlier oplog write is still in progress: nothing after it can become visible.
             return;
         }
 
-        _shuttingDown = true;
-        _isRunning = false;
+        // This write closed the oldest hole. The writes that finished behind it are done waiting.
+        while (!_oplogWrites.empty() && _oplogWrites.begin()->second) {
+            _visibilityDelayMicrosHistogram.increment(now - *_oplogWrites.begin()->second);
+            _oplogWrites.erase(_oplogWrites.begin());
+        }
     }
 
-    if (_oplogVisibilityThread.joinable()) {
-        _oplogVisibilityThreadCV.notify_one();
-        _oplogVisibilityThread.join();
-    }
+    stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
+    _updateOplogReadTimestamp(lk);
 }
 
 void WiredTigerOplogManager::triggerOplogVisibilityUpdate() {
-    stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-    if (!_triggerOplogVisibilityUpdate) {
-        _triggerOplogVisibilityUpdate = true;
-        _oplogVisibilityThreadCV.notify_one();
-    }
+    stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
+    _updateOplogReadTimestamp(lk);
 }
 
 void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
@@ -144,17 +162,10 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
 
     stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
 
-    // Prevent any scheduled oplog visibility updates from being delayed for batching and blocking
-    // this wait excessively.
-    ++_opsWaitingForOplogVisibilityUpdate;
-    invariant(_opsWaitingForOplogVisibilityUpdate > 0);
-    ScopeGuard exitGuard([&] { --_opsWaitingForOplogVisibilityUpdate; });
-
-    // Out of order writes to the oplog always call triggerOplogVisibilityUpdate() on commit to
-    // prompt the OplogVisibilityThread to run and update the oplog visibility. We simply need to
-    // wait until all of the writes behind and including 'waitingFor' commit so there are no oplog
-    // holes.
-    opCtx->waitForConditionOrInterrupt(_oplogEntriesBecameVisibleCV, lk, [&] {
+    // Out of order writes to the oplog always update the oplog visibility when they close the
+    // oldest oplog hole. We simply need to wait until all of the writes behind and including
+    // 'waitingFor' commit so there are no oplog holes.
+    auto isVisible = [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
         if (newLatestVisibleTimestamp < currentLatestVisibleTimestamp) {
             LOGV2_DEBUG(22370,
@@ -179,67 +190,60 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
                             Timestamp(currentLatestVisibleTimestamp));
         }
         return newLatestVisible >= waitingFor;
-    });
+    };
+    while (!opCtx->waitForConditionOrInterruptUntil(_oplogEntriesBecameVisibleCV,
+                                                    lk,
+                                                    Date_t::now() + Milliseconds(kDelayMillis),
+                                                    isVisible)) {
+        _updateOplogReadTimestamp(lk);
+    }
 }
 
-void WiredTigerOplogManager::_updateOplogVisibilityLoop(WiredTigerSessionCache* sessionCache,
-                                                        WiredTigerRecordStore* oplogRecordStore) {
-    Client::initThread("OplogVisibilityThread");
-
-    // This thread updates the oplog read timestamp, the timestamp used to read from the oplog with
-    // forward cursors. The timestamp is used to hide oplog entries that might be committed but have
-    // uncommitted entries behind them. This prevents cursors from seeing 'holes' in the oplog and
-    // consequently missing data that was not there yet when scanning went passed up to a later
-    // timestamp.
-    while (true) {
-        stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
-        {
-            MONGO_IDLE_THREAD_BLOCK;
-            _oplogVisibilityThreadCV.wait(
-                lk, [&] { return _shuttingDown || _triggerOplogVisibilityUpdate; });
-
-            // If we are not shutting down and nobody is actively waiting for the oplog to become
-            // visible, delay a bit to batch more requests into one update and reduce system load.
-            auto now = Date_t::now();
-            auto deadline = now + Milliseconds(kDelayMillis);
-
-            auto wakeUpEarlyForWaitersPredicate = [&] {
-                return _shuttingDown || _opsWaitingForOplogVisibilityUpdate ||
-                    oplogRecordStore->haveCappedWaiters();
-            };
-
-            // Check once a millisecond, up to the delay deadline, whether the delay should be
-            // preempted because of waiting callers or shutdown.
-            while (now < deadline &&
-                   !_oplogVisibilityThreadCV.wait_until(
-                       lk, now.toSystemTimePoint(), wakeUpEarlyForWaitersPredicate)) {
-                now += Milliseconds(1);
-            }
-        }
+void WiredTigerOplogManager::_updateOplogReadTimestamp(stdx::unique_lock<Latch>& lk) {
+    if (!_isRunning || MONGO_unlikely(WTPauseOplogVisibilityUpdates.shouldFail())) {
+        return;
+    }
 
-        while (!_shuttingDown && MONGO_unlikely(WTPauseOplogVisibilityUpdateLoop.shouldFail())) {
-            lk.unlock();
-            sleepmillis(10);
-            lk.lock();
-        }
+    // The writes that finished before this call are covered by a query of all_durable that starts
+    // after it. An update in flight makes that query once its current one returns, unless it is
+    // already making its last one. This thread makes it then, once that update is done.
+    _oplogVisibilityUpdateFinishedCV.wait(lk, [&] {
+        return !_oplogVisibilityUpdateInProgress || !_oplogVisibilityUpdateInLastRound;
+    });
+    if (!_isRunning) {
+        return;
+    }
 
-        if (_shuttingDown) {
-            LOGV2(22372, "Oplog visibility thread shutting down.");
-            return;
-        }
+    _oplogVisibilityUpdateRequested = true;
+    if (_oplogVisibilityUpdateInProgress) {
+        return;
+    }
 
-        invariant(_triggerOplogVisibilityUpdate);
-        _triggerOplogVisibilityUpdate = false;
+    _oplogVisibilityUpdateInProgress = true;
 
-        lk.unlock();
+    // The session cache and the oplog record store outlive the update: halt() waits for it.
+    auto kvEngine = _sessionCache->getKVEngine();
+    auto oplogRecordStore = _oplogRecordStore;
+    int roundsLeft = 2;
+    while (roundsLeft > 0 && _oplogVisibilityUpdateRequested && _isRunning) {
+        _oplogVisibilityUpdateRequested = false;
+        _oplogVisibilityUpdateInLastRound = --roundsLeft == 0;
+        const auto oplogReadTimestampResets = _oplogReadTimestampResets;
 
-        // Fetch the all_durable timestamp from the storage engine, which is guaranteed not to have
-        // any holes behind it in-memory.
-        const uint64_t newTimestamp = sessionCache->getKVEngine()->getAllDurableTimestamp().asULL();
+        lk.unlock();
+        const uint64_t newTimestamp = kvEngine->getAllDurableTimestamp().asULL();
+        lk.lock();
 
         // The newTimestamp may actually go backward during secondary batch application,
         // where we commit data file changes separately from oplog changes, so ignore
-        // a non-incrementing timestamp.
+        // a non-incrementing timestamp. A timestamp queried before the oplog read timestamp was
+        // reset, as by a rollback, is ignored too, and queried again in an extra round as resets
+        // are rare.
+        if (oplogReadTimestampResets != _oplogReadTimestampResets) {
+            _oplogVisibilityUpdateRequested = true;
+            ++roundsLeft;
+            continue;
+        }
         if (newTimestamp <= _oplogReadTimestamp.load()) {
             LOGV2_DEBUG(22373,
                         2,
@@ -248,21 +252,21 @@ void WiredTigerOplogManager::_updateOplogVisibilityLoop(WiredTigerSessionCache*
             continue;
         }
 
-        lk.lock();
-        // Publish the new timestamp value. Avoid going backward.
-        auto currentVisibleTimestamp = getOplogReadTimestamp();
-        if (newTimestamp > currentVisibleTimestamp) {
-            _setOplogReadTimestamp(lk, newTimestamp);
-        }
-        lk.unlock();
+        _setOplogReadTimestamp(lk, newTimestamp);
 
         // Wake up any awaitData cursors and tell them more data might be visible now.
         //
         // We normally notify waiters on capped collection inserts/updates, but oplog entries will
         // not become visible immediately upon insert, so we notify waiters here as well, when new
         // oplog entries actually become visible to cursors.
+        lk.unlock();
         oplogRecordStore->notifyCappedWaitersIfNeeded();
+        lk.lock();
     }
+
+    _oplogVisibilityUpdateInProgress = false;
+    _oplogVisibilityUpdateInLastRound = false;
+    _oplogVisibilityUpdateFinishedCV.notify_all();
 }
 
 std::uint64_t WiredTigerOplogManager::getOplogReadTimestamp() const {
@@ -271,9 +275,14 @@ std::uint64_t WiredTigerOplogManager::getOplogReadTimestamp() const {
 
 void WiredTigerOplogManager::setOplogReadTimestamp(Timestamp ts) {
     stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+    ++_oplogReadTimestampResets;
     _setOplogReadTimestamp(lk, ts.asULL());
 }
 
+void WiredTigerOplogManager::appendVisibilityStats(BSONObjBuilder& builder) const {
+    appendHistogram(builder, _visibilityDelayMicrosHistogram, "visibilityDelayMicros");
+}
+
 void WiredTigerOplogManager::_setOplogReadTimestamp(WithLock, uint64_t newTimestamp) {
     _oplogReadTimestamp.store(newTimestamp);
     _oplogEntriesBecameVisibleCV.notify_all();
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <map>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
-#include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/histogram.h"
 
 namespace mongo {
 
@@ -43,8 +46,17 @@ class WiredTigerSessionCache;
 /**
  * Manages oplog visibility.
  *
- * On demand, queries WiredTiger's all_durable timestamp value and updates the oplog read timestamp.
- * This is done asynchronously on a thread that startVisibilityThread() will set up.
+ * Writers whose commits can be out of order with respect to their oplog timestamps publish the
+ * timestamp of their first oplog entry with beginOplogWrite() and report that their transaction
+ * committed or aborted with endOplogWrite(). The writer finishing the earliest outstanding oplog
+ * write closes the oldest oplog 'hole': it queries WiredTiger's all_durable timestamp value and
+ * updates the oplog read timestamp itself, so that entries become visible as soon as the holes
+ * behind them are closed.
+ *
+ * A single writer at a time queries all_durable and publishes it. Writers that finish while an
+ * update is in flight leave it a request and return: the updater queries all_durable again once
+ * its current query returns, which covers their writes. Neither the WiredTiger query nor the
+ * wakeup of the awaitData cursors is done while holding the mutex that waiters for visibility use.
  *
  * The WT all_durable timestamp is the in-memory timestamp behind which there are no oplog holes
  * in-memory. Note, all_durable is the timestamp that has no holes in-memory, which may NOT be
@@ -64,18 +76,30 @@ public:
     ~WiredTigerOplogManager() {}
 
     /*
-     * Initializes the oplog read timestamp and start the update visibility thread.
+     * Initializes the oplog read timestamp and starts updating it as oplog writes finish.
      */
-    void startVisibilityThread(OperationContext* opCtx, WiredTigerRecordStore* oplogRecordStore);
-    void haltVisibilityThread();
+    void start(OperationContext* opCtx, WiredTigerRecordStore* oplogRecordStore);
+    void halt();
 
     bool isRunning() {
         stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-        return _isRunning && !_shuttingDown;
+        return _isRunning;
     }
 
     /**
-     * Signals the oplog visibility thread to update the oplog read timestamp.
+     * Publishes the timestamp of the first oplog entry written by a transaction that may commit out
+     * of order. Entries at or after 'ts' are not made visible until endOplogWrite() is called.
+     */
+    void beginOplogWrite(Timestamp ts);
+
+    /**
+     * Records that the transaction that called beginOplogWrite() with 'ts' committed or aborted. If
+     * it was the earliest outstanding oplog write, updates the oplog read timestamp.
+     */
+    void endOplogWrite(Timestamp ts);
+
+    /**
+     * Updates the oplog read timestamp, for writes that did not publish their oplog timestamp.
      */
     void triggerOplogVisibilityUpdate();
 
@@ -98,23 +122,28 @@ public:
     std::uint64_t getOplogReadTimestamp() const;
     void setOplogReadTimestamp(Timestamp ts);
 
+    /**
+     * Appends the distribution of the time between an oplog write committing and it becoming
+     * visible.
+     */
+    void appendVisibilityStats(BSONObjBuilder& builder) const;
+
 private:
     /**
-     * Runs the oplog visibility updates when signaled by triggerOplogVisibilityUpdate() until
-     * _shuttingDown is set to true.
+     * Advances the oplog read timestamp to WiredTiger's all_durable timestamp, which is guaranteed
+     * not to have any holes behind it in-memory, and wakes up the cursors waiting for new entries.
+     * If another thread is already doing so and has yet to start its last query, leaves it a
+     * request to query all_durable again and returns without waiting. Otherwise waits for it to
+     * finish and takes over. Each thread queries all_durable at most twice, once for itself and
+     * once for the requests left meanwhile, so its latency does not depend on the rate of writes.
+     * 'lk' is released while querying WiredTiger and waking up cursors.
      */
-    void _updateOplogVisibilityLoop(WiredTigerSessionCache* sessionCache,
-                                    WiredTigerRecordStore* oplogRecordStore);
+    void _updateOplogReadTimestamp(stdx::unique_lock<Latch>& lk);
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
     AtomicWord<unsigned long long> _oplogReadTimestamp{0};
 
-    stdx::thread _oplogVisibilityThread;
-
-    // Signaled to trigger the oplog visibility thread to run.
-    mutable stdx::condition_variable _oplogVisibilityThreadCV;
-
     // Signaled when oplog visibility has been updated.
     mutable stdx::condition_variable _oplogEntriesBecameVisibleCV;
 
@@ -123,14 +152,37 @@ private:
         MONGO_MAKE_LATCH("WiredTigerOplogManager::_oplogVisibilityStateMutex");
 
     bool _isRunning = false;
-    bool _shuttingDown = false;
 
-    // Triggers an oplog visibility update -- can be delayed if no callers are waiting for an
-    // update, per the _opsWaitingForOplogVisibility counter.
-    bool _triggerOplogVisibilityUpdate = false;
+    // Set while a thread is updating the oplog read timestamp, and signaled through
+    // '_oplogVisibilityUpdateFinishedCV' when it is done.
+    bool _oplogVisibilityUpdateInProgress = false;
+    stdx::condition_variable _oplogVisibilityUpdateFinishedCV;
+
+    // Set when all_durable has to be queried again by the update in progress, because writes
+    // finished after it last queried it.
+    bool _oplogVisibilityUpdateRequested = false;
+
+    // Set while the update in progress makes its last query of all_durable, after which it does
+    // not take requests anymore.
+    bool _oplogVisibilityUpdateInLastRound = false;
+
+    // Incremented by setOplogReadTimestamp(), so that the update in progress does not publish an
+    // all_durable timestamp it queried before the oplog read timestamp was reset.
+    uint64_t _oplogReadTimestampResets = 0;
+
+    WiredTigerSessionCache* _sessionCache = nullptr;     // not owned
+    WiredTigerRecordStore* _oplogRecordStore = nullptr;  // not owned
+
+    // Protects '_oplogWrites'. Only held to update the map, never while calling into WiredTiger.
+    Mutex _oplogWritesMutex = MONGO_MAKE_LATCH("WiredTigerOplogManager::_oplogWritesMutex");
+
+    // The outstanding oplog writes, by the timestamp of their first oplog entry, and the time at
+    // which they finished, if they did. The first entry is the oldest oplog hole: the finished
+    // writes after it are not visible yet.
+    std::map<Timestamp, boost::optional<std::uint64_t>> _oplogWrites;
 
-    // Incremented when a caller is waiting for more of the oplog to become visible, to avoid update
-    // delays for batching.
-    int64_t _opsWaitingForOplogVisibilityUpdate = 0;
+    // Microseconds between an oplog write finishing and the oplog hole before it being closed.
+    Histogram<int64_t> _visibilityDelayMicrosHistogram{
+        {100, 500, 1000, 5000, 10000, 50000, 100000}};
 };
 }  // namespace mongo
@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_test_harness.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 64;
+
+/**
+ * An oplog record store written to by many threads at once. Every write closes an oplog hole when
+ * it commits, so every commit updates the oplog visibility.
+ */
+class OplogVisibilityBenchmarkFixture : public benchmark::Fixture {
+public:
+    void setUpOplog(int numThreads) {
+        _harnessHelper = std::make_unique<WiredTigerHarnessHelper>();
+        _oplog = _harnessHelper->newOplogRecordStore();
+        _lastInc = 0;
+        for (int i = 0; i < numThreads; ++i) {
+            auto client = _harnessHelper->serviceContext()->makeClient(str::stream()
+                                                                       << "oplog writer " << i);
+            auto opCtx = _harnessHelper->newOperationContext(client.get());
+            _clients.emplace_back(std::move(client), std::move(opCtx));
+        }
+    }
+
+    void tearDownOplog() {
+        _clients.clear();
+        _oplog.reset();
+        _harnessHelper.reset();
+    }
+
+    OperationContext* opCtx(int threadIndex) {
+        return _clients[threadIndex].second.get();
+    }
+
+    // Writes one oplog entry in its own transaction.
+    void writeOplogEntry(OperationContext* opCtx) {
+        WriteUnitOfWork wuow(opCtx);
+        Timestamp ts;
+        {
+            // Oplog timestamps are reserved and published in order, as on a primary.
+            stdx::lock_guard<Latch> lk(_reservationMutex);
+            ts = Timestamp(1, ++_lastInc);
+            invariant(_oplog->oplogDiskLocRegister(opCtx, ts, false));
+        }
+        BSONObj obj = BSON("ts" << ts);
+        invariant(_oplog->insertRecord(opCtx, obj.objdata(), obj.objsize(), ts).getStatus());
+        wuow.commit();
+    }
+
+private:
+    std::unique_ptr<WiredTigerHarnessHelper> _harnessHelper;
+    std::unique_ptr<RecordStore> _oplog;
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        _clients;
+
+    Mutex _reservationMutex =
+        MONGO_MAKE_LATCH("OplogVisibilityBenchmarkFixture::_reservationMutex");
+    unsigned _lastInc = 0;
+};
+
+// Commits oplog writes from many threads at once, each of which updates the oplog visibility.
+BENCHMARK_DEFINE_F(OplogVisibilityBenchmarkFixture, BM_ConcurrentOplogWrites)
+(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        setUpOplog(state.threads);
+    }
+
+    for (auto _ : state) {
+        writeOplogEntry(opCtx(state.thread_index));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        tearDownOplog();
+    }
+}
+
+BENCHMARK_REGISTER_F(OplogVisibilityBenchmarkFixture, BM_ConcurrentOplogWrites)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
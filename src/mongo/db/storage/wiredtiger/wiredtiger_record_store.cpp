@@ -64,6 +64,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
@@ -124,6 +125,21 @@ void appendNumericStats(WT_SESSION* s, const std::string& uri, BSONObjBuilder& b
     }
 }
 
+// Returns the number of oplog stones to keep for an oplog of size 'maxSize' when at most
+// 'maxStonesToKeep' are allowed.
+size_t computeNumStonesToKeep(long long maxSize, long long maxStonesToKeep) {
+    // The minimum oplog stone size should be BSONObjMaxInternalSize.
+    const unsigned int oplogStoneSize =
+        std::max(gOplogStoneSizeMB * 1024 * 1024, BSONObjMaxInternalSize);
+
+    // IDL does not support unsigned long long types.
+    const unsigned long long kMinStonesToKeep = static_cast<unsigned long long>(gMinOplogStones);
+    const unsigned long long kMaxStonesToKeep = static_cast<unsigned long long>(maxStonesToKeep);
+
+    unsigned long long numStones = maxSize / oplogStoneSize;
+    return std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+}
+
 std::size_t computeRecordIdSize(const RecordId& id) {
     // We previously weren't accounting for WiredTiger key size when it was an int64_t, thus we
     // return 0 in those cases. With the clustering capabilities we now support potentially large
@@ -204,21 +220,20 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     invariant(rs->keyFormat() == KeyFormat::Long);
     long long maxSize = *rs->_oplogMaxSize;
 
-    // The minimum oplog stone size should be BSONObjMaxInternalSize.
-    const unsigned int oplogStoneSize =
-        std::max(gOplogStoneSizeMB * 1024 * 1024, BSONObjMaxInternalSize);
-
-    // IDL does not support unsigned long long types.
-    const unsigned long long kMinStonesToKeep = static_cast<unsigned long long>(gMinOplogStones);
-    const unsigned long long kMaxStonesToKeep =
-        static_cast<unsigned long long>(gMaxOplogStonesDuringStartup);
-
-    unsigned long long numStones = maxSize / oplogStoneSize;
-    size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
-    _minBytesPerStone = maxSize / numStonesToKeep;
+    // Stones are sized for the number of stones allowed after startup, unless the oplog has to be
+    // sampled: the number of samples grows with the number of stones, so startup limits it further.
+    _minBytesPerStone = maxSize / computeNumStonesToKeep(maxSize, gMaxOplogStonesAfterStartup);
     invariant(_minBytesPerStone > 0);
 
-    _calculateStones(opCtx, numStonesToKeep);
+    if (!_loadStones(opCtx)) {
+        size_t numStonesToKeep = computeNumStonesToKeep(maxSize, gMaxOplogStonesDuringStartup);
+        const auto minBytesPerStoneAfterStartup = _minBytesPerStone;
+        _minBytesPerStone = maxSize / numStonesToKeep;
+        invariant(_minBytesPerStone > 0);
+
+        _calculateStones(opCtx, numStonesToKeep);
+        _minBytesPerStone = minBytesPerStoneAfterStartup;
+    }
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -470,8 +485,126 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
     _calculateStonesBySampling(opCtx, int64_t(estRecordsPerStone), int64_t(estBytesPerStone));
 }
 
+void WiredTigerRecordStore::OplogStones::_addScannedRecord(const Record& record) {
+    _currentRecords.addAndFetch(1);
+    int64_t newCurrentBytes = _currentBytes.addAndFetch(record.data.size());
+    if (newCurrentBytes >= _minBytesPerStone) {
+        BSONObj obj = record.data.toBson();
+        auto wallTime = obj.hasField("wall") ? obj["wall"].Date() : obj["ts"].timestampTime();
+
+        LOGV2_DEBUG(22385,
+                    1,
+                    "Marking oplog entry as a potential future oplog truncation point",
+                    "wall"_attr = wallTime);
+
+        _stones.emplace_back(_currentRecords.swap(0), _currentBytes.swap(0), record.id, wallTime);
+    }
+}
+
+bool WiredTigerRecordStore::OplogStones::_loadStones(OperationContext* opCtx) {
+    if (!gPersistOplogTruncationPoints || !_rs->_sizeStorer) {
+        return false;
+    }
+
+    const std::uint64_t startTime = curTimeMicros64();
+    const BSONObj persisted = _rs->_sizeStorer->loadOplogTruncateMarkers(opCtx, _rs->getURI());
+    if (persisted.isEmpty()) {
+        return false;
+    }
+
+    RecordId firstRecord;
+    RecordId lastRecord;
+    {
+        auto forwardCursor = _rs->getCursor(opCtx, /*forward=*/true);
+        auto reverseCursor = _rs->getCursor(opCtx, /*forward=*/false);
+        auto first = forwardCursor->next();
+        auto last = reverseCursor->next();
+        if (!first || !last) {
+            return false;
+        }
+        firstRecord = first->id;
+        lastRecord = last->id;
+    }
+
+    // Skip the stones truncated since they were persisted, and those past the end of the oplog,
+    // which replication recovery may have truncated. The records after the last stone left are
+    // scanned below.
+    std::deque<Stone> stones;
+    try {
+        for (auto&& elem : persisted["markers"].Obj()) {
+            const auto marker = elem.Obj();
+            Stone stone(marker["records"].safeNumberLong(),
+                        marker["bytes"].safeNumberLong(),
+                        RecordId(marker["lastRecord"].safeNumberLong()),
+                        marker["wallTime"].Date());
+            if (stone.lastRecord < firstRecord) {
+                continue;
+            }
+            if (stone.lastRecord > lastRecord) {
+                break;
+            }
+            uassert(7804900,
+                    "Persisted oplog truncate markers are out of order",
+                    stones.empty() || stones.back().lastRecord < stone.lastRecord);
+            stones.push_back(std::move(stone));
+        }
+    } catch (const DBException& ex) {
+        LOGV2_WARNING(7804901,
+                      "Failed to load the persisted oplog truncate markers",
+                      "error"_attr = ex.toStatus());
+        return false;
+    }
+    if (stones.empty()) {
+        return false;
+    }
+
+    _processingMethod.store(ProcessingMethod::kLoading);
+    _stones = std::move(stones);
+    _numStonesLoaded.store(_stones.size());
+
+    long long numRecordsScanned = 0;
+    auto cursor = _rs->getCursor(opCtx, /*forward=*/true);
+    invariant(cursor->seekNear(_stones.back().lastRecord));
+    while (auto record = cursor->next()) {
+        _addScannedRecord(*record);
+        ++numRecordsScanned;
+    }
+    _numRecordsScannedAfterLoading.store(numRecordsScanned);
+
+    auto duration = curTimeMicros64() - startTime;
+    _totalTimeProcessing.fetchAndAdd(duration);
+    LOGV2(7804902,
+          "Loaded the persisted oplog truncate markers",
+          "numMarkers"_attr = _numStonesLoaded.load(),
+          "numRecordsScanned"_attr = numRecordsScanned,
+          "duration"_attr = Microseconds(static_cast<int64_t>(duration)));
+    return true;
+}
+
+void WiredTigerRecordStore::OplogStones::persist(WiredTigerSizeStorer* sizeStorer) {
+    if (!gPersistOplogTruncationPoints) {
+        return;
+    }
+
+    Timer timer;
+    BSONObjBuilder builder;
+    {
+        BSONArrayBuilder markers(builder.subarrayStart("markers"));
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto&& stone : _stones) {
+            markers.append(BSON("records" << stone.records << "bytes" << stone.bytes
+                                          << "lastRecord" << stone.lastRecord.getLong()
+                                          << "wallTime" << stone.wallTime));
+        }
+    }
+    sizeStorer->storeOplogTruncateMarkers(_rs->getURI(), builder.obj());
+
+    _totalTimePersisting.fetchAndAdd(timer.micros());
+    _persistCount.fetchAndAdd(1);
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* opCtx) {
-    _processBySampling.store(false);  // process by scanning
+    _processingMethod.store(ProcessingMethod::kScanning);
     LOGV2(22384, "Scanning the oplog to determine where to place markers for truncation");
 
     long long numRecords = 0;
@@ -479,20 +612,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
 
     auto cursor = _rs->getCursor(opCtx, true);
     while (auto record = cursor->next()) {
-        _currentRecords.addAndFetch(1);
-        int64_t newCurrentBytes = _currentBytes.addAndFetch(record->data.size());
-        if (newCurrentBytes >= _minBytesPerStone) {
-            BSONObj obj = record->data.toBson();
-            auto wallTime = obj.hasField("wall") ? obj["wall"].Date() : obj["ts"].timestampTime();
-
-            LOGV2_DEBUG(22385,
-                        1,
-                        "Marking oplog entry as a potential future oplog truncation point",
-                        "wall"_attr = wallTime);
-
-            _stones.emplace_back(
-                _currentRecords.swap(0), _currentBytes.swap(0), record->id, wallTime);
-        }
+        _addScannedRecord(*record);
 
         numRecords++;
         dataSize += record->data.size();
@@ -505,7 +625,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
                                                                     int64_t estRecordsPerStone,
                                                                     int64_t estBytesPerStone) {
     LOGV2(22386, "Sampling the oplog to determine where to place markers for truncation");
-    _processBySampling.store(true);  // process by sampling
+    _processingMethod.store(ProcessingMethod::kSampling);
     Timestamp earliestOpTime;
     Timestamp latestOpTime;
 
@@ -630,17 +750,7 @@ void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<Latch> reclaimLk(_oplogReclaimMutex);
     stdx::lock_guard<Latch> lk(_mutex);
 
-    const unsigned int oplogStoneSize =
-        std::max(gOplogStoneSizeMB * 1024 * 1024, BSONObjMaxInternalSize);
-
-    // IDL does not support unsigned long long types.
-    const unsigned long long kMinStonesToKeep = static_cast<unsigned long long>(gMinOplogStones);
-    const unsigned long long kMaxStonesToKeep =
-        static_cast<unsigned long long>(gMaxOplogStonesAfterStartup);
-
-    unsigned long long numStones = maxSize / oplogStoneSize;
-    size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
-    _minBytesPerStone = maxSize / numStonesToKeep;
+    _minBytesPerStone = maxSize / computeNumStonesToKeep(maxSize, gMaxOplogStonesAfterStartup);
     invariant(_minBytesPerStone > 0);
     _pokeReclaimThreadIfNeeded();
 }
@@ -801,7 +911,9 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
             // TODO (SERVER-60753): Remove special handling for index build during recovery. This
             // includes the following _mdb_catalog ident.
             ns == NamespaceString::kIndexBuildEntryNamespace.ns() ||
-            ident.startsWith("_mdb_catalog")) {
+            ident.startsWith("_mdb_catalog") ||
+            // Expired pre-images are truncated without a timestamp.
+            NamespaceString(ns).isChangeStreamPreImagesCollection()) {
             ss << "write_timestamp_usage=mixed_mode,";
         } else {
             ss << "write_timestamp_usage=ordered,";
@@ -1033,6 +1145,12 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
     }
 }
 
+void WiredTigerRecordStore::persistOplogTruncateMarkers() const {
+    if (_oplogStones && _sizeStorer) {
+        _oplogStones->persist(_sizeStorer);
+    }
+}
+
 void WiredTigerRecordStore::getOplogTruncateStats(BSONObjBuilder& builder) const {
     if (_oplogStones) {
         _oplogStones->getOplogStonesStats(builder);
@@ -1755,6 +1873,41 @@ Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
+Status WiredTigerRecordStore::rangeTruncate(OperationContext* opCtx,
+                                            const RecordId& minRecordId,
+                                            const RecordId& maxRecordId,
+                                            int64_t hintDataSizeIncrement,
+                                            int64_t hintNumRecordsIncrement) {
+    invariant(minRecordId <= maxRecordId);
+
+    // WiredTiger does not require the bounding keys of a truncate range to exist, so the cursors
+    // only need their keys set.
+    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* start = startWrap.get();
+    CursorKey startKey = makeCursorKey(minRecordId, _keyFormat);
+    setKey(start, &startKey);
+
+    WiredTigerCursor stopWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* stop = stopWrap.get();
+    CursorKey stopKey = makeCursorKey(maxRecordId, _keyFormat);
+    setKey(stop, &stopKey);
+
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    int ret = WT_OP_CHECK(session->truncate(session, nullptr, start, stop, nullptr));
+    if (ret == WT_NOTFOUND) {
+        // The range is empty.
+        return Status::OK();
+    }
+    auto status = wtRCToStatus(ret, session, "WiredTigerRecordStore::rangeTruncate");
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _changeNumRecords(opCtx, hintNumRecordsIncrement);
+    _increaseDataSize(opCtx, hintDataSizeIncrement);
+    return Status::OK();
+}
+
 Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isWriteLocked());
 
@@ -2138,7 +2291,13 @@ Status WiredTigerRecordStore::oplogDiskLocRegisterImpl(OperationContext* opCtx,
         // This labels the current transaction with a timestamp.
         // This is required for oplog visibility to work correctly, as WiredTiger uses the
         // transaction list to determine where there are holes in the oplog.
-        return opCtx->recoveryUnit()->setTimestamp(ts);
+        Status status = opCtx->recoveryUnit()->setTimestamp(ts);
+        if (status.isOK()) {
+            // Publish the hole, so that the oplog read timestamp is forwarded as soon as this
+            // transaction and all earlier ones have committed or aborted.
+            WiredTigerRecoveryUnit::get(opCtx)->beginOplogWrite(ts);
+        }
+        return status;
     }
 
     // This handles non-primary (secondary) state behavior; we simply set the oplog visiblity read
@@ -2293,6 +2452,79 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::seekExactBatch(const std::vector<RecordId>& ids,
+                                                     std::vector<boost::optional<Record>>* out) {
+    if (!_forward || _rs._isOplog) {
+        // Oplog cursors apply visibility rules to every lookup, see seekExact().
+        SeekableRecordCursor::seekExactBatch(ids, out);
+        return;
+    }
+
+    invariant(_hasRestored);
+    dassert(std::is_sorted(ids.begin(), ids.end()));
+
+    // Ensure an active transaction is open. While WiredTiger supports using cursors on a session
+    // without an active transaction (i.e. an implicit transaction), that would bypass configuration
+    // options we pass when we explicitly start transactions in the RecoveryUnit.
+    WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+    out->reserve(out->size() + ids.size());
+
+    // The id of the record the WT_CURSOR is positioned on, if any.
+    boost::optional<RecordId> positionedId;
+    for (const auto& id : ids) {
+        bool found = false;
+        if (positionedId && id > *positionedId) {
+            // The wanted record is likely close to the current position, in particular when the
+            // ids are dense. Stepping to the next record is cheaper than a search, and tells
+            // whether 'id' exists when it is not beyond that next record.
+            int advanceRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->next(c); });
+            if (advanceRet == WT_NOTFOUND) {
+                // There are no records after the previous one.
+                positionedId = boost::none;
+                out->emplace_back();
+                continue;
+            }
+            invariantWTOK(advanceRet, c->session);
+
+            positionedId = getKey(c);
+            if (*positionedId > id) {
+                out->emplace_back();
+                continue;
+            }
+            found = *positionedId == id;
+        }
+
+        if (!found) {
+            auto key = makeCursorKey(id, _rs.keyFormat());
+            setKey(c, &key);
+            // Nothing after the next line can throw WCEs.
+            int seekRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+            if (seekRet == WT_NOTFOUND) {
+                positionedId = boost::none;
+                out->emplace_back();
+                continue;
+            }
+            invariantWTOK(seekRet, c->session);
+            metricsCollector.incrementOneCursorSeek();
+            positionedId = id;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(c->get_value(c, &value), c->session);
+        metricsCollector.incrementOneDocRead(value.size + computeRecordIdSize(id));
+
+        RecordData data(static_cast<const char*>(value.data), static_cast<int>(value.size));
+        out->push_back(Record{id, data.getOwned()});
+    }
+
+    _lastReturnedId = positionedId.value_or(RecordId());
+    _eof = !positionedId;
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekNear(const RecordId& id) {
     dassert(_opCtx->lockState()->isReadLocked());
 
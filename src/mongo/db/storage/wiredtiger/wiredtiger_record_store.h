@@ -121,6 +121,11 @@ public:
 
     virtual void getOplogTruncateStats(BSONObjBuilder& builder) const;
 
+    /**
+     * Persists the oplog stones, if this is the oplog, so that they can be loaded on startup.
+     */
+    void persistOplogTruncateMarkers() const;
+
     virtual ~WiredTigerRecordStore();
 
     virtual void postConstructorInit(OperationContext* opCtx);
@@ -201,6 +206,12 @@ public:
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
 
+    virtual Status rangeTruncate(OperationContext* opCtx,
+                                 const RecordId& minRecordId,
+                                 const RecordId& maxRecordId,
+                                 int64_t hintDataSizeIncrement,
+                                 int64_t hintNumRecordsIncrement);
+
     virtual void updateStatsAfterRepair(OperationContext* opCtx,
                                         long long numRecords,
                                         long long dataSize);
@@ -395,6 +406,9 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    void seekExactBatch(const std::vector<RecordId>& ids,
+                        std::vector<boost::optional<Record>>* out) override;
+
     boost::optional<Record> seekNear(const RecordId& start);
 
     void save();
@@ -474,5 +488,5 @@ extern FailPoint WTWriteConflictExceptionForReads;
 // Prevents oplog writes from becoming visible asynchronously. Once activated, new writes will not
 // be seen by regular readers until deactivated. It is unspecified whether writes that commit before
 // activation will become visible while active.
-extern FailPoint WTPauseOplogVisibilityUpdateLoop;
+extern FailPoint WTPauseOplogVisibilityUpdates;
 }  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_test_harness.h"
+
+namespace mongo {
+namespace {
+
+const int kNumRecords = 100 * 1000;
+
+/**
+ * A WiredTiger record store holding 'kNumRecords' small records, and a random selection of their
+ * RecordIds like a FETCH stage would receive from an index scan.
+ */
+class SeekBenchmarkFixture {
+public:
+    SeekBenchmarkFixture(size_t nIds) : _recordStore(_harnessHelper.newRecordStore()) {
+        auto opCtx = _harnessHelper.newOperationContext();
+
+        std::vector<RecordId> allIds;
+        const std::string data(64, 'x');
+        const int kRecordsPerWUOW = 1000;
+        for (int i = 0; i < kNumRecords; i += kRecordsPerWUOW) {
+            WriteUnitOfWork wuow(opCtx.get());
+            for (int j = 0; j < kRecordsPerWUOW; ++j) {
+                auto res = _recordStore->insertRecord(
+                    opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+                invariant(res.getStatus());
+                allIds.push_back(res.getValue());
+            }
+            wuow.commit();
+        }
+
+        std::mt19937 gen(1);
+        std::shuffle(allIds.begin(), allIds.end(), gen);
+        ids.assign(allIds.begin(), allIds.begin() + nIds);
+    }
+
+    ServiceContext::UniqueOperationContext newOperationContext() {
+        return _harnessHelper.newOperationContext();
+    }
+
+    RecordStore* recordStore() {
+        return _recordStore.get();
+    }
+
+    // RecordIds in index order, which is unrelated to RecordId order.
+    std::vector<RecordId> ids;
+
+private:
+    WiredTigerHarnessHelper _harnessHelper;
+    std::unique_ptr<RecordStore> _recordStore;
+};
+
+// Looks up each RecordId with its own seekExact() call, in the order the ids were produced.
+void BM_SeekExact(benchmark::State& state) {
+    SeekBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.newOperationContext();
+    auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+
+    for (auto _ : state) {
+        for (const auto& id : fixture.ids) {
+            auto record = cursor->seekExact(id);
+            invariant(record);
+            // Documents have to be owned to outlive the cursor position, as in a batch.
+            benchmark::DoNotOptimize(record->data.getOwned());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * fixture.ids.size());
+}
+
+// Sorts the RecordIds and looks them up with a single seekExactBatch() call.
+void BM_SeekExactBatch(benchmark::State& state) {
+    SeekBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.newOperationContext();
+    auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+
+    std::vector<boost::optional<Record>> records;
+    for (auto _ : state) {
+        std::vector<RecordId> sortedIds(fixture.ids);
+        std::sort(sortedIds.begin(), sortedIds.end());
+        records.clear();
+        cursor->seekExactBatch(sortedIds, &records);
+        benchmark::DoNotOptimize(records.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fixture.ids.size());
+}
+
+BENCHMARK(BM_SeekExact)->Arg(16)->Arg(128)->Arg(1024)->Arg(16 * 1024);
+BENCHMARK(BM_SeekExactBatch)->Arg(16)->Arg(128)->Arg(1024)->Arg(16 * 1024);
+
+}  // namespace
+}  // namespace mongo
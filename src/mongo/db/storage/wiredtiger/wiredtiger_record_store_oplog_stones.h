@@ -67,7 +67,22 @@ public:
 
     void getOplogStonesStats(BSONObjBuilder& builder) const {
         builder.append("totalTimeProcessingMicros", _totalTimeProcessing.load());
-        builder.append("processingMethod", _processBySampling.load() ? "sampling" : "scanning");
+        switch (_processingMethod.load()) {
+            case ProcessingMethod::kScanning:
+                builder.append("processingMethod", "scanning");
+                break;
+            case ProcessingMethod::kSampling:
+                builder.append("processingMethod", "sampling");
+                break;
+            case ProcessingMethod::kLoading:
+                builder.append("processingMethod", "loading");
+                builder.append("numTruncationPointsLoaded", _numStonesLoaded.load());
+                builder.append("numRecordsScannedAfterLoading",
+                               _numRecordsScannedAfterLoading.load());
+                break;
+        }
+        builder.append("totalTimePersistingMicros", _totalTimePersisting.load());
+        builder.append("persistCount", _persistCount.load());
         if (auto oplogMinRetentionHours = storageGlobalParams.oplogMinRetentionHours.load()) {
             builder.append("oplogMinRetentionHours", oplogMinRetentionHours);
         }
@@ -94,6 +109,12 @@ public:
     // Resize oplog size
     void adjust(int64_t maxSize);
 
+    /**
+     * Writes the stones with the oplog's size information, to be loaded by the next startup rather
+     * than sampling or scanning the oplog. Called when a checkpoint is taken.
+     */
+    void persist(WiredTigerSizeStorer* sizeStorer);
+
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
     RecordId firstRecord;
@@ -118,13 +139,21 @@ public:
     void setMinBytesPerStone(int64_t size);
 
     bool processedBySampling() const {
-        return _processBySampling.load();
+        return _processingMethod.load() == ProcessingMethod::kSampling;
+    }
+
+    bool processedByLoading() const {
+        return _processingMethod.load() == ProcessingMethod::kLoading;
     }
 
 private:
     class InsertChange;
 
+    enum class ProcessingMethod { kScanning, kSampling, kLoading };
+
     void _calculateStones(OperationContext* opCtx, size_t size);
+    bool _loadStones(OperationContext* opCtx);
+    void _addScannedRecord(const Record& record);
     void _calculateStonesByScanning(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
                                     int64_t estRecordsPerStone,
@@ -151,7 +180,17 @@ private:
     AtomicWord<long long> _currentBytes;       // Number of bytes in the stone being filled.
     AtomicWord<int64_t> _totalTimeProcessing;  // Amount of time spent scanning and/or sampling the
                                                // oplog during start up, if any.
-    AtomicWord<bool> _processBySampling;       // Whether the oplog was sampled or scanned.
+
+    // Whether the stones were determined by scanning or sampling the oplog, or loaded.
+    AtomicWord<ProcessingMethod> _processingMethod;
+
+    // When the stones were loaded at startup, the number of stones loaded and the number of records
+    // inserted since they were persisted that had to be scanned.
+    AtomicWord<long long> _numStonesLoaded;
+    AtomicWord<long long> _numRecordsScannedAfterLoading;
+
+    AtomicWord<long long> _totalTimePersisting;  // Amount of time spent persisting the stones.
+    AtomicWord<long long> _persistCount;         // Number of times the stones were persisted.
 
     // Protects against concurrent access to the deque of oplog stones.
     mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogStones::_mutex");
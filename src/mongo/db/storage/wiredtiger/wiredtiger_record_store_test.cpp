@@ -48,6 +48,8 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
@@ -236,8 +238,8 @@ RecordId _oplogOrderInsertOplog(OperationContext* opCtx,
 // Test that even when the oplog durability loop is paused, we can still advance the commit point as
 // long as the commit for each insert comes before the next insert starts.
 TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityInOrder) {
-    ON_BLOCK_EXIT([] { WTPauseOplogVisibilityUpdateLoop.setMode(FailPoint::off); });
-    WTPauseOplogVisibilityUpdateLoop.setMode(FailPoint::alwaysOn);
+    ON_BLOCK_EXIT([] { WTPauseOplogVisibilityUpdates.setMode(FailPoint::off); });
+    WTPauseOplogVisibilityUpdates.setMode(FailPoint::alwaysOn);
 
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
@@ -265,8 +267,8 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityInOrder) {
 // Test that Oplog entries inserted while there are hidden entries do not become visible until the
 // op and all earlier ops are durable.
 TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
-    ON_BLOCK_EXIT([] { WTPauseOplogVisibilityUpdateLoop.setMode(FailPoint::off); });
-    WTPauseOplogVisibilityUpdateLoop.setMode(FailPoint::alwaysOn);
+    ON_BLOCK_EXIT([] { WTPauseOplogVisibilityUpdates.setMode(FailPoint::off); });
+    WTPauseOplogVisibilityUpdates.setMode(FailPoint::alwaysOn);
 
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
@@ -303,7 +305,7 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
     ASSERT(wtrs->isOpHidden_forTest(id1));
     ASSERT(wtrs->isOpHidden_forTest(id2));
 
-    WTPauseOplogVisibilityUpdateLoop.setMode(FailPoint::off);
+    WTPauseOplogVisibilityUpdates.setMode(FailPoint::off);
 
     rs->waitForAllEarlierOplogWritesToBeVisible(longLivedOp.get());
 
@@ -311,6 +313,99 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
     ASSERT(!wtrs->isOpHidden_forTest(id2));
 }
 
+// Test that oplog entries become visible as soon as the oldest hole behind them is closed, whether
+// the write holding it commits or aborts.
+TEST(WiredTigerRecordStoreTest, OplogVisibilityAdvancesWhenOldestHoleCloses) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    auto insertBehindHole = [&](int holeInc, bool commitHole) {
+        ServiceContext::UniqueOperationContext longLivedOp(harnessHelper->newOperationContext());
+        boost::optional<WriteUnitOfWork> uow;
+        uow.emplace(longLivedOp.get());
+        RecordId hole = _oplogOrderInsertOplog(longLivedOp.get(), rs, holeInc);
+
+        RecordId id;
+        {
+            auto innerClient = harnessHelper->serviceContext()->makeClient("inner");
+            ServiceContext::UniqueOperationContext opCtx(
+                harnessHelper->newOperationContext(innerClient.get()));
+            WriteUnitOfWork innerUow(opCtx.get());
+            id = _oplogOrderInsertOplog(opCtx.get(), rs, holeInc + 1);
+            innerUow.commit();
+        }
+
+        ASSERT(wtrs->isOpHidden_forTest(hole));
+        ASSERT(wtrs->isOpHidden_forTest(id));
+
+        if (commitHole) {
+            uow->commit();
+        }
+        uow.reset();
+
+        // No need to wait: closing the hole made the entry behind it visible.
+        ASSERT(!wtrs->isOpHidden_forTest(id));
+    };
+
+    insertBehindHole(1, /*commitHole=*/true);
+    insertBehindHole(3, /*commitHole=*/false);
+
+    auto wtKvEngine = dynamic_cast<WiredTigerKVEngine*>(harnessHelper->getEngine());
+    BSONObjBuilder builder;
+    wtKvEngine->getOplogManager()->appendVisibilityStats(builder);
+    ASSERT_EQ(4, builder.obj()["visibilityDelayMicros"]["totalCount"].numberLong());
+}
+
+// Test that when many writers finish oplog writes at once, and most of them leave the update of the
+// oplog visibility to the one already updating it, every entry is visible once they all returned.
+TEST(WiredTigerRecordStoreTest, ConcurrentOplogWritesBecomeVisible) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    const int kNumThreads = 16;
+    const int kWritesPerThread = 200;
+    auto reservationMutex = MONGO_MAKE_LATCH();
+    unsigned lastInc = 0;
+    RecordId lastId;
+
+    unittest::Barrier barrier(kNumThreads);
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&, i] {
+            auto client =
+                harnessHelper->serviceContext()->makeClient(str::stream() << "writer " << i);
+            auto opCtx = harnessHelper->newOperationContext(client.get());
+            barrier.countDownAndWait();
+            for (int j = 0; j < kWritesPerThread; ++j) {
+                WriteUnitOfWork wuow(opCtx.get());
+                Timestamp ts;
+                {
+                    // Oplog timestamps are reserved and published in order, as on a primary.
+                    stdx::lock_guard<Latch> lk(reservationMutex);
+                    ts = Timestamp(5, ++lastInc);
+                    ASSERT_OK(rs->oplogDiskLocRegister(opCtx.get(), ts, false));
+                }
+                BSONObj obj = BSON("ts" << ts);
+                auto res = rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), ts);
+                ASSERT_OK(res.getStatus());
+                wuow.commit();
+
+                stdx::lock_guard<Latch> lk(reservationMutex);
+                lastId = std::max(lastId, res.getValue());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(RecordId(Timestamp(5, kNumThreads * kWritesPerThread).asULL()), lastId);
+    ASSERT(!wtrs->isOpHidden_forTest(lastId));
+}
+
 TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
     unique_ptr<RecordStore> rs(harnessHelper->newRecordStore("a.b"));
@@ -944,6 +1039,65 @@ TEST(WiredTigerRecordStoreTest, OplogStones_Duplicates) {
     }
 }
 
+// Persist the oplog stones and verify that they are loaded, rather than recomputed, when the oplog
+// is opened again. The records after the last persisted stone are scanned on load.
+TEST(WiredTigerRecordStoreTest, OplogStones_LoadPersistedStones) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    auto wtHarnessHelper = dynamic_cast<WiredTigerHarnessHelper*>(harnessHelper.get());
+    WiredTigerSizeStorer sizeStorer(wtHarnessHelper->conn(),
+                                    WiredTigerKVEngine::kTableUriPrefix + "sizeStorer",
+                                    /*readOnly=*/false);
+
+    {
+        std::unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+        WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+        wtrs->setSizeStorer(&sizeStorer);
+        WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+        ASSERT_FALSE(oplogStones->processedByLoading());
+
+        oplogStones->setMinBytesPerStone(100);
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 0), 100), RecordId(1, 0));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(2, 0), 100), RecordId(2, 0));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(3, 0), 100), RecordId(3, 0));
+        ASSERT_EQ(3U, oplogStones->numStones());
+
+        wtrs->persistOplogTruncateMarkers();
+
+        // These records are not covered by a persisted stone and must be scanned on load.
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(4, 0), 50), RecordId(4, 0));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(5, 0), 40), RecordId(5, 0));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    auto wtKvEngine = dynamic_cast<WiredTigerKVEngine*>(harnessHelper->getEngine());
+    wtKvEngine->getOplogManager()->setOplogReadTimestamp(Timestamp(5, 0));
+
+    std::unique_ptr<RecordStore> rs(wtHarnessHelper->newOplogRecordStoreNoInit());
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    wtrs->setSizeStorer(&sizeStorer);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        wtrs->postConstructorInit(opCtx.get());
+    }
+
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    ASSERT(oplogStones->processedByLoading());
+    ASSERT_EQ(3U, oplogStones->numStones());
+    ASSERT_EQ(2, oplogStones->currentRecords());
+    ASSERT_EQ(90, oplogStones->currentBytes());
+
+    BSONObjBuilder builder;
+    oplogStones->getOplogStonesStats(builder);
+    auto stats = builder.obj();
+    ASSERT_EQ("loading", stats["processingMethod"].String());
+    ASSERT_EQ(3, stats["numTruncationPointsLoaded"].numberLong());
+    ASSERT_EQ(2, stats["numRecordsScannedAfterLoading"].numberLong());
+
+    rs.reset();  // The record store has to be destroyed before the size storer.
+}
+
 TEST(WiredTigerRecordStoreTest, GetLatestOplogTest) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
@@ -503,18 +503,21 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
             22413, 3, "WT rollback_transaction", "snapshotId"_attr = getSnapshotId().toNumber());
     }
 
-    if (_isTimestamped) {
-        if (!_orderedCommit) {
-            // We only need to update oplog visibility where commits can be out-of-order with
-            // respect to their assigned optime. This will ensure the oplog read timestamp gets
-            // updated when oplog 'holes' are filled: the last commit filling the last hole will
-            // prompt the oplog read timestamp to be forwarded.
-            //
-            // This should happen only on primary nodes.
-            _oplogManager->triggerOplogVisibilityUpdate();
-        }
-        _isTimestamped = false;
+    if (_oplogWriteTimestamp) {
+        // We only need to update oplog visibility where commits can be out-of-order with respect
+        // to their assigned optime. This will ensure the oplog read timestamp gets updated when
+        // oplog 'holes' are filled, whether by a commit or by an abort: the transaction filling the
+        // last hole will forward the oplog read timestamp.
+        //
+        // This should happen only on primary nodes.
+        _oplogManager->endOplogWrite(*_oplogWriteTimestamp);
+        _oplogWriteTimestamp = boost::none;
+    } else if (_isTimestamped && !_orderedCommit) {
+        // Unordered commits that did not publish their oplog timestamp, such as direct writes into
+        // the oplog, update the oplog visibility when they commit.
+        _oplogManager->triggerOplogVisibilityUpdate();
     }
+    _isTimestamped = false;
     invariantWTOK(wtRet, s);
 
     invariant(!_lastTimestampSet || _commitTimestamp.isNull(),
@@ -797,6 +800,17 @@ void WiredTigerRecoveryUnit::_updateMultiTimestampConstraint(Timestamp timestamp
     timestampOrder.push(timestamp);
 }
 
+void WiredTigerRecoveryUnit::beginOplogWrite(Timestamp ts) {
+    invariant(_isActive(), toString(_getState()));
+    if (_oplogWriteTimestamp) {
+        // Oplog timestamps are reserved in increasing order: the first one reserved by this
+        // transaction is the one that holds back oplog visibility.
+        return;
+    }
+    _oplogManager->beginOplogWrite(ts);
+    _oplogWriteTimestamp = ts;
+}
+
 Status WiredTigerRecoveryUnit::setTimestamp(Timestamp timestamp) {
     _ensureSession();
     LOGV2_DEBUG(22415,
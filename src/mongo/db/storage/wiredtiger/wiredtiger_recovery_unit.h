@@ -193,6 +193,13 @@ public:
         return _isOplogReader;
     }
 
+    /**
+     * Publishes 'ts' to the oplog manager as the timestamp of an oplog entry written by the active
+     * transaction, unless the transaction already published an earlier one. The oplog manager is
+     * told when the transaction commits or aborts, so that the entry can become visible.
+     */
+    void beginOplogWrite(Timestamp ts);
+
     /**
      * Enter a period of wait or computation during which there are no WT calls.
      * Any non-relevant cached handles can be closed.
@@ -313,6 +320,9 @@ private:
     std::unique_ptr<Timer> _timer;
     bool _isOplogReader = false;
     boost::optional<int64_t> _oplogVisibleTs = boost::none;
+    // The timestamp of the first oplog entry written by the active transaction, if it was published
+    // to the oplog manager by beginOplogWrite().
+    boost::optional<Timestamp> _oplogWriteTimestamp;
     bool _gatherWriteContextForDebugging = false;
     std::vector<BSONObj> _writeContextForDebugging;
 };
@@ -100,6 +100,7 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
         BSONObjBuilder subsection(bob.subobjStart("oplog"));
         subsection.append("visibility timestamp",
                           Timestamp(engine->getOplogManager()->getOplogReadTimestamp()));
+        engine->getOplogManager()->appendVisibilityStats(subsection);
     }
 
     return bob.obj();
@@ -121,6 +121,14 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Opera
                                       data["dataSize"].safeNumberLong());
 }
 
+namespace {
+
+std::string oplogTruncateMarkersKey(StringData oplogUri) {
+    return "oplogTruncateMarkers:" + oplogUri;
+}
+
+}  // namespace
+
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
     Buffer buffer;
     {
@@ -201,4 +209,50 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
                 "WiredTigerSizeStorer::flush completed",
                 "duration"_attr = Microseconds{t.micros()});
 }
+
+void WiredTigerSizeStorer::storeOplogTruncateMarkers(StringData oplogUri, const BSONObj& markers) {
+    if (_readOnly)
+        return;
+
+    stdx::lock_guard<Latch> flushLock(_flushMutex);
+
+    WiredTigerSession session(_conn);
+    WT_CURSOR* cursor = session.getNewCursor(_storageUri, "overwrite=true");
+
+    // As in flush(), allow the transaction to time itself out rather than deadlock with cache
+    // eviction. The markers are written again on the next attempt.
+    WiredTigerBeginTxnBlock txnOpen(session.getSession(), "operation_timeout_ms=10");
+
+    const auto keyString = oplogTruncateMarkersKey(oplogUri);
+    WiredTigerItem key(keyString.c_str(), keyString.size());
+    WiredTigerItem value(markers.objdata(), markers.objsize());
+    cursor->set_key(cursor, key.Get());
+    cursor->set_value(cursor, value.Get());
+    int ret = cursor->insert(cursor);
+    if (ret == WT_ROLLBACK) {
+        return;
+    }
+    invariantWTOK(ret, cursor->session);
+
+    txnOpen.done();
+    invariantWTOK(session.getSession()->commit_transaction(session.getSession(), nullptr),
+                  session.getSession());
+}
+
+BSONObj WiredTigerSizeStorer::loadOplogTruncateMarkers(OperationContext* opCtx,
+                                                       StringData oplogUri) const {
+    WiredTigerCursor cursor(_storageUri, _tableId, /*allowOverwrite=*/false, opCtx);
+
+    const auto keyString = oplogTruncateMarkersKey(oplogUri);
+    WT_ITEM key = {keyString.c_str(), keyString.size()};
+    cursor->set_key(cursor.get(), &key);
+    int ret = cursor->search(cursor.get());
+    if (ret == WT_NOTFOUND)
+        return BSONObj();
+    invariantWTOK(ret, cursor->session);
+
+    WT_ITEM value;
+    invariantWTOK(cursor->get_value(cursor.get(), &value), cursor->session);
+    return BSONObj(reinterpret_cast<const char*>(value.data)).getOwned();
+}
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
@@ -92,6 +93,18 @@ public:
      */
     void flush(bool syncToDisk);
 
+    /**
+     * Writes 'markers', the oplog truncate markers of the oplog table 'oplogUri', to the underlying
+     * table, next to the oplog's size information. Unlike size information, they are not buffered.
+     */
+    void storeOplogTruncateMarkers(StringData oplogUri, const BSONObj& markers);
+
+    /**
+     * Returns the oplog truncate markers last stored for 'oplogUri', or an empty object if there
+     * are none.
+     */
+    BSONObj loadOplogTruncateMarkers(OperationContext* opCtx, StringData oplogUri) const;
+
 private:
     WT_CONNECTION* _conn;
     const std::string _storageUri;
@@ -33,11 +33,13 @@
 
 #include <algorithm>
 #include <boost/iterator/transform_iterator.hpp>
+#include <limits>
 
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/timeseries/timeseries_global_options.h"
 #include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/thread.h"
@@ -543,6 +545,18 @@ void BucketCatalog::WriteBatch::_abort(const Status& status) {
     _promise.setError(status);
 }
 
+BucketCatalog::BucketCatalog() : BucketCatalog(getTimeseriesBucketCatalogNumStripes()) {}
+
+BucketCatalog::BucketCatalog(std::size_t numberOfStripes)
+    : _numberOfStripes(numberOfStripes),
+      _stripes(std::make_unique<Stripe[]>(numberOfStripes)),
+      _bucketStates(std::make_unique<BucketStateShard[]>(numberOfStripes)) {
+    invariant(_numberOfStripes > 0);
+    invariant(_numberOfStripes <= std::numeric_limits<StripeNumber>::max());
+}
+
+BucketCatalog::~BucketCatalog() = default;
+
 BucketCatalog& BucketCatalog::get(ServiceContext* svcCtx) {
     return getBucketCatalog(svcCtx);
 }
@@ -563,6 +577,10 @@ BSONObj BucketCatalog::getMetadata(const BucketHandle& handle) const {
     return bucket->_metadata.toBSON();
 }
 
+bool BucketCatalog::isBucketOpen(const OID& oid) const {
+    return _getBucketState(oid).has_value();
+}
+
 StatusWith<BucketCatalog::InsertResult> BucketCatalog::insert(
     OperationContext* opCtx,
     const NamespaceString& ns,
@@ -579,9 +597,6 @@ StatusWith<BucketCatalog::InsertResult> BucketCatalog::insert(
     }
     auto time = timeElem.Date();
 
-    auto stats = _getExecutionStats(ns);
-    invariant(stats);
-
     BSONElement metadata;
     auto metaFieldName = options.getMetaField();
     if (metaFieldName) {
@@ -593,12 +608,15 @@ StatusWith<BucketCatalog::InsertResult> BucketCatalog::insert(
     auto key = BucketKey{ns, BucketMetadata{metadata, comparator}};
     auto stripeNumber = _getStripeNumber(key);
 
-    ClosedBuckets closedBuckets;
-    CreationInfo info{key, stripeNumber, time, options, stats.get(), &closedBuckets};
-
     auto& stripe = _stripes[stripeNumber];
     stdx::lock_guard stripeLock{stripe.mutex};
 
+    auto stats = _getExecutionStats(&stripe, stripeLock, ns);
+    invariant(stats);
+
+    ClosedBuckets closedBuckets;
+    CreationInfo info{key, stripeNumber, time, options, stats.get(), &closedBuckets};
+
     Bucket* bucket = _useOrCreateBucket(&stripe, stripeLock, info);
     invariant(bucket);
 
@@ -805,17 +823,25 @@ void BucketCatalog::clear(const OID& oid) {
 }
 
 void BucketCatalog::clear(const std::function<bool(const NamespaceString&)>& shouldClear) {
-    for (auto& stripe : _stripes) {
+    {
+        // Remove the stats first, so that any stripe which looks them up again while we are
+        // clearing the others gets a fresh entry, which then is the only one in the catalog.
+        stdx::lock_guard catalogLock{_mutex};
+        stdx::erase_if(_executionStats,
+                       [&](const auto& entry) { return shouldClear(entry.first); });
+    }
+
+    for (std::size_t i = 0; i < _numberOfStripes; ++i) {
+        auto& stripe = _stripes[i];
         stdx::lock_guard stripeLock{stripe.mutex};
+        stdx::erase_if(stripe.executionStats,
+                       [&](const auto& entry) { return shouldClear(entry.first); });
+
         for (auto it = stripe.allBuckets.begin(); it != stripe.allBuckets.end();) {
             auto nextIt = std::next(it);
 
             const auto& bucket = it->second;
             if (shouldClear(bucket->_ns)) {
-                {
-                    stdx::lock_guard catalogLock{_mutex};
-                    _executionStats.erase(bucket->_ns);
-                }
                 _abort(&stripe,
                        stripeLock,
                        bucket.get(),
@@ -901,8 +927,12 @@ std::size_t BucketCatalog::BucketHasher::operator()(const BucketKey& key) const
     return key.hash;
 }
 
-BucketCatalog::StripeNumber BucketCatalog::_getStripeNumber(const BucketKey& key) {
-    return key.hash % kNumberOfStripes;
+BucketCatalog::StripeNumber BucketCatalog::_getStripeNumber(const BucketKey& key) const {
+    return key.hash % _numberOfStripes;
+}
+
+BucketCatalog::BucketStateShard& BucketCatalog::_getBucketStateShard(const OID& id) const {
+    return _bucketStates[OID::Hasher()(id) % _numberOfStripes];
 }
 
 const BucketCatalog::Bucket* BucketCatalog::_findBucket(const Stripe& stripe,
@@ -1159,6 +1189,18 @@ std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutionStats
     return res.first->second;
 }
 
+std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutionStats(
+    Stripe* stripe, WithLock, const NamespaceString& ns) {
+    auto it = stripe->executionStats.find(ns);
+    if (it != stripe->executionStats.end()) {
+        return it->second;
+    }
+
+    auto stats = _getExecutionStats(ns);
+    stripe->executionStats.emplace(ns, stats);
+    return stats;
+}
+
 const std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutionStats(
     const NamespaceString& ns) const {
     static const auto kEmptyStats{std::make_shared<ExecutionStats>()};
@@ -1173,26 +1215,30 @@ const std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutio
 }
 
 void BucketCatalog::_initializeBucketState(const OID& id) {
-    stdx::lock_guard catalogLock{_mutex};
-    _bucketStates.emplace(id, BucketState::kNormal);
+    auto& shard = _getBucketStateShard(id);
+    stdx::lock_guard shardLock{shard.mutex};
+    shard.states.emplace(id, BucketState::kNormal);
 }
 
 void BucketCatalog::_eraseBucketState(const OID& id) {
-    stdx::lock_guard catalogLock{_mutex};
-    _bucketStates.erase(id);
+    auto& shard = _getBucketStateShard(id);
+    stdx::lock_guard shardLock{shard.mutex};
+    shard.states.erase(id);
 }
 
 boost::optional<BucketCatalog::BucketState> BucketCatalog::_getBucketState(const OID& id) const {
-    stdx::lock_guard catalogLock{_mutex};
-    auto it = _bucketStates.find(id);
-    return it != _bucketStates.end() ? boost::make_optional(it->second) : boost::none;
+    auto& shard = _getBucketStateShard(id);
+    stdx::lock_guard shardLock{shard.mutex};
+    auto it = shard.states.find(id);
+    return it != shard.states.end() ? boost::make_optional(it->second) : boost::none;
 }
 
 boost::optional<BucketCatalog::BucketState> BucketCatalog::_setBucketState(const OID& id,
                                                                            BucketState target) {
-    stdx::lock_guard catalogLock{_mutex};
-    auto it = _bucketStates.find(id);
-    if (it == _bucketStates.end()) {
+    auto& shard = _getBucketStateShard(id);
+    stdx::lock_guard shardLock{shard.mutex};
+    auto it = shard.states.find(id);
+    if (it == shard.states.end()) {
         return boost::none;
     }
 
@@ -1246,7 +1292,8 @@ class BucketCatalog::ServerStatus : public ServerStatusSection {
 
     BucketCounts _getBucketCounts(const BucketCatalog& catalog) const {
         BucketCounts sum;
-        for (auto const& stripe : catalog._stripes) {
+        for (std::size_t i = 0; i < catalog._numberOfStripes; ++i) {
+            auto const& stripe = catalog._stripes[i];
             stdx::lock_guard stripeLock{stripe.mutex};
             sum += {stripe.allBuckets.size(), stripe.openBuckets.size(), stripe.idleBuckets.size()};
         }
@@ -50,7 +50,7 @@ class BucketCatalog {
     static constexpr std::size_t kNumStaticNewFields = 10;
     using NewFieldNames = boost::container::small_vector<StringMapHashedKey, kNumStaticNewFields>;
 
-    using StripeNumber = std::uint8_t;
+    using StripeNumber = std::uint32_t;
 
     struct BucketHandle {
         const OID id;
@@ -188,7 +188,13 @@ public:
     static BucketCatalog& get(ServiceContext* svcCtx);
     static BucketCatalog& get(OperationContext* opCtx);
 
-    BucketCatalog() = default;
+    /**
+     * Creates a catalog whose buckets are partitioned across 'numberOfStripes' independently-locked
+     * stripes. By default the number of stripes is scaled to the number of available cores.
+     */
+    BucketCatalog();
+    explicit BucketCatalog(std::size_t numberOfStripes);
+    ~BucketCatalog();
 
     BucketCatalog(const BucketCatalog&) = delete;
     BucketCatalog operator=(const BucketCatalog&) = delete;
@@ -203,6 +209,13 @@ public:
      */
     BSONObj getMetadata(const BucketHandle& bucket) const;
 
+    /**
+     * Returns whether the bucket with the given OID is tracked by the catalog, in which case it may
+     * still receive inserts. A bucket which has been closed is never tracked again, so once this
+     * returns false for an existing bucket, it is safe to rewrite the bucket directly.
+     */
+    bool isBucketOpen(const OID& oid) const;
+
     /**
      * Returns the WriteBatch into which the document was inserted and a list of any buckets that
      * were closed in order to make space to insert the document. Any caller who receives the same
@@ -340,7 +353,8 @@ private:
     /**
      * Struct to hold a portion of the buckets managed by the catalog.
      *
-     * Each of the bucket lists, as well as the buckets themselves, are protected by 'mutex'.
+     * Each of the bucket lists, as well as the buckets themselves, are protected by 'mutex'. The
+     * number of stripes is fixed at construction, so a BucketKey always maps to the same stripe.
      */
     struct Stripe {
         mutable Mutex mutex =
@@ -356,9 +370,27 @@ private:
         // Buckets that do not have any outstanding writes.
         using IdleList = std::list<Bucket*>;
         IdleList idleBuckets;
+
+        // Execution stats of the namespaces inserted into through this stripe, so that inserts do
+        // not need to take the catalog-wide '_mutex' to find them.
+        stdx::unordered_map<NamespaceString, std::shared_ptr<ExecutionStats>> executionStats;
+    };
+
+    /**
+     * Bucket states are partitioned by bucket id, so that looking up or changing the state of a
+     * bucket only contends with operations on buckets in the same partition. Direct writes to a
+     * bucket only know its id, which is why the states are not kept in the owning Stripe.
+     */
+    struct BucketStateShard {
+        mutable Mutex mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                               "BucketCatalog::BucketStateShard::mutex");
+
+        stdx::unordered_map<OID, BucketState, OID::Hasher> states;
     };
 
-    StripeNumber _getStripeNumber(const BucketKey& key);
+    StripeNumber _getStripeNumber(const BucketKey& key) const;
+
+    BucketStateShard& _getBucketStateShard(const OID& id) const;
 
     /**
      * Mode enum to control whether the bucket retrieval methods below will return buckets that are
@@ -461,6 +493,9 @@ private:
                       const CreationInfo& info);
 
     std::shared_ptr<ExecutionStats> _getExecutionStats(const NamespaceString& ns);
+    std::shared_ptr<ExecutionStats> _getExecutionStats(Stripe* stripe,
+                                                       WithLock stripeLock,
+                                                       const NamespaceString& ns);
     const std::shared_ptr<ExecutionStats> _getExecutionStats(const NamespaceString& ns) const;
 
     /**
@@ -488,18 +523,20 @@ private:
      */
     boost::optional<BucketState> _setBucketState(const OID& id, BucketState target);
 
-    static constexpr std::size_t kNumberOfStripes = 32;
-    std::array<Stripe, kNumberOfStripes> _stripes;
+    const std::size_t _numberOfStripes;
+    std::unique_ptr<Stripe[]> _stripes;
+
+    // Bucket state for synchronization with direct writes, partitioned by bucket id into
+    // '_numberOfStripes' shards.
+    std::unique_ptr<BucketStateShard[]> _bucketStates;
 
     mutable Mutex _mutex =
         MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "BucketCatalog::_mutex");
 
-    // Bucket state for synchronization with direct writes, protected by '_mutex'
-    stdx::unordered_map<OID, BucketState, OID::Hasher> _bucketStates;
-
     // Per-namespace execution stats. This map is protected by '_mutex'. Once you complete your
     // lookup, you can keep the shared_ptr to an individual namespace's stats object and release the
-    // lock. The object itself is thread-safe (using atomics).
+    // lock. The object itself is thread-safe (using atomics). Each stripe caches the entries it
+    // uses; an entry is removed from the caches whenever it is removed from this map.
     stdx::unordered_map<NamespaceString, std::shared_ptr<ExecutionStats>> _executionStats;
 
     // Approximate memory usage of the bucket catalog.
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+
+namespace mongo {
+namespace {
+
+constexpr StringData kTimeField = "time"_sd;
+constexpr StringData kMetaField = "meta"_sd;
+
+ServiceContext* setupServiceContext() {
+    if (!hasGlobalServiceContext()) {
+        setGlobalServiceContext(ServiceContext::make());
+    }
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(multiversion::GenericFCV::kLatest);
+    return getGlobalServiceContext();
+}
+
+TimeseriesOptions makeTimeseriesOptions() {
+    TimeseriesOptions options(kTimeField.toString());
+    options.setMetaField(kMetaField);
+    options.setBucketMaxSpanSeconds(
+        timeseries::getMaxSpanSecondsFromGranularity(options.getGranularity()));
+    return options;
+}
+
+/**
+ * Drives concurrent inserts from 'state.threads' clients into a catalog with 'state.range(0)'
+ * stripes, or the default number of stripes if zero, spreading the measurements across
+ * 'state.range(1)' series. Each client commits the batches it claims commit rights for and waits
+ * for the others, like an unordered insert command.
+ */
+void BM_BucketCatalogConcurrentInsert(benchmark::State& state) {
+    static std::unique_ptr<BucketCatalog> catalog;
+    static ServiceContext* serviceContext;
+    if (state.thread_index == 0) {
+        serviceContext = setupServiceContext();
+        catalog = state.range(0) ? std::make_unique<BucketCatalog>(state.range(0))
+                                 : std::make_unique<BucketCatalog>();
+    }
+
+    const NamespaceString ns("bucket_catalog_bm", "ts");
+    const auto options = makeTimeseriesOptions();
+    const long long numSeries = state.range(1);
+
+    ThreadClient threadClient(serviceContext);
+    auto opCtx = threadClient->makeOperationContext();
+
+    long long series = state.thread_index;
+    long long numMeasurements = 0;
+    long long numCommits = 0;
+    for (auto _ : state) {
+        series = (series + state.threads) % numSeries;
+        auto result = catalog->insert(opCtx.get(),
+                                      ns,
+                                      nullptr,
+                                      options,
+                                      BSON(kTimeField << Date_t::now() << kMetaField << series
+                                                      << "value" << numMeasurements),
+                                      BucketCatalog::CombineWithInsertsFromOtherClients::kAllow);
+        invariant(result.isOK());
+        ++numMeasurements;
+
+        auto& batch = result.getValue().batch;
+        if (batch->claimCommitRights()) {
+            invariant(catalog->prepareCommit(batch));
+            catalog->finish(batch, {});
+            ++numCommits;
+        } else {
+            batch->getResult().getStatus().ignore();
+        }
+    }
+
+    state.counters["Measurements"] =
+        benchmark::Counter(numMeasurements, benchmark::Counter::kIsRate);
+    state.counters["Commits"] = benchmark::Counter(numCommits, benchmark::Counter::kIsRate);
+
+    if (state.thread_index == 0) {
+        catalog.reset();
+    }
+}
+
+// Compare the historical fixed stripe count against the count derived from the available cores,
+// for few and many series.
+BENCHMARK(BM_BucketCatalogConcurrentInsert)
+    ->ArgNames({"stripes", "series"})
+    ->ArgsProduct({{32, 0}, {64, 100'000}})
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -491,6 +491,59 @@ TEST_F(BucketCatalogTest, ClearDatabaseBuckets) {
     _insertOneAndCommit(_ns3, 1);
 }
 
+TEST_F(BucketCatalogTest, ConcurrentInsertsAcrossStripes) {
+    static constexpr int kNumThreads = 4;
+    static constexpr int kNumSeries = 64;
+    static constexpr int kNumInsertsPerThread = 128;
+
+    const auto options = _getTimeseriesOptions(_ns1);
+    const auto collator = _getCollator(_ns1);
+    AtomicWord<int> numFailures{0};
+
+    {
+        std::vector<std::unique_ptr<Task>> tasks;
+        for (int t = 0; t < kNumThreads; ++t) {
+            tasks.push_back(std::make_unique<Task>([&, t] {
+                auto [client, opCtx] = _makeOperationContext();
+                for (int i = 0; i < kNumInsertsPerThread; ++i) {
+                    auto result = _bucketCatalog->insert(
+                        opCtx.get(),
+                        _ns1,
+                        collator,
+                        options,
+                        BSON(_timeField << Date_t::now() << _metaField << (t + i) % kNumSeries),
+                        BucketCatalog::CombineWithInsertsFromOtherClients::kAllow);
+                    if (!result.isOK()) {
+                        numFailures.fetchAndAdd(1);
+                        continue;
+                    }
+
+                    // Whoever claims the commit rights commits the measurements of every client
+                    // which joined the batch in the meantime.
+                    auto& batch = result.getValue().batch;
+                    if (batch->claimCommitRights()) {
+                        if (!_bucketCatalog->prepareCommit(batch).isOK()) {
+                            numFailures.fetchAndAdd(1);
+                            continue;
+                        }
+                        _bucketCatalog->finish(batch, {});
+                    } else if (!batch->getResult().isOK()) {
+                        numFailures.fetchAndAdd(1);
+                    }
+                }
+            }));
+        }
+    }
+
+    ASSERT_EQ(numFailures.load(), 0);
+
+    BSONObjBuilder builder;
+    _bucketCatalog->appendExecutionStats(_ns1, &builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats.getIntField("numMeasurementsCommitted"), kNumThreads * kNumInsertsPerThread);
+    ASSERT_EQ(stats.getIntField("numBucketsOpenedDueToMetadata"), kNumSeries);
+}
+
 TEST_F(BucketCatalogTest, InsertBetweenPrepareAndFinish) {
     auto batch1 = _bucketCatalog
                       ->insert(_opCtx,
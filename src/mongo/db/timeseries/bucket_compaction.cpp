@@ -0,0 +1,677 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/db/timeseries/bucket_compaction.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/record_id_helpers.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/db/timeseries/flat_bson.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/str.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class TimeseriesBucketCompactor;
+
+namespace {
+
+const auto getTimeseriesBucketCompactor =
+    ServiceContext::declareDecoration<std::unique_ptr<TimeseriesBucketCompactor>>();
+
+// The number of buckets read from a collection while holding its lock, before yielding to merge
+// the candidates found so far.
+constexpr int kScanBatchSize = 1000;
+
+// The number of series for which a run of undersized buckets is tracked at once while scanning a
+// collection. Beyond that, the runs found so far are merged and forgotten.
+constexpr size_t kMaxPendingRuns = 100'000;
+
+Counter64 compactionPasses;
+Counter64 compactionMerges;
+Counter64 compactionBucketsMerged;
+Counter64 compactionBytesReclaimed;
+
+ServerStatusMetricField<Counter64> compactionPassesDisplay("timeseries.compaction.passes",
+                                                           &compactionPasses);
+ServerStatusMetricField<Counter64> compactionMergesDisplay("timeseries.compaction.merges",
+                                                           &compactionMerges);
+ServerStatusMetricField<Counter64> compactionBucketsMergedDisplay(
+    "timeseries.compaction.bucketsMerged", &compactionBucketsMerged);
+ServerStatusMetricField<Counter64> compactionBytesReclaimedDisplay(
+    "timeseries.compaction.bytesReclaimed", &compactionBytesReclaimed);
+
+MONGO_FAIL_POINT_DEFINE(hangTimeseriesBucketCompactorBetweenPasses);
+
+/**
+ * The parts of a bucket which decide whether it can be merged with its neighbours.
+ */
+struct BucketSummary {
+    OID id;
+    int count = 0;
+    int size = 0;
+    Date_t minTime;
+    Date_t maxTime;
+};
+
+/**
+ * Returns the summary of the given bucket, or boost::none if the bucket is not in a format the
+ * compactor understands.
+ */
+boost::optional<BucketSummary> summarize(const BSONObj& bucket, StringData timeField) {
+    auto idElem = bucket[timeseries::kBucketIdFieldName];
+    auto controlElem = bucket[timeseries::kBucketControlFieldName];
+    auto dataElem = bucket[timeseries::kBucketDataFieldName];
+    if (idElem.type() != BSONType::jstOID || controlElem.type() != BSONType::Object ||
+        dataElem.type() != BSONType::Object) {
+        return boost::none;
+    }
+
+    auto control = controlElem.Obj();
+    auto minTime = control.getObjectField(timeseries::kBucketControlMinFieldName)[timeField];
+    auto maxTime = control.getObjectField(timeseries::kBucketControlMaxFieldName)[timeField];
+    if (minTime.type() != BSONType::Date || maxTime.type() != BSONType::Date) {
+        return boost::none;
+    }
+
+    BucketSummary summary;
+    summary.id = idElem.OID();
+    summary.size = bucket.objsize();
+    summary.minTime = minTime.Date();
+    summary.maxTime = maxTime.Date();
+
+    auto version = control[timeseries::kBucketControlVersionFieldName];
+    if (version.isNumber() &&
+        version.numberInt() == timeseries::kTimeseriesControlCompressedVersion) {
+        auto count = control[timeseries::kBucketControlCountFieldName];
+        if (!count.isNumber()) {
+            return boost::none;
+        }
+        summary.count = count.numberInt();
+    } else if (version.isNumber() &&
+               version.numberInt() == timeseries::kTimeseriesControlDefaultVersion) {
+        auto time = dataElem.Obj()[timeField];
+        if (time.type() != BSONType::Object) {
+            return boost::none;
+        }
+        summary.count = time.Obj().nFields();
+    } else {
+        return boost::none;
+    }
+
+    return summary;
+}
+
+/**
+ * Returns a key which is equal for buckets with the same meta value. Bucket meta values are stored
+ * normalized, so the binary representation is sufficient.
+ */
+std::string makeSeriesKey(const BSONObj& bucket) {
+    auto meta = bucket[timeseries::kBucketMetaFieldName];
+    if (meta.eoo()) {
+        return {};
+    }
+    return std::string(1, static_cast<char>(meta.type())) +
+        std::string(meta.value(), meta.valuesize());
+}
+
+}  // namespace
+
+namespace timeseries {
+
+bool updateSchemaFromBucket(Schema& schema,
+                            const BSONObj& bucket,
+                            const StringData::ComparatorInterface* comparator) {
+    auto control = bucket.getObjectField(kBucketControlFieldName);
+    for (auto&& bound : {kBucketControlMinFieldName, kBucketControlMaxFieldName}) {
+        if (schema.update(control.getObjectField(bound), boost::none, comparator) ==
+            Schema::UpdateStatus::Failed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+boost::optional<BSONObj> mergeBuckets(const std::vector<BSONObj>& buckets,
+                                      StringData timeField,
+                                      const StringData::ComparatorInterface* comparator) {
+    invariant(!buckets.empty());
+
+    Schema schema;
+    for (auto&& bucket : buckets) {
+        if (!updateSchemaFromBucket(schema, bucket, comparator)) {
+            return boost::none;
+        }
+    }
+
+    // Work on the uncompressed form of each bucket, where each data field is an object keyed by
+    // measurement index.
+    std::vector<BSONObj> uncompressed;
+    uncompressed.reserve(buckets.size());
+    for (auto&& bucket : buckets) {
+        auto control = bucket.getObjectField(kBucketControlFieldName);
+        auto version = control[kBucketControlVersionFieldName];
+        if (version.isNumber() && version.numberInt() == kTimeseriesControlCompressedVersion) {
+            auto decompressed = decompressBucket(bucket);
+            if (!decompressed) {
+                return boost::none;
+            }
+            uncompressed.push_back(std::move(*decompressed));
+        } else {
+            uncompressed.push_back(bucket);
+        }
+    }
+
+    // Collect the data fields in order of first appearance, with the time field first, along with
+    // the index at which the measurements of each bucket start in the merged bucket.
+    std::vector<std::string> fieldNames{timeField.toString()};
+    StringSet seenFieldNames{timeField.toString()};
+    std::vector<int> offsets;
+    int numMeasurements = 0;
+    MinMax minmax;
+    for (auto&& bucket : uncompressed) {
+        auto control = bucket.getObjectField(kBucketControlFieldName);
+        auto data = bucket.getObjectField(kBucketDataFieldName);
+        auto time = data[timeField];
+        if (time.type() != BSONType::Object) {
+            return boost::none;
+        }
+
+        offsets.push_back(numMeasurements);
+        numMeasurements += time.Obj().nFields();
+
+        for (auto&& column : data) {
+            if (seenFieldNames.insert(column.fieldName()).second) {
+                fieldNames.push_back(column.fieldName());
+            }
+        }
+
+        // Every value of a bucket lies between its control.min and control.max, so the extremes
+        // over those objects are the extremes over all measurements.
+        minmax.update(control.getObjectField(kBucketControlMinFieldName), boost::none, comparator);
+        minmax.update(control.getObjectField(kBucketControlMaxFieldName), boost::none, comparator);
+    }
+
+    const auto& first = uncompressed.front();
+    BSONObjBuilder builder;
+    builder.append(first[kBucketIdFieldName]);
+    {
+        BSONObjBuilder control(builder.subobjStart(kBucketControlFieldName));
+        control.append(kBucketControlVersionFieldName, kTimeseriesControlDefaultVersion);
+        control.append(kBucketControlMinFieldName, minmax.min());
+        control.append(kBucketControlMaxFieldName, minmax.max());
+    }
+    if (auto meta = first[kBucketMetaFieldName]) {
+        builder.append(meta);
+    }
+    {
+        BSONObjBuilder data(builder.subobjStart(kBucketDataFieldName));
+        for (auto&& fieldName : fieldNames) {
+            BSONObjBuilder column(data.subobjStart(fieldName));
+            for (size_t i = 0; i < uncompressed.size(); ++i) {
+                auto values = uncompressed[i].getObjectField(kBucketDataFieldName)[fieldName];
+                if (values.eoo()) {
+                    continue;
+                }
+                if (values.type() != BSONType::Object) {
+                    return boost::none;
+                }
+
+                for (auto&& value : values.Obj()) {
+                    int index;
+                    if (!NumberParser{}(value.fieldNameStringData(), &index).isOK()) {
+                        return boost::none;
+                    }
+                    column.appendAs(value, std::to_string(offsets[i] + index));
+                }
+            }
+        }
+    }
+
+    return builder.obj();
+}
+
+void BucketMergeSelector::add(const BSONObj& bucket,
+                              bool isOpen,
+                              const Limits& limits,
+                              const StringData::ComparatorInterface* comparator) {
+    auto summary = summarize(bucket, _timeField);
+    if (!summary) {
+        return;
+    }
+
+    auto& run = _runs[makeSeriesKey(bucket)];
+
+    // Buckets which are still open may receive more measurements, and full ones are left alone.
+    // Either way they end the current run of their series.
+    if (summary->count >= limits.minCount || isOpen) {
+        _flush(run);
+        return;
+    }
+
+    if (!run.ids.empty() &&
+        (run.count + summary->count > limits.maxCount ||
+         run.size + summary->size > limits.maxSize ||
+         summary->maxTime - run.minTime >= limits.maxSpan)) {
+        _flush(run);
+    }
+
+    // Buckets whose fields have different types than those of the run start a new one. A bucket
+    // which already holds mixed-schema data is left alone.
+    if (!run.ids.empty() && !updateSchemaFromBucket(run.schema, bucket, comparator)) {
+        _flush(run);
+    }
+    if (run.ids.empty()) {
+        if (!updateSchemaFromBucket(run.schema, bucket, comparator)) {
+            _flush(run);
+            return;
+        }
+        run.minTime = summary->minTime;
+    }
+    run.ids.push_back(summary->id);
+    run.count += summary->count;
+    run.size += summary->size;
+}
+
+void BucketMergeSelector::flushAll() {
+    for (auto&& [_, run] : _runs) {
+        _flush(run);
+    }
+    _runs.clear();
+}
+
+std::vector<std::vector<OID>> BucketMergeSelector::takeMergeCandidates() {
+    return std::exchange(_toMerge, {});
+}
+
+void BucketMergeSelector::_flush(Run& run) {
+    if (run.ids.size() > 1) {
+        _toMerge.push_back(std::move(run.ids));
+    }
+    run = Run{};
+}
+
+}  // namespace timeseries
+
+class TimeseriesBucketCompactor : public BackgroundJob {
+public:
+    TimeseriesBucketCompactor() : BackgroundJob(false /* selfDelete */) {}
+
+    static TimeseriesBucketCompactor* get(ServiceContext* serviceCtx) {
+        return getTimeseriesBucketCompactor(serviceCtx).get();
+    }
+
+    static void set(ServiceContext* serviceCtx,
+                    std::unique_ptr<TimeseriesBucketCompactor> compactor) {
+        auto& current = getTimeseriesBucketCompactor(serviceCtx);
+        if (current) {
+            invariant(!current->running(),
+                      "Tried to reset the time-series bucket compactor without shutting down the "
+                      "original instance.");
+        }
+
+        invariant(compactor);
+        current = std::move(compactor);
+    }
+
+    std::string name() const {
+        return "TimeseriesBucketCompactor";
+    }
+
+    void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+        {
+            stdx::lock_guard<Client> lk(*tc.get());
+            tc.get()->setSystemOperationKillableByStepdown(lk);
+        }
+
+        while (true) {
+            if (!_sleepFor(Seconds(gTimeseriesBucketCompactionIntervalSecs.load()))) {
+                return;
+            }
+
+            if (!gTimeseriesBucketCompactionEnabled.load()) {
+                continue;
+            }
+
+            try {
+                _doPass();
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
+                LOGV2_DEBUG(7803601,
+                            1,
+                            "Time-series bucket compactor was interrupted",
+                            "error"_attr = interruption);
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(
+                    7803602, "Time-series bucket compaction pass failed", "error"_attr = ex);
+            }
+        }
+    }
+
+    /**
+     * Signals the thread to quit and then waits until it does.
+     */
+    void shutdown() {
+        LOGV2(7803603, "Shutting down time-series bucket compactor thread");
+        {
+            stdx::lock_guard<Latch> lk(_stateMutex);
+            _shuttingDown = true;
+            _shuttingDownCV.notify_one();
+        }
+        wait();
+        LOGV2(7803604, "Finished shutting down time-series bucket compactor thread");
+    }
+
+private:
+    /**
+     * Waits for the given duration or until a shutdown is requested. Returns false in the latter
+     * case.
+     */
+    bool _sleepFor(Milliseconds duration) {
+        auto deadline = Date_t::now() + duration;
+        stdx::unique_lock<Latch> lk(_stateMutex);
+
+        MONGO_IDLE_THREAD_BLOCK;
+        _shuttingDownCV.wait_until(lk, deadline.toSystemTimePoint(), [&] { return _shuttingDown; });
+        return !_shuttingDown;
+    }
+
+    /**
+     * Waits long enough for 'bytes' of I/O to fit within the configured budget. Returns false if a
+     * shutdown was requested meanwhile.
+     */
+    bool _throttle(long long bytes) {
+        auto budget = gTimeseriesBucketCompactionMaxBytesPerSecond.load();
+        return _sleepFor(Milliseconds(bytes * 1000 / budget));
+    }
+
+    void _doPass() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext* opCtx = opCtxPtr.get();
+
+        hangTimeseriesBucketCompactorBetweenPasses.pauseWhileSet(opCtx);
+
+        // Only the primary rewrites buckets, secondaries replicate the result.
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet &&
+            !replCoord->getMemberState().primary()) {
+            return;
+        }
+
+        ON_BLOCK_EXIT([&] { compactionPasses.increment(); });
+
+        auto catalog = CollectionCatalog::get(opCtx);
+        for (auto&& dbName : catalog->getAllDbNames()) {
+            for (auto&& nss : catalog->getAllCollectionNamesFromDb(opCtx, dbName)) {
+                if (!nss.isTimeseriesBucketsCollection()) {
+                    continue;
+                }
+
+                try {
+                    if (!_compactCollection(opCtx, nss)) {
+                        return;
+                    }
+                } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                    throw;
+                } catch (const DBException& ex) {
+                    LOGV2_WARNING(7803605,
+                                  "Error compacting time-series buckets",
+                                  logAttrs(nss),
+                                  "error"_attr = ex);
+                }
+            }
+        }
+    }
+
+    /**
+     * Scans the buckets of the given collection in _id order, and merges the runs of adjacent
+     * undersized buckets of each series chosen by a BucketMergeSelector. Returns false if a
+     * shutdown was requested.
+     */
+    bool _compactCollection(OperationContext* opCtx, const NamespaceString& nss) {
+        boost::optional<UUID> uuid;
+        std::string timeField;
+        boost::optional<timeseries::BucketMergeSelector> selector;
+        RecordId lastScanned;
+        bool exhausted = false;
+
+        while (!exhausted) {
+            long long bytesScanned = 0;
+            {
+                AutoGetCollection coll(opCtx, nss, MODE_IS);
+                if (!coll || (uuid && coll->uuid() != *uuid)) {
+                    return true;
+                }
+
+                auto options = coll->getTimeseriesOptions();
+                if (!options || !coll->isClustered()) {
+                    return true;
+                }
+                uuid = coll->uuid();
+                timeField = options->getTimeField().toString();
+                if (!selector) {
+                    selector.emplace(timeField);
+                }
+
+                auto& bucketCatalog = BucketCatalog::get(opCtx);
+                auto comparator = coll->getDefaultCollator();
+                timeseries::BucketMergeSelector::Limits limits;
+                limits.minCount = gTimeseriesBucketCompactionMinMeasurementCount.load();
+                limits.maxCount = gTimeseriesBucketMaxCount;
+                limits.maxSize = gTimeseriesBucketMaxSize;
+                limits.maxSpan = Seconds(*options->getBucketMaxSpanSeconds());
+
+                auto cursor = coll->getCursor(opCtx);
+                auto record = lastScanned.isNull() ? cursor->next() : cursor->seekNear(lastScanned);
+                while (record && !lastScanned.isNull() && record->id <= lastScanned) {
+                    record = cursor->next();
+                }
+
+                int scanned = 0;
+                for (; record && scanned < kScanBatchSize; record = cursor->next(), ++scanned) {
+                    lastScanned = record->id;
+                    auto bucket = record->data.toBson();
+                    bytesScanned += bucket.objsize();
+
+                    auto id = bucket[timeseries::kBucketIdFieldName];
+                    selector->add(bucket,
+                                  id.type() == BSONType::jstOID &&
+                                      bucketCatalog.isBucketOpen(id.OID()),
+                                  limits,
+                                  comparator);
+                }
+                exhausted = !record;
+            }
+
+            if (exhausted || selector->numPendingRuns() > kMaxPendingRuns) {
+                selector->flushAll();
+            }
+
+            if (!_throttle(bytesScanned)) {
+                return false;
+            }
+
+            for (auto&& ids : selector->takeMergeCandidates()) {
+                auto bytesWritten = _mergeBuckets(opCtx, nss, *uuid, timeField, ids);
+                if (!_throttle(bytesWritten)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Replaces the first of the given buckets with one bucket holding the measurements of all of
+     * them, and deletes the others, in a single storage transaction. The merged bucket is
+     * compressed if the feature compatibility version allows compressed buckets. Does nothing if
+     * any of the buckets was removed or reopened since it was scanned. Returns the number of bytes
+     * read and written.
+     */
+    long long _mergeBuckets(OperationContext* opCtx,
+                            const NamespaceString& nss,
+                            const UUID& uuid,
+                            StringData timeField,
+                            const std::vector<OID>& ids) {
+        long long bytes = 0;
+        writeConflictRetry(opCtx, "timeseriesBucketCompaction", nss.ns(), [&] {
+            bytes = 0;
+            AutoGetCollection coll(opCtx, nss, MODE_IX);
+            if (!coll || coll->uuid() != uuid) {
+                return;
+            }
+
+            if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss)) {
+                return;
+            }
+
+            auto& bucketCatalog = BucketCatalog::get(opCtx);
+            std::vector<Snapshotted<BSONObj>> snapshots;
+            std::vector<BSONObj> buckets;
+            int sizeBefore = 0;
+            for (auto&& id : ids) {
+                Snapshotted<BSONObj> doc;
+                if (bucketCatalog.isBucketOpen(id) ||
+                    !coll->findDoc(opCtx, record_id_helpers::keyForOID(id), &doc)) {
+                    return;
+                }
+                sizeBefore += doc.value().objsize();
+                buckets.push_back(doc.value());
+                snapshots.push_back(std::move(doc));
+            }
+            bytes += sizeBefore;
+
+            auto merged = timeseries::mergeBuckets(buckets, timeField, coll->getDefaultCollator());
+            if (!merged || merged->objsize() > BSONObjMaxUserSize) {
+                return;
+            }
+
+            // Compressed buckets cannot be written before the feature compatibility version
+            // allows them, as binaries of the previous version cannot read them.
+            timeseries::CompressionResult compressed;
+            if (feature_flags::gTimeseriesBucketCompression.isEnabled(
+                    serverGlobalParams.featureCompatibility)) {
+                compressed = timeseries::compressBucket(
+                    *merged, timeField, nss, gValidateTimeseriesCompression.load());
+            }
+            const auto& newBucket =
+                compressed.compressedBucket ? *compressed.compressedBucket : *merged;
+            bytes += newBucket.objsize();
+
+            WriteUnitOfWork wuow(opCtx);
+
+            CollectionUpdateArgs args;
+            args.preImageDoc = buckets.front();
+            args.update = newBucket;
+            args.criteria = BSON(timeseries::kBucketIdFieldName << ids.front());
+            coll->updateDocument(opCtx,
+                                 record_id_helpers::keyForOID(ids.front()),
+                                 snapshots.front(),
+                                 newBucket,
+                                 true /* indexesAffected */,
+                                 nullptr /* opDebug */,
+                                 &args);
+
+            for (size_t i = 1; i < ids.size(); ++i) {
+                coll->deleteDocument(opCtx,
+                                     snapshots[i],
+                                     kUninitializedStmtId,
+                                     record_id_helpers::keyForOID(ids[i]),
+                                     nullptr /* opDebug */);
+            }
+
+            wuow.commit();
+
+            compactionMerges.increment();
+            compactionBucketsMerged.increment(ids.size());
+            compactionBytesReclaimed.increment(std::max(sizeBefore - newBucket.objsize(), 0));
+
+            LOGV2_DEBUG(7803606,
+                        2,
+                        "Merged time-series buckets",
+                        logAttrs(nss),
+                        "bucketId"_attr = ids.front(),
+                        "numBuckets"_attr = ids.size(),
+                        "sizeBefore"_attr = sizeBefore,
+                        "sizeAfter"_attr = newBucket.objsize());
+        });
+        return bytes;
+    }
+
+    // Protects the state below.
+    mutable Mutex _stateMutex = MONGO_MAKE_LATCH("TimeseriesBucketCompactor::_stateMutex");
+
+    // Signaled to wake up the thread, if the thread is waiting. The thread will check whether
+    // _shuttingDown is set and stop accordingly.
+    mutable stdx::condition_variable _shuttingDownCV;
+
+    bool _shuttingDown = false;
+};
+
+void startTimeseriesBucketCompactor(ServiceContext* serviceContext) {
+    auto compactor = std::make_unique<TimeseriesBucketCompactor>();
+    compactor->go();
+    TimeseriesBucketCompactor::set(serviceContext, std::move(compactor));
+}
+
+void shutdownTimeseriesBucketCompactor(ServiceContext* serviceContext) {
+    // We allow the compactor not to be set in case shutdown occurs before the thread has been
+    // initialized.
+    if (auto compactor = TimeseriesBucketCompactor::get(serviceContext)) {
+        compactor->shutdown();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/timeseries/flat_bson.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+namespace timeseries {
+
+/**
+ * Adds the field types of 'bucket', as recorded by its control.min and control.max, to 'schema'.
+ * Returns false if they conflict with the types already in 'schema' or with each other, in which
+ * case 'schema' must not be used any further.
+ */
+bool updateSchemaFromBucket(Schema& schema,
+                            const BSONObj& bucket,
+                            const StringData::ComparatorInterface* comparator);
+
+/**
+ * Returns a single uncompressed (v1) bucket holding all measurements of 'buckets', which may each
+ * be compressed or not and must share the same meta value. The result keeps the _id and meta value
+ * of the first bucket, and its control block covers the control.min and control.max values of all
+ * of them, compared using 'comparator'. Returns boost::none if any of the buckets cannot be read,
+ * or if they do not agree on the type of each field, since the merged bucket would otherwise hold
+ * mixed-schema data that queries rewritten against its control block may miss.
+ */
+boost::optional<BSONObj> mergeBuckets(const std::vector<BSONObj>& buckets,
+                                      StringData timeField,
+                                      const StringData::ComparatorInterface* comparator);
+
+/**
+ * Chooses which buckets of a collection to merge. The buckets are fed to it in _id order, and it
+ * tracks for each series the run of adjacent undersized buckets which fit in a single bucket.
+ * A run becomes a merge candidate once a bucket of its series does not fit in it, or when all
+ * runs are flushed, provided it holds more than one bucket.
+ */
+class BucketMergeSelector {
+public:
+    /**
+     * The thresholds deciding whether buckets are merged, read from the server parameters and the
+     * collection options when the buckets are scanned.
+     */
+    struct Limits {
+        // Buckets with at least this many measurements are left alone.
+        int minCount = 0;
+
+        // The bounds on the number of measurements, size and time span of a merged bucket.
+        int maxCount = 0;
+        int maxSize = 0;
+        Seconds maxSpan{0};
+    };
+
+    explicit BucketMergeSelector(StringData timeField) : _timeField(timeField.toString()) {}
+
+    /**
+     * Adds the next bucket of the collection. A bucket which is still open ends the run of its
+     * series, as do buckets which are full, which have a different schema than the run, or which
+     * would make the run exceed 'limits'.
+     */
+    void add(const BSONObj& bucket,
+             bool isOpen,
+             const Limits& limits,
+             const StringData::ComparatorInterface* comparator);
+
+    /**
+     * Ends the runs of all series.
+     */
+    void flushAll();
+
+    /**
+     * Returns the number of series for which a run is being tracked.
+     */
+    size_t numPendingRuns() const {
+        return _runs.size();
+    }
+
+    /**
+     * Returns the _ids of the buckets of each run chosen for merging so far, and forgets them.
+     */
+    std::vector<std::vector<OID>> takeMergeCandidates();
+
+private:
+    /**
+     * A sequence of adjacent, undersized buckets of one series which fit in a single bucket.
+     */
+    struct Run {
+        std::vector<OID> ids;
+        int count = 0;
+        int size = 0;
+        Date_t minTime;
+
+        // The field types of the buckets in the run, which a bucket must agree with to join it.
+        Schema schema;
+    };
+
+    void _flush(Run& run);
+
+    const std::string _timeField;
+    stdx::unordered_map<std::string, Run> _runs;
+    std::vector<std::vector<OID>> _toMerge;
+};
+
+}  // namespace timeseries
+
+/**
+ * Instantiates the background compactor which merges undersized, closed buckets of time-series
+ * collections which share a meta value into larger compressed buckets. Safe to call again after
+ * shutdownTimeseriesBucketCompactor() has been called.
+ */
+void startTimeseriesBucketCompactor(ServiceContext* serviceContext);
+
+/**
+ * Shuts down the background bucket compactor if it is running. Safe to call multiple times.
+ */
+void shutdownTimeseriesBucketCompactor(ServiceContext* serviceContext);
+
+}  // namespace mongo
@@ -0,0 +1,273 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/timeseries/bucket_compaction.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::timeseries {
+namespace {
+
+const BSONObj kFirstBucket = fromjson(
+    "{_id: {$oid: '62a0c5000000000000000000'}, "
+    "control: {version: 1, min: {time: {$date: 1000}, a: 1, b: 'x'}, "
+    "max: {time: {$date: 2000}, a: 5, b: 'x'}}, "
+    "meta: {region: 'eu'}, "
+    "data: {time: {'0': {$date: 1000}, '1': {$date: 2000}}, a: {'0': 1, '1': 5}, b: {'1': 'x'}}}");
+
+const BSONObj kSecondBucket = fromjson(
+    "{_id: {$oid: '62a0c5010000000000000000'}, "
+    "control: {version: 1, min: {time: {$date: 3000}, a: 0, c: true}, "
+    "max: {time: {$date: 4000}, a: 3, c: true}}, "
+    "meta: {region: 'eu'}, "
+    "data: {time: {'0': {$date: 3000}, '1': {$date: 4000}}, a: {'0': 0, '1': 3}, c: {'0': true}}}");
+
+const BSONObj kMergedBucket = fromjson(
+    "{_id: {$oid: '62a0c5000000000000000000'}, "
+    "control: {version: 1, min: {time: {$date: 1000}, a: 0, b: 'x', c: true}, "
+    "max: {time: {$date: 4000}, a: 5, b: 'x', c: true}}, "
+    "meta: {region: 'eu'}, "
+    "data: {time: {'0': {$date: 1000}, '1': {$date: 2000}, '2': {$date: 3000}, "
+    "'3': {$date: 4000}}, a: {'0': 1, '1': 5, '2': 0, '3': 3}, b: {'1': 'x'}, c: {'2': true}}}");
+
+TEST(BucketCompaction, MergeUncompressedBuckets) {
+    auto merged = mergeBuckets({kFirstBucket, kSecondBucket}, "time"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, kMergedBucket);
+}
+
+TEST(BucketCompaction, MergeCompressedBuckets) {
+    auto firstCompressed = compressBucket(kFirstBucket, "time"_sd, {}, true).compressedBucket;
+    auto secondCompressed = compressBucket(kSecondBucket, "time"_sd, {}, true).compressedBucket;
+    ASSERT(firstCompressed);
+    ASSERT(secondCompressed);
+
+    auto merged = mergeBuckets({*firstCompressed, kSecondBucket}, "time"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, kMergedBucket);
+
+    merged = mergeBuckets({*firstCompressed, *secondCompressed}, "time"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, kMergedBucket);
+}
+
+TEST(BucketCompaction, MergeSingleBucketIsIdentity) {
+    auto merged = mergeBuckets({kFirstBucket}, "time"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, kFirstBucket);
+}
+
+TEST(BucketCompaction, MergeFailsOnMissingTimeField) {
+    auto bucket = fromjson("{_id: 1, control: {version: 1}, data: {a: {'0': 1}}}");
+    ASSERT_FALSE(mergeBuckets({kFirstBucket, bucket}, "time"_sd, nullptr));
+}
+
+TEST(BucketCompaction, MergeFailsOnConflictingFieldTypes) {
+    // 'b' holds strings in the first bucket and a number here.
+    auto bucket = fromjson(
+        "{_id: {$oid: '62a0c5010000000000000000'}, "
+        "control: {version: 1, min: {time: {$date: 3000}, b: 1}, "
+        "max: {time: {$date: 3000}, b: 1}}, "
+        "meta: {region: 'eu'}, data: {time: {'0': {$date: 3000}}, b: {'0': 1}}}");
+    ASSERT_FALSE(mergeBuckets({kFirstBucket, bucket}, "time"_sd, nullptr));
+    ASSERT_FALSE(mergeBuckets({bucket, kFirstBucket}, "time"_sd, nullptr));
+
+    // Numeric types are compatible with each other.
+    auto doubles = fromjson(
+        "{_id: {$oid: '62a0c5010000000000000000'}, "
+        "control: {version: 1, min: {time: {$date: 3000}, a: 0.5}, "
+        "max: {time: {$date: 3000}, a: 0.5}}, "
+        "meta: {region: 'eu'}, data: {time: {'0': {$date: 3000}}, a: {'0': 0.5}}}");
+    ASSERT(mergeBuckets({kFirstBucket, doubles}, "time"_sd, nullptr));
+}
+
+TEST(BucketCompaction, UpdateSchemaFromBucket) {
+    Schema schema;
+    ASSERT_TRUE(updateSchemaFromBucket(schema, kFirstBucket, nullptr));
+    ASSERT_TRUE(updateSchemaFromBucket(schema, kSecondBucket, nullptr));
+
+    // A bucket whose own control.min and control.max disagree already holds mixed-schema data.
+    auto mixed = fromjson(
+        "{control: {version: 1, min: {time: {$date: 1000}, a: 1}, "
+        "max: {time: {$date: 1000}, a: 'x'}}}");
+    Schema fresh;
+    ASSERT_FALSE(updateSchemaFromBucket(fresh, mixed, nullptr));
+}
+
+TEST(BucketCompaction, DecompressRoundTrip) {
+    auto compressed = compressBucket(kMergedBucket, "time"_sd, {}, true).compressedBucket;
+    ASSERT(compressed);
+
+    auto decompressed = decompressBucket(*compressed);
+    ASSERT(decompressed);
+
+    // The control block loses its count, but the field order of the data region is preserved.
+    ASSERT_BSONOBJ_EQ(*decompressed, kMergedBucket);
+}
+
+const BucketMergeSelector::Limits kLimits{10 /* minCount */,
+                                          1000 /* maxCount */,
+                                          1024 * 1024 /* maxSize */,
+                                          Seconds(3600) /* maxSpan */};
+
+/**
+ * Returns an uncompressed bucket of the series 'region' with 'count' measurements taken every
+ * second from 'startSecs', holding a field 'a' which is a number or, if 'strings', a string.
+ */
+BSONObj makeBucket(const OID& id,
+                   StringData region,
+                   int startSecs,
+                   int count,
+                   bool strings = false) {
+    auto value = [&](int i) {
+        return strings ? BSON("a" << std::to_string(i)) : BSON("a" << i);
+    };
+    auto startTime = Date_t::fromMillisSinceEpoch(startSecs * 1000LL);
+    auto endTime = startTime + Seconds(count - 1);
+
+    BSONObjBuilder builder;
+    builder.append("_id", id);
+    {
+        BSONObjBuilder control(builder.subobjStart("control"));
+        control.append("version", 1);
+        control.append("min", BSON("time" << startTime).addFields(value(0)));
+        control.append("max", BSON("time" << endTime).addFields(value(count - 1)));
+    }
+    builder.append("meta", BSON("region" << region));
+    {
+        BSONObjBuilder data(builder.subobjStart("data"));
+        BSONObjBuilder time(data.subobjStart("time"));
+        BSONObjBuilder a;
+        for (int i = 0; i < count; ++i) {
+            time.append(std::to_string(i), startTime + Seconds(i));
+            a.appendAs(value(i).firstElement(), std::to_string(i));
+        }
+        time.done();
+        data.append("a", a.obj());
+    }
+    return builder.obj();
+}
+
+class BucketMergeSelectorTest : public unittest::Test {
+protected:
+    /**
+     * Feeds a new bucket made by makeBucket() to the selector and returns its _id.
+     */
+    OID add(StringData region, int startSecs, int count, bool strings = false, bool open = false) {
+        auto id = OID::gen();
+        _selector.add(makeBucket(id, region, startSecs, count, strings), open, limits, nullptr);
+        return id;
+    }
+
+    void addRaw(const BSONObj& bucket) {
+        _selector.add(bucket, false, limits, nullptr);
+    }
+
+    /**
+     * Flushes all runs and returns the candidates the selector chose.
+     */
+
+    std::vector<std::vector<OID>> finish() {
+        _selector.flushAll();
+        return _selector.takeMergeCandidates();
+    }
+
+    BucketMergeSelector::Limits limits = kLimits;
+
+private:
+    BucketMergeSelector _selector{"time"_sd};
+};
+
+TEST_F(BucketMergeSelectorTest, MergesAdjacentUndersizedBucketsOfEachSeries) {
+    auto eu1 = add("eu", 0, 2);
+    add("us", 0, 2);
+    auto eu2 = add("eu", 10, 2);
+    auto eu3 = add("eu", 20, 2);
+
+    // The single bucket of the other series is not worth merging.
+    std::vector<std::vector<OID>> expected{{eu1, eu2, eu3}};
+    ASSERT(finish() == expected);
+}
+
+TEST_F(BucketMergeSelectorTest, FullAndOpenBucketsEndTheRun) {
+    auto first = add("eu", 0, 2);
+    auto second = add("eu", 10, 2);
+    add("eu", 20, kLimits.minCount);
+    add("eu", 40, 2);
+    add("eu", 50, 2, false /* strings */, true /* open */);
+    add("eu", 60, 2);
+
+    std::vector<std::vector<OID>> expected{{first, second}};
+    ASSERT(finish() == expected);
+}
+
+TEST_F(BucketMergeSelectorTest, RunsFitInOneBucket) {
+    // The merged bucket may hold at most 'maxCount' measurements.
+    limits.maxCount = 5;
+    auto first = add("eu", 0, 2);
+    auto second = add("eu", 10, 3);
+    auto third = add("eu", 20, 2);
+    auto fourth = add("eu", 30, 2);
+
+    // The merged bucket may span at most 'maxSpan'.
+    limits = kLimits;
+    limits.maxSpan = Seconds(100);
+    auto fifth = add("eu", 1000, 2);
+    auto sixth = add("eu", 1098, 2);
+    add("eu", 1100, 2);
+
+    std::vector<std::vector<OID>> expected{{first, second}, {third, fourth}, {fifth, sixth}};
+    ASSERT(finish() == expected);
+}
+
+TEST_F(BucketMergeSelectorTest, RunsShareOneSchema) {
+    add("eu", 0, 2);
+    auto first = add("eu", 10, 2, true /* strings */);
+    auto second = add("eu", 20, 2, true /* strings */);
+
+    std::vector<std::vector<OID>> expected{{first, second}};
+    ASSERT(finish() == expected);
+}
+
+TEST_F(BucketMergeSelectorTest, SkipsUnknownBucketFormats) {
+    auto first = add("eu", 0, 2);
+    addRaw(fromjson("{_id: 1, control: {version: 3}, meta: {region: 'eu'}}"));
+    auto second = add("eu", 10, 2);
+
+    std::vector<std::vector<OID>> expected{{first, second}};
+    ASSERT(finish() == expected);
+}
+
+}  // namespace
+}  // namespace mongo::timeseries
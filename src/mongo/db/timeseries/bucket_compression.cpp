@@ -38,6 +38,7 @@
 #include "mongo/db/timeseries/timeseries_constants.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/decimal_counter.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -342,5 +343,56 @@ CompressionResult compressBucket(const BSONObj& bucketDoc,
     return {};
 }
 
+boost::optional<BSONObj> decompressBucket(const BSONObj& bucketDoc) try {
+    BSONObjBuilder builder;
+
+    for (auto&& elem : bucketDoc) {
+        // Rewrite the control block with the uncompressed version and without the count, which
+        // uncompressed buckets derive from the time field.
+        if (elem.fieldNameStringData() == kBucketControlFieldName) {
+            BSONObjBuilder control(builder.subobjStart(kBucketControlFieldName));
+            for (auto&& controlField : elem.Obj()) {
+                if (controlField.fieldNameStringData() == kBucketControlVersionFieldName) {
+                    control.append(kBucketControlVersionFieldName,
+                                   kTimeseriesControlDefaultVersion);
+                } else if (controlField.fieldNameStringData() != kBucketControlCountFieldName) {
+                    control.append(controlField);
+                }
+            }
+            continue;
+        }
+
+        if (elem.fieldNameStringData() != kBucketDataFieldName) {
+            builder.append(elem);
+            continue;
+        }
+
+        BSONObjBuilder dataBuilder(builder.subobjStart(kBucketDataFieldName));
+        for (auto&& columnElem : elem.Obj()) {
+            if (columnElem.type() != BSONType::BinData) {
+                return boost::none;
+            }
+
+            BSONObjBuilder columnBuilder(dataBuilder.subobjStart(columnElem.fieldNameStringData()));
+            DecimalCounter<uint32_t> index;
+            for (auto&& value : BSONColumn(columnElem)) {
+                // Missing values are stored as EOO in the column.
+                if (!value.eoo()) {
+                    columnBuilder.appendAs(value, index);
+                }
+                ++index;
+            }
+        }
+    }
+
+    return builder.obj();
+} catch (...) {
+    LOGV2_DEBUG(7803600,
+                1,
+                "Exception when decompressing timeseries bucket",
+                "error"_attr = exceptionToStatus());
+    return boost::none;
+}
+
 }  // namespace timeseries
 }  // namespace mongo
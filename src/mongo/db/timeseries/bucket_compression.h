@@ -60,5 +60,12 @@ CompressionResult compressBucket(const BSONObj& bucketDoc,
                                  const NamespaceString& nss,
                                  bool validateDecompression);
 
+/**
+ * Returns a decompressed timeseries bucket in v1 format for a given compressed v2 bucket. Data
+ * fields are keyed by measurement index in the order in which the measurements are stored, and
+ * missing values are omitted. Returns boost::none if the bucket could not be decompressed.
+ */
+boost::optional<BSONObj> decompressBucket(const BSONObj& bucketDoc);
+
 }  // namespace timeseries
 }  // namespace mongo
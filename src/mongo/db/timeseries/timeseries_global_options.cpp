@@ -27,6 +27,9 @@
  *    it in the license file.
  */
 
+#include "mongo/db/timeseries/timeseries_global_options.h"
+
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/util/processinfo.h"
 
 namespace mongo {
@@ -51,4 +54,21 @@ uint64_t getTimeseriesIdleBucketExpiryMemoryUsageThresholdBytes() {
     return systemBasedValue;
 }
 
+std::size_t getTimeseriesBucketCatalogNumStripes() {
+    if (gTimeseriesBucketCatalogNumStripes > 0) {
+        return static_cast<std::size_t>(gTimeseriesBucketCatalogNumStripes);
+    }
+
+    // Use a power of two of at least twice the number of cores, so that concurrent writers to
+    // different buckets rarely contend on the same stripe, but never fewer than the 32 stripes
+    // the catalog has historically used.
+    static constexpr std::size_t kMinStripes = 32;
+    static constexpr std::size_t kMaxStripes = 1024;
+    std::size_t numStripes = kMinStripes;
+    while (numStripes < 2 * ProcessInfo::getNumAvailableCores() && numStripes < kMaxStripes) {
+        numStripes *= 2;
+    }
+    return numStripes;
+}
+
 }  // namespace mongo
@@ -36,4 +36,11 @@ namespace mongo {
 extern AtomicWord<long long> gTimeseriesIdleBucketExpiryMemoryUsageThresholdBytes;
 uint64_t getTimeseriesIdleBucketExpiryMemoryUsageThresholdBytes();
 
+/**
+ * Returns the number of stripes the bucket catalog should use: the configured value of
+ * 'timeseriesBucketCatalogNumStripes' if positive, otherwise a power of two scaled to the number of
+ * available cores.
+ */
+std::size_t getTimeseriesBucketCatalogNumStripes();
+
 }  // namespace mongo
@@ -75,6 +75,10 @@ static ServerStatusMetricField<Counter64> gleDefaultUnsatisfiableDisplay(
 
 MONGO_FAIL_POINT_DEFINE(hangBeforeWaitingForWriteConcern);
 
+// Set when the journal was already flushed for the operation's write concern, and cleared by the
+// next write concern wait, which then skips its own flush.
+const auto journalFlushedForWriteConcern = OperationContext::declareDecoration<bool>();
+
 bool commandSpecifiesWriteConcern(const BSONObj& cmdObj) {
     return cmdObj.hasField(WriteConcernOptions::kWriteConcernField);
 }
@@ -262,6 +266,25 @@ void waitForNoOplogHolesIfNeeded(OperationContext* opCtx) {
     }
 }
 
+boost::optional<SharedSemiFuture<void>> requestJournalFlushForWriteConcern(
+    OperationContext* opCtx, const WriteConcernOptions& writeConcern) {
+    auto* const storageEngine = opCtx->getServiceContext()->getStorageEngine();
+    const auto syncMode = repl::ReplicationCoordinator::get(opCtx)
+                              ->populateUnsetWriteConcernOptionsSyncMode(writeConcern)
+                              .syncMode;
+    if (syncMode != WriteConcernOptions::SyncMode::JOURNAL &&
+        !(syncMode == WriteConcernOptions::SyncMode::FSYNC && storageEngine->isDurable())) {
+        return boost::none;
+    }
+
+    waitForNoOplogHolesIfNeeded(opCtx);
+    return JournalFlusher::get(opCtx)->requestJournalFlush();
+}
+
+void setJournalFlushedForWriteConcern(OperationContext* opCtx) {
+    journalFlushedForWriteConcern(opCtx) = true;
+}
+
 Status waitForWriteConcern(OperationContext* opCtx,
                            const OpTime& replOpTime,
                            const WriteConcernOptions& writeConcern,
@@ -291,6 +314,7 @@ Status waitForWriteConcern(OperationContext* opCtx,
     Timer syncTimer;
     WriteConcernOptions writeConcernWithPopulatedSyncMode =
         replCoord->populateUnsetWriteConcernOptionsSyncMode(writeConcern);
+    const bool journalFlushed = std::exchange(journalFlushedForWriteConcern(opCtx), false);
 
     // Waiting for durability (flushing the journal or all files to disk) can throw on interruption.
     try {
@@ -308,15 +332,17 @@ Status waitForWriteConcern(OperationContext* opCtx,
                     // This field has had a dummy value since MMAP went away. It is undocumented.
                     // Maintaining it so as not to cause unnecessary user pain across upgrades.
                     result->fsyncFiles = 1;
-                } else {
+                } else if (!journalFlushed) {
                     // We only need to commit the journal if we're durable
                     JournalFlusher::get(opCtx)->waitForJournalFlush();
                 }
                 break;
             }
             case WriteConcernOptions::SyncMode::JOURNAL:
-                waitForNoOplogHolesIfNeeded(opCtx);
-                JournalFlusher::get(opCtx)->waitForJournalFlush();
+                if (!journalFlushed) {
+                    waitForNoOplogHolesIfNeeded(opCtx);
+                    JournalFlusher::get(opCtx)->waitForJournalFlush();
+                }
                 break;
         }
     } catch (const DBException& ex) {
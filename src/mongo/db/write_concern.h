@@ -31,6 +31,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/util/future.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -108,5 +109,21 @@ Status waitForWriteConcern(OperationContext* opCtx,
                            const WriteConcernOptions& writeConcern,
                            WriteConcernResult* result);
 
+/**
+ * Requests the journal flush that waiting for 'writeConcern' would block on, without waiting for
+ * it. Returns boost::none if 'writeConcern' does not call for a journal flush, and otherwise a
+ * future that becomes ready once the journal has been flushed. Continuations that are run inline
+ * on it run on the journal flusher thread.
+ *
+ * Can throw on opCtx interruption.
+ */
+boost::optional<SharedSemiFuture<void>> requestJournalFlushForWriteConcern(
+    OperationContext* opCtx, const WriteConcernOptions& writeConcern);
+
+/**
+ * Records that the journal has been flushed since the operation last wrote, so that the next
+ * waitForWriteConcern() call for 'opCtx' does not flush it again.
+ */
+void setJournalFlushedForWriteConcern(OperationContext* opCtx);
 
 }  // namespace mongo
@@ -213,6 +213,34 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentInsert) {
     assertMultikeyPaths(collection.getCollection(), keyPattern, {{0U}, {0U}});
 }
 
+TEST_F(MultikeyPathsTest, PathsUpdatedOnBatchedDocumentInsert) {
+    AutoGetCollection collection(_opCtx.get(), _nss, MODE_X);
+    invariant(collection);
+
+    BSONObj keyPattern = BSON("a" << 1 << "b" << 1);
+    createIndex(collection.getCollection(),
+                BSON("name"
+                     << "a_1_b_1"
+                     << "key" << keyPattern << "v" << static_cast<int>(kIndexVersion)))
+        .transitional_ignore();
+
+    // The keys of a whole batch are inserted together, but each document contributes its own
+    // multikey paths.
+    std::vector<InsertStatement> batch{
+        InsertStatement(BSON("_id" << 0 << "a" << 5 << "b" << 5)),
+        InsertStatement(BSON("_id" << 1 << "a" << 5 << "b" << BSON_ARRAY(1 << 2 << 3))),
+        InsertStatement(BSON("_id" << 2 << "a" << BSON_ARRAY(1 << 2 << 3) << "b" << 5))};
+    {
+        WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        ASSERT_OK(
+            collection->insertDocuments(_opCtx.get(), batch.begin(), batch.end(), nullOpDebug));
+        wuow.commit();
+    }
+
+    assertMultikeyPaths(collection.getCollection(), keyPattern, {{0U}, {0U}});
+}
+
 TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
     AutoGetCollection collection(_opCtx.get(), _nss, MODE_X);
     invariant(collection);
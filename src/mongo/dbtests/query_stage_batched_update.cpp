@@ -0,0 +1,316 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/batched_update_stage.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/json.h"
+#include "mongo/db/ops/update_request.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/update/update_driver.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace QueryStageBatchedUpdate {
+
+static const NamespaceString nss("unittests.QueryStageBatchedUpdate");
+
+// For the following tests, fix the targetBatchDocs to 10 documents.
+static const int targetBatchDocs = 10;
+
+class QueryStageBatchedUpdateTest : public unittest::Test {
+public:
+    QueryStageBatchedUpdateTest() : _client(&_opCtx) {}
+
+    virtual ~QueryStageBatchedUpdateTest() {
+        _client.dropCollection(nss.ns());
+    }
+
+    // Populates the collection with nDocs of shape {_id: <int i>, a: <int i>}.
+    void prePopulateCollection(int nDocs) {
+        for (int i = 0; i < nDocs; i++) {
+            _client.insert(nss.ns(), BSON("_id" << i << "a" << i));
+        }
+    }
+
+    void remove(const BSONObj& obj) {
+        _client.remove(nss.ns(), obj);
+    }
+
+    void update(const BSONObj& query, const BSONObj& updateSpec) {
+        _client.update(nss.ns(), query, updateSpec);
+    }
+
+    size_t count(const BSONObj& query) {
+        return _client.count(nss, query, 0, 0, 0);
+    }
+
+    std::unique_ptr<CanonicalQuery> canonicalize(const BSONObj& query) {
+        auto findCommand = std::make_unique<FindCommandRequest>(nss);
+        findCommand->setFilter(query);
+        auto statusWithCQ = CanonicalQuery::canonicalize(&_opCtx, std::move(findCommand));
+        ASSERT_OK(statusWithCQ.getStatus());
+        return std::move(statusWithCQ.getValue());
+    }
+
+    // Builds a BatchedUpdateStage over a forward collection scan filtered by 'query', applying
+    // 'updateSpec' to every matching document.
+    std::unique_ptr<BatchedUpdateStage> makeBatchedUpdateStage(WorkingSet* ws,
+                                                               const CollectionPtr& coll,
+                                                               const BSONObj& query,
+                                                               const BSONObj& updateSpec) {
+        _request.setNamespaceString(nss);
+        _request.setMulti();
+        _request.setQuery(query);
+        _request.setUpdateModification(
+            write_ops::UpdateModification::parseFromClassicUpdate(updateSpec));
+
+        const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+        _driver.parse(
+            _request.getUpdateModification(), arrayFilters, boost::none, _request.isMulti());
+
+        _cq = canonicalize(query);
+        UpdateStageParams updateParams(&_request, &_driver, &CurOp::get(_opCtx)->debug());
+        updateParams.canonicalQuery = _cq.get();
+
+        auto batchParams = std::make_unique<BatchedUpdateStageBatchParams>();
+        batchParams->targetBatchDocs = targetBatchDocs;
+        batchParams->targetBatchBytes = 0;
+        batchParams->targetBatchTimeMS = Milliseconds(0);
+
+        CollectionScanParams collScanParams;
+        return std::make_unique<BatchedUpdateStage>(
+            _expCtx.get(),
+            updateParams,
+            std::move(batchParams),
+            ws,
+            coll,
+            new CollectionScan(_expCtx.get(), coll, collScanParams, ws, _cq->root()));
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _opCtxPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_opCtxPtr;
+
+    boost::intrusive_ptr<ExpressionContext> _expCtx =
+        make_intrusive<ExpressionContext>(&_opCtx, nullptr, nss);
+
+private:
+    DBDirectClient _client;
+
+    // The update request, driver and query must outlive the stage built from them.
+    UpdateRequest _request;
+    UpdateDriver _driver{_expCtx};
+    std::unique_ptr<CanonicalQuery> _cq;
+};
+
+// Confirms batched updates wait until a batch meets the targetBatchDocs before updating documents.
+TEST_F(QueryStageBatchedUpdateTest, BatchedUpdateTargetBatchDocsBasic) {
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto nDocs = 52;
+    prePopulateCollection(nDocs);
+
+    const CollectionPtr& coll = ctx.getCollection();
+    ASSERT(coll);
+
+    WorkingSet ws;
+    auto updateStage =
+        makeBatchedUpdateStage(&ws, coll, BSONObj(), fromjson("{$set: {updated: true}}"));
+    const UpdateStats* stats = static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    while ((state = updateStage->work(&id)) != PlanStage::IS_EOF) {
+        ASSERT_EQUALS(state, PlanStage::NEED_TIME);
+
+        // Documents are only updated once a full batch has been staged.
+        ASSERT_EQUALS(stats->nModified % targetBatchDocs, 0U);
+        ASSERT_EQUALS(count(BSON("updated" << true)), stats->nModified);
+    }
+
+    // The last 2 documents are updated when the child reaches EOF.
+    ASSERT_EQUALS(stats->nMatched, static_cast<size_t>(nDocs));
+    ASSERT_EQUALS(stats->nModified, static_cast<size_t>(nDocs));
+    ASSERT_EQUALS(count(BSON("updated" << true)), static_cast<size_t>(nDocs));
+}
+
+// Unversioned writes on a shard may update orphaned documents as 'fromMigrate' writes, so they are
+// not batched.
+TEST_F(QueryStageBatchedUpdateTest, UnversionedWritesOnShardsAreNotBatched) {
+    RAIIServerParameterControllerForTest batchedUpdates("batchedUpdatesEnabled", true);
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    prePopulateCollection(1);
+    const CollectionPtr& coll = ctx.getCollection();
+    ASSERT(coll);
+
+    UpdateRequest request;
+    request.setNamespaceString(nss);
+    request.setMulti();
+    UpdateStageParams params(&request, nullptr, nullptr);
+    ASSERT_TRUE(BatchedUpdateStage::isBatchedUpdateEligible(&_opCtx, params, coll));
+
+    const auto clusterRole = serverGlobalParams.clusterRole;
+    serverGlobalParams.clusterRole = ClusterRole::ShardServer;
+    ON_BLOCK_EXIT([&] { serverGlobalParams.clusterRole = clusterRole; });
+    ASSERT_FALSE(BatchedUpdateStage::isBatchedUpdateEligible(&_opCtx, params, coll));
+}
+
+// A staged document is removed while the BatchedUpdateStage is in a saved state. Upon restoring
+// its state, the stage's snapshot changes and it skips over the missing document.
+TEST_F(QueryStageBatchedUpdateTest, BatchedUpdateStagedDocIsDeleted) {
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto nDocs = 11;
+    prePopulateCollection(nDocs);
+
+    const CollectionPtr& coll = ctx.getCollection();
+    ASSERT(coll);
+
+    WorkingSet ws;
+    auto updateStage =
+        makeBatchedUpdateStage(&ws, coll, BSONObj(), fromjson("{$set: {updated: true}}"));
+    const UpdateStats* stats = static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+    // Index to pause at before fetching the remaining documents into the update batch.
+    int pauseBatchingIdx = 6;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    for (int i = 0; i < pauseBatchingIdx; i++) {
+        ASSERT_EQUALS(updateStage->work(&id), PlanStage::NEED_TIME);
+        ASSERT_EQUALS(stats->nModified, 0U);
+    }
+
+    {
+        // Delete a document that has already been added to the update batch.
+        updateStage->saveState();
+        remove(BSON("_id" << pauseBatchingIdx - 2));
+        // Increases the snapshotId.
+        updateStage->restoreState(&coll);
+    }
+
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while ((state = updateStage->work(&id)) != PlanStage::IS_EOF) {
+        ASSERT_EQUALS(state, PlanStage::NEED_TIME);
+    }
+
+    ASSERT_EQUALS(stats->nModified, static_cast<size_t>(nDocs - 1));
+    ASSERT_EQUALS(count(BSON("updated" << true)), static_cast<size_t>(nDocs - 1));
+}
+
+// One of the staged documents is updated to no longer match the query, and the stage changes
+// snapshots before applying the batch. The document must be re-matched and left untouched.
+TEST_F(QueryStageBatchedUpdateTest, BatchedUpdateStagedDocIsUpdatedToNotMatch) {
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto nDocs = 11;
+    prePopulateCollection(nDocs);
+
+    const CollectionPtr& coll = ctx.getCollection();
+    ASSERT(coll);
+
+    // Only update documents whose 'a' field is greater than or equal to 0.
+    WorkingSet ws;
+    auto updateStage = makeBatchedUpdateStage(
+        &ws, coll, BSON("a" << BSON("$gte" << 0)), fromjson("{$set: {updated: true}}"));
+    const UpdateStats* stats = static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+    // Index to pause at before fetching the remaining documents into the update batch.
+    int pauseBatchingIdx = 6;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    for (int i = 0; i < pauseBatchingIdx; i++) {
+        ASSERT_EQUALS(updateStage->work(&id), PlanStage::NEED_TIME);
+        ASSERT_EQUALS(stats->nModified, 0U);
+    }
+
+    {
+        // Update a staged document so it no longer matches the update query.
+        updateStage->saveState();
+        update(BSON("_id" << 2), BSON("a" << -1));
+        // Increases the snapshotId.
+        updateStage->restoreState(&coll);
+    }
+
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while ((state = updateStage->work(&id)) != PlanStage::IS_EOF) {
+        ASSERT_EQUALS(state, PlanStage::NEED_TIME);
+    }
+
+    ASSERT_EQUALS(stats->nMatched, static_cast<size_t>(nDocs - 1));
+    ASSERT_EQUALS(stats->nModified, static_cast<size_t>(nDocs - 1));
+    ASSERT_EQUALS(count(BSON("updated" << true)), static_cast<size_t>(nDocs - 1));
+    ASSERT_EQUALS(count(BSON("_id" << 2 << "a" << -1)), 1U);
+}
+
+// A write conflict while applying a batch rolls back the whole batch, including its stats, and the
+// batch is retried after yielding.
+TEST_F(QueryStageBatchedUpdateTest, BatchedUpdateWriteConflictRetriesBatch) {
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto nDocs = 10;
+    prePopulateCollection(nDocs);
+
+    const CollectionPtr& coll = ctx.getCollection();
+    ASSERT(coll);
+
+    WorkingSet ws;
+    auto updateStage = makeBatchedUpdateStage(&ws, coll, BSONObj(), fromjson("{$inc: {a: 1}}"));
+    const UpdateStats* stats = static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    {
+        FailPointEnableBlock fp("throwWriteConflictExceptionInBatchedUpdateStage");
+        while ((state = updateStage->work(&id)) == PlanStage::NEED_TIME) {
+        }
+        ASSERT_EQUALS(state, PlanStage::NEED_YIELD);
+        ASSERT_EQUALS(stats->nMatched, 0U);
+        ASSERT_EQUALS(stats->nModified, 0U);
+    }
+
+    while ((state = updateStage->work(&id)) != PlanStage::IS_EOF) {
+        ASSERT_EQUALS(state, PlanStage::NEED_TIME);
+    }
+
+    // Every document was incremented exactly once.
+    ASSERT_EQUALS(stats->nModified, static_cast<size_t>(nDocs));
+    for (int i = 0; i < nDocs; i++) {
+        ASSERT_EQUALS(count(BSON("_id" << i << "a" << i + 1)), 1U);
+    }
+}
+
+}  // namespace QueryStageBatchedUpdate
+}  // namespace mongo
@@ -47,6 +47,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/idl/server_parameter_test_util.h"
 
 namespace QueryStageFetch {
 
@@ -226,6 +227,166 @@ public:
     }
 };
 
+//
+// Test that batched fetching returns documents in the order the child produced them.
+//
+class FetchStageBatched : public QueryStageFetchBase {
+public:
+    void run() {
+        RAIIServerParameterControllerForTest controller("internalQueryFetchBatchSize", 4);
+
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        CollectionPtr coll =
+            CollectionCatalog::get(&_opCtx)->lookupCollectionByNamespace(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int nDocs = 6;
+        for (int i = 0; i < nDocs; ++i) {
+            insert(BSON("_id" << i));
+        }
+        set<RecordId> recordIdSet;
+        getRecordIds(&recordIdSet, coll);
+        ASSERT_EQUALS(size_t(nDocs), recordIdSet.size());
+        std::vector<RecordId> recordIds(recordIdSet.begin(), recordIdSet.end());
+
+        // Remove the document with the third RecordId, whose index entry is then dangling.
+        BSONObj removedDoc = coll->docFor(&_opCtx, recordIds[2]).value().getOwned();
+        remove(removedDoc);
+
+        // Produce the RecordIds in reverse order, followed by an already fetched document.
+        auto mockStage = std::make_unique<QueuedDataStage>(_expCtx.get(), &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+        {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->doc = {SnapshotId(), Document{BSON("_id" << nDocs)}};
+            mockMember->transitionToOwnedObj();
+            mockStage->pushBack(id);
+        }
+
+        auto fetchStage =
+            std::make_unique<FetchStage>(_expCtx.get(), &ws, std::move(mockStage), nullptr, coll);
+
+        std::vector<BSONObj> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (state == PlanStage::ADVANCED) {
+                results.push_back(ws.get(id)->doc.value().toBson().getOwned());
+            }
+        }
+
+        std::vector<BSONObj> expected;
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            if (*it != recordIds[2]) {
+                expected.push_back(coll->docFor(&_opCtx, *it).value());
+            }
+        }
+        expected.push_back(BSON("_id" << nDocs));
+
+        ASSERT_EQUALS(expected.size(), results.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(expected[i], results[i]);
+        }
+
+        const FetchStats* stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(1), stats->alreadyHasObj);
+    }
+};
+
+//
+// Test that yielding in the middle of a batch leaves the buffered documents owned.
+//
+class FetchStageBatchedYield : public QueryStageFetchBase {
+public:
+    void run() {
+        RAIIServerParameterControllerForTest controller("internalQueryFetchBatchSize", 4);
+
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        CollectionPtr coll =
+            CollectionCatalog::get(&_opCtx)->lookupCollectionByNamespace(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int nDocs = 6;
+        for (int i = 0; i < nDocs; ++i) {
+            insert(BSON("_id" << i));
+        }
+        set<RecordId> recordIdSet;
+        getRecordIds(&recordIdSet, coll);
+        ASSERT_EQUALS(size_t(nDocs), recordIdSet.size());
+
+        // Every other member already has an unowned copy of its document, the others need to be
+        // fetched.
+        std::vector<BSONObj> docs;
+        std::vector<WorkingSetID> ids;
+        auto mockStage = std::make_unique<QueuedDataStage>(_expCtx.get(), &ws);
+        for (auto&& recordId : recordIdSet) {
+            docs.push_back(coll->docFor(&_opCtx, recordId).value().getOwned());
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* member = ws.get(id);
+            member->recordId = recordId;
+            if (ids.size() % 2 == 0) {
+                member->doc = {SnapshotId(), Document{BSONObj(docs.back().objdata())}};
+                ws.transitionToRecordIdAndObj(id);
+                ASSERT_FALSE(member->doc.value().isOwned());
+            } else {
+                ws.transitionToRecordIdAndIdx(id);
+            }
+            ids.push_back(id);
+            mockStage->pushBack(id);
+        }
+
+        auto fetchStage =
+            std::make_unique<FetchStage>(_expCtx.get(), &ws, std::move(mockStage), nullptr, coll);
+
+        std::vector<BSONObj> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::ADVANCED) {
+            ASSERT_NOT_EQUALS(PlanStage::IS_EOF, state);
+        }
+        ASSERT_EQUALS(ids[0], id);
+        results.push_back(ws.get(id)->doc.value().toBson().getOwned());
+
+        // The rest of the first batch is buffered in the stage across the yield.
+        fetchStage->saveState();
+        for (size_t i = 1; i < 4; ++i) {
+            ASSERT_TRUE(ws.get(ids[i])->doc.value().isOwned()) << i;
+        }
+        fetchStage->restoreState(&coll);
+
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (state == PlanStage::ADVANCED) {
+                results.push_back(ws.get(id)->doc.value().toBson().getOwned());
+            }
+        }
+
+        ASSERT_EQUALS(docs.size(), results.size());
+        for (size_t i = 0; i < docs.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(docs[i], results[i]);
+        }
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_fetch") {}
@@ -233,6 +394,8 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatched>();
+        add<FetchStageBatchedYield>();
     }
 };
 
@@ -61,6 +61,9 @@ struct OpMsg {
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
     static constexpr uint32_t kExhaustSupported = 1 << 16;
+    // The client tolerates responses to this request arriving out of order, interleaved with
+    // responses to other requests sent with this flag on the same connection.
+    static constexpr uint32_t kPipelineSupported = 1 << 17;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
@@ -1401,5 +1401,188 @@ TEST(OpMsg, HelloOkCanBeDisabled) {
     ASSERT(!isHelloOk);
 }
 
+TEST(OpMsg, PipelinedReadsAreFollowedByNonPipelinedRequestResponses) {
+    auto conn = getIntegrationTestConnection();
+
+    // Pipelining is only implemented by mongod.
+    if (conn->isMongos()) {
+        return;
+    }
+
+    NamespaceString nss("test", "coll");
+
+    conn->dropCollection(nss.toString());
+    for (int i = 0; i < 5; i++) {
+        conn->insert(nss.toString(), BSON("_id" << i));
+    }
+
+    // Send a pipelined find and, without waiting for its response, an insert. The insert cannot
+    // be pipelined, so it must not run until the find has responded.
+    auto find = OpMsgRequest::fromDBAndBody(
+                    nss.db(), BSON("find" << nss.coll() << "sort" << BSON("_id" << 1)))
+                    .serialize();
+    OpMsg::setFlag(&find, OpMsg::kPipelineSupported);
+    conn->say(find);
+    const auto findId = find.header().getId();
+
+    auto insert = OpMsgRequest::fromDBAndBody(
+                      nss.db(),
+                      BSON("insert" << nss.coll() << "documents" << BSON_ARRAY(BSON("_id" << 5))))
+                      .serialize();
+    conn->say(insert);
+    const auto insertId = insert.header().getId();
+
+    Message reply;
+    ASSERT_OK(conn->recv(reply, findId));
+    auto res = OpMsg::parse(reply).body;
+    ASSERT_OK(getStatusFromCommandResult(res));
+    ASSERT_EQ(res["cursor"]["firstBatch"].Array().size(), 5U);
+
+    ASSERT_OK(conn->recv(reply, insertId));
+    res = OpMsg::parse(reply).body;
+    ASSERT_OK(getStatusFromCommandResult(res));
+    ASSERT_EQ(res["n"].numberInt(), 1);
+}
+
+Message makePipelinedFind(const NamespaceString& nss, StringData comment) {
+    auto find = OpMsgRequest::fromDBAndBody(
+                    nss.db(), BSON("find" << nss.coll() << "comment" << comment))
+                    .serialize();
+    OpMsg::setFlag(&find, OpMsg::kPipelineSupported);
+    return find;
+}
+
+// Configures the failpoint 'name' and returns the number of times it was entered before.
+long long configurePipelineFailPoint(DBClientBase* conn, StringData name, BSONObj modeAndData) {
+    auto reply = conn->runCommand(OpMsgRequest::fromDBAndBody(
+                                      "admin",
+                                      BSON("configureFailPoint" << name).addFields(modeAndData)))
+                     ->getCommandReply();
+    ASSERT_OK(getStatusFromCommandResult(reply));
+    return reply["count"].safeNumberLong();
+}
+
+void waitForPipelineFailPoint(DBClientBase* conn, StringData name, long long timesEntered) {
+    auto reply = conn->runCommand(OpMsgRequest::fromDBAndBody(
+                                      "admin",
+                                      BSON("waitForFailPoint" << name << "timesEntered"
+                                                              << timesEntered << "maxTimeMS"
+                                                              << 30000)))
+                     ->getCommandReply();
+    ASSERT_OK(getStatusFromCommandResult(reply));
+}
+
+// A hung request enters the hangBeforeRunningPipelinedRequest failpoint twice.
+long long configureHangBeforeRunningPipelinedRequest(DBClientBase* conn, BSONObj modeAndData) {
+    return configurePipelineFailPoint(conn, "hangBeforeRunningPipelinedRequest", modeAndData);
+}
+
+void waitForHangBeforeRunningPipelinedRequest(DBClientBase* conn, long long timesEntered) {
+    waitForPipelineFailPoint(conn, "hangBeforeRunningPipelinedRequest", timesEntered);
+}
+
+void assertFindSucceeded(const Message& reply) {
+    auto res = OpMsg::parse(reply).body;
+    ASSERT_OK(getStatusFromCommandResult(res));
+}
+
+TEST(OpMsg, PipelinedRequestsRespondInCompletionOrder) {
+    auto conn = getIntegrationTestConnection();
+    auto adminConn = getIntegrationTestConnection();
+
+    // Pipelining is only implemented by mongod.
+    if (conn->isMongos()) {
+        return;
+    }
+
+    NamespaceString nss("test", "coll");
+    conn->dropCollection(nss.toString());
+    conn->insert(nss.toString(), BSON("_id" << 0));
+
+    // Hold the first find, the second one must respond before it.
+    auto timesEntered = configureHangBeforeRunningPipelinedRequest(
+        adminConn.get(), BSON("mode" << "alwaysOn" << "data" << BSON("comment" << "slow")));
+    ScopeGuard failPointGuard([&] {
+        configureHangBeforeRunningPipelinedRequest(adminConn.get(), BSON("mode"
+                                                                         << "off"));
+    });
+
+    auto slowFind = makePipelinedFind(nss, "slow");
+    conn->say(slowFind);
+    const auto slowFindId = slowFind.header().getId();
+    waitForHangBeforeRunningPipelinedRequest(adminConn.get(), timesEntered + 2);
+
+    auto fastFind = makePipelinedFind(nss, "fast");
+    conn->say(fastFind);
+
+    // Receiving a response to another request than the one expected fails.
+    Message reply;
+    ASSERT_OK(conn->recv(reply, fastFind.header().getId()));
+    assertFindSucceeded(reply);
+
+    failPointGuard.dismiss();
+    configureHangBeforeRunningPipelinedRequest(adminConn.get(), BSON("mode" << "off"));
+
+    ASSERT_OK(conn->recv(reply, slowFindId));
+    assertFindSucceeded(reply);
+}
+
+TEST(OpMsg, PipelinedRequestsAreLimitedPerConnection) {
+    auto conn = getIntegrationTestConnection();
+    auto adminConn = getIntegrationTestConnection();
+
+    // Pipelining is only implemented by mongod.
+    if (conn->isMongos()) {
+        return;
+    }
+
+    NamespaceString nss("test", "coll");
+    conn->dropCollection(nss.toString());
+    conn->insert(nss.toString(), BSON("_id" << 0));
+
+    const auto setLimit = [&](int limit) {
+        auto reply = adminConn
+                         ->runCommand(OpMsgRequest::fromDBAndBody(
+                             "admin",
+                             BSON("setParameter" << 1 << "maxPipelinedRequestsPerConnection"
+                                                 << limit)))
+                         ->getCommandReply();
+        ASSERT_OK(getStatusFromCommandResult(reply));
+        return reply["was"].numberInt();
+    };
+    const auto previousLimit = setLimit(2);
+    ON_BLOCK_EXIT([&] { setLimit(previousLimit); });
+
+    // Record when the connection suspends reading requests because it reached the limit.
+    auto timesSuspended = configurePipelineFailPoint(
+        adminConn.get(), "suspendedForPipelinedRequests", BSON("mode" << "alwaysOn"));
+    ON_BLOCK_EXIT([&] {
+        configurePipelineFailPoint(
+            adminConn.get(), "suspendedForPipelinedRequests", BSON("mode" << "off"));
+    });
+
+    // Hold every pipelined request.
+    auto timesEntered =
+        configureHangBeforeRunningPipelinedRequest(adminConn.get(), BSON("mode" << "alwaysOn"));
+    ScopeGuard failPointGuard([&] {
+        configureHangBeforeRunningPipelinedRequest(adminConn.get(), BSON("mode"
+                                                                         << "off"));
+    });
+
+    for (int i = 0; i < 3; i++) {
+        auto find = makePipelinedFind(nss, "find" + std::to_string(i));
+        conn->say(find);
+    }
+
+    // The first two finds run and hang. The connection suspends before running the third one, which
+    // cannot resume until one of them completes, so it never enters the hang failpoint.
+    waitForHangBeforeRunningPipelinedRequest(adminConn.get(), timesEntered + 4);
+    waitForPipelineFailPoint(adminConn.get(), "suspendedForPipelinedRequests", timesSuspended + 1);
+
+    failPointGuard.dismiss();
+    ASSERT_EQ(timesEntered + 4,
+              configureHangBeforeRunningPipelinedRequest(adminConn.get(), BSON("mode" << "off")));
+}
+
 }  // namespace
 }  // namespace mongo
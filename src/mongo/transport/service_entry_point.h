@@ -96,6 +96,39 @@ public:
     virtual Future<DbResponse> handleRequest(OperationContext* opCtx,
                                              const Message& request) noexcept = 0;
 
+    /**
+     * Returns true if 'request', which was sent with the OpMsg::kPipelineSupported flag, may run
+     * concurrently with other requests from the same connection. Only requests that neither
+     * depend on nor affect the outcome of their neighbours should be pipelined.
+     *
+     * Invoked from the Client thread before the request is processed.
+     */
+    virtual bool isPipelinableRequest(Client* client, const Message& request) noexcept {
+        return false;
+    }
+
+    /**
+     * Prepares 'pipelinedClient' to run requests on behalf of 'client', e.g. by carrying over the
+     * users that authenticated on the connection.
+     *
+     * Invoked from the Client thread before 'pipelinedClient' runs any request.
+     */
+    virtual Status initPipelinedClient(Client* client,
+                                       ServiceContext::UniqueClient& pipelinedClient) {
+        return Status::OK();
+    }
+
+    /**
+     * Returns true if 'pipelinedClient', which was prepared by initPipelinedClient() and has since
+     * run requests, may run further requests on behalf of 'client'. Pipelined Clients are reused
+     * for as long as this holds.
+     *
+     * Invoked from the Client thread while 'pipelinedClient' is not running any request.
+     */
+    virtual bool isPipelinedClientCurrent(Client* client, Client* pipelinedClient) {
+        return true;
+    }
+
     /**
      * Optional handler which is invoked after a session ends.
      *
@@ -35,6 +35,7 @@
 
 #include <boost/optional.hpp>
 
+#include "mongo/db/operation_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/service_executor_fixed.h"
@@ -57,6 +58,7 @@ auto getServiceExecutorStats =
     ServiceContext::declareDecoration<synchronized_value<ServiceExecutorStats>>();
 auto getServiceExecutorContext =
     Client::declareDecoration<boost::optional<ServiceExecutorContext>>();
+auto getMayCompleteAsynchronously = OperationContext::declareDecoration<bool>();
 }  // namespace
 
 StringData toString(ServiceExecutor::ThreadingModel threadingModel) {
@@ -169,6 +171,14 @@ void ServiceExecutorContext::reset(Client* client) noexcept {
     }
 }
 
+void ServiceExecutorContext::setMayCompleteAsynchronously(OperationContext* opCtx) noexcept {
+    getMayCompleteAsynchronously(opCtx) = true;
+}
+
+bool ServiceExecutorContext::mayCompleteAsynchronously(OperationContext* opCtx) noexcept {
+    return getMayCompleteAsynchronously(opCtx);
+}
+
 void ServiceExecutorContext::setThreadingModel(ThreadingModel threadingModel) noexcept {
 
     if (_threadingModel == threadingModel) {
@@ -166,6 +166,21 @@ public:
      */
     static void reset(Client* client) noexcept;
 
+    /**
+     * Allow ServiceEntryPoint::handleRequest() to complete the future it returns for 'opCtx' later
+     * on the Client's ServiceExecutor, rather than keep the thread it runs on blocked while the
+     * request waits for other work, such as a journal flush.
+     *
+     * Only callers that wait for that future asynchronously and release the Client in the meantime
+     * may allow this: a caller that blocks on the future while the Client is bound would deadlock.
+     */
+    static void setMayCompleteAsynchronously(OperationContext* opCtx) noexcept;
+
+    /**
+     * Returns true if setMayCompleteAsynchronously() was called for 'opCtx'.
+     */
+    static bool mayCompleteAsynchronously(OperationContext* opCtx) noexcept;
+
     ServiceExecutorContext() = default;
     ServiceExecutorContext(const ServiceExecutorContext&) = delete;
     ServiceExecutorContext& operator=(const ServiceExecutorContext&) = delete;
@@ -31,12 +31,24 @@
 
 #include "mongo/transport/service_executor_fixed.h"
 
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "mongo/base/error_codes.h"
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/testing_proctor.h"
 #include "mongo/util/thread_safety_context.h"
@@ -79,11 +91,100 @@ const auto getHandle = ServiceContext::declareDecoration<std::unique_ptr<Handle>
 
 const auto serviceExecutorFixedRegisterer = ServiceContext::ConstructorActionRegisterer{
     "ServiceExecutorFixed", [](ServiceContext* ctx) {
+        auto numaNodes = fixedServiceExecutorNumaAware
+            ? ServiceExecutorFixed::detectNumaNodes()
+            : std::vector<ServiceExecutorFixed::NumaNode>{};
         getHandle(ctx) = std::make_unique<Handle>(std::make_shared<ServiceExecutorFixed>(
-            ctx, ThreadPool::Limits{0, static_cast<size_t>(fixedServiceExecutorThreadLimit)}));
+            ctx,
+            ThreadPool::Limits{0, static_cast<size_t>(fixedServiceExecutorThreadLimit)},
+            std::move(numaNodes)));
     }};
+
+/**
+ * Parses a kernel CPU list (e.g., "0-3,8,10-11") into the CPU numbers it contains.
+ */
+std::vector<int> parseCpuList(StringData cpuList) {
+    std::vector<int> cpus;
+    while (!cpuList.empty()) {
+        auto rangeEnd = cpuList.find(',');
+        auto range = cpuList.substr(0, rangeEnd);
+        cpuList = rangeEnd == std::string::npos ? StringData{} : cpuList.substr(rangeEnd + 1);
+
+        int first = 0, last = 0;
+        auto dash = range.find('-');
+        if (!NumberParser{}(range.substr(0, dash), &first).isOK() ||
+            !NumberParser{}(dash == std::string::npos ? range : range.substr(dash + 1), &last)
+                 .isOK()) {
+            return {};
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+void pinCurrentThreadToCpus(const std::vector<int>& cpus) {
+#ifdef __linux__
+    if (cpus.empty()) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+
+    if (auto err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+        LOGV2_WARNING(7802700,
+                      "Failed to pin service executor thread to its NUMA node",
+                      "error"_attr = errnoWithDescription(err));
+    }
+#endif
+}
 }  // namespace
 
+std::vector<ServiceExecutorFixed::NumaNode> ServiceExecutorFixed::detectNumaNodes() {
+    std::vector<NumaNode> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return {};
+    }
+
+    for (int id = 0;; ++id) {
+        auto path = fmt::format("/sys/devices/system/node/node{}/cpulist", id);
+        std::ifstream cpuListFile(path);
+        if (!cpuListFile) {
+            break;
+        }
+
+        std::string cpuList;
+        std::getline(cpuListFile, cpuList);
+
+        NumaNode node{id, {}};
+        for (auto cpu : parseCpuList(cpuList)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                node.cpus.push_back(cpu);
+            }
+        }
+
+        // Nodes without usable CPUs (e.g., memory-only nodes) cannot host executor threads.
+        if (!node.cpus.empty()) {
+            nodes.push_back(std::move(node));
+        }
+    }
+#endif
+
+    if (nodes.size() < 2) {
+        return {};
+    }
+
+    LOGV2(7802701, "Partitioning fixed service executor by NUMA node", "nodes"_attr = nodes.size());
+    return nodes;
+}
+
 struct ServiceExecutorFixed::Stats {
     size_t threadsRunning() const {
         auto ended = threadsEnded.load();
@@ -124,9 +225,28 @@ struct ServiceExecutorFixed::Stats {
     AtomicWord<size_t> waitersEnded{0};
 };
 
+struct ServiceExecutorFixed::Node {
+    explicit Node(NumaNode numaNode) : numaNode(std::move(numaNode)) {}
+
+    size_t queueDepth() const {
+        auto dequeued = tasksDequeued.load();
+        auto queued = tasksQueued.loadRelaxed();
+        return queued - dequeued;
+    }
+
+    const NumaNode numaNode;
+    std::shared_ptr<ThreadPool> threadPool;
+
+    AtomicWord<size_t> tasksQueued{0};
+    AtomicWord<size_t> tasksDequeued{0};
+
+    // The number of tasks this node took over from a node with a deeper queue.
+    AtomicWord<size_t> tasksStolen{0};
+};
+
 class ServiceExecutorFixed::ExecutorThreadContext {
 public:
-    ExecutorThreadContext(ServiceExecutorFixed* serviceExecutor);
+    ExecutorThreadContext(ServiceExecutorFixed* serviceExecutor, size_t nodeIndex);
     ~ExecutorThreadContext();
 
     ExecutorThreadContext(ExecutorThreadContext&&) = delete;
@@ -155,14 +275,19 @@ public:
         return _recursionDepth;
     }
 
+    size_t getNodeIndex() const {
+        return _nodeIndex;
+    }
+
 private:
     ServiceExecutorFixed* const _executor;
+    const size_t _nodeIndex;
     int _recursionDepth = 0;
 };
 
 ServiceExecutorFixed::ExecutorThreadContext::ExecutorThreadContext(
-    ServiceExecutorFixed* serviceExecutor)
-    : _executor(serviceExecutor) {
+    ServiceExecutorFixed* serviceExecutor, size_t nodeIndex)
+    : _executor(serviceExecutor), _nodeIndex(nodeIndex) {
     _executor->_stats->threadsStarted.fetchAndAdd(1);
     hangAfterServiceExecutorFixedExecutorThreadsStart.pauseWhileSet();
 }
@@ -178,18 +303,52 @@ ServiceExecutorFixed::ExecutorThreadContext::~ExecutorThreadContext() {
 thread_local std::unique_ptr<ServiceExecutorFixed::ExecutorThreadContext>
     ServiceExecutorFixed::_executorContext;
 
-ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx, ThreadPool::Limits limits)
-    : _stats{std::make_unique<Stats>()},
-      _svcCtx{ctx},
-      _options{[&] {
-          ThreadPool::Options opt(std::move(limits));
-          opt.poolName = "ServiceExecutorFixed";
-          opt.onCreateThread = [this](const auto&) {
-              _executorContext = std::make_unique<ExecutorThreadContext>(this);
-          };
-          return opt;
-      }()},
-      _threadPool{std::make_shared<ThreadPool>(_options)} {}
+ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx,
+                                           ThreadPool::Limits limits,
+                                           std::vector<NumaNode> numaNodes)
+    : _stats{std::make_unique<Stats>()}, _svcCtx{ctx}, _poolName{"ServiceExecutorFixed"} {
+    if (numaNodes.size() > std::max<size_t>(1, limits.maxThreads)) {
+        // Too few threads to give each node its own: the pools could not add up to the limit.
+        LOGV2(7802702,
+              "Not partitioning fixed service executor by NUMA node, as it has fewer threads than "
+              "nodes",
+              "nodes"_attr = numaNodes.size(),
+              "maxThreads"_attr = limits.maxThreads);
+        numaNodes.clear();
+    }
+    if (numaNodes.empty()) {
+        // Without a NUMA topology, run a single pool whose threads are not pinned.
+        numaNodes.emplace_back();
+    }
+
+    // The thread limits apply to the executor as a whole, so split them evenly across nodes, with
+    // the first nodes taking one thread of the remainder each.
+    const auto nodeCount = numaNodes.size();
+    auto perNode = [&](size_t threads, size_t nodeIndex) {
+        return threads / nodeCount + (nodeIndex < threads % nodeCount ? 1 : 0);
+    };
+
+    for (auto& numaNode : numaNodes) {
+        const auto nodeIndex = _nodes.size();
+        auto node = std::make_unique<Node>(std::move(numaNode));
+
+        ThreadPool::Limits nodeLimits = limits;
+        nodeLimits.maxThreads = std::max<size_t>(1, perNode(limits.maxThreads, nodeIndex));
+        nodeLimits.minThreads =
+            std::min(perNode(limits.minThreads, nodeIndex), nodeLimits.maxThreads);
+
+        ThreadPool::Options opt(nodeLimits);
+        opt.poolName = nodeCount == 1 ? _poolName
+                                      : fmt::format("{}-node{}", _poolName, node->numaNode.id);
+        opt.onCreateThread = [this, nodeIndex, cpus = node->numaNode.cpus](const auto&) {
+            pinCurrentThreadToCpus(cpus);
+            _executorContext = std::make_unique<ExecutorThreadContext>(this, nodeIndex);
+        };
+        node->threadPool = std::make_shared<ThreadPool>(std::move(opt));
+
+        _nodes.push_back(std::move(node));
+    }
+}
 
 ServiceExecutorFixed::~ServiceExecutorFixed() {
     _finalize();
@@ -199,15 +358,26 @@ void ServiceExecutorFixed::_finalize() noexcept {
     LOGV2_DEBUG(4910502,
                 kDiagnosticLogLevel,
                 "Joining fixed thread-pool service executor",
-                "name"_attr = _options.poolName);
-
-    if (std::shared_ptr<ThreadPool> pool = [&] {
-            auto lk = stdx::unique_lock(_mutex);
-            _beginShutdown();
-            _waitForStop(lk, {});
-            return std::exchange(_threadPool, nullptr);
-        }()) {
+                "name"_attr = _poolName);
+
+    auto pools = [&] {
+        auto lk = stdx::unique_lock(_mutex);
+        _beginShutdown();
+        _waitForStop(lk, {});
+
+        std::vector<std::shared_ptr<ThreadPool>> pools;
+        for (auto& node : _nodes) {
+            if (auto pool = std::exchange(node->threadPool, nullptr)) {
+                pools.push_back(std::move(pool));
+            }
+        }
+        return pools;
+    }();
+
+    for (auto& pool : pools) {
         pool->shutdown();
+    }
+    for (auto& pool : pools) {
         pool->join();
     }
 
@@ -235,9 +405,12 @@ Status ServiceExecutorFixed::start() {
     LOGV2_DEBUG(4910501,
                 kDiagnosticLogLevel,
                 "Starting fixed thread-pool service executor",
-                "name"_attr = _options.poolName);
+                "name"_attr = _poolName,
+                "nodes"_attr = _nodes.size());
 
-    _threadPool->startup();
+    for (auto& node : _nodes) {
+        node->threadPool->startup();
+    }
 
     if (!_svcCtx) {
         // For some tests, we do not have a ServiceContext.
@@ -254,7 +427,7 @@ Status ServiceExecutorFixed::start() {
 
     auto reactor = tl->getReactor(TransportLayer::WhichReactor::kIngress);
     invariant(reactor);
-    _threadPool->schedule([this, reactor](Status) {
+    _nodes.front()->threadPool->schedule([this, reactor](Status) {
         {
             // Check to make sure we haven't been shutdown already. Note that there is still a brief
             // race that immediately follows this check. ASIOReactor::stop() is not permanent, thus
@@ -337,7 +510,7 @@ void ServiceExecutorFixed::_beginShutdown() {
 }
 
 const std::string& ServiceExecutorFixed::_name() const {
-    return _options.poolName;
+    return _poolName;
 }
 
 void ServiceExecutorFixed::_checkForShutdown() {
@@ -399,7 +572,7 @@ Status ServiceExecutorFixed::scheduleTask(Task task, ScheduleFlags flags) try {
 
     hangBeforeSchedulingServiceExecutorFixedTask.pauseWhileSet();
 
-    _threadPool->schedule([this, task = std::move(task)](Status status) mutable {
+    _scheduleOnNode(_nodeForCaller(), [this, task = std::move(task)](Status status) mutable {
         invariant(status);
         _executorContext->run([&] { task(); });
     });
@@ -410,6 +583,10 @@ Status ServiceExecutorFixed::scheduleTask(Task task, ScheduleFlags flags) try {
 }
 
 void ServiceExecutorFixed::_schedule(OutOfLineExecutor::Task task) noexcept {
+    _schedule(_nodeForCaller(), std::move(task));
+}
+
+void ServiceExecutorFixed::_schedule(size_t nodeIndex, OutOfLineExecutor::Task task) noexcept {
     {
         auto lk = stdx::unique_lock(_mutex);
         if (_state != State::kRunning) {
@@ -421,11 +598,45 @@ void ServiceExecutorFixed::_schedule(OutOfLineExecutor::Task task) noexcept {
         _stats->tasksScheduled.fetchAndAdd(1);
     }
 
-    _threadPool->schedule([this, task = std::move(task)](Status status) mutable {
+    _scheduleOnNode(nodeIndex, [this, task = std::move(task)](Status status) mutable {
         _executorContext->run([&] { task(std::move(status)); });
     });
 }
 
+size_t ServiceExecutorFixed::_nodeForCaller() {
+    if (_executorContext) {
+        return _executorContext->getNodeIndex() % _nodes.size();
+    }
+    return _nextNode.fetchAndAdd(1) % _nodes.size();
+}
+
+void ServiceExecutorFixed::_scheduleOnNode(size_t nodeIndex,
+                                           OutOfLineExecutor::Task task) noexcept {
+    auto node = _nodes[nodeIndex].get();
+
+    // Keep tasks on their own node unless it falls too far behind. Running on a remote node costs
+    // cross-node memory traffic, which is still cheaper than leaving the task queued.
+    if (_nodes.size() > 1) {
+        const auto threshold = fixedServiceExecutorNumaStealThreshold.loadRelaxed();
+        if (threshold > 0 && node->queueDepth() >= static_cast<size_t>(threshold)) {
+            auto leastBusy = std::min_element(
+                _nodes.begin(), _nodes.end(), [](const auto& a, const auto& b) {
+                    return a->queueDepth() < b->queueDepth();
+                });
+            if ((*leastBusy)->queueDepth() < node->queueDepth()) {
+                node = leastBusy->get();
+                node->tasksStolen.fetchAndAdd(1);
+            }
+        }
+    }
+
+    node->tasksQueued.fetchAndAdd(1);
+    node->threadPool->schedule([node, task = std::move(task)](Status status) mutable {
+        node->tasksDequeued.fetchAndAdd(1);
+        task(std::move(status));
+    });
+}
+
 size_t ServiceExecutorFixed::getRunningThreads() const {
     return _stats->threadsRunning();
 }
@@ -448,17 +659,28 @@ void ServiceExecutorFixed::runOnDataAvailable(const SessionHandle& session,
 
     lk.unlock();
 
-    auto anchor = shared_from_this();
-    session->asyncWaitForData().thenRunOn(anchor).getAsync([this, anchor, it](Status status) {
-        // Remove our waiter from the list.
-        auto lk = stdx::unique_lock(_mutex);
-        auto waiter = std::exchange(*it, {});
-        _waiters.erase(it);
-        _stats->waitersEnded.fetchAndAdd(1);
-        lk.unlock();
+    // Sessions are spread across nodes by id, which assigns each newly accepted session to the
+    // next node, and keeps serving a session on the node that owns its buffers.
+    const auto nodeIndex = session->id() % _nodes.size();
 
-        waiter.session = nullptr;
-        waiter.onCompletionCallback(std::move(status));
+    auto anchor = shared_from_this();
+    session->asyncWaitForData().getAsync([this, anchor, it, nodeIndex](Status status) mutable {
+        _schedule(nodeIndex,
+                  [this, anchor, it, status = std::move(status)](Status execStatus) mutable {
+                      if (!execStatus.isOK()) {
+                          status = std::move(execStatus);
+                      }
+
+                      // Remove our waiter from the list.
+                      auto lk = stdx::unique_lock(_mutex);
+                      auto waiter = std::exchange(*it, {});
+                      _waiters.erase(it);
+                      _stats->waitersEnded.fetchAndAdd(1);
+                      lk.unlock();
+
+                      waiter.session = nullptr;
+                      waiter.onCompletionCallback(std::move(status));
+                  });
     });
 }
 
@@ -470,6 +692,17 @@ void ServiceExecutorFixed::appendStats(BSONObjBuilder* bob) const {
     subbob.append("clientsInTotal", static_cast<int>(_stats->tasksTotal()));
     subbob.append("clientsRunning", static_cast<int>(_stats->tasksRunning()));
     subbob.append("clientsWaitingForData", static_cast<int>(_stats->tasksWaiting()));
+
+    if (_nodes.size() > 1) {
+        BSONArrayBuilder nodesBob(subbob.subarrayStart("numaNodes"));
+        for (const auto& node : _nodes) {
+            BSONObjBuilder nodeBob(nodesBob.subobjStart());
+            nodeBob.append("node", node->numaNode.id);
+            nodeBob.append("cpus", static_cast<int>(node->numaNode.cpus.size()));
+            nodeBob.append("queueDepth", static_cast<long long>(node->queueDepth()));
+            nodeBob.append("tasksStolen", static_cast<long long>(node->tasksStolen.load()));
+        }
+    }
 }
 
 int ServiceExecutorFixed::getRecursionDepthForExecutorThread() const {
@@ -477,4 +710,9 @@ int ServiceExecutorFixed::getRecursionDepthForExecutorThread() const {
     return _executorContext->getRecursionDepth();
 }
 
+size_t ServiceExecutorFixed::getNodeForExecutorThread() const {
+    invariant(_executorContext);
+    return _executorContext->getNodeIndex();
+}
+
 }  // namespace mongo::transport
@@ -31,6 +31,7 @@
 
 #include <boost/optional.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/db/service_context.h"
@@ -52,19 +53,43 @@ namespace transport {
  * A service executor that uses a fixed (configurable) number of threads to execute tasks.
  * This executor always yields before executing scheduled tasks, and never yields before scheduling
  * new tasks (i.e., `ScheduleFlags::kMayYieldBeforeSchedule` is a no-op for this executor).
+ *
+ * The threads may be partitioned by NUMA node, in which case each node runs its own thread pool
+ * whose threads are pinned to the CPUs of that node. Sessions are assigned to a node when they
+ * first wait for data, and the tasks they schedule from an executor thread stay on that node
+ * unless its queue is backed up, in which case they are handed to the least busy node. The thread
+ * limits are split across the nodes so that their pools add up to them, and an executor with fewer
+ * threads than nodes runs a single pool instead.
  */
 class ServiceExecutorFixed final : public ServiceExecutor,
                                    public std::enable_shared_from_this<ServiceExecutorFixed> {
     static constexpr auto kDiagnosticLogLevel = 3;
 
 public:
-    explicit ServiceExecutorFixed(ServiceContext* ctx, ThreadPool::Limits limits);
-    explicit ServiceExecutorFixed(ThreadPool::Limits limits)
-        : ServiceExecutorFixed(nullptr, std::move(limits)) {}
+    /**
+     * Describes a NUMA node and the CPUs its executor threads may run on. An empty list of CPUs
+     * leaves the threads unpinned.
+     */
+    struct NumaNode {
+        int id = 0;
+        std::vector<int> cpus;
+    };
+
+    explicit ServiceExecutorFixed(ServiceContext* ctx,
+                                  ThreadPool::Limits limits,
+                                  std::vector<NumaNode> numaNodes = {});
+    explicit ServiceExecutorFixed(ThreadPool::Limits limits, std::vector<NumaNode> numaNodes = {})
+        : ServiceExecutorFixed(nullptr, std::move(limits), std::move(numaNodes)) {}
     virtual ~ServiceExecutorFixed();
 
     static ServiceExecutorFixed* get(ServiceContext* ctx);
 
+    /**
+     * Returns the NUMA nodes of this host that have CPUs available to this process, or an empty
+     * list if the topology cannot be determined or the host has a single node.
+     */
+    static std::vector<NumaNode> detectNumaNodes();
+
     Status start() override;
     Status shutdown(Milliseconds timeout) override;
 
@@ -86,6 +111,19 @@ public:
      */
     int getRecursionDepthForExecutorThread() const;
 
+    /**
+     * Returns the index of the node that runs the active executor thread.
+     * It is forbidden to invoke this method outside scheduled tasks.
+     */
+    size_t getNodeForExecutorThread() const;
+
+    /**
+     * Returns the number of thread pools (one per NUMA node) run by this executor.
+     */
+    size_t getNodeCount() const {
+        return _nodes.size();
+    }
+
 private:
     enum class State { kNotStarted, kRunning, kStopping, kStopped };
 
@@ -94,6 +132,9 @@ private:
 
     struct Stats;
 
+    // The thread pool and scheduling statistics for a single NUMA node.
+    struct Node;
+
     struct Waiter {
         SessionHandle session;
         OutOfLineExecutor::Task onCompletionCallback;
@@ -108,6 +149,19 @@ private:
     void _beginShutdown();
 
     void _schedule(OutOfLineExecutor::Task task) noexcept;
+    void _schedule(size_t nodeIndex, OutOfLineExecutor::Task task) noexcept;
+
+    /**
+     * Schedules the task on the pool of 'nodeIndex', or on the least busy node if the queue of
+     * 'nodeIndex' is too deep.
+     */
+    void _scheduleOnNode(size_t nodeIndex, OutOfLineExecutor::Task task) noexcept;
+
+    /**
+     * Returns the node tasks scheduled by the calling thread should run on: the node of the
+     * calling executor thread, otherwise the next node in round-robin order.
+     */
+    size_t _nodeForCaller();
 
     void _finalize() noexcept;
 
@@ -126,8 +180,9 @@ private:
     stdx::condition_variable _shutdownCondition;
     SharedPromise<void> _shutdownComplete;
 
-    ThreadPool::Options _options;
-    std::shared_ptr<ThreadPool> _threadPool;
+    std::string _poolName;
+    std::vector<std::unique_ptr<Node>> _nodes;
+    AtomicWord<size_t> _nextNode{0};
 
     std::list<Waiter> _waiters;
 
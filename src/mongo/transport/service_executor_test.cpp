@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/mock_session.h"
 #include "mongo/transport/service_executor_fixed.h"
@@ -160,6 +161,9 @@ public:
     class Handle {
     public:
         Handle() = default;
+        explicit Handle(std::vector<ServiceExecutorFixed::NumaNode> numaNodes)
+            : _executor{std::make_shared<ServiceExecutorFixed>(
+                  ThreadPool::Limits{kExecutorThreads, kExecutorThreads}, std::move(numaNodes))} {}
         Handle(const Handle&) = delete;
         Handle& operator=(const Handle&) = delete;
 
@@ -249,6 +253,73 @@ TEST_F(ServiceExecutorFixedTest, FlattenRecursiveScheduledTasks) {
     barrier.countDownAndWait();
 }
 
+TEST_F(ServiceExecutorFixedTest, TasksStayOnTheNodeOfTheirExecutorThread) {
+    unittest::Barrier barrier(2);
+    Handle handle({{0, {}}, {1, {}}});
+    handle.start();
+    ASSERT_EQ(handle->getNodeCount(), 2U);
+
+    // Tasks scheduled from outside the executor are spread across nodes, while tasks scheduled
+    // from an executor thread run on the node of that thread.
+    AtomicWord<int> tasksToSchedule{10};
+    std::function<void(size_t)> followUpTask = [&](size_t node) {
+        ASSERT_EQ(handle->getNodeForExecutorThread(), node);
+        if (tasksToSchedule.fetchAndSubtract(1) > 0) {
+            ASSERT_OK(handle->scheduleTask([&, node] { followUpTask(node); }, {}));
+        } else {
+            barrier.countDownAndWait();
+        }
+    };
+    ASSERT_OK(handle->scheduleTask([&] { followUpTask(handle->getNodeForExecutorThread()); }, {}));
+    barrier.countDownAndWait();
+
+    BSONObjBuilder bob;
+    handle->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats["fixed"]["numaNodes"].Array().size(), 2U);
+}
+
+TEST_F(ServiceExecutorFixedTest, TasksAreStolenFromABackedUpNode) {
+    RAIIServerParameterControllerForTest threshold{"fixedServiceExecutorNumaStealThreshold", 1};
+    Handle handle({{0, {}}, {1, {}}});
+    handle.start();
+    ASSERT_EQ(handle->getNodeCount(), 2U);
+
+    // Each node runs a single thread. A task holds the thread of its node while it schedules two
+    // more: the first one is queued on that node, which backs it up, so the second one is handed
+    // to the other node and runs while the thread is still held.
+    auto stolen = makePromiseFuture<size_t>();
+    auto done = makePromiseFuture<std::pair<size_t, size_t>>();
+    ASSERT_OK(handle->scheduleTask(
+        [&] {
+            const auto node = handle->getNodeForExecutorThread();
+            ASSERT_OK(handle->scheduleTask([] {}, {}));
+            ASSERT_OK(handle->scheduleTask(
+                [&] { stolen.promise.emplaceValue(handle->getNodeForExecutorThread()); }, {}));
+            done.promise.emplaceValue(node, std::move(stolen.future).get());
+        },
+        {}));
+
+    auto [node, stolenNode] = std::move(done.future).get();
+    ASSERT_NE(node, stolenNode);
+
+    BSONObjBuilder bob;
+    handle->appendStats(&bob);
+    auto nodes = bob.obj()["fixed"]["numaNodes"].Array();
+    ASSERT_EQ(nodes[node].Obj()["tasksStolen"].numberLong(), 0);
+    ASSERT_EQ(nodes[stolenNode].Obj()["tasksStolen"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorFixedTest, RunsASinglePoolWithFewerThreadsThanNodes) {
+    Handle handle({{0, {}}, {1, {}}, {2, {}}});
+    handle.start();
+    ASSERT_EQ(handle->getNodeCount(), 1U);
+
+    unittest::Barrier barrier(2);
+    ASSERT_OK(handle->scheduleTask([&] { barrier.countDownAndWait(); }, {}));
+    barrier.countDownAndWait();
+}
+
 TEST_F(ServiceExecutorFixedTest, ShutdownTimeLimit) {
     SharedPromise<void> invoked;
     SharedPromise<void> mayReturn;
@@ -33,6 +33,7 @@
 
 #include "mongo/transport/service_state_machine.h"
 
+#include <fmt/format.h>
 #include <memory>
 
 #include "mongo/base/status.h"
@@ -51,22 +52,51 @@
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_entry_point_impl_gen.h"
+#include "mongo/transport/service_executor_utils.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/functional.h"
 #include "mongo/util/future.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_peer_info.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace transport {
 namespace {
 MONGO_FAIL_POINT_DEFINE(doNotSetMoreToCome);
 MONGO_FAIL_POINT_DEFINE(beforeCompressingExhaustResponse);
+MONGO_FAIL_POINT_DEFINE(hangBeforeRunningPipelinedRequest);
+MONGO_FAIL_POINT_DEFINE(suspendedForPipelinedRequests);
+
+/**
+ * Stamps the response to 'request' with a new message id and the id of the request it answers,
+ * appending a checksum if the request carried one.
+ */
+void prepareResponseHeader(const SessionHandle& session,
+                           const Message& request,
+                           Message* response) {
+    invariant(!OpMsg::isFlagSet(*response, OpMsg::kChecksumPresent));
+
+    response->header().setId(nextMessageId());
+    response->header().setResponseToMsgId(request.header().getId());
+    if (OpMsg::isFlagSet(request, OpMsg::kChecksumPresent)) {
+#ifdef MONGO_CONFIG_SSL
+        if (!SSLPeerInfo::forSession(session).isTLS) {
+            OpMsg::appendChecksum(response);
+        }
+#else
+        OpMsg::appendChecksum(response);
+#endif
+    }
+}
+
 /**
  * Given a request and its already generated response, checks for exhaust flags. If exhaust is
  * allowed, produces the subsequent request message, and modifies the response message to indicate
@@ -128,6 +158,7 @@ public:
      * Source -> SourceWait -> Process -> SinkWait -> Source (standard RPC)
      * Source -> SourceWait -> Process -> SinkWait -> Process -> SinkWait ... (exhaust)
      * Source -> SourceWait -> Process -> Source (fire-and-forget)
+     * Source -> SourceWait -> Process -> Source (pipelined, the request runs on its own Client)
      */
     enum class State {
         Created,     // The session has been created, but no operations have been performed yet
@@ -182,9 +213,71 @@ public:
     void sinkMessage();
 
     /*
-     * Releases all the resources associated with the session and call the cleanupHook.
+     * Records the incoming message and decompresses it if needed. This must run before the message
+     * is inspected for pipelining or handed to processMessage().
+     */
+    void prepareMessage();
+
+    /*
+     * Returns true if the client opted into pipelining for the current message and the
+     * ServiceEntryPoint deems it safe to run concurrently with other requests from this connection.
+     */
+    bool canPipelineMessage();
+
+    /*
+     * Hands the current message off to a pipelined worker.
+     */
+    void pipelineMessage();
+
+    /*
+     * Pipelines or processes the current message, sinks the response if any, and schedules the
+     * next loop.
+     */
+    void runMessage(bool pipeline);
+
+    /*
+     * Runs a pipelined request on its own Client and sinks the response as soon as it is ready.
+     * Responses are tagged with the id of their request, so they may be delivered out of order.
+     */
+    void runPipelinedRequest(ClientStrandPtr strand,
+                             Message request,
+                             boost::optional<MessageCompressorId> compressorId);
+
+    /*
+     * Returns an idle pipelined Client that is up to date with the users authenticated on this
+     * connection, creating one if there is none.
+     */
+    ClientStrandPtr acquirePipelinedClient();
+
+    /*
+     * Returns true if fewer than 'limit' pipelined requests are in flight for this connection.
+     * Otherwise, returns false without blocking and has the pipelined request that brings their
+     * number below 'limit' run 'onReady' once it finishes.
+     */
+    bool waitForPipelinedRequests(int limit, unique_function<void()> onReady);
+
+    /*
+     * Accounts for a pipelined request that finished or could not be scheduled, and runs the
+     * callback waiting for it, if any.
+     */
+    void onPipelinedRequestDone();
+
+    /*
+     * Continues the loop suspended until pipelined requests finish, on the service executor.
+     */
+    void resumeLoop(ServiceExecutor* executor, bool pipeline);
+
+    /*
+     * Sends a message to the client, serializing with pipelined requests sinking their responses.
+     */
+    Status sinkToSession(Message message);
+
+    /*
+     * Releases all the resources associated with the session and call the cleanupHook, once the
+     * pipelined requests in flight finish.
      */
     void cleanupSession(const Status& status);
+    void finishCleanupSession();
 
     /*
      * Schedules a new loop for this state machine on a service executor. The status argument
@@ -239,6 +332,25 @@ private:
     Message _outMessage;
 
     ServiceContext::UniqueOperationContext _opCtx;
+
+    // Tracks requests that the client allowed to run concurrently on this connection.
+    Mutex _pipelineMutex = MONGO_MAKE_LATCH("ServiceStateMachine::Impl::_pipelineMutex");
+    int _pipelinedInFlight = 0;
+
+    // Set while the state machine is suspended until fewer than 'limit' pipelined requests are in
+    // flight. The pipelined request that finishes first below the limit runs 'onReady'.
+    struct PipelineWaiter {
+        int limit;
+        unique_function<void()> onReady;
+    };
+    boost::optional<PipelineWaiter> _pipelineWaiter;
+
+    // Pipelined Clients that are not running a request. They are reused by later pipelined
+    // requests, so that the users authenticated on the connection are only authorized once.
+    std::vector<ClientStrandPtr> _idlePipelinedClients;
+
+    // Serializes sinking responses to the session while pipelined requests are in flight.
+    Mutex _sinkMutex = MONGO_MAKE_LATCH("ServiceStateMachine::Impl::_sinkMutex");
 };
 
 void ServiceStateMachine::Impl::sourceMessage() {
@@ -309,7 +421,7 @@ void ServiceStateMachine::Impl::sinkMessage() {
     //
     // Otherwise, update the current state depending on whether we're in exhaust or not and return
     // from this function to let startNewLoop() continue the future chaining of state transitions.
-    if (auto status = session()->sinkMessage(std::exchange(_outMessage, {})); !status.isOK()) {
+    if (auto status = sinkToSession(std::exchange(_outMessage, {})); !status.isOK()) {
         LOGV2(22989,
               "Error sending response to client. Ending connection from remote",
               "error"_attr = status,
@@ -330,18 +442,22 @@ void ServiceStateMachine::Impl::sinkMessage() {
     executor()->yieldIfAppropriate();
 }
 
-Future<void> ServiceStateMachine::Impl::processMessage() {
+Status ServiceStateMachine::Impl::sinkToSession(Message message) {
+    stdx::lock_guard lk(_sinkMutex);
+    return session()->sinkMessage(std::move(message));
+}
+
+void ServiceStateMachine::Impl::prepareMessage() {
     invariant(!_inMessage.empty());
 
     TrafficRecorder::get(_serviceContext)
         .observe(session(), _serviceContext->getPreciseClockSource()->now(), _inMessage);
 
-    auto& compressorMgr = MessageCompressorManager::forSession(session());
-
     // Setup compressor and acquire a compressor id when processing compressed messages. Exhaust
     // messages produced via `makeExhaustMessage(...)` are not compressed, so the body of this if
     // statement only runs for sourced compressed messages.
     if (_inMessage.operation() == dbCompressed) {
+        auto& compressorMgr = MessageCompressorManager::forSession(session());
         MessageCompressorId compressorId;
         auto swm = compressorMgr.decompressMessage(_inMessage, &compressorId);
         uassertStatusOK(swm.getStatus());
@@ -350,6 +466,214 @@ Future<void> ServiceStateMachine::Impl::processMessage() {
     }
 
     networkCounter.hitLogicalIn(_inMessage.size());
+}
+
+bool ServiceStateMachine::Impl::waitForPipelinedRequests(int limit,
+                                                         unique_function<void()> onReady) {
+    {
+        stdx::lock_guard lk(_pipelineMutex);
+        if (_pipelinedInFlight < limit) {
+            return true;
+        }
+
+        invariant(!_pipelineWaiter);
+        _pipelineWaiter.emplace(PipelineWaiter{limit, std::move(onReady)});
+    }
+
+    suspendedForPipelinedRequests.execute([](const BSONObj&) {
+        // Nothing to do as we only need to record the incident.
+    });
+    return false;
+}
+
+void ServiceStateMachine::Impl::onPipelinedRequestDone() {
+    unique_function<void()> onReady;
+    {
+        stdx::lock_guard lk(_pipelineMutex);
+        --_pipelinedInFlight;
+        if (_pipelineWaiter && _pipelinedInFlight < _pipelineWaiter->limit) {
+            onReady = std::move(_pipelineWaiter->onReady);
+            _pipelineWaiter.reset();
+        }
+    }
+
+    if (onReady) {
+        onReady();
+    }
+}
+
+void ServiceStateMachine::Impl::resumeLoop(ServiceExecutor* executor, bool pipeline) {
+    try {
+        executor->schedule([this, anchor = shared_from_this(), pipeline](Status status) {
+            _clientStrand->run([&] {
+                if (!status.isOK()) {
+                    cleanupSession(status);
+                    return;
+                }
+                runMessage(pipeline);
+            });
+        });
+    } catch (const DBException& ex) {
+        LOGV2_DEBUG(7802601, 2, "Terminating session due to error", "error"_attr = ex.toStatus());
+        _clientStrand->run([&] {
+            _state.store(State::EndSession);
+            terminate();
+            cleanupSession(ex.toStatus());
+        });
+    }
+}
+
+bool ServiceStateMachine::Impl::canPipelineMessage() {
+    if (_inMessage.operation() != dbMsg ||
+        !OpMsg::isFlagSet(_inMessage, OpMsg::kPipelineSupported)) {
+        return false;
+    }
+
+    const auto maxInFlight = gMaxPipelinedRequestsPerConnection.load();
+    if (maxInFlight <= 1) {
+        return false;
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    // A TLS stream does not support reading and writing from different threads at once, which
+    // pipelining requires since responses are sunk while the next request is being sourced.
+    if (SSLPeerInfo::forSession(session()).isTLS) {
+        return false;
+    }
+#endif
+
+    return _sep->isPipelinableRequest(_clientStrand->getClientPointer(), _inMessage);
+}
+
+void ServiceStateMachine::Impl::pipelineMessage() {
+    auto client = _clientStrand->getClientPointer();
+    auto pipelinedClient = acquirePipelinedClient();
+
+    {
+        stdx::lock_guard lk(_pipelineMutex);
+        ++_pipelinedInFlight;
+    }
+
+    auto task = [this,
+                 anchor = shared_from_this(),
+                 pipelinedClient = std::move(pipelinedClient),
+                 request = std::exchange(_inMessage, {}),
+                 compressorId = _compressorId]() mutable {
+        runPipelinedRequest(std::move(pipelinedClient), std::move(request), compressorId);
+    };
+
+    // Clients using the dedicated threading model own their worker thread, so scheduling on
+    // their executor would only queue the request behind the current one.
+    const auto threadingModel = ServiceExecutorContext::get(client)->getThreadingModel();
+    auto status = (threadingModel == ServiceExecutor::ThreadingModel::kDedicated)
+        ? launchServiceWorkerThread(std::move(task))
+        : executor()->scheduleTask(std::move(task), ServiceExecutor::ScheduleFlags{});
+    if (!status.isOK()) {
+        onPipelinedRequestDone();
+        uassertStatusOK(status);
+    }
+
+    _state.store(State::Source);
+}
+
+ClientStrandPtr ServiceStateMachine::Impl::acquirePipelinedClient() {
+    auto client = _clientStrand->getClientPointer();
+    while (true) {
+        ClientStrandPtr strand;
+        {
+            stdx::lock_guard lk(_pipelineMutex);
+            if (_idlePipelinedClients.empty()) {
+                break;
+            }
+            strand = std::move(_idlePipelinedClients.back());
+            _idlePipelinedClients.pop_back();
+        }
+
+        // Users may have authenticated or logged out since the Client last ran a request, in which
+        // case it is dropped.
+        if (_sep->isPipelinedClientCurrent(client, strand->getClientPointer())) {
+            return strand;
+        }
+    }
+
+    auto pipelinedClient =
+        _serviceContext->makeClient(fmt::format("{}-pipelined", client->desc()), session());
+    uassertStatusOK(_sep->initPipelinedClient(client, pipelinedClient));
+    return ClientStrand::make(std::move(pipelinedClient));
+}
+
+void ServiceStateMachine::Impl::runPipelinedRequest(
+    ClientStrandPtr strand,
+    Message request,
+    boost::optional<MessageCompressorId> compressorId) {
+    ON_BLOCK_EXIT([&] {
+        {
+            stdx::lock_guard lk(_pipelineMutex);
+            if (_idlePipelinedClients.size() <
+                static_cast<size_t>(gMaxPipelinedRequestsPerConnection.load())) {
+                _idlePipelinedClients.push_back(std::move(strand));
+            }
+        }
+        onPipelinedRequestDone();
+    });
+
+    auto status = [&]() -> Status {
+        auto guard = strand->bind();
+        try {
+            auto opCtx = Client::getCurrent()->makeOperationContext();
+            opCtx->markKillOnClientDisconnect();
+
+            // Hangs the pipelined requests whose comment matches the one in the failpoint data, if
+            // any.
+            if (MONGO_unlikely(
+                    hangBeforeRunningPipelinedRequest.shouldFail([&](const BSONObj& data) {
+                        return !data.hasField("comment") ||
+                            data["comment"].woCompare(OpMsg::parse(request).body["comment"],
+                                                      /*considerFieldName=*/false) == 0;
+                    }))) {
+                hangBeforeRunningPipelinedRequest.pauseWhileSet(opCtx.get());
+            }
+
+            auto dbresponse = _sep->handleRequest(opCtx.get(), request).get();
+            _serviceContext->killAndDelistOperation(opCtx.get(),
+                                                    ErrorCodes::OperationIsKilledAndDelisted);
+
+            Message& toSink = dbresponse.response;
+            if (toSink.empty()) {
+                return Status::OK();
+            }
+
+            prepareResponseHeader(session(), request, &toSink);
+            networkCounter.hitLogicalOut(toSink.size());
+
+            if (compressorId) {
+                auto& compressorMgr = MessageCompressorManager::forSession(session());
+                toSink = uassertStatusOK(compressorMgr.compressMessage(toSink, &*compressorId));
+            }
+
+            TrafficRecorder::get(_serviceContext)
+                .observe(session(), _serviceContext->getPreciseClockSource()->now(), toSink);
+
+            return sinkToSession(std::move(toSink));
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+    }();
+
+    if (!status.isOK()) {
+        LOGV2(7802600,
+              "Error running pipelined request. Ending connection from remote",
+              "error"_attr = status,
+              "remote"_attr = session()->remote(),
+              "connectionId"_attr = session()->id());
+        terminate();
+    }
+}
+
+Future<void> ServiceStateMachine::Impl::processMessage() {
+    invariant(!_inMessage.empty());
+
+    auto& compressorMgr = MessageCompressorManager::forSession(session());
 
     // Pass sourced Message to handler to generate response.
     _opCtx = Client::getCurrent()->makeOperationContext();
@@ -357,6 +681,13 @@ Future<void> ServiceStateMachine::Impl::processMessage() {
         _opCtx->markKillOnClientDisconnect();
     }
 
+    // The loop below waits for the response asynchronously and releases the Client meanwhile, so
+    // Clients on borrowed threads can give their thread back while the request waits.
+    if (ServiceExecutorContext::get(Client::getCurrent())->getThreadingModel() ==
+        ServiceExecutor::ThreadingModel::kBorrowed) {
+        ServiceExecutorContext::setMayCompleteAsynchronously(_opCtx.get());
+    }
+
     // The handleRequest is implemented in a subclass for mongod/mongos and actually all the
     // database work for this request.
     return _sep->handleRequest(_opCtx.get(), _inMessage)
@@ -374,20 +705,9 @@ Future<void> ServiceStateMachine::Impl::processMessage() {
             Message& toSink = dbresponse.response;
             if (!toSink.empty()) {
                 invariant(!OpMsg::isFlagSet(_inMessage, OpMsg::kMoreToCome));
-                invariant(!OpMsg::isFlagSet(toSink, OpMsg::kChecksumPresent));
 
                 // Update the header for the response message.
-                toSink.header().setId(nextMessageId());
-                toSink.header().setResponseToMsgId(_inMessage.header().getId());
-                if (OpMsg::isFlagSet(_inMessage, OpMsg::kChecksumPresent)) {
-#ifdef MONGO_CONFIG_SSL
-                    if (!SSLPeerInfo::forSession(session()).isTLS) {
-                        OpMsg::appendChecksum(&toSink);
-                    }
-#else
-                    OpMsg::appendChecksum(&toSink);
-#endif
-                }
+                prepareResponseHeader(session(), _inMessage, &toSink);
 
                 // If the incoming message has the exhaust flag set, then we bypass the normal RPC
                 // behavior. We will sink the response to the network, but we also synthesize a new
@@ -475,9 +795,52 @@ void ServiceStateMachine::Impl::startNewLoop(const Status& executorStatus) {
         return;
     }
 
-    makeReadyFutureWith([this] {
-        if (!_inExhaust) {
-            sourceMessage();
+    bool pipeline = false;
+    bool ready = true;
+    auto status = [&]() -> Status {
+        try {
+            if (!_inExhaust) {
+                sourceMessage();
+            }
+
+            prepareMessage();
+
+            // Exhaust streams are never pipelined, the synthetic requests they produce must run in
+            // order on this Client.
+            if (_inExhaust) {
+                return Status::OK();
+            }
+
+            // Requests that cannot be pipelined act as a barrier for the ones that preceded them,
+            // and pipelined requests wait for a free slot. Rather than tying up this thread, the
+            // loop is suspended and the pipelined request that frees the way resumes it on the
+            // service executor.
+            pipeline = canPipelineMessage();
+            ready = waitForPipelinedRequests(
+                pipeline ? gMaxPipelinedRequestsPerConnection.load() : 1,
+                [this, anchor = shared_from_this(), executor = executor(), pipeline] {
+                    resumeLoop(executor, pipeline);
+                });
+            return Status::OK();
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+    }();
+    if (!status.isOK()) {
+        scheduleNewLoop(std::move(status));
+        return;
+    }
+
+    if (ready) {
+        runMessage(pipeline);
+    }
+}
+
+void ServiceStateMachine::Impl::runMessage(bool pipeline) {
+    makeReadyFutureWith([this, pipeline] {
+        if (pipeline) {
+            pipelineMessage();
+            return Future<void>::makeReady();
         }
 
         return processMessage();
@@ -549,6 +912,23 @@ void ServiceStateMachine::Impl::cleanupSession(const Status& status) {
     LOGV2_DEBUG(5127900, 2, "Ending session", "error"_attr = status);
 
     cleanupExhaustResources();
+
+    // Pipelined requests hold on to the session, let them finish (or observe the disconnect)
+    // before tearing down the connection state. The last of them finishes the cleanup, so that
+    // this thread is not tied up waiting for them.
+    if (waitForPipelinedRequests(1, [this, anchor = shared_from_this()] {
+            _clientStrand->run([&] { finishCleanupSession(); });
+        })) {
+        finishCleanupSession();
+    }
+}
+
+void ServiceStateMachine::Impl::finishCleanupSession() {
+    {
+        stdx::lock_guard lk(_pipelineMutex);
+        _idlePipelinedClients.clear();
+    }
+
     auto client = _clientStrand->getClientPointer();
     _sep->onClientDisconnect(client);
 
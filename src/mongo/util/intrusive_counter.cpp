@@ -31,11 +31,26 @@
 
 #include "mongo/util/intrusive_counter.h"
 
+#include "mongo/util/memory_arena.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 using boost::intrusive_ptr;
 
+namespace {
+/**
+ * An RCString whose storage was carved from a MemoryArena. It differs from RCString only in how
+ * its storage is released, which is selected through RefCountable's virtual destructor.
+ */
+class ArenaRCString final : public RCString {
+public:
+    void operator delete(void* ptr) {
+        MemoryArena::deallocate(ptr);
+    }
+};
+static_assert(sizeof(ArenaRCString) == sizeof(RCString));
+}  // namespace
+
 intrusive_ptr<const RCString> RCString::create(StringData s) {
     uassert(16493,
             str::stream() << "Tried to create string longer than "
@@ -45,10 +60,16 @@ intrusive_ptr<const RCString> RCString::create(StringData s) {
     const size_t sizeWithNUL = s.size() + 1;
     const size_t bytesNeeded = sizeof(RCString) + sizeWithNUL;
 
+    intrusive_ptr<RCString> ptr;
+    auto arena = MemoryArena::current();
+    if (void* storage = arena ? arena->allocate(bytesNeeded) : nullptr) {
+        ptr = ::new (storage) ArenaRCString();
+    } else {
 #pragma warning(push)
 #pragma warning(disable : 4291)
-    intrusive_ptr<RCString> ptr = new (bytesNeeded) RCString();  // uses custom operator new
+        ptr = new (bytesNeeded) RCString();  // uses custom operator new
 #pragma warning(pop)
+    }
 
     ptr->_size = s.size();
     char* stringStart = reinterpret_cast<char*>(ptr.get()) + sizeof(RCString);
@@ -115,6 +115,10 @@ public:
         return StringData(c_str(), _size);
     }
 
+    /**
+     * Creates a copy of 's'. The storage is taken from the calling thread's MemoryArena if one is
+     * installed, and from the heap otherwise.
+     */
     static boost::intrusive_ptr<const RCString> create(StringData s);
 
 // MSVC: C4291: 'declaration' : no matching operator delete found; memory will not be freed if
@@ -128,9 +132,11 @@ public:
     }
 #pragma warning(pop)
 
-private:
+protected:
     // these can only be created by calling create()
     RCString(){};
+
+private:
     void* operator new(size_t objSize, size_t realSize) {
         return mongoMalloc(realSize);
     }
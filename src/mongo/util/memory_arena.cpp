@@ -0,0 +1,248 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_arena.h"
+
+#include <atomic>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+namespace {
+constexpr size_t kAlignment = 16;
+
+constexpr size_t alignUp(size_t bytes) {
+    return (bytes + kAlignment - 1) & ~(kAlignment - 1);
+}
+}  // namespace
+
+/**
+ * The state shared between an arena and the chunks it has handed out. Chunks with live
+ * allocations keep the pool alive, so that they can be returned to it after the arena is gone.
+ */
+class MemoryArena::Pool : public RefCountable {
+public:
+    ~Pool() {
+        for (auto chunk : _freeChunks) {
+            destroy(chunk);
+        }
+    }
+
+    /**
+     * Returns an empty chunk of 'chunkSizeBytes' bytes, reusing a recycled one when possible.
+     */
+    Chunk* take(size_t chunkSizeBytes);
+
+    /**
+     * Returns a chunk with no remaining allocations to the free list, or frees it if the owning
+     * arena has been destroyed or the free list is full.
+     */
+    void recycle(Chunk* chunk);
+
+    /**
+     * Called when the owning arena is destroyed. Frees the free list and stops caching chunks.
+     */
+    void close();
+
+    AtomicWord<long long> bytesReserved;
+    AtomicWord<long long> bytesCached;
+    AtomicWord<long long> bytesInUse;
+    AtomicWord<long long> chunksAllocated;
+    AtomicWord<long long> chunksRecycled;
+
+private:
+    void destroy(Chunk* chunk);
+
+    Mutex _mutex = MONGO_MAKE_LATCH("MemoryArena::Pool::_mutex");
+    std::vector<Chunk*> _freeChunks;
+    bool _closed = false;
+};
+
+struct MemoryArena::Chunk {
+    // Precedes every allocation, so that deallocate() can find the owning chunk.
+    struct AllocationHeader {
+        Chunk* chunk;
+        size_t bytes;
+    };
+    static constexpr size_t kHeaderBytes = alignUp(sizeof(AllocationHeader));
+
+    explicit Chunk(size_t sizeBytes) : sizeBytes(sizeBytes) {}
+
+    char* data() {
+        return reinterpret_cast<char*>(this) + alignUp(sizeof(Chunk));
+    }
+
+    size_t capacity() const {
+        return sizeBytes - alignUp(sizeof(Chunk));
+    }
+
+    const size_t sizeBytes;
+
+    // Offset of the next allocation in data(). Only accessed by the owning arena.
+    size_t used = 0;
+
+    // Live allocations, plus one while the chunk is the arena's current chunk.
+    std::atomic<uint32_t> refs{0};  // NOLINT
+
+    // Set while the chunk is handed out by 'pool'.
+    boost::intrusive_ptr<Pool> pool;
+};
+
+MemoryArena::Chunk* MemoryArena::Pool::take(size_t chunkSizeBytes) {
+    Chunk* chunk = nullptr;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_freeChunks.empty()) {
+            chunk = _freeChunks.back();
+            _freeChunks.pop_back();
+        }
+    }
+
+    if (chunk) {
+        bytesCached.fetchAndSubtract(chunk->sizeBytes);
+        chunksRecycled.fetchAndAdd(1);
+    } else {
+        chunk = new (mongoMalloc(chunkSizeBytes)) Chunk(chunkSizeBytes);
+        bytesReserved.fetchAndAdd(chunkSizeBytes);
+        chunksAllocated.fetchAndAdd(1);
+    }
+
+    chunk->used = 0;
+    chunk->refs.store(1, std::memory_order_relaxed);
+    chunk->pool = this;
+    return chunk;
+}
+
+void MemoryArena::Pool::recycle(Chunk* chunk) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_closed && _freeChunks.size() < kMaxCachedChunks) {
+            _freeChunks.push_back(chunk);
+            bytesCached.fetchAndAdd(chunk->sizeBytes);
+            return;
+        }
+    }
+    destroy(chunk);
+}
+
+void MemoryArena::Pool::close() {
+    std::vector<Chunk*> freeChunks;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _closed = true;
+        freeChunks.swap(_freeChunks);
+    }
+    for (auto chunk : freeChunks) {
+        bytesCached.fetchAndSubtract(chunk->sizeBytes);
+        destroy(chunk);
+    }
+}
+
+void MemoryArena::Pool::destroy(Chunk* chunk) {
+    bytesReserved.fetchAndSubtract(chunk->sizeBytes);
+    chunk->~Chunk();
+    free(chunk);
+}
+
+MemoryArena::MemoryArena(size_t chunkSizeBytes)
+    : _chunkSizeBytes(chunkSizeBytes), _pool(make_intrusive<Pool>()) {
+    invariant(_chunkSizeBytes >= 4 * (alignUp(sizeof(Chunk)) + Chunk::kHeaderBytes));
+}
+
+MemoryArena::~MemoryArena() {
+    invariant(_current != this);
+    _pool->close();
+    if (_chunk) {
+        releaseChunk(_chunk);
+    }
+}
+
+void* MemoryArena::allocate(size_t bytes) {
+    const size_t needed = Chunk::kHeaderBytes + alignUp(bytes);
+
+    // Large requests would leave most of a chunk unused, so they are left to the heap.
+    if (needed > _chunkSizeBytes / 4) {
+        return nullptr;
+    }
+
+    if (!_chunk || _chunk->used + needed > _chunk->capacity()) {
+        advanceChunk();
+    }
+
+    char* ptr = _chunk->data() + _chunk->used;
+    _chunk->used += needed;
+    _chunk->refs.fetch_add(1, std::memory_order_relaxed);
+    new (ptr) Chunk::AllocationHeader{_chunk, needed};
+    _pool->bytesInUse.fetchAndAdd(needed);
+    return ptr + Chunk::kHeaderBytes;
+}
+
+void MemoryArena::deallocate(void* ptr) {
+    auto header = reinterpret_cast<Chunk::AllocationHeader*>(static_cast<char*>(ptr) -
+                                                             Chunk::kHeaderBytes);
+    Chunk* chunk = header->chunk;
+    chunk->pool->bytesInUse.fetchAndSubtract(header->bytes);
+    releaseChunk(chunk);
+}
+
+void MemoryArena::releaseChunk(Chunk* chunk) {
+    if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // The chunk no longer references the pool once it is back on the free list, which may
+        // release the last reference to the pool.
+        auto pool = std::move(chunk->pool);
+        pool->recycle(chunk);
+    }
+}
+
+void MemoryArena::advanceChunk() {
+    if (_chunk) {
+        releaseChunk(std::exchange(_chunk, nullptr));
+    }
+    _chunk = _pool->take(_chunkSizeBytes);
+}
+
+MemoryArena::Stats MemoryArena::stats() const {
+    Stats stats;
+    stats.bytesReserved = _pool->bytesReserved.load();
+    stats.bytesCached = _pool->bytesCached.load();
+    stats.bytesInUse = _pool->bytesInUse.load();
+    stats.chunksAllocated = _pool->chunksAllocated.load();
+    stats.chunksRecycled = _pool->chunksRecycled.load();
+    return stats;
+}
+
+}  // namespace mongo
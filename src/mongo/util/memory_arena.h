@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/intrusive_ptr.hpp>
+
+namespace mongo {
+
+/**
+ * A monotonic arena for the short-lived allocations made while executing a single operation.
+ *
+ * Memory is carved sequentially out of fixed-size chunks, so an allocation is a pointer bump on
+ * the thread which owns the arena rather than a trip through the global allocator. Individual
+ * allocations are never reused; instead each chunk counts its live allocations and is recycled
+ * as a whole once all of them have been freed.
+ *
+ * Allocations made from an arena are not tied to its lifetime. deallocate() may be called from
+ * any thread, including after the arena itself has been destroyed, so it is safe for a value
+ * allocated here to escape the operation: it simply pins its chunk until it is released.
+ *
+ * Callers do not normally hold a reference to an arena. Instead, the owner of the operation
+ * installs it as the current arena for the executing thread with a MemoryArena::Scope, and
+ * low-level containers such as DocumentStorage and RCString consult MemoryArena::current() when
+ * allocating.
+ *
+ * allocate() must only be called by one thread at a time.
+ */
+class MemoryArena {
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+public:
+    static constexpr size_t kDefaultChunkSizeBytes = 64 * 1024;
+
+    // Drained chunks beyond this many are returned to the heap rather than kept for reuse.
+    static constexpr size_t kMaxCachedChunks = 16;
+
+    /**
+     * Makes 'arena' the current arena of the calling thread for the lifetime of the scope, and
+     * restores the previous one on exit. A null 'arena' leaves the current arena unchanged.
+     */
+    class Scope {
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    public:
+        explicit Scope(MemoryArena* arena) : _previous(_current) {
+            if (arena) {
+                _current = arena;
+            }
+        }
+
+        ~Scope() {
+            _current = _previous;
+        }
+
+    private:
+        MemoryArena* const _previous;
+    };
+
+    struct Stats {
+        // Bytes held in chunks, whether or not they currently contain live allocations.
+        int64_t bytesReserved = 0;
+        // Bytes held in drained chunks which are waiting on the free list to be reused.
+        int64_t bytesCached = 0;
+        // Bytes of live allocations, including per-allocation bookkeeping.
+        int64_t bytesInUse = 0;
+        int64_t chunksAllocated = 0;
+        int64_t chunksRecycled = 0;
+
+        /**
+         * Memory pinned by live allocations but not attributable to them, such as the unused tail
+         * of a chunk or a chunk pinned by a single surviving value. Drained chunks on the free list
+         * are not pinned by anything and do not count.
+         */
+        int64_t overheadBytes() const {
+            return bytesReserved - bytesCached - bytesInUse;
+        }
+    };
+
+    explicit MemoryArena(size_t chunkSizeBytes = kDefaultChunkSizeBytes);
+    ~MemoryArena();
+
+    /**
+     * Returns the arena installed on the calling thread, or nullptr if there is none.
+     */
+    static MemoryArena* current() {
+        return _current;
+    }
+
+    /**
+     * Returns 16-byte aligned storage for 'bytes' bytes, or nullptr if the request is too large
+     * to be served from a chunk. Such requests should be served from the heap by the caller.
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * Releases storage returned by allocate() on any arena.
+     */
+    static void deallocate(void* ptr);
+
+    Stats stats() const;
+
+private:
+    class Pool;
+    struct Chunk;
+
+    static void releaseChunk(Chunk* chunk);
+    void advanceChunk();
+
+    static inline thread_local MemoryArena* _current = nullptr;
+
+    const size_t _chunkSizeBytes;
+    boost::intrusive_ptr<Pool> _pool;
+
+    // The chunk allocations are currently carved from. Holds one reference on behalf of the
+    // arena, so that it is not recycled while partially filled.
+    Chunk* _chunk = nullptr;
+};
+
+}  // namespace mongo
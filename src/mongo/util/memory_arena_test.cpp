@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_arena.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kChunkSize = 4096;
+
+TEST(MemoryArenaTest, AllocationsAreAlignedAndAccounted) {
+    MemoryArena arena(kChunkSize);
+    void* first = arena.allocate(1);
+    void* second = arena.allocate(24);
+    ASSERT(first);
+    ASSERT(second);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % 16, 0U);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(second) % 16, 0U);
+
+    auto stats = arena.stats();
+    ASSERT_EQ(stats.chunksAllocated, 1);
+    ASSERT_EQ(stats.bytesReserved, static_cast<int64_t>(kChunkSize));
+    ASSERT_GT(stats.bytesInUse, 0);
+
+    MemoryArena::deallocate(first);
+    MemoryArena::deallocate(second);
+    ASSERT_EQ(arena.stats().bytesInUse, 0);
+}
+
+TEST(MemoryArenaTest, LargeAllocationsAreLeftToTheHeap) {
+    MemoryArena arena(kChunkSize);
+    ASSERT_FALSE(arena.allocate(kChunkSize / 2));
+    ASSERT_EQ(arena.stats().chunksAllocated, 0);
+}
+
+TEST(MemoryArenaTest, DrainedChunksAreRecycled) {
+    MemoryArena arena(kChunkSize);
+
+    // Fill several chunks, then release everything.
+    std::vector<void*> allocations;
+    while (arena.stats().chunksAllocated < 3) {
+        allocations.push_back(arena.allocate(100));
+    }
+    for (auto ptr : allocations) {
+        MemoryArena::deallocate(ptr);
+    }
+
+    // The drained chunks are reused rather than allocating new ones.
+    allocations.clear();
+    for (int i = 0; i < 50; ++i) {
+        allocations.push_back(arena.allocate(100));
+    }
+    auto stats = arena.stats();
+    ASSERT_EQ(stats.chunksAllocated, 3);
+    ASSERT_GT(stats.chunksRecycled, 0);
+
+    for (auto ptr : allocations) {
+        MemoryArena::deallocate(ptr);
+    }
+}
+
+TEST(MemoryArenaTest, DrainedChunksAreNotOverhead) {
+    MemoryArena arena(kChunkSize);
+
+    std::vector<void*> allocations;
+    while (arena.stats().chunksAllocated < 3) {
+        allocations.push_back(arena.allocate(100));
+    }
+    for (auto ptr : allocations) {
+        MemoryArena::deallocate(ptr);
+    }
+
+    // Only the current chunk is still pinned, by the arena itself. The drained ones are cached.
+    auto stats = arena.stats();
+    ASSERT_EQ(stats.bytesInUse, 0);
+    ASSERT_EQ(stats.bytesCached, static_cast<int64_t>(2 * kChunkSize));
+    ASSERT_EQ(stats.overheadBytes(), static_cast<int64_t>(kChunkSize));
+}
+
+TEST(MemoryArenaTest, FreeListIsBounded) {
+    MemoryArena arena(kChunkSize);
+
+    std::vector<void*> allocations;
+    while (arena.stats().chunksAllocated < static_cast<int64_t>(MemoryArena::kMaxCachedChunks + 4)) {
+        allocations.push_back(arena.allocate(100));
+    }
+    for (auto ptr : allocations) {
+        MemoryArena::deallocate(ptr);
+    }
+
+    // Drained chunks beyond the cap are returned to the heap.
+    auto stats = arena.stats();
+    ASSERT_EQ(stats.bytesCached,
+              static_cast<int64_t>(MemoryArena::kMaxCachedChunks * kChunkSize));
+    ASSERT_EQ(stats.bytesReserved,
+              static_cast<int64_t>((MemoryArena::kMaxCachedChunks + 1) * kChunkSize));
+}
+
+TEST(MemoryArenaTest, AllocationsMayOutliveTheArena) {
+    void* survivor;
+    {
+        MemoryArena arena(kChunkSize);
+        survivor = arena.allocate(64);
+        memset(survivor, 'x', 64);
+    }
+    ASSERT_EQ(static_cast<char*>(survivor)[63], 'x');
+    MemoryArena::deallocate(survivor);
+}
+
+TEST(MemoryArenaTest, ScopeInstallsArenaForRCString) {
+    ASSERT_FALSE(MemoryArena::current());
+
+    MemoryArena arena(kChunkSize);
+    boost::intrusive_ptr<const RCString> str;
+    {
+        MemoryArena::Scope scope(&arena);
+        ASSERT_EQ(MemoryArena::current(), &arena);
+        str = RCString::create("a string which lives in the arena");
+        ASSERT_GT(arena.stats().bytesInUse, 0);
+    }
+    ASSERT_FALSE(MemoryArena::current());
+
+    ASSERT_EQ(str->stringData(), "a string which lives in the arena"_sd);
+    str.reset();
+    ASSERT_EQ(arena.stats().bytesInUse, 0);
+}
+
+}  // namespace
+}  // namespace mongo